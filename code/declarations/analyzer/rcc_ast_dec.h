@@ -17,6 +17,10 @@ namespace ast
     class VarID;
     class SetID;
     class OpItem;
+    class CompilationSession;
+    class ModuleRegistry;
+    class BuildScheduler;
+    struct CompiledModule;
 
     // --- 访问器 ---
     class Visitor;
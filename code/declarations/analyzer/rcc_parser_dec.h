@@ -9,9 +9,10 @@ namespace parser
 {
     class Parser;
     using ExpressionNodePtr = std::shared_ptr<ast::ExpressionNode>;
-    using PrefixExpressionBuilder = std::function<ExpressionNodePtr(Parser*)>;
-    using InfixExpressionBuilder = std::function<ExpressionNodePtr(Parser*, const ExpressionNodePtr &)>;
-    using PostfixExpressionBuilder = std::function<ExpressionNodePtr(Parser*, const ExpressionNodePtr &)>;
+    // 构建函数直接以成员函数指针存放在分派表中，避免 std::function 的间接调用开销
+    using PrefixExpressionBuilder = ExpressionNodePtr (Parser::*)();
+    using InfixExpressionBuilder = ExpressionNodePtr (Parser::*)(const ExpressionNodePtr &);
+    using PostfixExpressionBuilder = ExpressionNodePtr (Parser::*)(const ExpressionNodePtr &);
     void enableDebugMode(bool cond);
 }
 
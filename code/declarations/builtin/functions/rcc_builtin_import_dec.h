@@ -11,15 +11,25 @@ namespace builtin
 {
     namespace rcc_import_utils {
         std::string resolveImportedFilePath(const ast::CompileVisitor& visitor, const std::string& extName);
+        // 按导入方文件路径解析，供语义分析之前的导入图预解析使用
+        std::string resolveImportedFilePath(const std::string& importerFilePath, const std::string& extName);
         std::string generateVariableIdentifier(ast::CompileVisitor& visitor, const std::string& ident,
                                                const std::string& importedFilePath, bool isAutomaticForm);
         std::string handleRegisteredExtension(ast::CompileVisitor& visitor,
                                               const std::shared_ptr<symbol::ClassSymbol>& registeredExtension,
                                               const ast::VarID& tempVarId,
                                               bool isAutomaticForm);
-        std::string compileAndProcessNewExtension(ast::CompileVisitor& visitor,
-                                                  const std::string& importedFilePath,
-                                                  const ast::VarID& tempVarId);
+        // 在由 importer 派生的模块会话中编译 modulePath 并发布到模块注册表，返回注册表中的模块
+        // 构建调度器的工作线程与导入处的串行编译共用此流程，编译失败时抛出异常
+        std::shared_ptr<const ast::CompiledModule> compileExtensionModule(ast::CompilationSession& importer,
+                                                                          const std::string& entryFilePath,
+                                                                          const std::string& modulePath);
+        // 取得已发布的模块，未发布时在当前线程上编译
+        std::shared_ptr<const ast::CompiledModule> importExtensionModule(ast::CompileVisitor& visitor,
+                                                                         const std::string& importedFilePath,
+                                                                         const ast::VarID& tempVarId);
+        // 记录导入关系并合并模块的自定义类型；根会话中还返回模块及其尚未并入输出的依赖的代码
+        std::string linkExtensionModule(ast::CompilationSession& session, const ast::CompiledModule& module);
         std::string processImportedSymbols(const ast::CompileVisitor& visitor,
                                            ast::CompileVisitor& importVisitor,
                                            const std::shared_ptr<symbol::ClassSymbol>& extensionSymbol);
@@ -21,6 +21,19 @@ namespace builtin
         ast::CompileVisitor &visitor,
         const CallInfos &)>;
 
+    // 内置函数分派：指向注册表中的纯内置函数或内置函数，注册表只增不删，指针长期有效
+    // 二者皆空表示不在注册表中（非内置函数或由 DLL 扩展提供）
+    struct BuiltinDispatch
+    {
+        const PureBuiltinFunction *pureBuiltinFunction = nullptr;
+        const BuiltinFunc *builtinFunction = nullptr;
+
+        explicit operator bool() const
+        {
+            return pureBuiltinFunction || builtinFunction;
+        }
+    };
+
     void initializePureBuiltinEnvironment(ast::CompileVisitor &visitor);
 
     bool isPureBuiltinFunction(const std::string &funcName);
@@ -30,6 +43,10 @@ namespace builtin
     BuiltinFuncRetType callBuiltinFunction(
         ast::CompileVisitor &visitor, const std::string &funcName, const CallInfos& callInfos);
 
+    BuiltinDispatch findBuiltinDispatch(const std::string &funcName);
+    BuiltinFuncRetType callBuiltinFunction(
+        ast::CompileVisitor &visitor, const BuiltinDispatch &dispatch, const CallInfos& callInfos);
+
     void registerExternalPureBuiltinFunction(const std::string &funcName, const PureBuiltinFunction &func);
     void registerExternalBuiltinFunction(const std::string &funcName, const BuiltinFunc &func);
 
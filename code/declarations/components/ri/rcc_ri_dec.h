@@ -62,6 +62,10 @@ namespace ri
     class TP_ADD_INST_FIELD;
     class TP_GET_FIELD;
     class TP_SET_FIELD;
+    class OperandPool;
+    class InstructionBuffer;
+    struct OptimizeStats;
+    class RaOptimizer;
 }
 
 #endif //RCC_RCC_RI_DEC_H
\ No newline at end of file
@@ -29,6 +29,7 @@ namespace symbol
     class FunctionSymbol;
     class ClassSymbol;
     class SymbolTableManager;
+    class TypeLabelSet;
 
     extern std::unordered_map<std::string, LabelType> labelTypeMap;
 
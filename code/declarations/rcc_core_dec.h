@@ -5,6 +5,7 @@
 #ifndef RCC_RCC_CORE_DEC_H
 #define RCC_RCC_CORE_DEC_H
 #include <string>
+#include <string_view>
 
 namespace core
 {
@@ -27,6 +28,10 @@ namespace core
 
     // 函数声明
     std::string getTokenTypeName(const TokenType& type);
+    // 在编译期生成的完美哈希表中查找关键字与符号，未收录时返回 TOKEN_UNDEFINED
+    TokenType lookupSymbolType(std::string_view text);
+    // 按词素文本判定 Token 类型
+    TokenType classifyLexeme(std::string_view text);
 }
 
 #endif //RCC_RCC_CORE_DEC_H
\ No newline at end of file
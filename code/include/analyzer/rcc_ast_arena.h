@@ -0,0 +1,79 @@
+//
+// Created by RestRegular on 2025/6/29.
+//
+
+#ifndef RCC_RCC_AST_ARENA_H
+#define RCC_RCC_AST_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace ast {
+
+    // AST 内存池：节点连同其引用计数控制块按块顺序分配，单个节点释放时不归还内存，内存池析构时一次性归还。
+    // 节点不持有内存池，由语法树的根（ProgramNode）及其他保留节点的对象持有，须保证内存池比其中的节点存活得更久。
+    // 内存池本身不是线程安全的，一次语法分析独占一个内存池
+    class AstArena {
+    public:
+        static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+        AstArena() = default;
+        AstArena(const AstArena &) = delete;
+        AstArena &operator=(const AstArena &) = delete;
+
+        void *allocate(size_t size, size_t alignment);
+
+        [[nodiscard]] size_t getAllocationCount() const;
+        [[nodiscard]] size_t getAllocatedBytes() const;
+        [[nodiscard]] size_t getBlockCount() const;
+
+    private:
+        std::vector<std::unique_ptr<std::byte[]>> _blocks;
+        std::byte *_cursor = nullptr;
+        size_t _remaining = 0;
+        size_t _allocationCount = 0;
+        size_t _allocatedBytes = 0;
+    };
+
+    // 供 std::allocate_shared 使用的分配器；控制块中的分配器副本只是不持有所有权的指针，
+    // 构造与释放节点时不必更新内存池的引用计数
+    template <typename T>
+    class ArenaAllocator {
+        template <typename U> friend class ArenaAllocator;
+        AstArena *_arena;
+    public:
+        using value_type = T;
+
+        explicit ArenaAllocator(AstArena *arena) : _arena(arena) {}
+
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U> &other) : _arena(other._arena) {}
+
+        T *allocate(const size_t n)
+        {
+            return static_cast<T *>(_arena->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T *, size_t) {}
+
+        template <typename U>
+        bool operator==(const ArenaAllocator<U> &other) const { return _arena == other._arena; }
+
+        template <typename U>
+        bool operator!=(const ArenaAllocator<U> &other) const { return _arena != other._arena; }
+    };
+
+    // 在内存池中构造节点；没有内存池时退化为普通的 std::make_shared
+    template <typename T, typename... Args>
+    std::shared_ptr<T> makeNode(const std::shared_ptr<AstArena> &arena, Args &&... args)
+    {
+        if (!arena) {
+            return std::make_shared<T>(std::forward<Args>(args)...);
+        }
+        return std::allocate_shared<T>(ArenaAllocator<T>(arena.get()), std::forward<Args>(args)...);
+    }
+
+} // ast
+
+#endif //RCC_RCC_AST_ARENA_H
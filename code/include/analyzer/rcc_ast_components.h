@@ -7,6 +7,7 @@
 
 #include <utility>
 #include "./rcc_ast.h"
+#include "./rcc_ast_arena.h"
 #include "../rcc_base.h"
 #include "../visitors/rcc_base_visitor.h"
 #include "../../include/rcc_core.h"
@@ -438,6 +439,7 @@ namespace ast {
         [[nodiscard]] std::shared_ptr<ExpressionNode> getCallNode() const;
         [[nodiscard]] std::vector<std::shared_ptr<LabelNode>> getLabelNodes() const;
         [[nodiscard]] Token getColonToken() const;
+        [[nodiscard]] std::shared_ptr<Token> getColonTokenPtr() const;
     };
 
     class FunctionDefinitionNode final : public ExpressionNode {
@@ -458,6 +460,7 @@ namespace ast {
         [[nodiscard]] std::vector<std::shared_ptr<LabelNode>> getLabelNodes() const;
         [[nodiscard]] std::shared_ptr<ExpressionNode> getBodyNode() const;
         [[nodiscard]] Token getColonToken() const;
+        [[nodiscard]] std::shared_ptr<Token> getColonTokenPtr() const;
         [[nodiscard]] std::shared_ptr<Token> getIndicatorToken() const;
     };
 
@@ -643,10 +646,17 @@ namespace ast {
     };
 
     class ProgramNode final : public StatementNode {
+        // 语句节点所在的内存池（增量分析时各语句可能来自不同的内存池），节点不持有内存池，由程序节点保证其存活；
+        // 声明在 statements 之前，从而在全部语句节点释放之后才析构。程序节点本身不在内存池中分配
+        std::vector<std::shared_ptr<AstArena>> arenas;
         std::vector<std::shared_ptr<StatementNode>> statements;
     public:
         explicit ProgramNode(const Token &mainToken, std::vector<std::shared_ptr<StatementNode>> statements);
 
+        void addArena(const std::shared_ptr<AstArena> &arena);
+
+        [[nodiscard]] const std::vector<std::shared_ptr<AstArena>> &getArenas() const;
+
         void acceptVisitor(Visitor &visitor) override;
 
         [[nodiscard]] Pos getPos() const override;
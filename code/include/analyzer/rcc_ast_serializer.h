@@ -0,0 +1,52 @@
+//
+// Created by RestRegular on 2025/6/29.
+//
+
+#ifndef RCC_RCC_AST_SERIALIZER_H
+#define RCC_RCC_AST_SERIALIZER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "./rcc_ast_components.h"
+#include "./rcc_lexer.h"
+
+namespace ast {
+
+    // 语法树二进制序列化：文件头记录格式版本、编译器版本、源码哈希与载荷校验和，其后依次是字符串表、文件路径表，
+    // 以及前序排列的节点（类型标签 + 构造参数）。Token 的位置只保存文件序号与偏移，行列信息仍由行表换算
+    // 反序列化时经由节点原有的构造函数重建，派生字段（循环类型、字面量值等）与语法分析的结果一致
+    class AstSerializer {
+    public:
+        static constexpr char MAGIC[4] = {'R', 'A', 'S', 'T'};
+        // 节点编码方式变化时递增，旧缓存随之失效
+        static constexpr uint32_t FORMAT_VERSION = 2;
+
+        // 语法树中出现无法序列化的节点时抛出 std::runtime_error
+        static std::string serialize(ProgramNode &program, uint64_t sourceHash);
+
+        // 格式版本、编译器版本或源码哈希不一致时返回 nullptr；校验和不符或数据损坏时抛出 std::runtime_error
+        static std::shared_ptr<ProgramNode> deserialize(std::string_view data, uint64_t sourceHash,
+                                                        const std::shared_ptr<AstArena> &arena);
+    };
+
+    // 语法树缓存：以模块绝对路径为键保存序列化结果，源码哈希一致时直接载入，跳过语法分析
+    // 只缓存 RCC 库目录下的模块，这些模块在多次编译之间几乎不变
+    class AstCache {
+    public:
+        static bool isCacheable(const std::string &filepath);
+
+        static std::string getCachePath(const std::string &filepath);
+
+        // 缓存缺失或失效时返回 nullptr；命中时会构建 lexer 的行表，保证位置信息可用
+        static std::shared_ptr<ProgramNode> load(const lexer::Lexer &lexer);
+
+        // 写入失败只放弃本次缓存，不影响编译
+        static void store(const lexer::Lexer &lexer, ProgramNode &program);
+    };
+
+} // ast
+
+#endif //RCC_RCC_AST_SERIALIZER_H
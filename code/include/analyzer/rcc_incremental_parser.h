@@ -0,0 +1,80 @@
+//
+// Created by RestRegular on 2025/6/29.
+//
+
+#ifndef RCC_RCC_INCREMENTAL_PARSER_H
+#define RCC_RCC_INCREMENTAL_PARSER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "./rcc_parser.h"
+
+namespace parser {
+
+    // 增量前端：保存一份源码及其逐条顶层语句的解析结果，编辑后只重新扫描、解析受影响的语句
+    // 重新扫描从编辑位置之前最近的同步点开始，并在编辑之后重新回到旧 Token 流的同步点时停止，
+    // 其后未受影响的顶层语句子树原样复用，其位置通过平移锚点基址保持正确
+    // 被替换语句的锚点随即释放并由之后的扫描复用，因此编辑之前取得的语法树中被替换部分的位置不再有效
+    class IncrementalParser {
+    public:
+        explicit IncrementalParser(const std::string &filepath, const std::string &dirpath="");
+        IncrementalParser(const std::string &filepath, std::string source);
+        ~IncrementalParser();
+        IncrementalParser(const IncrementalParser &) = delete;
+        IncrementalParser &operator=(const IncrementalParser &) = delete;
+
+        // 将 source[offset, offset + length) 替换为 replacement 并更新语法树，返回是否存在语法错误
+        bool applyEdit(size_t offset, size_t length, const std::string &replacement);
+
+        [[nodiscard]] std::shared_ptr<ProgramNode> getProgram() const;
+        [[nodiscard]] const std::string &getSource() const;
+        [[nodiscard]] const std::string &getFilepath() const;
+        [[nodiscard]] StringVector getErrorMsgs() const;
+        [[nodiscard]] bool hasError() const;
+
+        // 最近一次更新中重新解析与复用的顶层语句数量
+        [[nodiscard]] size_t getReparsedCount() const;
+        [[nodiscard]] size_t getReusedCount() const;
+
+    private:
+        // 一条顶层语句及其解析结果
+        struct Segment {
+            // 首个 Token 的起止偏移
+            size_t begin = 0;
+            size_t firstEnd = 0;
+            // 语句开始于同步点时为其前面换行词素的首字符，否则为 '\0'
+            char newline = '\0';
+            // 语句节点所在的内存池，声明在 node 之前以便在节点之后析构
+            std::shared_ptr<AstArena> arena;
+            std::shared_ptr<StatementNode> node;
+            StringVector errors;
+        };
+        // 锚点：从某个同步点开始的 Token 都以它为基址记录位置
+        struct Anchor {
+            size_t base;
+            uint32_t id;
+        };
+
+        std::string _filepath;
+        uint32_t _fileId;
+        std::string _source;
+        Token _programToken;
+        StringVector _programErrors;
+        std::vector<Segment> _segments;
+        std::vector<Anchor> _anchors;
+        std::shared_ptr<ProgramNode> _program;
+        size_t _reparsedCount = 0;
+        size_t _reusedCount = 0;
+
+        // 从第 first 条语句开始重新解析，first 为 0 时从文件开头解析
+        // editEnd 为编辑后替换文本的结束偏移，其后的旧语句平移 delta 后即可复用
+        void reparse(size_t first, size_t editEnd, int64_t delta);
+        void buildProgram();
+        void releaseAnchors();
+    };
+
+} // parser
+
+#endif //RCC_RCC_INCREMENTAL_PARSER_H
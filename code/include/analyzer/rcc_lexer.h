@@ -5,21 +5,82 @@
 #ifndef RCC_RCC_LEXER_H
 #define RCC_RCC_LEXER_H
 
+#include <deque>
 #include <queue>
+#include <string_view>
 #include "../rcc_core.h"
 #include "../lib/rcc_utils.h"
 
 namespace lexer {
 
+    // 零拷贝词素：text 指向源码映射缓冲区（或静态字面量），offset 为其在源码中的字节偏移，type 在扫描时确定
+    struct TokenView {
+        std::string_view text;
+        size_t offset;
+        core::TokenType type;
+    };
+
+    // 拉取式 Token 流：语法分析器按需逐个取用，流结束时返回 nullptr
+    class TokenSource {
+    public:
+        virtual ~TokenSource() = default;
+        virtual std::shared_ptr<core::Token> next() = 0;
+    };
+
+    // 兼容已物化的 Token 队列
+    class QueueTokenSource final : public TokenSource {
+        std::queue<std::shared_ptr<core::Token>> _tokens;
+    public:
+        explicit QueueTokenSource(std::queue<std::shared_ptr<core::Token>> tokens);
+        std::shared_ptr<core::Token> next() override;
+    };
+
     class Lexer {
+        // 可恢复的扫描游标，扫描状态在多次拉取之间保留
+        struct ScanCursor {
+            size_t index = 0;
+            // 当前正在累积的词素为 code[tBegin, tEnd)
+            size_t tBegin = 0, tEnd = 0;
+            // 组合符号最多两个字符，未组合完成时最多只保留一个字符
+            char groupSign = '\0';
+            char quoteChar = '\0';
+            size_t quoteOffset = 0;
+            bool needEscape = false;
+            bool finished = false;
+            core::CommentType commentType = core::CommentType::NONE;
+            // 尚未交出的词素：组合符号会回退最近的两个词素，因此总保留一个小窗口
+            std::deque<TokenView> pending;
+            std::string_view lastReleased;
+            // 记录同步点供增量分析使用，见 isSyncState
+            bool trackSyncPoints = false;
+            std::deque<size_t> syncPoints;
+        };
+        static constexpr size_t SCAN_WINDOW = 4;
+
         std::string _filepath;
-        std::string _filecode;
-        std::vector<std::string> _lines;
-        void splitCodeToLines();
+        uint32_t _fileId;
+        std::unique_ptr<utils::MappedFile> _source;
+        std::string_view _code;
+        // 每一行起始位置的字节偏移，首次查询行列信息时才构建，并同步登记到全局源文件表
+        mutable std::vector<uint32_t> _lineOffsets;
+        std::vector<TokenView> _views;
+        bool _scanned = false;
+        ScanCursor _cursor;
         std::queue<std::shared_ptr<core::Token>> tokens;
+        void scanChar(size_t &i);
+        void finishScan();
+        [[nodiscard]] bool lastIsNewLine(bool acceptCarriageReturn) const;
+        // 同步状态：没有未完成的词素、注释、引号或组合符号，且上一个词素是换行
+        // 从同步状态开始的扫描结果只取决于其后的源码，增量分析可以从这里重新扫描
+        [[nodiscard]] bool isSyncState() const;
+        struct InMemorySource {};
+        Lexer(InMemorySource, const std::string &filepath, std::string_view source);
     public:
         explicit Lexer(const std::string &filepath, const std::string &dirpath="");
 
+        // 扫描内存中的源码，source 由调用方持有，须在 Lexer 的生命周期内保持有效
+        static Lexer fromSource(const std::string &filepath, std::string_view source);
+
         [[nodiscard]] std::vector<std::string> getCodeLines() const;
 
         [[nodiscard]] std::string getCodeLine(const int &rowIndex) const;
@@ -28,9 +89,54 @@ namespace lexer {
 
         [[nodiscard]] std::string getFilepath() const;
 
+        [[nodiscard]] uint32_t getFileId() const;
+
+        [[nodiscard]] std::string_view getSource() const;
+
+        [[nodiscard]] size_t getLineCount() const;
+
+        // 构建行表并登记到全局源文件表，已构建时直接返回
+        void buildLineIndex() const;
+
+        // 将字节偏移换算为 (行, 列)，行列均从 1 开始
+        [[nodiscard]] std::pair<size_t, size_t> getLineColumn(size_t offset) const;
+
+        [[nodiscard]] utils::SourceLoc makeLoc(size_t offset, size_t length) const;
+
+        [[nodiscard]] utils::Pos makePos(size_t offset, size_t length) const;
+
+        [[nodiscard]] std::shared_ptr<core::Token> makeToken(const TokenView &view) const;
+
+        [[nodiscard]] static std::shared_ptr<core::Token> makeToken(const TokenView &view, const utils::SourceLoc &loc);
+
+        // 零拷贝扫描：只产生指向源码缓冲区的词素切片，不为单个词素分配堆内存
+        const std::vector<TokenView> &scan();
+
+        // 从头开始流式扫描；之后每次调用 scanNext 产出一个词素，扫描结束时返回 false
+        void rewind();
+        bool scanNext(TokenView &view);
+
+        // 从同步点 offset 开始流式扫描，newline 为同步点之前的换行词素文本（"\n" 或 "\r"）
+        void rewind(size_t offset, char newline);
+        // 开启后扫描过程中会记录同步点，之后可通过 isSyncPoint 查询
+        void trackSyncPoints(bool enable);
+        // 查询 offset 处是否是同步点，早于 offset 的记录会被丢弃，因此须按偏移递增的顺序查询
+        bool isSyncPoint(size_t offset);
+
+        // 按需产生 Token 的流，Lexer 的生命周期须长于返回的流
+        [[nodiscard]] std::shared_ptr<TokenSource> tokenStream();
+
         std::queue<std::shared_ptr<core::Token>> tokenize();
     };
 
+    class LexerTokenSource final : public TokenSource {
+        Lexer &_lexer;
+        bool _programEmitted = false;
+    public:
+        explicit LexerTokenSource(Lexer &lexer);
+        std::shared_ptr<core::Token> next() override;
+    };
+
     void enableDebugMode(bool cond);
 } // lexer
 
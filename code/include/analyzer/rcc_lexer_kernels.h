@@ -0,0 +1,91 @@
+//
+// Created by RestRegular on 2025/6/28.
+//
+
+#ifndef RCC_RCC_LEXER_KERNELS_H
+#define RCC_RCC_LEXER_KERNELS_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace lexer::kernels {
+
+    // 字符分类标志，同一字符可同时属于多个分类
+    enum CharClass : uint8_t {
+        CC_NONE = 0,
+        // 会打断词素的操作符字符（含空格与换行）
+        CC_OPERATOR = 1 << 0,
+        // 标识符字符：字母、数字、下划线及所有非 ASCII 字节
+        CC_IDENTIFIER = 1 << 1,
+        // 空白字符：空格与制表符
+        CC_WHITESPACE = 1 << 2,
+        // 单行注释内需要逐字符处理的字符：换行符与会产生换行 Token 的分号
+        CC_LINE_COMMENT_STOP = 1 << 3,
+        // 字符串字面量内需要逐字符处理的字符：引号、反斜杠与控制字符
+        CC_STRING_STOP = 1 << 4,
+        // 文档注释内需要逐字符处理的字符：可能参与组合符号判定的字符与分号
+        CC_DOC_COMMENT_STOP = 1 << 5
+    };
+
+    constexpr std::array<uint8_t, 256> buildCharClassTable()
+    {
+        std::array<uint8_t, 256> table{};
+        for (const char c : std::string_view(" \n\r+-*/%()[]{}:;,.=<>&!|?~^@")) {
+            table[static_cast<uint8_t>(c)] |= CC_OPERATOR;
+        }
+        for (int c = 0; c < 256; c++) {
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                (c >= '0' && c <= '9') || c == '_' || c >= 0x80) {
+                table[c] |= CC_IDENTIFIER;
+            }
+        }
+        for (const char c : std::string_view(" \t")) {
+            table[static_cast<uint8_t>(c)] |= CC_WHITESPACE;
+        }
+        for (const char c : std::string_view("\n\r;")) {
+            table[static_cast<uint8_t>(c)] |= CC_LINE_COMMENT_STOP;
+        }
+        for (const char c : std::string_view("\"'\\\n\r\t")) {
+            table[static_cast<uint8_t>(c)] |= CC_STRING_STOP;
+        }
+        for (const char c : std::string_view("*/.;")) {
+            table[static_cast<uint8_t>(c)] |= CC_DOC_COMMENT_STOP;
+        }
+        return table;
+    }
+
+    inline constexpr std::array<uint8_t, 256> CHAR_CLASS_TABLE = buildCharClassTable();
+
+    constexpr bool hasClass(const char c, const CharClass charClass)
+    {
+        return (CHAR_CLASS_TABLE[static_cast<uint8_t>(c)] & charClass) != 0;
+    }
+
+    constexpr bool isOperatorChar(const char c) { return hasClass(c, CC_OPERATOR); }
+
+    constexpr bool isIdentifierChar(const char c) { return hasClass(c, CC_IDENTIFIER); }
+
+    // 以下扫描函数均从 pos 开始，返回第一个满足停止条件的位置，找不到时返回 code.size()
+
+    // 跳过连续的标识符字符
+    size_t skipIdentifier(std::string_view code, size_t pos);
+
+    // 跳过连续的空格与制表符
+    size_t skipWhitespace(std::string_view code, size_t pos);
+
+    // 查找单行注释中下一个换行符或分号
+    size_t findLineCommentStop(std::string_view code, size_t pos);
+
+    // 查找文档注释中下一个可能构成 "*/" 的字符或分号
+    size_t findDocCommentStop(std::string_view code, size_t pos);
+
+    // 查找字符串字面量中下一个引号、反斜杠或控制字符
+    size_t findStringStop(std::string_view code, size_t pos);
+
+    // 当前编译启用的扫描实现："avx2"、"sse2" 或 "scalar"
+    const char *activeKernelName();
+
+} // lexer::kernels
+
+#endif //RCC_RCC_LEXER_KERNELS_H
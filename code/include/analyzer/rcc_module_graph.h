@@ -0,0 +1,62 @@
+//
+// Created by RestRegular on 2025/6/29.
+//
+
+#ifndef RCC_RCC_MODULE_GRAPH_H
+#define RCC_RCC_MODULE_GRAPH_H
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "./rcc_parser.h"
+
+namespace parser {
+
+    // 一个模块的词法、语法分析结果；Lexer 与 Parser 需随语法树一同保留，供后续输出错误信息
+    // 语法树取自 AST 缓存时没有 Parser，此时 parser 为空
+    struct ParsedModule {
+        std::shared_ptr<lexer::Lexer> lexer;
+        std::unique_ptr<Parser> parser;
+        std::shared_ptr<ProgramNode> program;
+    };
+
+    // 导入图预解析：语义分析开始前，从入口文件出发扫描各模块顶层的 import(...) 调用，
+    // 在线程池上并行完成整个依赖集合的词法、语法分析，编译各模块时直接取用结果
+    // 预解析只是缓存：解析失败或未被预解析到的模块，编译时仍按原流程串行解析
+    // 预解析结果归属于编译会话（CompilationSession），不同会话之间互不共享
+    // 库目录下的模块优先从 AST 缓存载入，源码未变时跳过语法分析
+    class ModuleGraphParser {
+    public:
+        // 将 importerPath 中出现的扩展名 extName 解析为被导入文件的绝对路径
+        using ImportResolver = std::function<std::string(const std::string &importerPath, const std::string &extName)>;
+
+        // 并行解析 entryPath 及其全部传递依赖，阻塞直到完成；threadCount 为 0 时按硬件并发数决定
+        void parseAll(const std::string &entryPath, const ImportResolver &resolver, size_t threadCount = 0);
+
+        // 取出 filepath 的预解析结果，没有时返回 nullptr；每个结果只能取出一次
+        std::unique_ptr<ParsedModule> take(const std::string &filepath);
+
+        // filepath 已预解析、没有语法错误且结果尚未被取出
+        bool hasParsed(const std::string &filepath);
+
+        // 预解析时记录的 filepath 顶层直接导入的模块（绝对路径，按出现顺序），不受 take 影响
+        std::vector<std::string> getImports(const std::string &filepath);
+
+        void clear();
+
+        // 收集顶层 import(...) 调用中以字符串字面量给出的扩展名
+        static std::vector<std::string> collectImports(const ProgramNode &program);
+
+    private:
+        std::mutex _mutex;
+        std::unordered_map<std::string, std::unique_ptr<ParsedModule>> _modules;
+        std::unordered_map<std::string, std::vector<std::string>> _imports;
+    };
+
+} // parser
+
+#endif //RCC_RCC_MODULE_GRAPH_H
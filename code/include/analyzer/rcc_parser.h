@@ -7,10 +7,13 @@
 
 #include <memory>
 #include <functional>
+#include <array>
 #include <list>
 #include <queue>
 
 #include "../rcc_base.h"
+#include "./rcc_lexer.h"
+#include "./rcc_ast_arena.h"
 #include "./rcc_ast_components.h"
 #include "../../declarations/analyzer/rcc_parser_dec.h"
 
@@ -23,10 +26,21 @@ namespace parser {
     class Parser {
     public:
         explicit Parser(std::queue<std::shared_ptr<Token>> tokens);
+        explicit Parser(std::shared_ptr<lexer::TokenSource> source);
         std::pair<bool, std::shared_ptr<ProgramNode>> parse();
+        // 与 parse 相同，但异常时不输出错误信息，由调用方决定如何处理
+        std::shared_ptr<ProgramNode> parseProgram();
         [[nodiscard]] StringVector getErrorMsgs() const;
         void printParserErrors(std::ostream &os = std::cerr) const;
         [[nodiscard]] bool hasError() const;
+        [[nodiscard]] std::shared_ptr<AstArena> getArena() const;
+
+        // 逐条解析顶层语句，供增量分析按语句重建语法树
+        // beginProgram 消耗程序起始 Token；seekStatement 跳过空行并返回下一条语句的首个 Token，没有时返回 nullptr
+        Token beginProgram();
+        const Token *seekStatement();
+        // 解析当前语句并前进到其后的 Token，本条语句产生的错误信息写入 errors
+        std::shared_ptr<StatementNode> parseStatement(StringVector &errors);
     private:
         static Token STREAM_START_TOKEN;
         static Token STREAM_END_TOKEN;
@@ -34,10 +48,24 @@ namespace parser {
         // 解析状态
         bool isInDictRanger = false;
 
-        // 词法分析结果
-        std::queue<std::shared_ptr<Token>> _tokens;
-        // 先前的 Token
-        std::stack<std::shared_ptr<Token>> _previous_tokens;
+        // 本次语法分析的 AST 内存池，节点均在其中分配
+        std::shared_ptr<AstArena> _arena = std::make_shared<AstArena>();
+
+        template <typename T, typename... Args>
+        std::shared_ptr<T> makeNode(Args &&... args) {
+            return ast::makeNode<T>(_arena, std::forward<Args>(args)...);
+        }
+
+        // 回看深度上限，需覆盖匿名函数标签回退时的最大回退步数
+        static constexpr size_t LOOK_BEHIND_CAPACITY = 64;
+
+        // 词法分析结果，按需拉取
+        std::shared_ptr<lexer::TokenSource> _source;
+        // 先前的 Token，只保留最近 LOOK_BEHIND_CAPACITY 个，超出时覆盖最早的记录
+        // 窗口外的 Token 会被释放，构建函数中跨越 next() 使用的 Token 须按值保存
+        std::array<std::shared_ptr<Token>, LOOK_BEHIND_CAPACITY> _previous_tokens;
+        size_t _previous_top = 0;
+        size_t _previous_count = 0;
         // 当前的 Token
         std::shared_ptr<Token> _current_token;
         // 临时 Token
@@ -46,16 +74,21 @@ namespace parser {
         std::list<std::shared_ptr<Token>> _tempTokens;
         // 语法分析错误列表
         std::vector<std::string> errorMsgs;
-        // 前缀表达式构建函数映射表
-        static std::map<core::TokenType, PrefixExpressionBuilder> prefixExpressionBuilders;
-        // 中缀表达式构建函数映射表
-        static std::map<core::TokenType, InfixExpressionBuilder> infixExpressionBuilders;
-        // 后缀表达式构建函数映射表
-        static std::map<core::TokenType, PostfixExpressionBuilder> postfixExpressionBuilders;
-        // 运算符优先级映射表
-        static std::map<core::TokenType, Precedence> precedenceMap;
+        // 以 TokenType 为下标的稠密分派表，编译期构建，每个 Token 只需一次数组访问
+        template <typename T>
+        using TokenTypeTable = std::array<T, core::TOKEN_TYPE_COUNT>;
+        // 前缀表达式构建函数表，空指针表示没有对应的构建函数
+        static const TokenTypeTable<PrefixExpressionBuilder> prefixExpressionBuilders;
+        // 中缀表达式构建函数表
+        static const TokenTypeTable<InfixExpressionBuilder> infixExpressionBuilders;
+        // 后缀表达式构建函数表
+        static const TokenTypeTable<PostfixExpressionBuilder> postfixExpressionBuilders;
+        // 运算符优先级表，非运算符为 Precedence::LOWEST
+        static const TokenTypeTable<Precedence> precedenceTable;
 
         bool isAtEnd();
+        void pushPrevious(std::shared_ptr<Token> token);
+        std::shared_ptr<Token> pullToken();
         void previous();
         const Token &next();
         void consumeNext();
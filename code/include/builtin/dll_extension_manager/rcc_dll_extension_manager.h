@@ -6,6 +6,7 @@
 #define RCC_RCC_DLL_EXTENSION_MANAGER_H
 
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 
@@ -64,6 +65,8 @@ namespace rccdll
     {
         static std::unordered_map<std::string, std::unique_ptr<DLLExtension>> dllExtMap;
         static std::unordered_map<std::string, std::string> dllExtPathAliasMap;
+        // 模块可能在不同线程中并行编译，扩展表的读写需加锁
+        static std::shared_mutex dllExtMutex;
 
     public:
 
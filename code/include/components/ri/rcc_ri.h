@@ -6,6 +6,7 @@
 #define RCC_RI_H
 
 #include "../../lib/rcc_utils.h"
+#include "../../../declarations/components/ri/rcc_ri_dec.h"
 
 namespace ri {
 
@@ -21,6 +22,9 @@ namespace ri {
         }
 
         virtual std::string getOpRI() const = 0;
+
+        // 以结构化记录的形式写入指令流；默认退化为整段文本
+        virtual void emitTo(InstructionBuffer &buffer) const;
     };
 
     class ANNOTATION final : public RI
@@ -31,6 +35,7 @@ namespace ri {
         explicit ANNOTATION(const std::vector<std::string> &comments);
         [[nodiscard]] std::string toRACode() const override;
         std::string getOpRI() const override;
+        void emitTo(InstructionBuffer &buffer) const override;
     };
 
     class BREAKPOINT final : public RI
@@ -39,6 +44,7 @@ namespace ri {
         explicit BREAKPOINT();
         [[nodiscard]] std::string toRACode() const override;
         std::string getOpRI() const override;
+        void emitTo(InstructionBuffer &buffer) const override;
     };
 
     class FLAG: public RI
@@ -49,6 +55,7 @@ namespace ri {
         explicit FLAG(const std::string &opRI, const std::string &comment="");
         [[nodiscard]] std::string toRACode() const override;
         std::string getOpRI() const override;
+        void emitTo(InstructionBuffer &buffer) const override;
     };
 
     class ATMP final : public FLAG
@@ -72,6 +79,7 @@ namespace ri {
 
         [[nodiscard]] std::vector<std::string> getIdents() const;
         std::string getOpRI() const override;
+        void emitTo(InstructionBuffer &buffer) const override;
     };
 
     class EXE_RASM final : public PARALLEL
@@ -99,6 +107,7 @@ namespace ri {
     public:
         explicit ITER_APND(std::vector<std::string> idents, const std::string &target);
         [[nodiscard]] std::string toRACode() const override;
+        void emitTo(InstructionBuffer &buffer) const override;
     };
 
     class FUNC final: public PARALLEL
@@ -150,6 +159,7 @@ namespace ri {
         explicit UNARY(const std::string &opRI, const std::string &ident);
         [[nodiscard]] std::string toRACode() const override;
         std::string getOpRI() const override;
+        void emitTo(InstructionBuffer &buffer) const override;
     };
 
     class EXPOSE final : public UNARY
@@ -199,6 +209,7 @@ namespace ri {
         [[nodiscard]] std::string getRValue() const;
         [[nodiscard]] std::string getLValue() const;
         std::string getOpRI() const override;
+        void emitTo(InstructionBuffer &buffer) const override;
     };
 
     class DETECT : public BINARY
@@ -252,6 +263,7 @@ namespace ri {
     public:
         explicit TP_SET(const std::string &rvalue, const std::string &lvalue);
         [[nodiscard]] std::string toRACode() const override;
+        void emitTo(InstructionBuffer &buffer) const override;
     };
 
     class UNTIL final : public BINARY
@@ -304,6 +316,7 @@ namespace ri {
             const std::string &rvalue2, const std::string &lvalue);
         [[nodiscard]] std::string toRACode() const override;
         std::string getOpRI() const override;
+        void emitTo(InstructionBuffer &buffer) const override;
     };
 
     class ADD final : public TERNARY {
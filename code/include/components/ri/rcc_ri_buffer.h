@@ -0,0 +1,97 @@
+//
+// Created by RestRegular on 2025/7/16.
+//
+
+#ifndef RCC_RI_BUFFER_H
+#define RCC_RI_BUFFER_H
+
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../../../declarations/components/ri/rcc_ri_dec.h"
+
+namespace ri {
+
+    // 指令记录的形态，决定其文本化方式
+    enum class RecordForm : uint8_t {
+        RAW,        // 预先生成的 RA 文本，原样输出
+        ANNOTATION, // "; <注释>"
+        FLAG,       // "<操作码>: ;[ <注释>]"
+        OPERANDS    // "<操作码>: <操作数>, <操作数>, ..."
+    };
+
+    // 驻留的操作数池：相同的操作码、标识符与字面量只保存一份，指令记录中只保存其 ID
+    class OperandPool {
+    public:
+        uint32_t intern(std::string_view text);
+        [[nodiscard]] const std::string &get(uint32_t id) const;
+        [[nodiscard]] size_t size() const;
+
+    private:
+        // deque 扩容时不移动已有元素，索引中的 string_view 始终有效
+        std::deque<std::string> _texts;
+        std::unordered_map<std::string_view, uint32_t> _ids;
+    };
+
+    struct InstructionRecord {
+        RecordForm form;
+        // 操作码 ID；RAW 与 ANNOTATION 记录的文本保存在第一个操作数中
+        uint32_t op;
+        // 操作数 ID 在所属缓冲区操作数序列中的区间
+        uint32_t operandBegin;
+        uint32_t operandCount;
+    };
+
+    // RA 指令流：指令以 (形态, 操作码, 操作数 ID 区间) 的记录顺序保存，直到最后才统一生成文本
+    // 同一编译过程中的缓冲区共享一个操作数池，片段之间的拼接只复制定长记录
+    class InstructionBuffer {
+    public:
+        InstructionBuffer();
+        explicit InstructionBuffer(std::shared_ptr<OperandPool> pool);
+
+        void appendRaw(std::string_view text);
+        void appendAnnotation(std::string_view comment);
+        void appendFlag(std::string_view op, std::string_view comment = "");
+        void appendOperands(std::string_view op, const std::vector<std::string> &operands);
+        void appendOperands(std::string_view op, std::initializer_list<std::string_view> operands);
+        // 追加已驻留在本缓冲区操作数池中的记录，供指令流的改写过程使用
+        void appendInterned(RecordForm form, uint32_t op, const std::vector<uint32_t> &operandIds);
+        InstructionBuffer &operator<<(const RI &ri);
+
+        // 将 begin 之后的记录切分为新的片段，当前缓冲区只保留 begin 之前的部分
+        InstructionBuffer split(size_t begin);
+        // 将另一个片段的全部记录追加到末尾
+        void splice(const InstructionBuffer &other);
+        // 丢弃 count 之后的记录
+        void truncate(size_t count);
+
+        // 将 [begin, end) 区间的记录文本化后追加到 out
+        void render(size_t begin, size_t end, std::string &out) const;
+        [[nodiscard]] std::string render() const;
+
+        [[nodiscard]] size_t size() const;
+        [[nodiscard]] bool empty() const;
+        [[nodiscard]] const InstructionRecord &at(size_t index) const;
+        [[nodiscard]] const std::string &getOp(const InstructionRecord &record) const;
+        [[nodiscard]] const std::string &getOperand(const InstructionRecord &record, size_t index) const;
+        [[nodiscard]] uint32_t getOperandId(const InstructionRecord &record, size_t index) const;
+        [[nodiscard]] const std::shared_ptr<OperandPool> &getPool() const;
+
+    private:
+        std::shared_ptr<OperandPool> _pool;
+        std::vector<InstructionRecord> _records;
+        std::vector<uint32_t> _operands;
+
+        void appendRecord(RecordForm form, uint32_t op);
+        [[nodiscard]] size_t renderedSize(size_t begin, size_t end) const;
+    };
+
+}
+
+#endif //RCC_RI_BUFFER_H
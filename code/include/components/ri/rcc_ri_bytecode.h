@@ -0,0 +1,38 @@
+//
+// Created by RestRegular on 2025/7/16.
+//
+
+#ifndef RCC_RI_BYTECODE_H
+#define RCC_RI_BYTECODE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ri {
+
+    // RAB（RA Binary）：RA 文本的紧凑二进制编码，运行时加载时无需再对指令做词法切分
+    //
+    // 文件布局（整数均为无符号 LEB128 变长编码）：
+    //   "RAB\0" 版本号(1 字节) 段数
+    //   段：段 ID(1 字节) 段长度 段内容，加载器可按长度跳过不认识的段
+    //     STRINGS    字符串数 { 长度 字节 }，按引用次数降序排列，常用的操作数索引只占一个字节
+    //     SYMBOLS    符号数 { 字符串索引 }，ALLOT / FUNC / FUNI / TP_DEF 声明的标识符
+    //     SOURCE_MAP 条目数 { 记录序号增量 文件索引 行 列 后缀索引 }，对应 "; <文件>:<行>:<列>, <后缀>" 形式的位置注释
+    //     CODE       记录数 { 记录 }
+    //   记录：每条 RI 指令以一个操作码字节开头，随后是操作数个数与各操作数的字符串索引；
+    //   FLAG 形式（"<操作码>: ;[ <注释>]"）的操作码字节置最高位；无法按指令解析的行以 RAW 记录原样保存
+    //
+    // 解码得到的文本与编码前的 RA 文本逐字节一致
+    inline constexpr uint8_t RAB_VERSION = 1;
+
+    [[nodiscard]] bool isRabBytecode(std::string_view data);
+
+    [[nodiscard]] std::string encodeRabBytecode(std::string_view raCode);
+
+    // 数据损坏、截断或版本不受支持时抛出 std::runtime_error
+    [[nodiscard]] std::string decodeRabBytecode(std::string_view bytecode);
+
+}
+
+#endif //RCC_RI_BYTECODE_H
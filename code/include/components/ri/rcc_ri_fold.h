@@ -0,0 +1,46 @@
+//
+// Created by RestRegular on 2025/7/16.
+//
+
+#ifndef RCC_RI_FOLD_H
+#define RCC_RI_FOLD_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace ri {
+
+    // 可在编译期求值的 RA 字面量种类，按运行时看到的文本判断：
+    // 整数为不带前导零的十进制数，浮点数必须带小数点，字符串为双引号包围的转义文本
+    enum class ConstantKind : uint8_t {
+        INT,
+        FLOAT,
+        BOOL,
+        STR
+    };
+
+    [[nodiscard]] std::optional<ConstantKind> getConstantKind(std::string_view text);
+
+    // 以下求值函数的参数与结果都是 RA 字面量文本，规则与运行时的 BINARY 运算一致：
+    // int 与 int 运算得到 int（除法向零取整），任一侧为 float 时提升为 float，str 只支持相加拼接
+    // 整数溢出、除数为零、浮点结果无法以小数文本精确表示等情况返回 std::nullopt，留给运行时处理
+
+    // ADD / MUL / DIV / MOD
+    [[nodiscard]] std::optional<std::string> foldArithmetic(std::string_view op, std::string_view lhs,
+                                                            std::string_view rhs);
+
+    // OPP：数值取相反数，布尔值取反
+    [[nodiscard]] std::optional<std::string> foldOpposite(std::string_view operand);
+
+    // CMP 与其后 CREL 的组合：RE / RNE / RG / RGE / RL / RLE / AND / OR
+    [[nodiscard]] std::optional<std::string> foldRelation(std::string_view relation, std::string_view lhs,
+                                                          std::string_view rhs);
+
+    // 布尔字面量的值，用于消除条件恒定的分支
+    [[nodiscard]] std::optional<bool> getConstantTruth(std::string_view text);
+
+}
+
+#endif //RCC_RI_FOLD_H
@@ -0,0 +1,67 @@
+//
+// Created by RestRegular on 2025/7/16.
+//
+
+#ifndef RCC_RI_OPTIMIZER_H
+#define RCC_RI_OPTIMIZER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "./rcc_ri_buffer.h"
+
+namespace ri {
+
+    // 优化统计：各遍删除的指令条数
+    struct OptimizeStats {
+        size_t inputRecords = 0;
+        size_t outputRecords = 0;
+        size_t unreachable = 0;     // RET / EXIT / JMP 之后不可达的指令
+        size_t redundantJumps = 0;  // 跳向紧邻标签的 JMP 与无人引用的标签
+        size_t forwarded = 0;       // 临时变量转发：结果直接写入 PUT 的目标
+        size_t folded = 0;          // 常量折叠：在编译期求值的运算与条件跳转，多为原地改写，不计入 removed
+        size_t propagated = 0;      // 复制传播：以字面量或函数名替换只赋值一次的临时变量与常量变量
+        size_t deadStores = 0;      // 从未被读取的临时变量及其写入
+        size_t annotations = 0;     // 最小化编译时删除的注释
+        size_t shaken = 0;          // 从程序入口不可达的函数、类与成员注册
+        size_t inlined = 0;         // 就地展开的小函数调用，展开会增加指令，不计入 removed
+        size_t reusedSlots = 0;     // 复用已释放槽位的临时变量
+        size_t releasedSlots = 0;   // 以 DELETE 释放的临时变量槽位
+
+        [[nodiscard]] size_t removed() const;
+        OptimizeStats &operator+=(const OptimizeStats &other);
+        [[nodiscard]] std::string toString() const;
+    };
+
+    // RA 窥孔与数据流优化：在结构化指令流上工作，只改写编译器生成的临时变量
+    // RAW 记录（内置函数与导入模块生成的 RA 文本）中出现的标识符一律视为外部引用，不做改写
+    // 最后按活跃区间为临时变量分配可复用的槽位，槽位失效时以 DELETE 释放
+    class RaOptimizer {
+    public:
+        // compileLevel < 2 时只执行 treeShake 指定的裁剪；compileLevel >= 3 时额外删除文件头之后的注释
+        // treeShake 只应对程序入口的完整指令流开启：单独编译的导入模块中，成员的使用者尚不可见
+        // compileLevel >= 2 且 inlineThreshold > 0 时，函数体不超过 inlineThreshold 条指令的小函数的直接调用被就地展开
+        // （编译级别 2 只展开不会使指令总数增加的函数），展开后不再被引用的函数定义随即删除；
+        // externalNames 中的函数（模块导出的成员）不展开。newName 为展开出的参数与局部变量生成全局唯一的新名称
+        // externalNames 为指令流之外仍会引用的名称（如导入模块在优化之后才登记为成员的全局变量与函数），按 RAW 中的标识符对待
+        RaOptimizer(int compileLevel, const std::unordered_set<std::string> &tempVars, bool treeShake = false,
+                    size_t inlineThreshold = 0, std::function<std::string()> newName = {},
+                    std::unordered_set<std::string> externalNames = {});
+
+        OptimizeStats run(InstructionBuffer &buffer) const;
+
+    private:
+        int compileLevel;
+        bool treeShake;
+        const std::unordered_set<std::string> &tempVars;
+        size_t inlineThreshold;
+        std::function<std::string()> newName;
+        std::unordered_set<std::string> externalNames;
+    };
+
+}
+
+#endif //RCC_RI_OPTIMIZER_H
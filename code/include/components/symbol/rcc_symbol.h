@@ -5,7 +5,11 @@
 #ifndef RCC_SYMBOL_H
 #define RCC_SYMBOL_H
 
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 #include <ranges>
 #include <optional>
@@ -79,6 +83,9 @@ namespace symbol {
         LabelType labelType;
         std::vector<LabelDes> labelDesS{};
         mutable std::vector<LabelDesI> m_labelDesIS;
+    protected:
+        // 类型标签的类型编号，由类型名在构造时确定；copySelf 得到的副本同样携带
+        BuiltinTypeLabel typeId;
     public:
         LabelSymbol(
             const utils::Pos &pos,
@@ -122,10 +129,8 @@ namespace symbol {
     class TypeLabelSymbol final:
     public LabelSymbol,
     public IRCCTypeLabelSymbolInterface {
-        static std::unordered_set<std::string> builtInTypes;
+        static std::unordered_map<std::string, BuiltinTypeLabel> builtInTypes;
         static std::unordered_map<std::string, std::string> builtInTypeRaCodeMap;
-        static std::unordered_map<std::string, std::string> customTypeMap;
-        static std::unordered_map<std::string, std::shared_ptr<ClassSymbol>> customClassSymbolMap;
     public:
         TypeLabelSymbol(const utils::Pos &pos, const std::string &name,
             const size_t &scopeLevel, const std::string &uid = "");
@@ -133,6 +138,8 @@ namespace symbol {
         static std::string getTypeLabelRaCode(const std::string &name, const std::string &raValue);
         [[nodiscard]] static bool isTypeLabel(const std::string &name);
         [[nodiscard]] static bool isBuiltInType(const std::string &name);
+        // 非内置类型名返回 BuiltinTypeLabel::CUSTOM
+        [[nodiscard]] static BuiltinTypeLabel getBuiltinTypeId(const std::string &name);
         [[nodiscard]] static bool isCustomType(const std::string &uid);
         static void createCustomType(const std::string &name, const std::string &uid, const std::shared_ptr<ClassSymbol> &classSymbol);
         static void createCustomType(const std::shared_ptr<ClassSymbol> &classSymbol);
@@ -144,6 +151,10 @@ namespace symbol {
         bool Is(const char* name) const override;
         [[nodiscard]] bool isNot(const std::string &name) const;
         bool IsNot(const char* name) const override;
+        [[nodiscard]] BuiltinTypeLabel getTypeId() const;
+        [[nodiscard]] bool is(const BuiltinTypeLabel &type) const;
+        [[nodiscard]] bool isNot(const BuiltinTypeLabel &type) const;
+        [[nodiscard]] bool isOneOf(const TypeLabelSet &types) const;
         [[nodiscard]] bool isCustomType() const;
         bool IsCustomType() const override;
         std::string toDetailString() const override;
@@ -169,6 +180,12 @@ namespace symbol {
         const LabelDesI* GetLabelDesIS() const override;
         bool IsBuiltin() const override;
         const TypeLabelSymbol* TransformToTLSI() const override;
+        // 内置类型的规范实例：位置未知、作用域层级为 0，全局共享且不可修改
+        // func、funi 与 series 会追加标签描述（签名、元素类型），调用方不得取用其规范实例后再修改
+        [[nodiscard]] static const std::shared_ptr<TypeLabelSymbol> &builtinTypeSymbol(const BuiltinTypeLabel &type);
+        // 位置未知时返回规范实例，否则创建新实例；类型标签的位置会出现在诊断信息与符号输出中，不能丢弃
+        [[nodiscard]] static std::shared_ptr<TypeLabelSymbol> builtinTypeSymbol(const BuiltinTypeLabel &type,
+            const utils::Pos &pos, const size_t &scopeLevel);
         [[nodiscard]] static std::shared_ptr<TypeLabelSymbol> intTypeSymbol(const utils::Pos &pos, const size_t &scopeLevel);
         [[nodiscard]] static std::shared_ptr<TypeLabelSymbol> floatTypeSymbol(const utils::Pos &pos, const size_t &scopeLevel);
         [[nodiscard]] static std::shared_ptr<TypeLabelSymbol> strTypeSymbol(const utils::Pos &pos, const size_t &scopeLevel);
@@ -200,6 +217,9 @@ namespace symbol {
         std::string resultDisplay;
     public:
         LabelMarkManager() = default;
+        // 直接以各类标记构造，模块缓存还原符号时使用
+        LabelMarkManager(int permissionLabelMark, int objectOrientedLabelMarks, int lifeCycleLabelMarks,
+                         int restrictionLabelMarks, std::unordered_set<std::string> typeLabelMarks);
         void markLabels(const std::unordered_set<std::shared_ptr<LabelSymbol>> &labels);
         void markLabel(const std::shared_ptr<LabelSymbol> &label, const bool& refresh = false);
 
@@ -224,6 +244,10 @@ namespace symbol {
         void displayResult();
         std::optional<PermissionLabel> getPermissionLabelMark() const;
         std::unordered_set<std::string> getTypeLabelMarks() const;
+        // 以标签枚举值为位序的标记位
+        int getObjectOrientedLabelMarks() const;
+        int getLifeCycleLabelMarks() const;
+        int getRestrictionLabelMarks() const;
     private:
         void markPermissionLabel(const PermissionLabel &permissionLabel);
         void markObjectOrientedLabel(const ObjectOrientedLabel &objectOrientedLabel);
@@ -457,6 +481,39 @@ namespace symbol {
         void FreeParamSymbols(ParamSymbols& paramSymbols) override;
 };
 
+    // 符号表的查找键：名称的哈希值只计算一次，逐层查找各作用域时复用
+    class SymbolKey {
+        std::string_view name;
+        size_t hash;
+    public:
+        explicit SymbolKey(const std::string_view name)
+            : name(name), hash(std::hash<std::string_view>{}(name)) {}
+        [[nodiscard]] std::string_view getName() const { return name; }
+        [[nodiscard]] size_t getHash() const { return hash; }
+        friend bool operator==(const SymbolKey &lhs, const std::string_view rhs) { return lhs.name == rhs; }
+    };
+
+    // 与 std::hash<std::string> 结果一致，符号表的遍历顺序不受影响
+    struct SymbolKeyHash {
+        using is_transparent = void;
+        size_t operator()(const std::string_view name) const { return std::hash<std::string_view>{}(name); }
+        size_t operator()(const SymbolKey &key) const { return key.getHash(); }
+    };
+
+    using SymbolMap = std::unordered_map<std::string, std::pair<int, std::shared_ptr<Symbol>>,
+        SymbolKeyHash, std::equal_to<>>;
+
+    // 符号名称的原子：进程内每个不同的名称（符号名或 RA 标识）对应唯一的 32 位编号，各编译线程共享
+    using SymbolAtom = uint32_t;
+
+    class SymbolAtomTable {
+    public:
+        // 返回名称的原子，名称首次出现时分配新的原子
+        static SymbolAtom intern(std::string_view name);
+        // 名称从未登记过时返回 std::nullopt，此时任何作用域中都没有该名称的符号
+        static std::optional<SymbolAtom> find(std::string_view name);
+    };
+
     class ClassSymbol final :
     public Symbol,
     public IRCCClassSymbolInterface
@@ -483,7 +540,7 @@ namespace symbol {
         }
 
         // 用于处理符号表（map-like结构）
-        static std::vector<rjson::RJValue> transformSymbolTableToRJValues(const std::unordered_map<std::string, std::pair<int, std::shared_ptr<Symbol>>>& table)
+        static std::vector<rjson::RJValue> transformSymbolTableToRJValues(const SymbolMap& table)
         {
             std::vector<rjson::RJValue> values;
             values.reserve(table.size());
@@ -592,7 +649,7 @@ namespace symbol {
     class SymbolTable final:
     public utils::Object,
     public IRCCSymbolTableInterface {
-        std::unordered_map<std::string, std::pair<int, std::shared_ptr<Symbol>>> table{};
+        SymbolMap table{};
         std::vector<std::string> nameIndex{};
         std::unordered_set<std::string> sysDefinitionRecord{};
     public:
@@ -602,15 +659,17 @@ namespace symbol {
         void InsertByName(IRCCSymbolInterface* symbolI) override;
         std::shared_ptr<Symbol> insertByRID(const std::shared_ptr<Symbol>& symbol, const bool& sysDefined);
         std::shared_ptr<Symbol> find(const std::string &name) const;
+        std::shared_ptr<Symbol> find(const SymbolKey &key) const;
         IRCCSymbolInterface* Find(const char* name) override;
         [[nodiscard]] bool contains(const std::string &name) const;
+        [[nodiscard]] bool contains(const SymbolKey &key) const;
         bool Contains(const char* name) override;
-        [[nodiscard]] std::unordered_map<std::string, std::pair<int, std::shared_ptr<Symbol>>> getTable() const;
-        [[nodiscard]] std::vector<std::string> getNameIndex() const;
+        [[nodiscard]] const SymbolMap &getTable() const;
+        [[nodiscard]] const std::vector<std::string> &getNameIndex() const;
         void remove(const std::string &name);
         void Remove(const char* name) override;
         [[nodiscard]] std::shared_ptr<Object> copySelf() const override;
-        std::unordered_set<std::string> getSysDefinedRecord() const;
+        const std::unordered_set<std::string> &getSysDefinedRecord() const;
 
         // 支持管道操作符 |，用于范围适配
         template <std::ranges::viewable_range R>
@@ -627,7 +686,7 @@ namespace symbol {
 
         // 非常量迭代器
         class Iterator {
-            using MapIterator = std::unordered_map<std::string, std::pair<int, std::shared_ptr<Symbol>>>::iterator;
+            using MapIterator = SymbolMap::iterator;
             MapIterator mapIter;
         public:
             explicit Iterator(MapIterator it): mapIter(it) {}
@@ -645,7 +704,7 @@ namespace symbol {
 
         // 常量迭代器
         class ConstIterator {
-            using MapConstIterator = std::unordered_map<std::string, std::pair<int, std::shared_ptr<Symbol>>>::const_iterator;
+            using MapConstIterator = SymbolMap::const_iterator;
             MapConstIterator mapIter;
         public:
             explicit ConstIterator(MapConstIterator it): mapIter(it) {}
@@ -687,14 +746,66 @@ namespace symbol {
         }
     };
 
+    // 各作用域的符号表（scopes）保存声明本身，供遍历当前作用域等场合使用；查找则经由扁平的原子索引：
+    // 每个原子对应一条按作用域层级升序排列的遮蔽链，链尾是最内层的声明，当前作用域为最内层时查找为 O(1)，与嵌套深度无关
+    // 每个作用域记录自己声明的原子，退出作用域时按此撤销，代价与该作用域的声明数成正比
+    // 作用域中的符号须经由本类增删（insert、removeByName、restoreCurrentScope 等），直接修改作用域符号表不会更新索引
     class SymbolTableManager final:
     public utils::Object,
     public IRCCSymbolTableManagerInterface {
+        struct ScopedBinding {
+            size_t level;
+            std::shared_ptr<Symbol> symbol;
+        };
+        using BindingChains = std::unordered_map<SymbolAtom, std::vector<ScopedBinding>>;
+        struct ScopeDeclarations {
+            std::vector<SymbolAtom> names;
+            std::vector<SymbolAtom> rids;
+        };
+
         std::vector<std::pair<std::shared_ptr<SymbolTable>,
             std::shared_ptr<SymbolTable>>> scopes; // first: val -> Symbol, second: raVal -> Symbol
         size_t currentScopeLevel_; // 0 为全局作用域
+        // insert 等接口为 const（作用域符号表经由指针修改），索引随之声明为 mutable
+        mutable BindingChains nameBindings;
+        mutable BindingChains ridBindings;
+        mutable std::vector<ScopeDeclarations> declarations;
 
         void appendScope(const std::shared_ptr<SymbolTable> &nameScope, const std::shared_ptr<SymbolTable> &idScope);
+        void bind(BindingChains &chains, std::vector<SymbolAtom> &declared, const std::string &key,
+                  size_t level, const std::shared_ptr<Symbol> &symbol) const;
+        void unbind(BindingChains &chains, std::vector<SymbolAtom> &declared, const std::string &key, size_t level) const;
+        void unbindScope(size_t level) const;
+        void bindScope(size_t level) const;
+        // 将 from 及以上各层作用域的声明层级加上 delta，用于在中间插入或删除作用域
+        void shiftLevels(size_t from, int delta) const;
+        [[nodiscard]] static const std::vector<ScopedBinding> *findChain(const BindingChains &chains, std::string_view key);
+        // 从 startLevel 向外查找第一个满足 accept 的声明；skipGlobal 为真时不查找全局作用域
+        template <typename Accept>
+        [[nodiscard]] static std::pair<long long int, std::shared_ptr<Symbol>> lookup(
+            const BindingChains &chains, const std::string_view key, const size_t startLevel, const bool skipGlobal,
+            Accept accept)
+        {
+            if (const auto &chain = findChain(chains, key))
+            {
+                for (auto it = chain->rbegin(); it != chain->rend(); ++it)
+                {
+                    if (it->level > startLevel)
+                    {
+                        continue;
+                    }
+                    if (skipGlobal && it->level == 0)
+                    {
+                        break;
+                    }
+                    if (accept(*it->symbol))
+                    {
+                        return {static_cast<long long int>(it->level), it->symbol};
+                    }
+                }
+            }
+            return {-1, nullptr};
+        }
     public:
         SymbolTableManager();
         ~SymbolTableManager() override;
@@ -717,6 +828,8 @@ namespace symbol {
         [[nodiscard]] std::shared_ptr<Symbol> findInCurrentScope(const std::string &name) const;
         [[nodiscard]] bool containsName(const std::string &name) const;
         [[nodiscard]] bool currentScopeContains(const std::string &name) const;
+        // 以 nameScope、ridScope 的副本替换当前作用域的全部声明
+        void restoreCurrentScope(const SymbolTable &nameScope, const SymbolTable &ridScope);
         [[nodiscard]] size_t curScopeLevel() const;
         [[nodiscard]] std::shared_ptr<Object> copySelf() const override;
         void EnterScope(const size_t& scopeLevel) override;
@@ -738,29 +851,17 @@ namespace symbol {
         template <typename ST>
         [[nodiscard]] std::pair<long long int, std::shared_ptr<ST>> findByNameAndTransform(const std::string &name, const SymbolType &type) const
         {
-            for (size_t i = currentScopeLevel_; i > 0; --i) {
-                const auto &scope = scopes[i].first;
-                if (const auto &it = scope->find(name)) {
-                    if (it->getType() == type) {
-                        return {i, std::static_pointer_cast<ST>(it)};
-                    }
-                }
-            }
-            return {-1, nullptr};
+            const auto &[level, symbol] = lookup(nameBindings, name, currentScopeLevel_, true,
+                [&type](const Symbol &it) { return it.getType() == type; });
+            return {level, std::static_pointer_cast<ST>(symbol)};
         }
 
         template <typename ST>
         [[nodiscard]] std::pair<long long int, std::shared_ptr<ST>> findByRIDAndTransform(const std::string &rid, const SymbolType &type) const
         {
-            for (size_t i = currentScopeLevel_; i > 0; --i) {
-                const auto &scope = scopes[i].second;
-                if (const auto &it = scope->find(rid)) {
-                    if (it->getType() == type) {
-                        return {i, std::static_pointer_cast<ST>(it)};
-                    }
-                }
-            }
-            return {-1, nullptr};
+            const auto &[level, symbol] = lookup(ridBindings, rid, currentScopeLevel_, true,
+                [&type](const Symbol &it) { return it.getType() == type; });
+            return {level, std::static_pointer_cast<ST>(symbol)};
         }
     };
 
@@ -790,9 +891,35 @@ namespace symbol {
         LIST,
         DICT,
         SERIES,
-        FLAG
+        FLAG,
+        FUNI,
+        VAR_ARGS,
+        KW_VAR_ARGS,
+        CUSTOM // 非内置类型（自定义类类型等）
     };
 
+    // 内置类型的位集合，如 BuiltinTypeLabel::INT | BuiltinTypeLabel::FLOAT
+    class TypeLabelSet {
+        uint32_t bits = 0;
+        constexpr explicit TypeLabelSet(const uint32_t bits): bits(bits) {}
+    public:
+        constexpr TypeLabelSet() = default;
+        constexpr TypeLabelSet(const BuiltinTypeLabel &type): bits(1u << static_cast<uint32_t>(type)) {}
+        [[nodiscard]] constexpr bool contains(const BuiltinTypeLabel &type) const
+        {
+            return (bits & TypeLabelSet(type).bits) != 0;
+        }
+        constexpr TypeLabelSet operator|(const TypeLabelSet &other) const
+        {
+            return TypeLabelSet(bits | other.bits);
+        }
+    };
+
+    constexpr TypeLabelSet operator|(const BuiltinTypeLabel &lhs, const BuiltinTypeLabel &rhs)
+    {
+        return TypeLabelSet(lhs) | rhs;
+    }
+
     enum class RestrictionLabel: int {
         CONST_RL = 0,   // 对应 "const"
         QUOTE,       // 对应 "quote"
@@ -5,6 +5,7 @@
 #ifndef RCC_RA_UTILS_H
 #define RCC_RA_UTILS_H
 
+#include <atomic>
 #include <functional>
 #include <map>
 #include <vector>
@@ -12,6 +13,9 @@
 #include <sstream>
 #include <list>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 #include "../interfaces/rcc_object_interface.h"
 #include "../interfaces/rcc_pos_interface.h"
@@ -22,7 +26,7 @@ namespace utils {
     class Object:
     virtual public IRCCObjectInterface
     {
-        static size_t _id;
+        static std::atomic<size_t> _id;
         size_t id;
         std::string _hasCode;
         std::string _uniqueId;
@@ -79,7 +83,8 @@ namespace utils {
     enum class OutputFormat
     {
         TXT,
-        JSON
+        JSON,
+        RAB     // RA 二进制字节码，仅用于编译输出
     };
 
     enum class TimeFormat {
@@ -156,6 +161,8 @@ namespace utils {
     std::string getFileDirFromPath(const std::string &path);
     std::string getRCCDir();
     std::string getDefaultDir();
+    // 编译缓存根目录：优先 $XDG_CACHE_HOME/rcc，其次用户目录下的缓存目录，都不可用时退回 RCC 目录下的 .cache
+    std::string getCacheDir();
     std::string getAbsolutePath(const std::string& relPath, const std::string &dir_path = "");
     bool isValidPath(const std::string &path);
     bool isAbsolutePath(const std::string &path);
@@ -172,7 +179,7 @@ namespace utils {
     bool stringToBool(const std::string& str);
     Number stringToNumber(const std::string& str);
     ArgType getArgType(const std::string& str);
-    bool isValidNumber(const std::string &content);
+    bool isValidNumber(std::string_view content);
     bool isValidIdentifier(const std::string &content);
     bool isValidKeyWord(const std::string &content);
     bool isValidParameter(const std::string &content);
@@ -184,6 +191,12 @@ namespace utils {
     // === 序列化/反序列化 ===
     void serializeArgType(std::ostream &os, const ArgType &argType);
     ArgType deserializeArgType(std::istream &is);
+    // 二进制缓存格式共用的编码：无符号 LEB128 变长整数与带长度前缀的字节串
+    void appendVarint(std::string &out, uint64_t value);
+    void appendBytes(std::string &out, std::string_view bytes);
+    // 数据截断或变长整数超过 64 位时返回 false，不抛出异常，由调用者决定如何报告
+    bool readVarint(std::string_view data, size_t &pos, uint64_t &value);
+    bool readBytes(std::string_view data, size_t &pos, std::string_view &bytes);
     std::tuple<char, char, char, char, char> getSeparators(TimeFormat format);
     bool parseDateFromString(const std::string &dateString, TimeFormat format,
                              int &year, int &month, int &day, int &hour, int &minute, int &second);
@@ -195,21 +208,87 @@ namespace utils {
     bool appendFile(const std::string &path, const std::string &content);
     std::string getLineFromFile(const std::string& filePath, size_t lineNum);
 
+    // 只读内存映射文件：整个文件只映射一次，内容以 string_view 形式暴露，不做任何拷贝
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string &path);
+        ~MappedFile();
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+        [[nodiscard]] std::string_view view() const;
+        [[nodiscard]] size_t size() const;
+        [[nodiscard]] const std::string &getPath() const;
+    private:
+        std::string _path;
+        const char *_data = nullptr;
+        size_t _size = 0;
+#ifdef _WIN32
+        void *_fileHandle = nullptr;
+        void *_mappingHandle = nullptr;
+#endif
+    };
+
     // === 位置信息 ===
+    // 紧凑源码位置：32 位文件 ID + 字节偏移 + 长度，行列号按需通过文件行表计算
+    struct SourceLoc {
+        static constexpr uint32_t NO_OFFSET = UINT32_MAX;
+        uint32_t fileId = 0;
+        uint32_t offset = NO_OFFSET;
+        uint32_t length = 0;
+        [[nodiscard]] bool hasOffset() const { return offset != NO_OFFSET; }
+    };
+
+    // 全局源文件表：将文件路径驻留为 32 位 ID，并保存每个文件的行起始偏移
+    // 锚点是挂在某个文件下的派生 ID，位置偏移相对于锚点基址；增量分析通过平移锚点基址更新复用 Token 的位置
+    class SourceFileTable {
+    public:
+        static constexpr uint32_t NO_PARENT = UINT32_MAX;
+        static SourceFileTable &getInstance();
+        uint32_t intern(const std::string &filepath);
+        // 锚点不再被任何 Token 引用时应释放，其表项由之后新建的锚点复用
+        uint32_t anchor(uint32_t fileId, uint32_t base);
+        void shiftAnchors(const std::vector<uint32_t> &anchorIds, int64_t delta);
+        void releaseAnchors(const std::vector<uint32_t> &anchorIds);
+        // 将相对于锚点的位置换算为所属文件内的绝对位置
+        [[nodiscard]] SourceLoc resolveLoc(const SourceLoc &loc) const;
+        [[nodiscard]] const std::string &getFilepath(uint32_t fileId) const;
+        void setLineOffsets(uint32_t fileId, std::vector<uint32_t> lineOffsets);
+        [[nodiscard]] std::pair<size_t, size_t> getLineColumn(const SourceLoc &loc) const;
+        [[nodiscard]] uint32_t getOffset(uint32_t fileId, size_t line, size_t column) const;
+    private:
+        SourceFileTable();
+        struct Entry {
+            std::string filepath;
+            std::vector<uint32_t> lineOffsets;
+            uint32_t parent = NO_PARENT;
+            uint32_t base = 0;
+        };
+        // 锚点解析为其所属文件的表项，offset 换算为文件内的绝对偏移
+        [[nodiscard]] const Entry &resolve(uint32_t fileId, uint32_t &offset) const;
+        mutable std::shared_mutex _mutex;
+        std::vector<std::unique_ptr<Entry>> _entries;
+        std::unordered_map<std::string, uint32_t> _ids;
+        std::vector<uint32_t> _freeAnchors;
+    };
+
+    // Pos 是 SourceLoc 的展开视图，用于实现 IRCCPosInterface 及各类位置输出
     class Pos:
     public Object,
     public IRCCPosInterface {
     public:
         Pos() = default;
         ~Pos() override;
-        Pos(size_t line, size_t column, size_t offset, std::string filepath);
+        Pos(size_t line, size_t column, size_t offset, const std::string &filepath);
+        explicit Pos(const SourceLoc &loc);
+        [[nodiscard]] SourceLoc getLoc() const;
+        [[nodiscard]] uint32_t getFileId() const;
         [[nodiscard]] size_t getLine() const;
         size_t GetLine() const override;
         [[nodiscard]] size_t getColumn() const;
         size_t GetColumn() const override;
         [[nodiscard]] size_t getOffset() const;
         size_t GetOffset() const override;
-        [[nodiscard]] std::string getFilepath() const;
+        [[nodiscard]] const std::string &getFilepath() const;
         const char* GetFilepath() const override;
         [[nodiscard]] std::string getFileField() const;
         const char* GetFileField() const override;
@@ -245,7 +324,7 @@ namespace utils {
         size_t line{0};
         size_t column{0};
         size_t offset{0};
-        std::string filepath{};
+        uint32_t fileId{0};
     };
 
     const Pos &getUnknownPos();
@@ -442,6 +521,9 @@ namespace utils {
                     } else if (value == "json" || value == "JSON" || value == "j" || value == "J")
                     {
                         *var = OutputFormat::JSON;
+                    } else if (value == "rab" || value == "RAB" || value == "r" || value == "R")
+                    {
+                        *var = OutputFormat::RAB;
                     } else throw std::invalid_argument("Invalid OutputMode value");
                 }, aliases, description});
             } else {
@@ -491,7 +573,7 @@ namespace utils {
     std::string generateUniqueId(const std::string& str);
 
     // FNV-1a 哈希算法实现
-    uint64_t hashToCode(const std::string& str);
+    uint64_t hashToCode(std::string_view str);
     std::string hashToStr(const std::string& str);
 
     // === System ===
@@ -49,6 +49,8 @@ namespace base
     extern const StringMap RELATION_MAP;
     extern const std::string RCC_BUILTIN_LIB_DIR;
     extern const std::string RCC_LIB_DIR;
+    // 构建标识：构建时由全部源文件的散列生成，同一版本号下区分不同的构建
+    extern const char RCC_BUILD_ID[];
 
     // 类定义
     class RCCError : public std::exception, public utils::Object
@@ -12,26 +12,31 @@
 namespace core {
 
     // 类定义
-    class Token final : utils::Object {
-        utils::Pos pos;
+    // Token 只保存紧凑的 SourceLoc，完整的 Pos 在需要时再展开
+    class Token final {
         std::string value;
+        utils::SourceLoc loc;
         TokenType type;
-        [[nodiscard]] TokenType parseType();
     public:
         Token();
         explicit Token(const utils::Pos &pos, std::string content);
-        explicit Token(utils::Pos pos);
+        explicit Token(const utils::SourceLoc &loc, std::string content);
+        // 类型已由调用方确定（如词法分析器），不再按文本重新分类
+        explicit Token(const utils::Pos &pos, std::string content, TokenType type);
+        explicit Token(const utils::SourceLoc &loc, std::string content, TokenType type);
+        explicit Token(const utils::Pos &pos);
         [[nodiscard]] utils::Pos getPos() const;
+        [[nodiscard]] const utils::SourceLoc &getLoc() const;
         [[nodiscard]] std::string getPosString() const;
         [[nodiscard]] const std::string &getValue() const;
         void setValue(std::string value_);
-        void setPos(utils::Pos pos_);
+        void setPos(const utils::Pos &pos_);
         void setType(TokenType type_);
         [[nodiscard]] TokenType getType() const;
-        [[nodiscard]] std::string toString() const override;
-        [[nodiscard]] std::string briefString() const override;
-        [[nodiscard]] std::string professionalString() const override;
-        [[nodiscard]] std::string formatString(size_t indent, size_t level) const override;
+        [[nodiscard]] std::string toString() const;
+        [[nodiscard]] std::string briefString() const;
+        [[nodiscard]] std::string professionalString() const;
+        [[nodiscard]] std::string formatString(size_t indent, size_t level) const;
         void acceptRJsonBuilder(rjson::rj::RJsonBuilder& builder) const;
         [[nodiscard]] rjson::RJValue toRJson() const;
         [[nodiscard]] rjson::RJPair toRJPair() const;
@@ -149,6 +154,12 @@ namespace core {
         TOKEN_FINALLY,
         TOKEN_THROW,
     };
+    // Token 类型数量，用于以 TokenType 为下标的稠密表；须与最后一个枚举值保持同步
+    inline constexpr size_t TOKEN_TYPE_COUNT = static_cast<size_t>(TokenType::TOKEN_THROW) + 1;
+    constexpr size_t tokenIndex(const TokenType type)
+    {
+        return static_cast<size_t>(type);
+    }
     enum class StatementType {
         VAR_DEF, // Complete
         ASSIGNMENT, // Complete
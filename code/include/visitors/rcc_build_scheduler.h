@@ -0,0 +1,62 @@
+//
+// Created by RestRegular on 2025/7/20.
+//
+
+#ifndef RCC_BUILD_SCHEDULER_H
+#define RCC_BUILD_SCHEDULER_H
+
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "./rcc_compilation_session.h"
+
+namespace ast
+{
+    // 编译完成的模块：在独立的模块会话中编译，发布后只读，可被不同线程中的导入方同时使用
+    struct CompiledModule
+    {
+        std::string filepath;
+        std::shared_ptr<CompilationSession> session;
+        std::shared_ptr<CompileVisitor> visitor; // 导出的成员符号属于模块的符号表，随模块一同保留
+        std::shared_ptr<symbol::ClassSymbol> extension; // 模块导出的扩展类
+        std::string raCode; // 模块代码及扩展类的定义，由根会话在首次导入处并入输出
+        std::vector<std::string> dependencies; // 模块直接导入的模块，按首次导入的顺序排列
+        std::string cacheKey; // 模块缓存的键，模块不参与缓存时为空
+        // 模块拥有的符号与符号表对象，依赖该模块的缓存项以其中的序号引用它们；visitor 为空表示模块取自缓存
+        std::vector<std::shared_ptr<utils::Object>> symbolIndex;
+    };
+
+    // 模块注册表：同一次编译的全部会话共享，按模块绝对路径记录已发布的模块
+    class ModuleRegistry
+    {
+    public:
+        // 同一模块已发布时保留先发布的结果并将其返回
+        // 模块的编译结果只取决于输入，先后发布的两份结果生成的代码相同
+        std::shared_ptr<const CompiledModule> publish(const std::shared_ptr<const CompiledModule>& module);
+
+        [[nodiscard]] std::shared_ptr<const CompiledModule> find(const std::string& filepath) const;
+
+        void clear();
+
+    private:
+        mutable std::shared_mutex _mutex;
+        std::unordered_map<std::string, std::shared_ptr<const CompiledModule>> _modules;
+    };
+
+    // 构建调度器：入口文件语义分析之前，按导入图预解析得到的依赖关系从叶子模块开始，
+    // 在线程池上并行编译入口的全部依赖并发布到模块注册表，一个模块在其依赖全部发布后才开始编译
+    // 调度只是预编译：解析或编译失败、处于循环导入中及未被预解析到的模块不会发布，
+    // 编译到导入处时再串行编译，错误信息与输出顺序与串行编译一致
+    class BuildScheduler
+    {
+    public:
+        // threadCount 为 0 时按硬件并发数决定
+        // 编译错误（RCCError）之外的异常会停止调度，待工作线程全部结束后在调用线程重新抛出
+        static void build(CompilationSession& session, const std::string& entryPath, size_t threadCount = 0);
+    };
+}
+
+#endif //RCC_BUILD_SCHEDULER_H
@@ -0,0 +1,39 @@
+//
+// Created by RestRegular on 2025/7/20.
+//
+
+#ifndef RCC_BUILTIN_SNAPSHOT_H
+#define RCC_BUILTIN_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ast
+{
+    // 嵌入的快照数据，由构建时生成的源文件定义；未嵌入快照时长度为 0
+    extern const char BUILTIN_SNAPSHOT_DATA[];
+    extern const size_t BUILTIN_SNAPSHOT_SIZE;
+
+    // 内置扩展快照：构建时由不含快照的 RCC 以全部编译级别预编译 Lib/builtin 下的扩展，
+    // 将得到的模块缓存项按缓存键排序后嵌入可执行文件；导入内置扩展时按缓存键直接还原，不再编译
+    // 缓存键包含扩展相对库目录的路径与源码哈希：可执行文件连同 Lib 目录移动后快照仍然有效，内置扩展被修改后快照自然失效，按原流程编译
+    class BuiltinSnapshot
+    {
+    public:
+        static constexpr char MAGIC[4] = {'R', 'S', 'N', 'P'};
+        static constexpr uint32_t FORMAT_VERSION = 1;
+
+        // 返回缓存键对应的缓存项；快照为空、无效或不含该键时返回空视图
+        [[nodiscard]] static std::string_view find(const std::string& cacheKey);
+
+        // 预编译 libDir 下的全部扩展并返回快照数据；无法编译或无法缓存的扩展不写入快照
+        [[nodiscard]] static std::string build(const std::string& libDir);
+
+        // 将快照数据写为定义 BUILTIN_SNAPSHOT_DATA 与 BUILTIN_SNAPSHOT_SIZE 的 C++ 源文件
+        [[nodiscard]] static std::string toSource(std::string_view snapshot);
+    };
+}
+
+#endif //RCC_BUILTIN_SNAPSHOT_H
@@ -0,0 +1,122 @@
+//
+// Created by RestRegular on 2025/7/20.
+//
+
+#ifndef RCC_COMPILATION_SESSION_H
+#define RCC_COMPILATION_SESSION_H
+
+#include <list>
+#include <memory>
+#include <stack>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../analyzer/rcc_module_graph.h"
+#include "../components/ri/rcc_ri_optimizer.h"
+#include "../lib/rcc_utils.h"
+#include "../../declarations/analyzer/rcc_ast_dec.h"
+#include "../../declarations/components/symbol/rcc_symbol_dec.h"
+
+namespace ast
+{
+    // 编译会话：一个模块编译过程中的可变状态
+    // 入口文件使用根会话，导入的每个模块在由根会话派生的模块会话中独立编译，可以在不同线程中同时进行；
+    // 各种 ID 计数器在每个会话中都从零开始，模块会话生成的标识符带有由模块键（见 getModuleKey）决定的前缀，
+    // 因此标识符只取决于输入，与编译顺序、线程数和 RCC 的安装位置无关
+    class CompilationSession
+    {
+    public:
+        // 在当前线程上激活会话，析构时恢复之前激活的会话
+        // 错误定位、内置函数等只能通过静态接口取得编译状态的地方，经由当前线程激活的会话访问
+        class Activation
+        {
+            CompilationSession* previous;
+
+        public:
+            explicit Activation(CompilationSession& session);
+            ~Activation();
+            Activation(const Activation&) = delete;
+            Activation& operator=(const Activation&) = delete;
+        };
+
+        CompilationSession();
+        CompilationSession(const CompilationSession&) = delete;
+        CompilationSession& operator=(const CompilationSession&) = delete;
+
+        // 派生编译 modulePath 的模块会话：共享预解析结果与模块注册表，
+        // 并继承本会话当前的导入链，用于检测循环导入及在错误信息中显示扩展名
+        [[nodiscard]] std::shared_ptr<CompilationSession> createModuleSession(const std::string& modulePath) const;
+
+        // 当前线程激活的会话，没有时抛出 std::runtime_error
+        [[nodiscard]] static CompilationSession& current();
+        [[nodiscard]] static bool hasCurrent();
+
+        // 模块的稳定键：RCC 库目录下的模块取相对库目录的路径，与安装位置无关；其余模块取规范化的绝对路径
+        [[nodiscard]] static std::string getModuleKey(const std::string& modulePath);
+
+        [[nodiscard]] bool isModuleSession() const;
+        // 本会话生成的标识符前缀，根会话为空
+        [[nodiscard]] const std::string& getNamePrefix() const;
+        // 根会话输出前整理并入的模块代码中的标识符：去掉前缀后不与其他标识符冲突的直接去掉前缀，
+        // 其余的换成按模块首次出现的顺序编号的短前缀 "m<n>_"。改名是单射，不改变程序的含义
+        [[nodiscard]] std::string shortenModuleNames(std::string_view raCode) const;
+
+        // ID 计数器
+        size_t nextVarId(); // VarID 序号
+        size_t nextSetId(); // SetID 序号
+        size_t nextNameId(); // VarID 与 SetID 共用的名称序号，生成标识符中的 "id<n>" 部分
+        size_t nextTempVarId(); // 临时变量 "tv<n>"，从 1 开始
+        size_t nextSetLabelId(); // 集合标签 "sl<n>"，从 1 开始
+
+        // 词法分析器栈：栈顶为正在编译的模块，路径列表用于检测循环导入
+        [[nodiscard]] std::stack<std::shared_ptr<lexer::Lexer>>& getLexers();
+        [[nodiscard]] std::list<std::string>& getLexerPaths();
+        [[nodiscard]] std::stack<utils::Pos>& getProcessingPosStack();
+        // 最近一次输出错误所在的文件，用于在文件切换时输出分隔信息
+        [[nodiscard]] std::string& getErrorFileRecord();
+
+        // 扩展模块
+        [[nodiscard]] std::unordered_map<std::string, std::string>& getExtensionPathNameMap();
+        [[nodiscard]] std::stack<std::string>& getProcessingExtensionStack();
+        // 本模块直接导入的模块路径，按首次导入的顺序排列
+        [[nodiscard]] std::vector<std::string>& getImportedModules();
+        // 代码已并入本会话输出的模块，仅根会话使用
+        [[nodiscard]] std::unordered_set<std::string>& getLinkedModules();
+        // 同一次编译的全部会话共享的模块注册表
+        [[nodiscard]] ModuleRegistry& getModuleRegistry();
+
+        // 自定义类型：类型 uid 到类型名与类符号的映射
+        [[nodiscard]] std::unordered_map<std::string, std::string>& getCustomTypeMap();
+        [[nodiscard]] std::unordered_map<std::string, std::shared_ptr<symbol::ClassSymbol>>& getCustomClassSymbolMap();
+
+        [[nodiscard]] parser::ModuleGraphParser& getModuleGraph();
+        // 本会话中所有模块的优化统计
+        [[nodiscard]] ri::OptimizeStats& getOptimizeStats();
+
+    private:
+        std::string namePrefix{};
+        size_t varId = 0;
+        size_t setId = 0;
+        size_t nameId = 0;
+        size_t tempVarId = 0;
+        size_t setLabelId = 0;
+        std::stack<std::shared_ptr<lexer::Lexer>> lexers{};
+        std::list<std::string> lexerPaths{};
+        std::stack<utils::Pos> processingPosStack{};
+        std::string errorFileRecord{};
+        std::unordered_map<std::string, std::string> extensionPathNameMap{};
+        std::stack<std::string> processingExtensionStack{};
+        std::vector<std::string> importedModules{};
+        std::unordered_set<std::string> linkedModules{};
+        std::shared_ptr<ModuleRegistry> moduleRegistry;
+        std::unordered_map<std::string, std::string> customTypeMap{};
+        std::unordered_map<std::string, std::shared_ptr<symbol::ClassSymbol>> customClassSymbolMap{};
+        std::shared_ptr<parser::ModuleGraphParser> moduleGraph;
+        ri::OptimizeStats optimizeStats{};
+    };
+}
+
+#endif //RCC_COMPILATION_SESSION_H
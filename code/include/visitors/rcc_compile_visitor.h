@@ -5,25 +5,33 @@
 #ifndef RCC_COMPILER_VISITOR_H
 #define RCC_COMPILER_VISITOR_H
 
+#include <atomic>
+#include <deque>
+#include <optional>
 #include <queue>
 
 #include "../analyzer/rcc_lexer.h"
 #include "../components/ri/rcc_ri.h"
+#include "../components/ri/rcc_ri_buffer.h"
+#include "../components/ri/rcc_ri_optimizer.h"
 #include "../components/symbol/rcc_symbol.h"
 #include "../interfaces/rcc_compile_interface.h"
-
-namespace builtin
-{
-    struct CallInfos;
-}
+#include "./rcc_compilation_session.h"
+#include "../../declarations/builtin/rcc_builtin_dec.h"
 
 namespace ast
 {
+    // 内容构建器：指令以结构化记录写入同一条指令流，各层作用域是指令流末尾相邻的区间，
+    // 退出作用域只需截断或切分区间，文本在 buildAll 时一次性生成
     class ContentBuilder
     {
-        std::stack<std::stringstream> raCodeStack{};
+        ri::InstructionBuffer buffer;
+        // 各层作用域在指令流中的起始位置，栈顶作用域总是位于指令流的末尾
+        std::vector<size_t> scopeStarts{};
         std::string raCode;
 
+        void checkScope(const std::string& operation) const;
+
     public:
         ContentBuilder();
         ~ContentBuilder() = default;
@@ -31,20 +39,30 @@ namespace ast
         ContentBuilder& appendCode(const std::string& code);
         ContentBuilder& operator<<(const std::string& code);
         ContentBuilder& operator<<(const ri::RI& ri);
+        ContentBuilder& operator<<(const ri::InstructionBuffer& fragment);
         void enterScope();
         void exitScope();
+        // 退出当前作用域，其中的指令原样并入外层作用域
+        ContentBuilder& mergeScope();
+        // 退出当前作用域并取出其中的指令片段，片段可之后再拼接到任意位置
+        ri::InstructionBuffer takeCurScope();
         ContentBuilder& buildCurScope(std::string& target);
         ContentBuilder& buildCurScope(ContentBuilder& builder);
         ContentBuilder& operator>>(std::string& target);
         ContentBuilder& operator>>(ContentBuilder& builder);
         [[nodiscard]] std::string getCurScopeResult() const;
+        [[nodiscard]] const ri::InstructionBuffer& getBuffer() const;
+        // 对整个指令流执行优化，只能在所有嵌套作用域都已退出之后调用
+        ri::OptimizeStats optimize(const ri::RaOptimizer& optimizer);
     };
 
-    // 变量ID封装类
+    // 变量ID封装类：序号与名称序号取自当前线程激活的编译会话
+    // 会话之外创建的只有内置函数参数这类进程级的静态定义，它们使用独立的序号与 "vb" 前缀，不占用会话的序号
     class VarID final : public Object
     {
-        static size_t _varId; // 变量ID计数器
+        static std::atomic<size_t> _builtinVarId; // 静态定义的变量ID计数器
         static std::string rccVarPrefixField; // 变量前缀
+        static std::string rccBuiltinVarPrefixField; // 静态定义的变量前缀
         size_t id = 0; // 当前变量ID
         std::string fileField, scopeField, nameField; // 文件域、作用域、名称
         std::string vid; // 变量唯一标识
@@ -77,10 +95,9 @@ namespace ast
         }
     };
 
-    // 标签ID封装类
+    // 标签ID封装类：序号与名称序号取自当前线程激活的编译会话
     class SetID final : public Object
     {
-        static size_t _setId; // 集合ID计数器
         static std::string rccSetPrefixField; // 集合前缀
         size_t id = 0; // 当前集合ID
         std::string fileField, scopeField, nameField; // 文件域、作用域、名称
@@ -141,18 +158,18 @@ namespace ast
         [[nodiscard]] bool isNot(const OpItemType& opItemType) const;
         [[nodiscard]] std::string toString() const override;
 
-        // Getter方法
-        [[nodiscard]] Pos getPos() const;
+        // Getter方法：返回成员引用，读取操作数不复制字符串、不增加引用计数
+        [[nodiscard]] const Pos &getPos() const;
         void setPos(const Pos &pos_);
-        [[nodiscard]] std::string getVal() const;
+        [[nodiscard]] const std::string &getVal() const;
         [[nodiscard]] OpItemType getType() const;
         [[nodiscard]] std::string getRaVal(const symbol::SymbolTableManager& table,
                                            const bool& needSearch = true) const;
-        [[nodiscard]] std::shared_ptr<symbol::TypeLabelSymbol> getTypeLabel() const;
-        [[nodiscard]] std::shared_ptr<symbol::TypeLabelSymbol> getValueType() const;
-        [[nodiscard]] std::shared_ptr<symbol::Symbol> getBelonging() const;
-        [[nodiscard]] std::string getBelongAttrRaValue() const;
-        [[nodiscard]] std::shared_ptr<symbol::Symbol> getReferencedSymbol() const;
+        [[nodiscard]] const std::shared_ptr<symbol::TypeLabelSymbol> &getTypeLabel() const;
+        [[nodiscard]] const std::shared_ptr<symbol::TypeLabelSymbol> &getValueType() const;
+        [[nodiscard]] const std::shared_ptr<symbol::Symbol> &getBelonging() const;
+        [[nodiscard]] const std::string &getBelongAttrRaValue() const;
+        [[nodiscard]] const std::shared_ptr<symbol::Symbol> &getReferencedSymbol() const;
 
         // Setter方法
         void setTypeLabel(const std::shared_ptr<symbol::TypeLabelSymbol>& typeLabelSymbol);
@@ -181,6 +198,34 @@ namespace ast
         const OpItem* TransformToOII() const override;
     };
 
+    // 调用参数绑定方案：按被调函数的参数列表与调用形态（位置参数个数、命名参数名）预先确定每个形参的取值来源
+    struct CallBindingPlan
+    {
+        enum class Binding
+        {
+            NAMED, // 取同名的命名参数
+            POSITIONAL, // 取下一个位置参数
+            DEFAULT, // 取默认值
+            MISSING, // 参数缺失
+            VAR_LEN_POSITIONAL, // 打包剩余的位置参数
+            VAR_LEN_KEYWORD, // 打包剩余的命名参数
+            NONE // 不处理
+        };
+
+        size_t posArgCount = 0;
+        std::vector<std::string> namedArgKeys{}; // 已排序
+        std::vector<Binding> bindings{}; // 与参数列表一一对应
+    };
+
+    // 调用点解析缓存项：同一被调函数的内置函数分派与各调用形态的参数绑定方案
+    struct CallSiteCacheEntry
+    {
+        std::shared_ptr<symbol::FunctionSymbol> callee; // 持有被调函数，缓存键中的地址不会被复用
+        std::vector<std::shared_ptr<symbol::ParameterSymbol>> params;
+        builtin::BuiltinDispatch dispatch;
+        std::vector<CallBindingPlan> plans{};
+    };
+
     class CompileVisitor final :
     public Visitor,
     public IRCCCompileInterface
@@ -195,22 +240,26 @@ namespace ast
         static OutputFormat __symbol_option_format__;
 
         static int __compile_option_compile_level__;
-    private:
 
-        // ========================== 静态成员属性 ==========================
-        static size_t _temVarId; // 临时变量ID计数器
-        static size_t _setId; // 集合标签ID计数器
-        static std::unordered_map<std::string,
-                                  std::shared_ptr<symbol::ClassSymbol>> extensionMap; // 扩展类映射
-        static std::stack<std::shared_ptr<lexer::Lexer>> _lexers; // 词法分析器
-        static std::list<std::string> _lexer_paths; // 词法分析器路径向量
-        static std::string fileRecord;
-        static std::unordered_map<std::string, std::string> extensionPathNameMap;
-        static std::stack<std::string> processingExtensionStack;
+        static bool __compile_flag_opt_stats__;
+
+        static bool __compile_flag_tree_shake__;
+
+        static int __compile_option_inline_threshold__;
 
+        static int __compile_option_jobs__;
+
+        static bool __compile_flag_no_module_cache__;
+    private:
         // ========================== 成员属性 ==========================
+        // 编译会话：入口文件与其导入的模块共用同一会话，compile 期间在当前线程上激活
+        std::shared_ptr<CompilationSession> session;
+        // 正在编译的语法树：符号会保留其中的节点（函数定义、参数默认值），语法树的根须与符号表一同存活，
+        // 以保证节点所在的内存池不被提前释放，因此声明在符号表之前
+        std::shared_ptr<ProgramNode> programNode;
         ContentBuilder raCodeBuilder {}; // RA代码构建器
         ContentBuilder analyzeBuilder {}; // 分析结果构建器
+        std::unordered_set<std::string> tempVarIds {}; // 本模块生成的临时变量，供 RA 优化识别
         symbol::SymbolTableManager symbolTable{}; // 符号表管理器
 
         std::string programEntryFilePath; // 程序入口文件路径
@@ -221,14 +270,19 @@ namespace ast
 
         // 处理栈
         std::stack<std::shared_ptr<symbol::Symbol>> processingSymbolStack{}; // 符号处理栈
-        std::stack<std::shared_ptr<OpItem>> opItemStack{}; // 操作数栈
+        // 操作数栈：操作数按值存放，弹出时移出；双端队列压栈不移动已有元素，栈内操作数的地址在弹出前保持有效
+        std::deque<OpItem> opItemStack{};
         std::stack<ScopeType> scopeTypeStack{}; // 作用域类型栈
         std::stack<ScopeType> loopScopeStack{}; // 循环作用域栈
         std::unordered_map<std::string, std::shared_ptr<VarID>> varIdMap {};
+        bool branchAlwaysTaken = false; // 刚编译的分支条件恒为真，同一条件语句中其后的分支不可达
+        // 调用点解析缓存：以被调函数为键，重复调用时不再逐参数匹配名称、不再按名称查找内置函数
+        std::unordered_map<const symbol::FunctionSymbol*, CallSiteCacheEntry> callSiteCache{};
 
     public:
         // ======================= constructor ========================
         explicit CompileVisitor(
+            const std::shared_ptr<CompilationSession>& session,
             const std::string& programEntryFilePath,
             const std::string& programTargetFilePath,
             const std::string& compileOutputFilePath = "",
@@ -239,13 +293,14 @@ namespace ast
         [[nodiscard]] ContentBuilder& getRaCodeBuilder();
         [[nodiscard]] ContentBuilder& getAnalyzeBuilder();
         [[nodiscard]] std::stack<std::shared_ptr<symbol::Symbol>>& getProcessingSymbolStack();
-        [[nodiscard]] std::stack<std::shared_ptr<OpItem>>& getOpItemStack();
+        [[nodiscard]] std::deque<OpItem>& getOpItemStack();
         [[nodiscard]] std::stack<ScopeType>& getScopeTypeStack();
         [[nodiscard]] std::string getProgramEntryFilePath() const;
         [[nodiscard]] std::string getProgramTargetFilePath() const;
         [[nodiscard]] std::string getCompileOutputFilePath() const;
         [[nodiscard]] std::string getCurrentProcessingFilePath() const;
         void setCurrentProcessingFilePath(const std::string& filePath);
+        [[nodiscard]] const std::shared_ptr<CompilationSession>& getSession() const;
         static void enableDebugMode(bool cond);
 
         // ========================== 公共方法 ==========================
@@ -275,7 +330,6 @@ namespace ast
         static Pos currentPos();
         static void pushProcessingPos(const Pos& pos);
         static void popProcessingPos();
-        static std::stack<Pos> _currentProcessingPos;
         [[nodiscard]] bool checkTypeMatch(
             const std::shared_ptr<symbol::Symbol>& leftSymbol,
             const OpItem& rightOpItem) const; // 检查符号与操作数类型匹配
@@ -305,7 +359,7 @@ namespace ast
         [[nodiscard]] bool isProcessingSymbol() const; // 判断栈内是否有符号
 
         // 操作数栈操作
-        void pushOpItem(const std::shared_ptr<OpItem>& opItem); // 压入操作数（智能指针）
+        void pushOpItem(OpItem opItem); // 压入操作数
         void pushOpItem(
             // 压入操作数（参数构造）
             const OpItemType& type,
@@ -327,10 +381,10 @@ namespace ast
             const std::shared_ptr<symbol::TypeLabelSymbol>& valueType = nullptr,
             const std::shared_ptr<symbol::Symbol>& referencedSymbol = nullptr,
             const Pos& pos = getUnknownPos());
-        OpItem rPopOpItem(); // 弹出并返回操作数
+        OpItem rPopOpItem(); // 弹出并返回操作数（移出，不复制）
         void popOpItem(); // 弹出操作数
-        [[nodiscard]] OpItem topOpItem() const; // 获取栈顶操作数
-        [[nodiscard]] std::shared_ptr<OpItem> topOpItemPtr() const; // 获取栈顶操作数（智能指针）
+        [[nodiscard]] const OpItem& topOpItem() const; // 获取栈顶操作数，引用在该操作数弹出前有效
+        [[nodiscard]] OpItem& topOpItemRef(); // 获取可修改的栈顶操作数
         [[nodiscard]] std::string topOpRaVal() const; // 获取栈顶操作数RA值
         [[nodiscard]] std::string rPopOpItemRaVal(); // 弹出并返回操作数RA值
         [[nodiscard]] std::string rPopOpItemVal(); // 弹出并返回操作数原始值
@@ -340,13 +394,22 @@ namespace ast
         // 临时变量/集合生成
         [[nodiscard]] static std::string getNewTempVarName(); // 获取新临时变量名
         [[nodiscard]] static std::string getNewSetLabelName(); // 获取新集合标签名
-        OpItem pushTemOpVarItemWithRecord(
+        const OpItem& pushTemOpVarItemWithRecord(
             const Pos& pos,
             const std::shared_ptr<symbol::TypeLabelSymbol>& valueType = nullptr,
             const std::shared_ptr<symbol::Symbol>& referencedSymbol = nullptr,
             const bool& sysDefined = {},
             const std::shared_ptr<symbol::TypeLabelSymbol>& typeLabel = nullptr); // 生成并压入临时变量操作数
-        OpItem pushTemOpSetItem(const Pos& pos); // 生成并压入临时集合操作数
+        const OpItem& pushTemOpSetItem(const Pos& pos); // 生成并压入临时集合操作数
+        // 常量折叠（编译级别 2 及以上）
+        [[nodiscard]] std::optional<std::string> getConstantRaVal(const OpItem& opItem) const; // 可在编译期求值的字面量
+        [[nodiscard]] std::optional<bool> getConstantCondition(const OpItem& opItem) const; // 恒定的条件值
+        bool pushConstantItem(
+            const Pos& pos,
+            const std::optional<std::string>& raVal,
+            const std::shared_ptr<symbol::TypeLabelSymbol>& valueType = nullptr); // 压入折叠结果，raVal 为空时返回 false
+        std::optional<bool> compileLoopCondition(const Pos& pos); // 生成循环条件检查，返回恒定的条件值
+        void finishLoop(const std::optional<bool>& condition); // 结束循环的指令作用域，条件恒假时丢弃整个循环
         [[nodiscard]] OpItem newTemOpSetItem(const Pos& pos) const; // 生成临时集合操作数（不压栈）
         [[nodiscard]] VarID getThisFieldVarID(const Pos& pos) const;
         [[nodiscard]] std::shared_ptr<symbol::VariableSymbol> getThisFieldSymbol(
@@ -375,8 +438,6 @@ namespace ast
         static std::shared_ptr<symbol::Symbol> getReferenceTargetSymbol(const OpItem& opItem);
         static std::shared_ptr<symbol::Symbol> getReferenceTargetSymbol(
             const std::shared_ptr<symbol::VariableSymbol>& varSymbol);
-        static void registerExtension(const std::string& extensionPath,
-                                      const std::shared_ptr<symbol::ClassSymbol>& extensionClass);
         static std::shared_ptr<symbol::ClassSymbol> getRegisteredExtension(const std::string& extensionPath);
         static bool isExtensionRegistered(const std::string& extensionPath);
         static void setSymbolBuiltinType(const std::shared_ptr<symbol::Symbol>& processingSymbol,
@@ -454,6 +515,13 @@ namespace ast
                                std::vector<std::string>& fullProcessedArgs,
                                const Pos& callPos);
 
+        // 获取被调函数的调用点缓存项，首次调用时建立
+        CallSiteCacheEntry& getCallSiteCacheEntry(const std::shared_ptr<symbol::FunctionSymbol>& funcSymbol);
+
+        // 获取与调用形态相符的参数绑定方案，不存在时按参数列表推导并缓存
+        static const CallBindingPlan& getCallBindingPlan(CallSiteCacheEntry& entry, size_t posArgCount,
+                                                         const std::unordered_map<std::string, OpItem>& namedArgs);
+
         // 最终根据 funcSymbol 类型生成调用相关的 RA 指令（builtin 与普通函数分支）
         void emitFinalCall(const std::shared_ptr<symbol::FunctionSymbol>& funcSymbol,
                            const builtin::CallInfos& callInfos);
@@ -510,7 +578,7 @@ namespace ast
 
         void visitClassDeclarationNode(ClassDeclarationNode& node) override;
 
-        std::string compileConstructorNode(const std::shared_ptr<symbol::FunctionSymbol>& ctorSymbol);
+        ri::InstructionBuffer compileConstructorNode(const std::shared_ptr<symbol::FunctionSymbol>& ctorSymbol);
 
         void compileClassMembers(const std::string& classIdent, const std::shared_ptr<symbol::SymbolTable>& members,
                                  const symbol::LifeCycleLabel&
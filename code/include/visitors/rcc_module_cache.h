@@ -0,0 +1,58 @@
+//
+// Created by RestRegular on 2025/7/20.
+//
+
+#ifndef RCC_MODULE_CACHE_H
+#define RCC_MODULE_CACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "./rcc_build_scheduler.h"
+
+namespace ast
+{
+    // 模块缓存：按内容寻址保存编译完成的导入模块，源码与依赖未变时直接载入，跳过语义分析
+    // 缓存项包含模块的 RA 代码、直接依赖、优化统计、自定义类型，以及模块拥有的符号与符号表对象；
+    // 对依赖模块中符号的引用记为（模块路径，序号），序号即依赖模块 symbolIndex 中的位置；库目录下的路径以占位符记录
+    // 定义节点只在模块自身编译时使用，不写入缓存，载入的函数与成员变量没有定义节点
+    class ModuleCache
+    {
+    public:
+        static constexpr char MAGIC[4] = {'R', 'M', 'O', 'D'};
+        // 缓存项编码方式、符号的序列化字段变化或已缓存的 RA 代码需要重新生成（如修正优化错误）时递增，旧缓存随之失效
+        static constexpr uint32_t FORMAT_VERSION = 4;
+
+        // 缓存键：编译器版本、构建标识、编译级别、内联阈值、模块键（库目录下的模块为相对路径，见
+        // CompilationSession::getModuleKey）、源码哈希及全部直接依赖的缓存键，库目录下的模块的键与 RCC 的安装位置无关
+        // 缓存已关闭、模块未被预解析或有依赖尚未发布（依赖没有缓存键）时返回空串，此时模块不参与缓存
+        [[nodiscard]] static std::string computeKey(CompilationSession& importer, const std::string& filepath);
+
+        static std::string getCachePath(const std::string& cacheKey);
+
+        // 收集模块拥有的符号与符号表对象，写入 module.symbolIndex；缓存项与依赖方的引用都以此为准
+        // 依赖的模块无法定位时清空缓存键，模块及依赖它的模块都不再参与缓存
+        static void indexSymbols(CompiledModule& module);
+
+        // 先查找嵌入的内置扩展快照，再查找缓存目录
+        // 缓存缺失、失效或依赖的引用无法还原时返回 nullptr，调用方按原流程编译
+        [[nodiscard]] static std::shared_ptr<CompiledModule> load(CompilationSession& importer,
+                                                                  const std::string& filepath,
+                                                                  const std::string& cacheKey);
+
+        // 将模块编码为缓存项；模块引用了无法编码的对象时抛出异常
+        [[nodiscard]] static std::string serialize(const CompiledModule& module);
+
+        // 写入失败或模块引用了无法编码的对象时只放弃本次缓存，不影响编译
+        static void store(const CompiledModule& module);
+
+    private:
+        // 在 importer 派生的模块会话中还原缓存项 data；文件头与 cacheKey 不符时返回 nullptr
+        static std::shared_ptr<CompiledModule> restore(CompilationSession& importer, const std::string& filepath,
+                                                       const std::string& cacheKey, std::string_view data);
+    };
+}
+
+#endif //RCC_MODULE_CACHE_H
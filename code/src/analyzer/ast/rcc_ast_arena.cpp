@@ -0,0 +1,53 @@
+//
+// Created by RestRegular on 2025/6/29.
+//
+
+#include <cstdint>
+#include "../../../include/analyzer/rcc_ast_arena.h"
+
+namespace ast {
+
+    void *AstArena::allocate(const size_t size, const size_t alignment)
+    {
+        const auto padding = [&] {
+            const auto address = reinterpret_cast<uintptr_t>(_cursor);
+            return static_cast<size_t>((alignment - address % alignment) % alignment);
+        };
+        if (!_cursor || padding() + size > _remaining) {
+            // 超过块大小的对象单独占用一个块，不打断当前块的顺序分配
+            if (size + alignment > BLOCK_SIZE) {
+                auto &block = _blocks.emplace_back(std::make_unique<std::byte[]>(size + alignment));
+                auto address = reinterpret_cast<uintptr_t>(block.get());
+                address += (alignment - address % alignment) % alignment;
+                _allocationCount++;
+                _allocatedBytes += size;
+                return reinterpret_cast<void *>(address);
+            }
+            _cursor = _blocks.emplace_back(std::make_unique<std::byte[]>(BLOCK_SIZE)).get();
+            _remaining = BLOCK_SIZE;
+        }
+        const size_t offset = padding();
+        void *result = _cursor + offset;
+        _cursor += offset + size;
+        _remaining -= offset + size;
+        _allocationCount++;
+        _allocatedBytes += size;
+        return result;
+    }
+
+    size_t AstArena::getAllocationCount() const
+    {
+        return _allocationCount;
+    }
+
+    size_t AstArena::getAllocatedBytes() const
+    {
+        return _allocatedBytes;
+    }
+
+    size_t AstArena::getBlockCount() const
+    {
+        return _blocks.size();
+    }
+
+} // ast
@@ -2,6 +2,7 @@
 // Created by RestRegular on 2025/6/29.
 //
 
+#include <algorithm>
 #include <utility>
 
 #include "../../../include/rcc_base.h"
@@ -138,6 +139,10 @@ namespace ast {
         return *colonToken;
     }
 
+    std::shared_ptr<Token> FunctionDeclarationNode::getColonTokenPtr() const {
+        return colonToken;
+    }
+
     Pos FunctionDeclarationNode::getPos() const {
         return getMainToken().getPos();
     }
@@ -160,6 +165,10 @@ namespace ast {
         return *colonToken;
     }
 
+    std::shared_ptr<Token> FunctionDefinitionNode::getColonTokenPtr() const {
+        return colonToken;
+    }
+
     std::shared_ptr<Token> FunctionDefinitionNode::getIndicatorToken() const {
         return indicatorToken;
     }
@@ -444,6 +453,16 @@ namespace ast {
         visitor.visitProgramNode(*this);
     }
 
+    void ProgramNode::addArena(const std::shared_ptr<AstArena> &arena) {
+        if (arena && std::find(arenas.begin(), arenas.end(), arena) == arenas.end()) {
+            arenas.push_back(arena);
+        }
+    }
+
+    const std::vector<std::shared_ptr<AstArena>> &ProgramNode::getArenas() const {
+        return arenas;
+    }
+
     Pos ProgramNode::getPos() const {
         if (statements.empty()) {
             return Node::getPos();
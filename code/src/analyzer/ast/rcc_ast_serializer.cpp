@@ -0,0 +1,1135 @@
+//
+// Created by RestRegular on 2025/6/29.
+//
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#include "../../../include/rcc_base.h"
+#include "../../../include/analyzer/rcc_ast_serializer.h"
+
+namespace ast {
+
+    namespace {
+        // 节点类型标签；只能在末尾追加，调整已有标签时须递增 FORMAT_VERSION
+        enum class AstTag : uint8_t {
+            NONE = 0,
+            NULL_LITERAL,
+            STRING_LITERAL,
+            INTEGER_LITERAL,
+            FLOAT_LITERAL,
+            BOOLEAN_LITERAL,
+            CHARACTER_LITERAL,
+            IDENTIFIER,
+            VARIABLE_DEFINITION,
+            ASSIGNMENT,
+            FUNCTION_DECLARATION,
+            CONSTRUCTOR_DEFINITION,
+            CLASS_DECLARATION,
+            CLASS_DEFINITION,
+            FUNCTION_CALL,
+            INFIX,
+            UNARY,
+            EXPRESSION_STATEMENT,
+            PREFIX,
+            POSTFIX,
+            PAREN_RANGER,
+            BLOCK_RANGER,
+            FUNCTION_DEFINITION,
+            LABEL,
+            BRANCH,
+            CONDITION,
+            WHILE_LOOP,
+            UNTIL_LOOP,
+            FOR_LOOP,
+            PASS,
+            ENCAPSULATED,
+            RETURN,
+            BREAK,
+            CONTINUE,
+            ANON_FUNCTION_DEFINITION,
+            PAIR,
+            DICTIONARY,
+            LIST,
+            BRACKET,
+            INDEX,
+            TRY,
+            THROW
+        };
+
+        void appendHash(std::string &out, const uint64_t hash)
+        {
+            for (size_t i = 0; i < sizeof(hash); i++)
+            {
+                out.push_back(static_cast<char>((hash >> (i * 8)) & 0xFF));
+            }
+        }
+
+        // 节点写在独立的缓冲区中，字符串与文件路径边写边驻留，最后再拼出完整的数据
+        class AstWriter final : public Visitor {
+        public:
+            std::string finish(const ProgramNode &program, const uint64_t sourceHash)
+            {
+                writeToken(program.getMainToken());
+                writeNodes(program.getStatements());
+
+                std::string payload;
+                utils::appendVarint(payload, _strings.size());
+                for (const auto &str : _strings)
+                {
+                    utils::appendBytes(payload, str);
+                }
+                utils::appendVarint(payload, _files.size());
+                for (const auto &stringIndex : _files)
+                {
+                    utils::appendVarint(payload, stringIndex);
+                }
+                payload += _body;
+
+                std::string data(AstSerializer::MAGIC, sizeof(AstSerializer::MAGIC));
+                utils::appendVarint(data, AstSerializer::FORMAT_VERSION);
+                utils::appendBytes(data, RCC_VERSION);
+                appendHash(data, sourceHash);
+                // 载荷校验和：缓存文件被截断或改写时整体拒绝，而不是还原出一棵不同的语法树
+                appendHash(data, hashToCode(payload));
+                data += payload;
+                return data;
+            }
+
+            void visitLiteralNode(LiteralNode &node) override
+            {
+                throw std::runtime_error("Abstract literal node cannot be serialized: " + node.toString());
+            }
+
+            void visitNullLiteralNode(NullLiteralNode &node) override
+            {
+                writeTag(AstTag::NULL_LITERAL);
+                writeToken(node.getMainToken());
+            }
+
+            void visitStringLiteralNode(StringLiteralNode &node) override
+            {
+                writeTag(AstTag::STRING_LITERAL);
+                writeToken(node.getMainToken());
+            }
+
+            void visitNumberLiteralNode(NumberLiteralNode &node) override
+            {
+                throw std::runtime_error("Abstract number node cannot be serialized: " + node.toString());
+            }
+
+            void visitIntegerLiteralNode(IntegerLiteralNode &node) override
+            {
+                writeTag(AstTag::INTEGER_LITERAL);
+                writeToken(node.getMainToken());
+            }
+
+            void visitFloatLiteralNode(FloatLiteralNode &node) override
+            {
+                writeTag(AstTag::FLOAT_LITERAL);
+                writeToken(node.getMainToken());
+            }
+
+            void visitBooleanLiteralNode(BooleanLiteralNode &node) override
+            {
+                writeTag(AstTag::BOOLEAN_LITERAL);
+                writeToken(node.getMainToken());
+            }
+
+            void visitCharacterLiteralNode(CharacterLiteralNode &node) override
+            {
+                writeTag(AstTag::CHARACTER_LITERAL);
+                writeToken(node.getMainToken());
+            }
+
+            void visitIdentifierNode(IdentifierNode &node) override
+            {
+                writeTag(AstTag::IDENTIFIER);
+                writeToken(node.getMainToken());
+                writeOptionalToken(node.getColonTokenPtr());
+                writeNodes(node.getLabels());
+            }
+
+            void visitVariableDefinitionNode(VariableDefinitionNode &node) override
+            {
+                writeTag(AstTag::VARIABLE_DEFINITION);
+                writeToken(node.getMainToken());
+                const auto &varDefs = node.getVarDefs();
+                writeVarint(varDefs.size());
+                for (const auto &varDef : varDefs)
+                {
+                    writeNode(varDef->getNameNode());
+                    writeVarint(varDef->hasLabels());
+                    writeNodes(varDef->getLabelNodes());
+                    writeVarint(varDef->hasInitialValue());
+                    writeNode(varDef->getValueNode());
+                }
+            }
+
+            void visitAssignmentNode(AssignmentNode &node) override
+            {
+                writeTag(AstTag::ASSIGNMENT);
+                writeToken(node.getMainToken());
+                const auto &[left, right] = node.getAssignPair();
+                writeNode(left);
+                writeNode(right);
+            }
+
+            void visitParameterNode(ParameterNode &node) override
+            {
+                throw std::runtime_error("Parameter node cannot be serialized: " + node.toString());
+            }
+
+            void visitArgumentNode(ArgumentNode &node) override
+            {
+                throw std::runtime_error("Argument node cannot be serialized: " + node.toString());
+            }
+
+            void visitFunctionDeclarationNode(FunctionDeclarationNode &node) override
+            {
+                writeTag(AstTag::FUNCTION_DECLARATION);
+                writeToken(node.getMainToken());
+                writeNode(node.getCallNode());
+                writeOptionalToken(node.getColonTokenPtr());
+                writeNodes(node.getLabelNodes());
+            }
+
+            void visitConstructorDefinitionNode(ConstructorDefinitionNode &node) override
+            {
+                writeTag(AstTag::CONSTRUCTOR_DEFINITION);
+                writeToken(node.getMainToken());
+                writeNode(node.getParamNode());
+                writeOptionalToken(node.getColonToken());
+                writeNodes(node.getLabelNodes());
+                writeNode(node.getBodyNode());
+            }
+
+            void visitClassDeclarationNode(ClassDeclarationNode &node) override
+            {
+                writeTag(AstTag::CLASS_DECLARATION);
+                writeToken(node.getMainToken());
+                writeNode(node.getNameNode());
+            }
+
+            void visitClassDefinitionNode(ClassDefinitionNode &node) override
+            {
+                writeTag(AstTag::CLASS_DEFINITION);
+                writeToken(node.getMainToken());
+                writeNode(node.getNameNode());
+                writeNode(node.getBodyNode());
+            }
+
+            void visitFunctionCallNode(FunctionCallNode &node) override
+            {
+                // 调用节点的主 Token 取自被调用节点，由构造函数重新得出
+                writeTag(AstTag::FUNCTION_CALL);
+                writeToken(node.getOpToken());
+                writeNode(node.getLeftNode());
+                writeNode(node.getRightNode());
+            }
+
+            void visitProgramNode(ProgramNode &node) override
+            {
+                throw std::runtime_error("Nested program node cannot be serialized: " + node.toString());
+            }
+
+            void visitInfixNode(InfixExpressionNode &node) override
+            {
+                writeTag(AstTag::INFIX);
+                writeToken(node.getMainToken());
+                writeVarint(static_cast<uint64_t>(node.getInfixType()));
+                writeToken(node.getOpToken());
+                writeNode(node.getLeftNode());
+                writeNode(node.getRightNode());
+            }
+
+            void visitUnaryExpressionNode(UnaryExpressionNode &node) override
+            {
+                writeTag(AstTag::UNARY);
+                writeToken(node.getMainToken());
+                writeToken(node.getOpToken());
+                writeNode(node.getRightNode());
+            }
+
+            void visitExpressionStatementNode(ExpressionStatementNode &node) override
+            {
+                writeTag(AstTag::EXPRESSION_STATEMENT);
+                writeToken(node.getMainToken());
+                writeNode(node.getExpression());
+            }
+
+            void visitPrefixExpressionNode(PrefixExpressionNode &node) override
+            {
+                writeTag(AstTag::PREFIX);
+                writeToken(node.getMainToken());
+                writeVarint(static_cast<uint64_t>(node.getPrefixType()));
+                writeNode(node.getNode());
+            }
+
+            void visitPostfixNode(PostfixExpressionNode &node) override
+            {
+                writeTag(AstTag::POSTFIX);
+                writeToken(node.getMainToken());
+                writeVarint(static_cast<uint64_t>(node.getPostfixType()));
+                writeNode(node.getNode());
+            }
+
+            void visitParenRangerNode(ParenRangerNode &node) override
+            {
+                writeTag(AstTag::PAREN_RANGER);
+                writeToken(node.getRangerStartToken());
+                writeToken(node.getRangerEndToken());
+                writeNode(node.getRangerNode());
+            }
+
+            void visitBlockRangerNode(BlockRangerNode &node) override
+            {
+                writeTag(AstTag::BLOCK_RANGER);
+                writeToken(node.getRangerStartToken());
+                writeToken(node.getRangerEndToken());
+                writeNodes(node.getBodyExpressions());
+            }
+
+            void visitFunctionDefinitionNode(FunctionDefinitionNode &node) override
+            {
+                writeTag(AstTag::FUNCTION_DEFINITION);
+                writeToken(node.getMainToken());
+                writeNode(node.getCallNode());
+                writeOptionalToken(node.getColonTokenPtr());
+                writeNodes(node.getLabelNodes());
+                writeOptionalToken(node.getIndicatorToken());
+                writeNode(node.getBodyNode());
+            }
+
+            void visitLabelNode(LabelNode &node) override
+            {
+                // 标签路径中只有最后一段的 Token 成为主 Token，其余各段只保留文本
+                writeTag(AstTag::LABEL);
+                writeToken(node.getMainToken());
+                const auto &labelPath = node.getLabelPath();
+                writeVarint(labelPath.size());
+                for (const auto &label : labelPath)
+                {
+                    writeString(label);
+                }
+                writeNodes(node.getLabelDesNodes());
+            }
+
+            void visitBranchNode(BranchNode &node) override
+            {
+                writeTag(AstTag::BRANCH);
+                writeToken(node.getMainToken());
+                writeNode(node.getConditionNode());
+                writeNode(node.getBodyNode());
+            }
+
+            void visitConditionNode(ConditionNode &node) override
+            {
+                writeTag(AstTag::CONDITION);
+                writeNodes(node.getBranchNodes());
+            }
+
+            void visitLoopNode(LoopNode &node) override
+            {
+                switch (node.getLoopType())
+                {
+                case LoopType::WHILE: writeTag(AstTag::WHILE_LOOP); break;
+                case LoopType::UNTIL: writeTag(AstTag::UNTIL_LOOP); break;
+                default: throw std::runtime_error("Unexpected loop node: " + node.toString());
+                }
+                writeToken(node.getMainToken());
+                writeNode(node.getConditionNode());
+                writeNode(node.getBodyNode());
+            }
+
+            void visitForLoopNode(ForLoopNode &node) override
+            {
+                writeTag(AstTag::FOR_LOOP);
+                writeToken(node.getMainToken());
+                writeNode(node.getInitNode());
+                writeNode(node.getConditionNode());
+                writeNode(node.getUpdateNode());
+                writeNode(node.getBodyNode());
+            }
+
+            void visitPassExpressionNode(PassExpressionNode &node) override
+            {
+                writeTag(AstTag::PASS);
+                writeToken(node.getMainToken());
+            }
+
+            void visitEncapsulatedExpressionNode(EncapsulatedExpressionNode &node) override
+            {
+                writeTag(AstTag::ENCAPSULATED);
+                writeToken(node.getMainToken());
+            }
+
+            void visitReturnExpressionNode(ReturnExpressionNode &node) override
+            {
+                writeTag(AstTag::RETURN);
+                writeToken(node.getMainToken());
+                writeNode(node.getReturnNode());
+            }
+
+            void visitBreakExpressionNode(BreakExpressionNode &node) override
+            {
+                writeTag(AstTag::BREAK);
+                writeToken(node.getMainToken());
+            }
+
+            void visitContinueExpressionNode(ContinueExpressionNode &node) override
+            {
+                writeTag(AstTag::CONTINUE);
+                writeToken(node.getMainToken());
+            }
+
+            void visitAnonFunctionDefinitionNode(AnonFunctionDefinitionNode &node) override
+            {
+                writeTag(AstTag::ANON_FUNCTION_DEFINITION);
+                writeToken(node.getMainToken());
+                writeNode(node.getParamNode());
+                writeOptionalToken(node.getColonToken());
+                writeNodes(node.getLabelNodes());
+                writeToken(node.getIndicatorToken());
+                writeNode(node.getBodyNode());
+            }
+
+            void visitPairExpressionNode(PairExpressionNode &node) override
+            {
+                writeTag(AstTag::PAIR);
+                writeToken(node.getMainToken());
+                writeNode(node.getLeftNode());
+                writeToken(node.getColonToken());
+                writeNode(node.getRightNode());
+            }
+
+            void visitDictionaryExpressionNode(DictionaryExpressionNode &node) override
+            {
+                writeTag(AstTag::DICTIONARY);
+                writeToken(node.getRangerStartToken());
+                writeToken(node.getRangerEndToken());
+                writeNode(node.getBodyNode());
+            }
+
+            void visitListExpressionNode(ListExpressionNode &node) override
+            {
+                writeTag(AstTag::LIST);
+                writeToken(node.getRangerStartToken());
+                writeToken(node.getRangerEndToken());
+                writeNode(node.getBodyNode());
+            }
+
+            void visitBracketExpressionNode(BracketExpressionNode &node) override
+            {
+                writeTag(AstTag::BRACKET);
+                writeToken(node.getRangerStartToken());
+                writeToken(node.getRangerEndToken());
+                writeNode(node.getBodyNode());
+            }
+
+            void visitIndexExpressionNode(IndexExpressionNode &node) override
+            {
+                writeTag(AstTag::INDEX);
+                writeToken(node.getMainToken());
+                writeNode(node.getLeftNode());
+                writeNode(node.getIndexNode());
+            }
+
+            void visitTryNode(TryNode &node) override
+            {
+                writeTag(AstTag::TRY);
+                writeToken(node.getMainToken());
+                writeNode(node.getTryBody());
+                const auto &catchBodies = node.getCatchBodies();
+                writeVarint(catchBodies.size());
+                for (const auto &[identNode, catchBody] : catchBodies)
+                {
+                    writeNode(identNode);
+                    writeNode(catchBody);
+                }
+                writeNode(node.getFinallyBody());
+            }
+
+            void visitThrowNode(ThrowNode &node) override
+            {
+                writeTag(AstTag::THROW);
+                writeToken(node.getMainToken());
+                writeNode(node.getThrowExpression());
+            }
+
+        private:
+            std::string _body;
+            std::vector<std::string> _strings;
+            std::unordered_map<std::string, uint32_t> _stringIndices;
+            // 文件表的每一项是文件路径在字符串表中的序号
+            std::vector<uint32_t> _files;
+            std::unordered_map<uint32_t, uint32_t> _fileIndices;
+
+            void writeVarint(const uint64_t value)
+            {
+                utils::appendVarint(_body, value);
+            }
+
+            void writeTag(const AstTag tag)
+            {
+                _body.push_back(static_cast<char>(tag));
+            }
+
+            uint32_t internString(const std::string &str)
+            {
+                const auto [it, inserted] = _stringIndices.try_emplace(str, static_cast<uint32_t>(_strings.size()));
+                if (inserted)
+                {
+                    _strings.push_back(str);
+                }
+                return it->second;
+            }
+
+            void writeString(const std::string &str)
+            {
+                writeVarint(internString(str));
+            }
+
+            uint32_t internFile(const uint32_t fileId)
+            {
+                const auto [it, inserted] = _fileIndices.try_emplace(fileId, static_cast<uint32_t>(_files.size()));
+                if (inserted)
+                {
+                    _files.push_back(internString(SourceFileTable::getInstance().getFilepath(fileId)));
+                }
+                return it->second;
+            }
+
+            // 偏移加一存储，0 表示没有偏移（NO_OFFSET）；增量分析产生的锚点位置换算为文件内的绝对位置
+            void writeToken(const Token &token)
+            {
+                const auto loc = SourceFileTable::getInstance().resolveLoc(token.getLoc());
+                writeVarint(tokenIndex(token.getType()));
+                writeString(token.getValue());
+                writeVarint(internFile(loc.fileId));
+                writeVarint(loc.hasOffset() ? static_cast<uint64_t>(loc.offset) + 1 : 0);
+                writeVarint(loc.length);
+            }
+
+            void writeOptionalToken(const std::shared_ptr<Token> &token)
+            {
+                writeVarint(token != nullptr);
+                if (token)
+                {
+                    writeToken(*token);
+                }
+            }
+
+            void writeNode(const std::shared_ptr<Node> &node)
+            {
+                if (!node)
+                {
+                    writeTag(AstTag::NONE);
+                    return;
+                }
+                node->acceptVisitor(*this);
+            }
+
+            template <typename T>
+            void writeNodes(const std::vector<std::shared_ptr<T>> &nodes)
+            {
+                writeVarint(nodes.size());
+                for (const auto &node : nodes)
+                {
+                    writeNode(node);
+                }
+            }
+        };
+
+        class AstReader {
+        public:
+            AstReader(const std::string_view data, const std::shared_ptr<AstArena> &arena)
+                : _data(data), _arena(arena) {}
+
+            // 读取并校验文件头，任一字段不一致时返回 false
+            bool readHeader(const uint64_t sourceHash)
+            {
+                if (_data.size() < sizeof(AstSerializer::MAGIC) ||
+                    std::memcmp(_data.data(), AstSerializer::MAGIC, sizeof(AstSerializer::MAGIC)) != 0)
+                {
+                    return false;
+                }
+                _pos = sizeof(AstSerializer::MAGIC);
+                if (readVarint() != AstSerializer::FORMAT_VERSION || readBytes() != RCC_VERSION)
+                {
+                    return false;
+                }
+                return readHash() == sourceHash;
+            }
+
+            // 载荷校验和须在读取文件头之后调用，不一致时视为损坏
+            void checkPayload()
+            {
+                const auto checksum = readHash();
+                if (checksum != hashToCode(_data.substr(_pos)))
+                {
+                    corrupt("checksum mismatch");
+                }
+            }
+
+            std::shared_ptr<ProgramNode> readProgram()
+            {
+                checkPayload();
+                const auto stringCount = readCount();
+                _strings.reserve(stringCount);
+                for (size_t i = 0; i < stringCount; i++)
+                {
+                    _strings.push_back(readBytes());
+                }
+                const auto fileCount = readCount();
+                _fileIds.reserve(fileCount);
+                for (size_t i = 0; i < fileCount; i++)
+                {
+                    _fileIds.push_back(SourceFileTable::getInstance().intern(readString()));
+                }
+                const auto programToken = readToken();
+                std::vector<std::shared_ptr<StatementNode>> statements;
+                const auto statementCount = readCount();
+                statements.reserve(statementCount);
+                for (size_t i = 0; i < statementCount; i++)
+                {
+                    statements.push_back(readNodeAs<StatementNode>());
+                }
+                if (_pos != _data.size())
+                {
+                    corrupt("trailing bytes");
+                }
+                const auto program = std::make_shared<ProgramNode>(programToken, std::move(statements));
+                program->addArena(_arena);
+                return program;
+            }
+
+        private:
+            std::string_view _data;
+            size_t _pos = 0;
+            std::shared_ptr<AstArena> _arena;
+            std::vector<std::string_view> _strings;
+            std::vector<uint32_t> _fileIds;
+
+            [[noreturn]] static void corrupt(const std::string &reason)
+            {
+                throw std::runtime_error("Corrupted AST cache data: " + reason + ".");
+            }
+
+            uint8_t readByte()
+            {
+                if (_pos >= _data.size())
+                {
+                    corrupt("unexpected end of data");
+                }
+                return static_cast<uint8_t>(_data[_pos++]);
+            }
+
+            uint64_t readHash()
+            {
+                uint64_t hash = 0;
+                for (size_t i = 0; i < sizeof(hash); i++)
+                {
+                    hash |= static_cast<uint64_t>(readByte()) << (i * 8);
+                }
+                return hash;
+            }
+
+            uint64_t readVarint()
+            {
+                uint64_t value = 0;
+                if (!utils::readVarint(_data, _pos, value))
+                {
+                    corrupt("invalid varint");
+                }
+                return value;
+            }
+
+            // 元素个数不可能超过剩余字节数，借此拒绝损坏数据中的超大计数
+            size_t readCount()
+            {
+                const auto count = readVarint();
+                if (count > _data.size() - _pos)
+                {
+                    corrupt("invalid element count");
+                }
+                return static_cast<size_t>(count);
+            }
+
+            std::string_view readBytes()
+            {
+                std::string_view bytes;
+                if (!utils::readBytes(_data, _pos, bytes))
+                {
+                    corrupt("unexpected end of data");
+                }
+                return bytes;
+            }
+
+            std::string readString()
+            {
+                const auto index = readVarint();
+                if (index >= _strings.size())
+                {
+                    corrupt("string index out of range");
+                }
+                return std::string(_strings[index]);
+            }
+
+            Token readToken()
+            {
+                const auto type = readVarint();
+                if (type >= TOKEN_TYPE_COUNT)
+                {
+                    corrupt("invalid token type");
+                }
+                auto value = readString();
+                const auto fileIndex = readVarint();
+                if (fileIndex >= _fileIds.size())
+                {
+                    corrupt("file index out of range");
+                }
+                const auto offset = readVarint();
+                const auto length = readVarint();
+                return Token(SourceLoc{
+                    _fileIds[fileIndex],
+                    offset == 0 ? SourceLoc::NO_OFFSET : static_cast<uint32_t>(offset - 1),
+                    static_cast<uint32_t>(length)
+                }, std::move(value), static_cast<TokenType>(type));
+            }
+
+            std::shared_ptr<Token> readOptionalToken()
+            {
+                return readVarint() ? std::make_shared<Token>(readToken()) : nullptr;
+            }
+
+            NodeType readNodeType()
+            {
+                return static_cast<NodeType>(readVarint());
+            }
+
+            template <typename T>
+            std::shared_ptr<T> readNodeAs()
+            {
+                const auto node = readNode();
+                if (!node)
+                {
+                    return nullptr;
+                }
+                auto typed = std::dynamic_pointer_cast<T>(node);
+                if (!typed)
+                {
+                    corrupt("unexpected node " + node->toString());
+                }
+                return typed;
+            }
+
+            template <typename T>
+            std::vector<std::shared_ptr<T>> readNodesAs()
+            {
+                const auto count = readCount();
+                std::vector<std::shared_ptr<T>> nodes;
+                nodes.reserve(count);
+                for (size_t i = 0; i < count; i++)
+                {
+                    nodes.push_back(readNodeAs<T>());
+                }
+                return nodes;
+            }
+
+            std::shared_ptr<ExpressionNode> readExpression()
+            {
+                return readNodeAs<ExpressionNode>();
+            }
+
+            template <typename T, typename... Args>
+            std::shared_ptr<Node> make(Args &&... args)
+            {
+                return makeNode<T>(_arena, std::forward<Args>(args)...);
+            }
+
+            // 参数按构造函数的参数顺序写入，读取时先逐个求值再构造，避免依赖实参的求值顺序
+            std::shared_ptr<Node> readNode()
+            {
+                switch (static_cast<AstTag>(readByte()))
+                {
+                case AstTag::NONE:
+                    return nullptr;
+                case AstTag::NULL_LITERAL:
+                    return make<NullLiteralNode>(readToken());
+                case AstTag::STRING_LITERAL:
+                    return make<StringLiteralNode>(readToken());
+                case AstTag::INTEGER_LITERAL:
+                    return make<IntegerLiteralNode>(readToken());
+                case AstTag::FLOAT_LITERAL:
+                    return make<FloatLiteralNode>(readToken());
+                case AstTag::BOOLEAN_LITERAL:
+                    return make<BooleanLiteralNode>(readToken());
+                case AstTag::CHARACTER_LITERAL:
+                    return make<CharacterLiteralNode>(readToken());
+                case AstTag::IDENTIFIER:
+                    {
+                        const auto token = readToken();
+                        const auto colonToken = readOptionalToken();
+                        const auto labels = readNodesAs<LabelNode>();
+                        if (!colonToken)
+                        {
+                            return make<IdentifierNode>(token);
+                        }
+                        return make<IdentifierNode>(token, *colonToken, labels);
+                    }
+                case AstTag::VARIABLE_DEFINITION:
+                    {
+                        const auto token = readToken();
+                        const auto count = readCount();
+                        std::vector<std::shared_ptr<VariableDefinitionNode::VarDefData>> varDefs;
+                        varDefs.reserve(count);
+                        for (size_t i = 0; i < count; i++)
+                        {
+                            const auto nameNode = readNodeAs<IdentifierNode>();
+                            const bool hasLabels = readVarint();
+                            const auto labelNodes = readNodesAs<LabelNode>();
+                            const bool hasInitialValue = readVarint();
+                            const auto valueNode = readExpression();
+                            varDefs.push_back(makeNode<VariableDefinitionNode::VarDefData>(
+                                _arena, nameNode, hasLabels, labelNodes, hasInitialValue, valueNode));
+                        }
+                        return make<VariableDefinitionNode>(token, varDefs);
+                    }
+                case AstTag::ASSIGNMENT:
+                    {
+                        const auto token = readToken();
+                        const auto left = readExpression();
+                        const auto right = readExpression();
+                        return make<AssignmentNode>(token, std::make_pair(left, right));
+                    }
+                case AstTag::FUNCTION_DECLARATION:
+                    {
+                        const auto token = readToken();
+                        const auto callNode = readExpression();
+                        const auto colonToken = readOptionalToken();
+                        const auto labelNodes = readNodesAs<LabelNode>();
+                        return make<FunctionDeclarationNode>(token, callNode, colonToken, labelNodes);
+                    }
+                case AstTag::CONSTRUCTOR_DEFINITION:
+                    {
+                        const auto token = readToken();
+                        const auto paramNode = readExpression();
+                        const auto colonToken = readOptionalToken();
+                        const auto labelNodes = readNodesAs<LabelNode>();
+                        const auto bodyNode = readExpression();
+                        return make<ConstructorDefinitionNode>(token, paramNode, colonToken, labelNodes, bodyNode);
+                    }
+                case AstTag::CLASS_DECLARATION:
+                    {
+                        const auto token = readToken();
+                        return make<ClassDeclarationNode>(token, readExpression());
+                    }
+                case AstTag::CLASS_DEFINITION:
+                    {
+                        const auto token = readToken();
+                        const auto nameNode = readExpression();
+                        const auto bodyNode = readExpression();
+                        return make<ClassDefinitionNode>(token, nameNode, bodyNode);
+                    }
+                case AstTag::FUNCTION_CALL:
+                    {
+                        const auto opToken = readToken();
+                        const auto calledNode = readExpression();
+                        const auto argsNode = readExpression();
+                        if (!calledNode)
+                        {
+                            corrupt("function call without callee");
+                        }
+                        return make<FunctionCallNode>(opToken, calledNode, argsNode);
+                    }
+                case AstTag::INFIX:
+                    {
+                        const auto token = readToken();
+                        const auto infixType = readNodeType();
+                        const auto opToken = readToken();
+                        const auto left = readExpression();
+                        const auto right = readExpression();
+                        return make<InfixExpressionNode>(token, infixType, opToken, left, right);
+                    }
+                case AstTag::UNARY:
+                    {
+                        const auto token = readToken();
+                        const auto opToken = readToken();
+                        return make<UnaryExpressionNode>(token, opToken, readExpression());
+                    }
+                case AstTag::EXPRESSION_STATEMENT:
+                    {
+                        const auto token = readToken();
+                        return make<ExpressionStatementNode>(token, readExpression());
+                    }
+                case AstTag::PREFIX:
+                    {
+                        const auto token = readToken();
+                        const auto prefixType = readNodeType();
+                        return make<PrefixExpressionNode>(token, prefixType, readExpression());
+                    }
+                case AstTag::POSTFIX:
+                    {
+                        const auto token = readToken();
+                        const auto postfixType = readNodeType();
+                        return make<PostfixExpressionNode>(token, postfixType, readExpression());
+                    }
+                case AstTag::PAREN_RANGER:
+                    {
+                        const auto startToken = readToken();
+                        const auto endToken = readToken();
+                        return make<ParenRangerNode>(startToken, endToken, readExpression());
+                    }
+                case AstTag::BLOCK_RANGER:
+                    {
+                        const auto startToken = readToken();
+                        const auto endToken = readToken();
+                        return make<BlockRangerNode>(startToken, endToken, readNodesAs<ExpressionNode>());
+                    }
+                case AstTag::FUNCTION_DEFINITION:
+                    {
+                        const auto token = readToken();
+                        const auto callNode = readExpression();
+                        const auto colonToken = readOptionalToken();
+                        const auto labelNodes = readNodesAs<LabelNode>();
+                        const auto indicatorToken = readOptionalToken();
+                        const auto bodyNode = readExpression();
+                        return make<FunctionDefinitionNode>(token, callNode, colonToken, labelNodes,
+                            indicatorToken, bodyNode);
+                    }
+                case AstTag::LABEL:
+                    {
+                        const auto token = readToken();
+                        const auto pathCount = readCount();
+                        if (pathCount == 0)
+                        {
+                            corrupt("empty label path");
+                        }
+                        std::vector<Token> pathTokens;
+                        pathTokens.reserve(pathCount);
+                        for (size_t i = 0; i + 1 < pathCount; i++)
+                        {
+                            pathTokens.emplace_back(token.getLoc(), readString(), token.getType());
+                        }
+                        readString();
+                        pathTokens.push_back(token);
+                        const auto labelNode = makeNode<LabelNode>(_arena, pathTokens);
+                        for (const auto &labelDesNode : readNodesAs<ListExpressionNode>())
+                        {
+                            labelNode->appendLabelDesNode(labelDesNode);
+                        }
+                        return labelNode;
+                    }
+                case AstTag::BRANCH:
+                    {
+                        const auto token = readToken();
+                        const auto conditionNode = readExpression();
+                        const auto bodyNode = readExpression();
+                        return make<BranchNode>(token, conditionNode, bodyNode);
+                    }
+                case AstTag::CONDITION:
+                    {
+                        const auto branchNodes = readNodesAs<ExpressionNode>();
+                        if (branchNodes.empty() || !branchNodes.front())
+                        {
+                            corrupt("condition without branches");
+                        }
+                        return make<ConditionNode>(branchNodes);
+                    }
+                case AstTag::WHILE_LOOP:
+                    {
+                        const auto token = readToken();
+                        const auto conditionNode = readExpression();
+                        const auto bodyNode = readExpression();
+                        return make<WhileLoopNode>(token, conditionNode, bodyNode);
+                    }
+                case AstTag::UNTIL_LOOP:
+                    {
+                        const auto token = readToken();
+                        const auto conditionNode = readExpression();
+                        const auto bodyNode = readExpression();
+                        return make<UntilLoopNode>(token, conditionNode, bodyNode);
+                    }
+                case AstTag::FOR_LOOP:
+                    {
+                        const auto token = readToken();
+                        const auto initNode = readExpression();
+                        const auto conditionNode = readExpression();
+                        const auto updateNode = readExpression();
+                        const auto bodyNode = readExpression();
+                        return make<ForLoopNode>(token, initNode, conditionNode, updateNode, bodyNode);
+                    }
+                case AstTag::PASS:
+                    return make<PassExpressionNode>(readToken());
+                case AstTag::ENCAPSULATED:
+                    return make<EncapsulatedExpressionNode>(readToken());
+                case AstTag::RETURN:
+                    {
+                        const auto token = readToken();
+                        return make<ReturnExpressionNode>(token, readExpression());
+                    }
+                case AstTag::BREAK:
+                    return make<BreakExpressionNode>(readToken());
+                case AstTag::CONTINUE:
+                    return make<ContinueExpressionNode>(readToken());
+                case AstTag::ANON_FUNCTION_DEFINITION:
+                    {
+                        const auto token = readToken();
+                        const auto paramNode = readExpression();
+                        const auto colonToken = readOptionalToken();
+                        const auto labelNodes = readNodesAs<LabelNode>();
+                        const auto indicatorToken = readToken();
+                        const auto bodyNode = readExpression();
+                        return make<AnonFunctionDefinitionNode>(token, paramNode, colonToken, labelNodes,
+                            indicatorToken, bodyNode);
+                    }
+                case AstTag::PAIR:
+                    {
+                        const auto token = readToken();
+                        const auto left = readExpression();
+                        const auto colonToken = readToken();
+                        const auto right = readExpression();
+                        return make<PairExpressionNode>(token, left, colonToken, right);
+                    }
+                case AstTag::DICTIONARY:
+                    {
+                        const auto startToken = readToken();
+                        const auto endToken = readToken();
+                        return make<DictionaryExpressionNode>(startToken, endToken, readExpression());
+                    }
+                case AstTag::LIST:
+                    {
+                        const auto startToken = readToken();
+                        const auto endToken = readToken();
+                        return make<ListExpressionNode>(startToken, endToken, readExpression());
+                    }
+                case AstTag::BRACKET:
+                    {
+                        const auto startToken = readToken();
+                        const auto endToken = readToken();
+                        return make<BracketExpressionNode>(startToken, endToken, readExpression());
+                    }
+                case AstTag::INDEX:
+                    {
+                        const auto token = readToken();
+                        const auto leftNode = readExpression();
+                        const auto indexNode = readExpression();
+                        return make<IndexExpressionNode>(token, leftNode, indexNode);
+                    }
+                case AstTag::TRY:
+                    {
+                        const auto token = readToken();
+                        const auto tryBody = readNodeAs<BlockRangerNode>();
+                        const auto catchCount = readCount();
+                        std::vector<std::pair<std::shared_ptr<IdentifierNode>, std::shared_ptr<BlockRangerNode>>> catchBodies;
+                        catchBodies.reserve(catchCount);
+                        for (size_t i = 0; i < catchCount; i++)
+                        {
+                            const auto identNode = readNodeAs<IdentifierNode>();
+                            const auto catchBody = readNodeAs<BlockRangerNode>();
+                            catchBodies.emplace_back(identNode, catchBody);
+                        }
+                        const auto finallyBody = readNodeAs<BlockRangerNode>();
+                        return make<TryNode>(token, tryBody, catchBodies, finallyBody);
+                    }
+                case AstTag::THROW:
+                    {
+                        const auto token = readToken();
+                        return make<ThrowNode>(token, readExpression());
+                    }
+                default:
+                    corrupt("unknown node tag");
+                }
+            }
+        };
+    }
+
+    std::string AstSerializer::serialize(ProgramNode &program, const uint64_t sourceHash)
+    {
+        AstWriter writer;
+        return writer.finish(program, sourceHash);
+    }
+
+    std::shared_ptr<ProgramNode> AstSerializer::deserialize(const std::string_view data, const uint64_t sourceHash,
+                                                            const std::shared_ptr<AstArena> &arena)
+    {
+        AstReader reader(data, arena);
+        try
+        {
+            if (!reader.readHeader(sourceHash))
+            {
+                return nullptr;
+            }
+        } catch (const std::runtime_error &)
+        {
+            // 文件头不完整视为不匹配，而不是损坏
+            return nullptr;
+        }
+        return reader.readProgram();
+    }
+
+    bool AstCache::isCacheable(const std::string &filepath)
+    {
+        static const std::string libDir = std::filesystem::path(RCC_LIB_DIR).lexically_normal().string();
+        return std::filesystem::path(filepath).lexically_normal().string().starts_with(libDir);
+    }
+
+    std::string AstCache::getCachePath(const std::string &filepath)
+    {
+        return (std::filesystem::path(getCacheDir()) / "ast" / (hashToStr(filepath) + ".rast")).string();
+    }
+
+    std::shared_ptr<ProgramNode> AstCache::load(const lexer::Lexer &lexer)
+    {
+        try
+        {
+            const auto cachePath = getCachePath(lexer.getFilepath());
+            if (!std::filesystem::is_regular_file(cachePath) || std::filesystem::file_size(cachePath) == 0)
+            {
+                return nullptr;
+            }
+            const MappedFile cacheFile(cachePath);
+            const auto program = AstSerializer::deserialize(cacheFile.view(), hashToCode(lexer.getSource()),
+                std::make_shared<AstArena>());
+            if (program)
+            {
+                // 缓存的 Token 只有偏移，行列信息依赖源文件的行表
+                lexer.buildLineIndex();
+            }
+            return program;
+        } catch (...)
+        {
+            return nullptr;
+        }
+    }
+
+    void AstCache::store(const lexer::Lexer &lexer, ProgramNode &program)
+    {
+        try
+        {
+            const auto data = AstSerializer::serialize(program, hashToCode(lexer.getSource()));
+            const std::filesystem::path cachePath = getCachePath(lexer.getFilepath());
+            std::filesystem::create_directories(cachePath.parent_path());
+            // 先写临时文件再整体替换，并发的编译进程不会读到写了一半的缓存
+            auto tempPath = cachePath;
+            tempPath += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+            {
+                std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+                out.write(data.data(), static_cast<std::streamsize>(data.size()));
+                if (!out)
+                {
+                    std::filesystem::remove(tempPath);
+                    return;
+                }
+            }
+            std::filesystem::rename(tempPath, cachePath);
+        } catch (...) {}
+    }
+
+} // ast
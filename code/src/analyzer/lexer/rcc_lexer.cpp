@@ -2,31 +2,105 @@
 // Created by RestRegular on 2025/6/28.
 //
 
-#include <stack>
+#include <algorithm>
+#include <array>
 #include "../../../include/rcc_base.h"
 #include "../../../include/analyzer/rcc_lexer.h"
+#include "../../../include/analyzer/rcc_lexer_kernels.h"
 #include <queue>
-#include <sstream>
 #include <vector>
 
 namespace lexer {
     Lexer::Lexer(const std::string& filepath, const std::string &dirpath)
-        : _filepath(dirpath.empty() ? utils::getAbsolutePath(filepath, utils::getDefaultDir()) : utils::getAbsolutePath(filepath, dirpath)){
-        _filecode = utils::readFile(filepath);
-        splitCodeToLines();
+        : _filepath(dirpath.empty() ? utils::getAbsolutePath(filepath, utils::getDefaultDir()) : utils::getAbsolutePath(filepath, dirpath)),
+          _fileId(utils::SourceFileTable::getInstance().intern(_filepath)),
+          _source(std::make_unique<utils::MappedFile>(_filepath)),
+          _code(_source->view()) {}
+
+    Lexer::Lexer(InMemorySource, const std::string& filepath, const std::string_view source)
+        : _filepath(filepath),
+          _fileId(utils::SourceFileTable::getInstance().intern(_filepath)),
+          _code(source) {}
+
+    Lexer Lexer::fromSource(const std::string& filepath, const std::string_view source)
+    {
+        return {InMemorySource{}, filepath, source};
+    }
+
+    void Lexer::buildLineIndex() const
+    {
+        if (!_lineOffsets.empty())
+        {
+            return;
+        }
+        const std::string_view code = getSource();
+        _lineOffsets.push_back(0);
+        for (size_t i = 0; i < code.size(); i++) {
+            if (code[i] == '\n') {
+                _lineOffsets.push_back(static_cast<uint32_t>(i + 1));
+            } else if (code[i] == '\r') {
+                // "\r\n" 视为一个换行
+                if (i + 1 < code.size() && code[i + 1] == '\n') {
+                    ++i;
+                }
+                _lineOffsets.push_back(static_cast<uint32_t>(i + 1));
+            }
+        }
+        utils::SourceFileTable::getInstance().setLineOffsets(_fileId, _lineOffsets);
+    }
+
+    size_t Lexer::getLineCount() const
+    {
+        buildLineIndex();
+        // 以换行符结尾的文件，最后的空行不计入
+        if (_lineOffsets.size() > 1 && _lineOffsets.back() == getSource().size()) {
+            return _lineOffsets.size() - 1;
+        }
+        return getSource().empty() ? 0 : _lineOffsets.size();
+    }
+
+    std::pair<size_t, size_t> Lexer::getLineColumn(const size_t offset) const
+    {
+        buildLineIndex();
+        const auto it = std::upper_bound(_lineOffsets.begin(), _lineOffsets.end(), offset);
+        const auto lineIndex = static_cast<size_t>(it - _lineOffsets.begin()) - 1;
+        return {lineIndex + 1, offset - _lineOffsets[lineIndex] + 1};
+    }
+
+    utils::SourceLoc Lexer::makeLoc(const size_t offset, const size_t length) const
+    {
+        return {_fileId, static_cast<uint32_t>(offset), static_cast<uint32_t>(length)};
+    }
+
+    utils::Pos Lexer::makePos(const size_t offset, const size_t length) const
+    {
+        buildLineIndex();
+        return utils::Pos(makeLoc(offset, length));
     }
 
     std::vector<std::string> Lexer::getCodeLines() const
     {
-        return _lines;
+        std::vector<std::string> lines;
+        const size_t lineCount = getLineCount();
+        lines.reserve(lineCount);
+        for (size_t i = 1; i <= lineCount; i++) {
+            lines.push_back(getCodeLine(static_cast<int>(i)));
+        }
+        return lines;
     }
 
     std::string Lexer::getCodeLine(const int& rowIndex) const
     {
-        if (rowIndex >= _lines.size() || rowIndex < 0) {
+        if (rowIndex <= 0 || static_cast<size_t>(rowIndex) > getLineCount()) {
             return "";
         }
-        return _lines[rowIndex - 1];
+        const std::string_view code = getSource();
+        const size_t begin = _lineOffsets[rowIndex - 1];
+        size_t end = static_cast<size_t>(rowIndex) < _lineOffsets.size() ? _lineOffsets[rowIndex] : code.size();
+        while (end > begin && (code[end - 1] == '\n' || code[end - 1] == '\r')) {
+            --end;
+        }
+        return std::string(code.substr(begin, end - begin));
     }
 
     std::string Lexer::getCodeLine(const utils::Pos& pos) const
@@ -35,10 +109,7 @@ namespace lexer {
         {
             return "";
         }
-        if (_lines.empty() || pos.getLine() > _lines.size()) {
-            return "";
-        }
-        return _lines[pos.getLine() - 1];
+        return getCodeLine(static_cast<int>(pos.getLine()));
     }
 
     std::string Lexer::getFilepath() const
@@ -46,211 +117,400 @@ namespace lexer {
         return _filepath;
     }
 
-    void Lexer::splitCodeToLines()
+    uint32_t Lexer::getFileId() const
     {
-        const std::string &code = utils::readFile(_filepath);
-        std::stringstream ss(code);
-        std::string line;
-        while (std::getline(ss, line)) {
-            _lines.push_back(line);
-        }
+        return _fileId;
     }
 
-    std::queue<std::shared_ptr<core::Token>>
-    Lexer::tokenize()
+    std::string_view Lexer::getSource() const
     {
-        if (!tokens.empty())
-        {
-            return tokens;
-        }
-        size_t row = 1, column = 0;
-        std::vector tempTokens {
-            std::make_shared<core::Token>(utils::Pos(1, 0, 0, _filepath))
+        return _code;
+    }
+
+    bool Lexer::lastIsNewLine(const bool acceptCarriageReturn) const
+    {
+        const std::string_view last = _cursor.pending.empty() ? _cursor.lastReleased : _cursor.pending.back().text;
+        return last == "\n" || (acceptCarriageReturn && last == "\r");
+    }
+
+    bool Lexer::isSyncState() const
+    {
+        // 可能作为组合符号首字符的字符，处于这些组合状态时下一个字符的处理依赖前文
+        static const std::array<bool, 256> GROUP_PREFIX = [] {
+            std::array<bool, 256> table{};
+            for (const auto &sign : base::GROUP_SIGNS) {
+                table[static_cast<unsigned char>(sign[0])] = true;
+            }
+            return table;
+        }();
+        return _cursor.commentType == core::CommentType::NONE && _cursor.quoteChar == '\0'
+            && !_cursor.needEscape && _cursor.tEnd == _cursor.tBegin
+            && !GROUP_PREFIX[static_cast<unsigned char>(_cursor.groupSign)] && lastIsNewLine(true);
+    }
+
+    void Lexer::scanChar(size_t &i)
+    {
+        static constexpr std::string_view NEWLINE_TEXT = "\n";
+        const std::string_view code = getSource();
+        auto &[index, tBegin, tEnd, groupSign, quoteChar, quoteOffset,
+            needEscape, finished, commentType, pending, lastReleased, trackSync, syncPoints] = _cursor;
+
+        const auto appendText = [&](const size_t at) {
+            if (tBegin == tEnd) {
+                tBegin = at;
+            }
+            tEnd = at + 1;
         };
-        std::stringstream t;
-        std::string groupSign;
-        std::stack<core::Token> quoteStack;
-        bool needEscape = false;
-        auto commentType = core::CommentType::NONE;
-        static std::unordered_set operatorChars {
-                ' ', '\n', '\r', '+', '-', '*', '/', '%', '(', ')',
-                '[', ']', '{', '}', ':', ';', ',', '.', '=',
-                '<', '>', '&', '!', '|', '?', '~', '^', '@'
+        const auto clearText = [&] { tBegin = tEnd = 0; };
+        const auto pushText = [&] {
+            const std::string_view text = code.substr(tBegin, tEnd - tBegin);
+            pending.push_back({text, tBegin, core::classifyLexeme(text)});
+            clearText();
         };
 
-        for (size_t i = 0; i < _filecode.size(); i++) {
-            const char &c = _filecode[i];
-            column ++;
-
-            // 处理转义字符
-            if (needEscape)
-            {
-                t << c;
-                needEscape = false;
-                continue;
-                // throw base::RCCSyntaxError::illegalEscapeCharError(
-                //         utils::Pos(row, column, 1, _filepath).getFilePosStr(), RCC_UNKNOWN_CONST, c);
-            }
+        const char &c = code[i];
 
-            // 处理操作符字符
-            if (operatorChars.contains(c)) {
-                if (quoteStack.empty()) {
-                    // 处理小数
-                    if (c == '.' && t.tellp() > 0 && utils::isValidNumber(t.str()) && commentType == core::CommentType::NONE) {
-                        t << c;
-                        for (++i; i < _filecode.size() && std::isdigit(_filecode[i]); ++i) {
-                            t << _filecode[i];
-                            column ++;
-                        }
-                        --i;
-                        continue;
+        // 处理转义字符
+        if (needEscape)
+        {
+            appendText(i);
+            needEscape = false;
+            return;
+        }
+
+        // 批量跳过不会改变扫描状态的字符序列，剩余字符仍逐个处理
+        if (quoteChar != '\0') {
+            if (const size_t stop = kernels::findStringStop(code, i); stop > i) {
+                appendText(i);
+                tEnd = stop;
+                i = stop - 1;
+                return;
+            }
+        } else if (commentType == core::CommentType::SINGLE_LINE_COMMENT) {
+            if (const size_t stop = kernels::findLineCommentStop(code, i); stop > i) {
+                i = stop - 1;
+                return;
+            }
+        } else if (commentType == core::CommentType::DOC_COMMENT) {
+            if (const size_t stop = kernels::findDocCommentStop(code, i); stop > i) {
+                // 被跳过的操作符字符只会改写组合符号状态，且都无法与停止字符组合
+                for (size_t j = stop; j > i; --j) {
+                    if (kernels::isOperatorChar(code[j - 1])) {
+                        groupSign = '\0';
+                        break;
                     }
+                }
+                i = stop - 1;
+                return;
+            }
+        } else if (kernels::isIdentifierChar(c)) {
+            const size_t stop = kernels::skipIdentifier(code, i);
+            appendText(i);
+            tEnd = stop;
+            groupSign = '\0';
+            i = stop - 1;
+            return;
+        } else if (c == ' ') {
+            if (tEnd > tBegin) {
+                pushText();
+            }
+            groupSign = ' ';
+            i = kernels::skipWhitespace(code, i) - 1;
+            return;
+        }
 
-                    if (t.tellp() > 0 && commentType == core::CommentType::NONE) {
-                        tempTokens.emplace_back(std::make_shared<core::Token>(utils::Pos(row, column - t.str().size(), t.str().size(), _filepath), t.str()));
-                        t.str("");
-                        t.clear();
+        // 处理操作符字符
+        if (kernels::isOperatorChar(c)) {
+            if (quoteChar == '\0') {
+                // 处理小数
+                if (c == '.' && tEnd > tBegin && utils::isValidNumber(code.substr(tBegin, tEnd - tBegin))
+                    && commentType == core::CommentType::NONE) {
+                    appendText(i);
+                    for (++i; i < code.size() && std::isdigit(static_cast<unsigned char>(code[i])); ++i) {
+                        appendText(i);
                     }
+                    --i;
+                    return;
+                }
 
-                    // 处理负数
-                    if (c == '-' && t.tellp() == 0 && commentType == core::CommentType::NONE) {
-                        std::stringstream t_;
-                        t_ << c;
-                        for (size_t j = i + 1; j < _filecode.size() && std::isdigit(_filecode[j]); ++j) {
-                            t_ << _filecode[j];
-                        }
-                        if (std::string numStr = t_.str();
-                            numStr.size() > 1 && utils::isValidNumber(numStr)) {
-                            i += numStr.size() - 1;
-                            tempTokens.emplace_back(std::make_shared<core::Token>(utils::Pos(row, column, numStr.size(), _filepath), numStr));
-                            column += numStr.size() - 1;
-                            continue;
-                        }
+                if (tEnd > tBegin && commentType == core::CommentType::NONE) {
+                    pushText();
+                }
+
+                // 处理负数
+                if (c == '-' && tEnd == tBegin && commentType == core::CommentType::NONE) {
+                    size_t j = i + 1;
+                    while (j < code.size() && std::isdigit(static_cast<unsigned char>(code[j]))) {
+                        ++j;
+                    }
+                    if (j - i > 1) {
+                        pending.push_back({code.substr(i, j - i), i, core::TokenType::TOKEN_INTEGER});
+                        i = j - 1;
+                        return;
                     }
+                }
 
-                    if (c == ';') {
-                        if (tempTokens.empty() || tempTokens.back()->getValue() != "\n") {
-                            tempTokens.emplace_back(std::make_shared<core::Token>(utils::Pos(row, column, 1, _filepath), "\n"));
-                        }
-                    } else if (c != ' ' && commentType == core::CommentType::NONE) {
-                        if ((c != '\n' && c != '\r') || tempTokens.empty() || (tempTokens.back()->getValue() != "\n" &&
-                            tempTokens.back()->getValue() != "\r")) {
-                            tempTokens.emplace_back(std::make_shared<core::Token>(utils::Pos(row, column, 1, _filepath), std::string(1, c)));
-                        }
+                if (c == ';') {
+                    if (!lastIsNewLine(false)) {
+                        pending.push_back({NEWLINE_TEXT, i, core::TokenType::TOKEN_NEWLINE});
                     }
+                } else if (c != ' ' && commentType == core::CommentType::NONE) {
+                    if ((c != '\n' && c != '\r') || !lastIsNewLine(true)) {
+                        const std::string_view text = code.substr(i, 1);
+                        pending.push_back({text, i, core::lookupSymbolType(text)});
+                    }
+                }
 
-                    // 处理组合符号
-                    if (groupSign.empty()) {
-                        groupSign = c;
-                    } else if (base::GROUP_SIGNS.contains(groupSign + c)) {
-                        groupSign += c;
+                // 处理组合符号
+                if (groupSign == '\0') {
+                    groupSign = c;
+                } else if (const auto it = base::GROUP_SIGNS.find(std::string{groupSign, c});
+                    it != base::GROUP_SIGNS.end()) {
+                    const std::string &sign = *it;
+                    if (commentType == core::CommentType::NONE) {
+                        pending.resize(pending.size() >= 2 ? pending.size() - 2 : 0);
+                    }
+                    if (sign == "//" && commentType == core::CommentType::NONE) {
+                        commentType = core::CommentType::SINGLE_LINE_COMMENT;
+                    } else if (sign == "/*") {
                         if (commentType == core::CommentType::NONE) {
-                            if (tempTokens.size() >= 2) {
-                                tempTokens.resize(tempTokens.size() - 2);
+                            if (tEnd > tBegin) {
+                                pushText();
                             }
+                            commentType = core::CommentType::DOC_COMMENT;
                         }
-                        if (groupSign == "//" && commentType == core::CommentType::NONE) {
-                            commentType = core::CommentType::SINGLE_LINE_COMMENT;
-                        } else if (groupSign == "/*") {
-                            if (commentType == core::CommentType::NONE) {
-                                if (t.tellp() > 0) {
-                                    tempTokens.emplace_back(std::make_shared<core::Token>(utils::Pos(row, column - t.str().size(), t.str().size(), _filepath), t.str()));
-                                    t.str("");
-                                    t.clear();
-                                }
-                                commentType = core::CommentType::DOC_COMMENT;
-                            }
-                        } else if (groupSign == "*/") {
-                            if (commentType == core::CommentType::NONE) {
-                                throw base::RCCSyntaxError::illegalSymbolError(
-                                    utils::Pos(row, column, groupSign.size(), _filepath).toString(), RCC_UNKNOWN_CONST, groupSign);
-                            }
-                            t.str("");
-                            t.clear();
-                            if (commentType == core::CommentType::DOC_COMMENT) {
-                                commentType = core::CommentType::NONE;
-                            }
-                        } else if (commentType == core::CommentType::NONE) {
-                            tempTokens.emplace_back(std::make_shared<core::Token>(utils::Pos(row, column - (groupSign.size() - 1), groupSign.size(), _filepath), groupSign));
+                    } else if (sign == "*/") {
+                        if (commentType == core::CommentType::NONE) {
+                            throw base::RCCSyntaxError::illegalSymbolError(
+                                makePos(i, sign.size()).toString(), RCC_UNKNOWN_CONST, sign);
+                        }
+                        clearText();
+                        if (commentType == core::CommentType::DOC_COMMENT) {
+                            commentType = core::CommentType::NONE;
                         }
-                        groupSign.clear();
-                    } else {
-                        groupSign = std::string(1, c);
+                    } else if (commentType == core::CommentType::NONE) {
+                        // 组合符号的文本直接引用 GROUP_SIGNS 中的常量字符串
+                        pending.push_back({sign, i - (sign.size() - 1), core::lookupSymbolType(sign)});
                     }
+                    groupSign = '\0';
+                } else {
+                    groupSign = c;
+                }
 
-                    // 处理换行符
-                    if (c == '\n' || c == '\r') {
-                        if (commentType == core::CommentType::SINGLE_LINE_COMMENT) {
-                            t.str("");
-                            t.clear();
-                            if (tempTokens.empty() || tempTokens.back()->getValue() != "\n") {
-                                tempTokens.emplace_back(std::make_shared<core::Token>(utils::Pos(row, column, 1, _filepath), "\n"));
-                            }
-                            commentType = core::CommentType::NONE;
+                // 处理换行符
+                if (c == '\n' || c == '\r') {
+                    if (commentType == core::CommentType::SINGLE_LINE_COMMENT) {
+                        clearText();
+                        if (!lastIsNewLine(false)) {
+                            pending.push_back({NEWLINE_TEXT, i, core::TokenType::TOKEN_NEWLINE});
                         }
-                        ++row;
-                        column = 0;
+                        commentType = core::CommentType::NONE;
                     }
-                    continue;
                 }
+                return;
             }
+        }
 
-            // 处理转义字符
-            if (!quoteStack.empty() && c == '\\') {
-                needEscape = true;
-                t << c;
-                continue;
-            }
+        // 处理转义字符
+        if (quoteChar != '\0' && c == '\\') {
+            needEscape = true;
+            appendText(i);
+            return;
+        }
 
-            if (quoteStack.empty()) {
-                if (c != ' ' && c != '\n' && c != '\r' && c != '\t' && commentType == core::CommentType::NONE) {
-                    t << c;
-                    if (!groupSign.empty()) groupSign.clear();
-                }
+        if (quoteChar == '\0') {
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t' && commentType == core::CommentType::NONE) {
+                appendText(i);
+                groupSign = '\0';
+            } else if (c == '\t' && tEnd > tBegin && commentType == core::CommentType::NONE) {
+                // 制表符同样作为词素分隔符
+                pushText();
             }
-            else {
-                // 处理字符串
-                if (c == '\n' || c == '\t' || c == '\r') {
-                    throw base::RCCSyntaxError::undefinedExpressionError(
-                            utils::Pos(row, column, 0, _filepath).toString(), RCC_UNKNOWN_CONST);
-                }
-                t << c;
+        }
+        else {
+            // 处理字符串
+            if (c == '\n' || c == '\t' || c == '\r') {
+                throw base::RCCSyntaxError::undefinedExpressionError(
+                        makePos(i, 0).toString(), RCC_UNKNOWN_CONST);
             }
+            appendText(i);
+        }
 
-            // 引号匹配
-            if ((c == '"' || c == '\'') && commentType == core::CommentType::NONE) {
-                if (quoteStack.empty()) {
-                    quoteStack.emplace(utils::Pos(row, column, 1, _filepath), std::string{c});
-                } else if (quoteStack.top().getValue()[0] == c) {
-                    quoteStack.pop();
-                }
+        // 引号匹配
+        if ((c == '"' || c == '\'') && commentType == core::CommentType::NONE) {
+            if (quoteChar == '\0') {
+                quoteChar = c;
+                quoteOffset = i;
+            } else if (quoteChar == c) {
+                quoteChar = '\0';
             }
         }
+    }
+
+    void Lexer::finishScan()
+    {
+        static constexpr std::string_view NEWLINE_TEXT = "\n";
+        const std::string_view code = getSource();
+        auto &cursor = _cursor;
 
         // 处理未闭合的引号
-        if (!quoteStack.empty()) {
+        if (cursor.quoteChar != '\0') {
             throw base::RCCSyntaxError::unclosedQuoteError(
-                utils::Pos(row, column + 1, 0, _filepath).toString(), quoteStack.top().getPosString(), RCC_UNKNOWN_CONST, quoteStack.top().getValue()[0]);
+                makePos(code.size(), 0).toString(), makePos(cursor.quoteOffset, 1).toString(),
+                RCC_UNKNOWN_CONST, cursor.quoteChar);
         }
 
         // 处理剩余的文本
-        if (!t.str().empty() && commentType == core::CommentType::NONE) {
-            tempTokens.emplace_back(std::make_shared<core::Token>(utils::Pos(row, column - t.str().size() + 1, t.str().size(), _filepath), t.str()));
+        if (cursor.tEnd > cursor.tBegin && cursor.commentType == core::CommentType::NONE) {
+            const std::string_view text = code.substr(cursor.tBegin, cursor.tEnd - cursor.tBegin);
+            cursor.pending.push_back({text, cursor.tBegin, core::classifyLexeme(text)});
         }
 
         // 确保 token 列表最后一个是 '\n'
-        if (tempTokens.empty() || (tempTokens.back()->getValue() != "\n" && tempTokens.back()->getValue() != "\r")) {
-            tempTokens.emplace_back(std::make_shared<core::Token>(utils::Pos(row, column + 1, 1, _filepath), "\n"));
+        if (!lastIsNewLine(true)) {
+            cursor.pending.push_back({NEWLINE_TEXT, code.size(), core::TokenType::TOKEN_NEWLINE});
         }
+        cursor.finished = true;
+    }
 
-        // 将 vector 转换为 queue
-        for (const auto& token : tempTokens) {
-            tokens.push(token);
+    void Lexer::rewind()
+    {
+        const bool trackSync = _cursor.trackSyncPoints;
+        _cursor = {};
+        _cursor.trackSyncPoints = trackSync;
+    }
+
+    void Lexer::rewind(const size_t offset, const char newline)
+    {
+        static constexpr std::string_view NEWLINE_TEXTS = "\n\r";
+        rewind();
+        _cursor.index = offset;
+        _cursor.lastReleased = NEWLINE_TEXTS.substr(newline == '\r' ? 1 : 0, 1);
+    }
+
+    void Lexer::trackSyncPoints(const bool enable)
+    {
+        _cursor.trackSyncPoints = enable;
+        _cursor.syncPoints.clear();
+    }
+
+    bool Lexer::isSyncPoint(const size_t offset)
+    {
+        auto &syncPoints = _cursor.syncPoints;
+        while (!syncPoints.empty() && syncPoints.front() < offset) {
+            syncPoints.pop_front();
         }
+        return !syncPoints.empty() && syncPoints.front() == offset;
+    }
 
+    bool Lexer::scanNext(TokenView &view)
+    {
+        const size_t size = getSource().size();
+        while (!_cursor.finished && _cursor.pending.size() <= SCAN_WINDOW) {
+            if (_cursor.index < size) {
+                if (_cursor.trackSyncPoints && isSyncState()
+                    && (_cursor.syncPoints.empty() || _cursor.syncPoints.back() != _cursor.index)) {
+                    _cursor.syncPoints.push_back(_cursor.index);
+                }
+                scanChar(_cursor.index);
+                ++_cursor.index;
+            } else {
+                finishScan();
+            }
+        }
+        if (_cursor.pending.empty()) {
+            return false;
+        }
+        view = _cursor.pending.front();
+        _cursor.lastReleased = view.text;
+        _cursor.pending.pop_front();
+        return true;
+    }
+
+    const std::vector<TokenView> &Lexer::scan()
+    {
+        if (_scanned)
+        {
+            return _views;
+        }
+        // 词素平均长度远大于 4 字节，按此预留可避免扫描过程中的反复扩容
+        _views.reserve(getSource().size() / 4 + 2);
+        rewind();
+        for (TokenView view; scanNext(view);) {
+            _views.push_back(view);
+        }
+        _scanned = true;
+        return _views;
+    }
+
+    std::shared_ptr<core::Token> Lexer::makeToken(const TokenView &view) const
+    {
+        return makeToken(view, makeLoc(view.offset, view.text.size()));
+    }
+
+    std::shared_ptr<core::Token> Lexer::makeToken(const TokenView &view, const utils::SourceLoc &loc)
+    {
+        // 类型已在扫描时确定；字符串字面量的值保留外层引号并转义其内容
+        std::string value = view.type == core::TokenType::TOKEN_STRING
+            ? utils::StringManager::toStringFormat(std::string(view.text.substr(1, view.text.size() - 2)))
+            : std::string(view.text);
+        return std::make_shared<core::Token>(loc, std::move(value), view.type);
+    }
+
+    std::shared_ptr<TokenSource> Lexer::tokenStream()
+    {
+        buildLineIndex();
+        rewind();
+        return std::make_shared<LexerTokenSource>(*this);
+    }
+
+    std::queue<std::shared_ptr<core::Token>>
+    Lexer::tokenize()
+    {
+        if (!tokens.empty())
+        {
+            return tokens;
+        }
+        // Token 只记录偏移，行列号由登记到源文件表中的行表换算
+        buildLineIndex();
+        tokens.push(std::make_shared<core::Token>(utils::Pos(1, 0, 0, _filepath)));
+        for (const auto &view : scan()) {
+            tokens.push(makeToken(view));
+        }
         return tokens;
     }
 
+    QueueTokenSource::QueueTokenSource(std::queue<std::shared_ptr<core::Token>> tokens)
+        : _tokens(std::move(tokens)) {}
+
+    std::shared_ptr<core::Token> QueueTokenSource::next()
+    {
+        if (_tokens.empty())
+        {
+            return nullptr;
+        }
+        auto token = std::move(_tokens.front());
+        _tokens.pop();
+        return token;
+    }
+
+    LexerTokenSource::LexerTokenSource(Lexer &lexer)
+        : _lexer(lexer) {}
+
+    std::shared_ptr<core::Token> LexerTokenSource::next()
+    {
+        if (!_programEmitted)
+        {
+            _programEmitted = true;
+            return std::make_shared<core::Token>(utils::Pos(1, 0, 0, _lexer.getFilepath()));
+        }
+        if (TokenView view; _lexer.scanNext(view))
+        {
+            return _lexer.makeToken(view);
+        }
+        return nullptr;
+    }
+
     void enableDebugMode(bool cond)
     {
 
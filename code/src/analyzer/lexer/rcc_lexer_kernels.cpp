@@ -0,0 +1,161 @@
+//
+// Created by RestRegular on 2025/6/28.
+//
+
+#include "../../../include/analyzer/rcc_lexer_kernels.h"
+
+#if defined(__AVX2__)
+#define RCC_LEXER_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RCC_LEXER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace lexer::kernels {
+
+    namespace {
+
+#if defined(RCC_LEXER_AVX2) || defined(RCC_LEXER_SSE2)
+        inline unsigned countTrailingZeros(const uint32_t mask)
+        {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+        }
+#endif
+
+#if defined(RCC_LEXER_AVX2)
+        using Vec = __m256i;
+        constexpr size_t VEC_WIDTH = 32;
+        inline Vec load(const char *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+        inline Vec splat(const char c) { return _mm256_set1_epi8(c); }
+        inline Vec eq(const Vec v, const char c) { return _mm256_cmpeq_epi8(v, splat(c)); }
+        // 有符号比较，非 ASCII 字节视为负数
+        inline Vec greater(const Vec v, const char c) { return _mm256_cmpgt_epi8(v, splat(c)); }
+        inline Vec less(const Vec v, const char c) { return _mm256_cmpgt_epi8(splat(c), v); }
+        inline Vec vor(const Vec a, const Vec b) { return _mm256_or_si256(a, b); }
+        inline Vec vand(const Vec a, const Vec b) { return _mm256_and_si256(a, b); }
+        inline uint32_t bits(const Vec v) { return static_cast<uint32_t>(_mm256_movemask_epi8(v)); }
+        constexpr uint32_t FULL_MASK = 0xFFFFFFFFu;
+#elif defined(RCC_LEXER_SSE2)
+        using Vec = __m128i;
+        constexpr size_t VEC_WIDTH = 16;
+        inline Vec load(const char *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+        inline Vec splat(const char c) { return _mm_set1_epi8(c); }
+        inline Vec eq(const Vec v, const char c) { return _mm_cmpeq_epi8(v, splat(c)); }
+        // 有符号比较，非 ASCII 字节视为负数
+        inline Vec greater(const Vec v, const char c) { return _mm_cmpgt_epi8(v, splat(c)); }
+        inline Vec less(const Vec v, const char c) { return _mm_cmplt_epi8(v, splat(c)); }
+        inline Vec vor(const Vec a, const Vec b) { return _mm_or_si128(a, b); }
+        inline Vec vand(const Vec a, const Vec b) { return _mm_and_si128(a, b); }
+        inline uint32_t bits(const Vec v) { return static_cast<uint32_t>(_mm_movemask_epi8(v)); }
+        constexpr uint32_t FULL_MASK = 0xFFFFu;
+#endif
+
+        // 向量化主循环按块求出停止字符掩码，尾部不足一个块的部分由查表逐字节处理
+        template <typename BlockMask>
+        size_t scanUntil(const std::string_view code, size_t pos, const CharClass stopClass,
+                         const bool stopWhenMatched, [[maybe_unused]] BlockMask blockMask)
+        {
+            const char *data = code.data();
+            const size_t size = code.size();
+#if defined(RCC_LEXER_AVX2) || defined(RCC_LEXER_SSE2)
+            for (; pos + VEC_WIDTH <= size; pos += VEC_WIDTH) {
+                if (const uint32_t mask = blockMask(load(data + pos))) {
+                    return pos + countTrailingZeros(mask);
+                }
+            }
+#endif
+            for (; pos < size; ++pos) {
+                if (hasClass(data[pos], stopClass) == stopWhenMatched) {
+                    return pos;
+                }
+            }
+            return size;
+        }
+    }
+
+    size_t skipIdentifier(const std::string_view code, const size_t pos)
+    {
+        return scanUntil(code, pos, CC_IDENTIFIER, false, [](const auto v) {
+#if defined(RCC_LEXER_AVX2) || defined(RCC_LEXER_SSE2)
+            const Vec lower = vor(v, splat(0x20));
+            const Vec letter = vand(greater(lower, 'a' - 1), less(lower, 'z' + 1));
+            const Vec digit = vand(greater(v, '0' - 1), less(v, '9' + 1));
+            const Vec ident = vor(vor(letter, digit), eq(v, '_'));
+            // 最高位为 1 的字节（非 ASCII）同样视为标识符字符
+            return ~(bits(ident) | bits(v)) & FULL_MASK;
+#else
+            return 0u;
+#endif
+        });
+    }
+
+    size_t skipWhitespace(const std::string_view code, const size_t pos)
+    {
+        return scanUntil(code, pos, CC_WHITESPACE, false, [](const auto v) {
+#if defined(RCC_LEXER_AVX2) || defined(RCC_LEXER_SSE2)
+            return ~bits(vor(eq(v, ' '), eq(v, '\t'))) & FULL_MASK;
+#else
+            return 0u;
+#endif
+        });
+    }
+
+    size_t findLineCommentStop(const std::string_view code, const size_t pos)
+    {
+        return scanUntil(code, pos, CC_LINE_COMMENT_STOP, true, [](const auto v) {
+#if defined(RCC_LEXER_AVX2) || defined(RCC_LEXER_SSE2)
+            return bits(vor(vor(eq(v, '\n'), eq(v, '\r')), eq(v, ';')));
+#else
+            return 0u;
+#endif
+        });
+    }
+
+    size_t findDocCommentStop(const std::string_view code, const size_t pos)
+    {
+        return scanUntil(code, pos, CC_DOC_COMMENT_STOP, true, [](const auto v) {
+#if defined(RCC_LEXER_AVX2) || defined(RCC_LEXER_SSE2)
+            const Vec groupChar = vor(vor(eq(v, '*'), eq(v, '/')), eq(v, '.'));
+            return bits(vor(groupChar, eq(v, ';')));
+#else
+            return 0u;
+#endif
+        });
+    }
+
+    size_t findStringStop(const std::string_view code, const size_t pos)
+    {
+        return scanUntil(code, pos, CC_STRING_STOP, true, [](const auto v) {
+#if defined(RCC_LEXER_AVX2) || defined(RCC_LEXER_SSE2)
+            const Vec quote = vor(eq(v, '"'), eq(v, '\''));
+            const Vec control = vor(vor(eq(v, '\n'), eq(v, '\r')), eq(v, '\t'));
+            return bits(vor(vor(quote, eq(v, '\\')), control));
+#else
+            return 0u;
+#endif
+        });
+    }
+
+    const char *activeKernelName()
+    {
+#if defined(RCC_LEXER_AVX2)
+        return "avx2";
+#elif defined(RCC_LEXER_SSE2)
+        return "sse2";
+#else
+        return "scalar";
+#endif
+    }
+
+} // lexer::kernels
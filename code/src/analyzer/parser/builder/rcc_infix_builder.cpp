@@ -61,21 +61,21 @@ namespace parser {
             } else
             {
                 const auto &expression = buildExpression(Precedence::LOWEST);
-                right = std::make_shared<ReturnExpressionNode>(expression->getMainToken(), expression);
+                right = makeNode<ReturnExpressionNode>(expression->getMainToken(), expression);
                 skipNextNewLineToken();
             }
-            return std::make_shared<AnonFunctionDefinitionNode>(opToken, left, nullptr, std::vector<std::shared_ptr<LabelNode>>{}, opToken, right);
+            return makeNode<AnonFunctionDefinitionNode>(opToken, left, nullptr, std::vector<std::shared_ptr<LabelNode>>{}, opToken, right);
         }
         right = buildExpression(precedence);
-        return std::make_shared<InfixExpressionNode>(opToken, it->second, opToken, left, right);
+        return makeNode<InfixExpressionNode>(opToken, it->second, opToken, left, right);
     }
 
     ExpressionNodePtr Parser::buildAssignExpression(const ExpressionNodePtr &left){
-        const auto &opToken = currentToken();
+        const auto opToken = currentToken();
         const auto &precedence = currentTokenPrecedence();
         next();
         const auto &right = buildExpression(precedence);
-        return std::make_shared<AssignmentNode>(opToken, std::pair{left, right});
+        return makeNode<AssignmentNode>(opToken, std::pair{left, right});
     }
 
     ExpressionNodePtr Parser::buildCompoundExpression(const ExpressionNodePtr &left){
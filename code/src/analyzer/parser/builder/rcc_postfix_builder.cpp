@@ -20,7 +20,7 @@ namespace parser {
                 + " or " + getTokenTypeName(TokenType::TOKEN_DOUBLE_MINUS));
             return nullptr;
         }
-        return std::make_shared<PostfixExpressionNode>(currentToken(), it->second, left);
+        return makeNode<PostfixExpressionNode>(currentToken(), it->second, left);
     }
 
     ExpressionNodePtr Parser::buildCallExpression(const ExpressionNodePtr &left){
@@ -34,12 +34,12 @@ namespace parser {
         }
         const auto &mainToken = left->getMainToken();
         const auto &expression = buildRangerExpression();
-        return std::make_shared<FunctionCallNode>(mainToken, left, expression);
+        return makeNode<FunctionCallNode>(mainToken, left, expression);
     }
 
     ExpressionNodePtr Parser::buildIndexExpression(const ExpressionNodePtr &left) {
         if (!left) return nullptr;
         auto bracketNode = buildBracketExpression();
-        return std::make_shared<IndexExpressionNode>(left->getMainToken(), left, bracketNode);
+        return makeNode<IndexExpressionNode>(left->getMainToken(), left, bracketNode);
     }
 }
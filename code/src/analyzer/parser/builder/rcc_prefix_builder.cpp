@@ -30,7 +30,7 @@ namespace parser {
             recordSyntaxError(recordToken, currentToken(), "Expected expression");
             return nullptr;
         }
-        return std::make_shared<PrefixExpressionNode>(recordToken, it->second, expression);
+        return makeNode<PrefixExpressionNode>(recordToken, it->second, expression);
     }
 
     ExpressionNodePtr Parser::buildUnaryExpression() {
@@ -38,34 +38,34 @@ namespace parser {
         const auto &precedence = currentTokenPrecedence();
         next();
         const auto &expression = buildExpression(precedence);
-        return std::make_shared<UnaryExpressionNode>(opToken, opToken, expression);
+        return makeNode<UnaryExpressionNode>(opToken, opToken, expression);
     }
 
     ExpressionNodePtr Parser::buildIntegerExpression() {
-        return std::make_shared<IntegerLiteralNode>(currentToken());
+        return makeNode<IntegerLiteralNode>(currentToken());
     }
 
     ExpressionNodePtr Parser::buildBoolExpression(){
-        return std::make_shared<BooleanLiteralNode>(currentToken());
+        return makeNode<BooleanLiteralNode>(currentToken());
     }
 
     ExpressionNodePtr Parser::buildBreakExpression(){
-        return std::make_shared<BreakExpressionNode>(currentToken());
+        return makeNode<BreakExpressionNode>(currentToken());
     }
 
     ExpressionNodePtr Parser::buildClassExpression(){
-        const auto &classToken = currentToken();
+        const auto classToken = currentToken();
         next();
         auto nameNode = buildExpression(Precedence::LOWEST);
         if (nextTokenIs(TokenType::TOKEN_NEWLINE)) {
-            return std::make_shared<ClassDeclarationNode>(classToken, nameNode);
+            return makeNode<ClassDeclarationNode>(classToken, nameNode);
         }
         if (!expectedNextTokenAndConsume(TokenType::TOKEN_LBRACE)) {
             recordUnexpectedTokenTypeError(nextToken(), TokenType::TOKEN_LBRACE);
             return nullptr;
         }
         auto bodyNode = buildBraceExpression();
-        return std::make_shared<ClassDefinitionNode>(classToken, nameNode, bodyNode);
+        return makeNode<ClassDefinitionNode>(classToken, nameNode, bodyNode);
     }
 
     ExpressionNodePtr Parser::buildContinueExpression(){
@@ -73,7 +73,7 @@ namespace parser {
     }
 
     ExpressionNodePtr Parser::buildFloatExpression(){
-        return std::make_shared<FloatLiteralNode>(currentToken());
+        return makeNode<FloatLiteralNode>(currentToken());
     }
 
     ExpressionNodePtr Parser::buildFunctionExpression(){
@@ -110,7 +110,7 @@ namespace parser {
                         = std::static_pointer_cast<AnonFunctionDefinitionNode>(
                             callFuncNode->getRightNode()))
                     {
-                        return std::make_shared<FunctionDefinitionNode>(funToken, callNode, colonToken, labelNodes,
+                        return makeNode<FunctionDefinitionNode>(funToken, callNode, colonToken, labelNodes,
                             std::make_shared<Token>(funcDefNode->getIndicatorToken()),
                             funcDefNode->getBodyNode());
                     }
@@ -120,12 +120,12 @@ namespace parser {
             {
                 if (const auto &funcDefNode = std::static_pointer_cast<InfixExpressionNode>(callNode))
                 {
-                    return std::make_shared<FunctionDefinitionNode>(funToken, funcDefNode->getLeftNode(), colonToken, labelNodes,
+                    return makeNode<FunctionDefinitionNode>(funToken, funcDefNode->getLeftNode(), colonToken, labelNodes,
                         std::make_shared<Token>(funcDefNode->getOpToken()),
                         funcDefNode->getRightNode());
                 }
             }
-            return std::make_shared<FunctionDeclarationNode>(funToken, callNode, colonToken, labelNodes);
+            return makeNode<FunctionDeclarationNode>(funToken, callNode, colonToken, labelNodes);
         }
         std::shared_ptr<Token> indicatorToken = nullptr;
         if (nextTokenIs(TokenType::TOKEN_INDICATOR)){
@@ -138,17 +138,17 @@ namespace parser {
         }
         // 函数定义
         const auto &bodyNode = buildBraceExpression();
-        return std::make_shared<FunctionDefinitionNode>(funToken, callNode, colonToken, labelNodes, indicatorToken, bodyNode);
+        return makeNode<FunctionDefinitionNode>(funToken, callNode, colonToken, labelNodes, indicatorToken, bodyNode);
     }
 
     ExpressionNodePtr Parser::buildIdentifierExpression(){
         // 创建标识符节点，但是需要根据后续节点判断是否为其他节点类型，例如函数调用、函数定义、类定义等
-        const auto &nameToken = currentToken();
+        const auto nameToken = currentToken();
         if (nextTokenIs(TokenType::TOKEN_COLON)) {
             // 为变量添加标签
             next();
             if (nextTokenIs(TokenType::TOKEN_LABEL) || nextTokenIs(TokenType::TOKEN_IDENTIFIER)) {
-                const auto &colonToken = currentToken();
+                const auto colonToken = currentToken();
                 std::vector<std::shared_ptr<LabelNode>> labels{};
                 while (nextTokenIs(TokenType::TOKEN_LABEL) || nextTokenIs(TokenType::TOKEN_IDENTIFIER)) {
                     next();
@@ -158,16 +158,16 @@ namespace parser {
                         labels.push_back(std::static_pointer_cast<LabelNode>(labelNode));
                     }
                 }
-                return std::make_shared<IdentifierNode>(nameToken, colonToken,
-                                                        labels);
+                return makeNode<IdentifierNode>(nameToken, colonToken,
+                                                labels);
             }
             previous();
         }
-        return std::make_shared<IdentifierNode>(nameToken);
+        return makeNode<IdentifierNode>(nameToken);
     }
 
     ExpressionNodePtr Parser::buildIfExpression(){
-        const auto &ifToken = currentToken();
+        const auto ifToken = currentToken();
         next();
         const auto &conditionNode = buildExpression(Precedence::LOWEST);
         if (!nextTokenIs(TokenType::TOKEN_LBRACE)) {
@@ -176,7 +176,7 @@ namespace parser {
         }
         next();
         const auto &bodyNode = buildBraceExpression();
-        return std::make_shared<BranchNode>(ifToken, conditionNode, bodyNode);
+        return makeNode<BranchNode>(ifToken, conditionNode, bodyNode);
     }
 
     ExpressionNodePtr Parser::buildConditionExpression() {
@@ -192,7 +192,7 @@ namespace parser {
             }
             else if (currentTokenIs(TokenType::TOKEN_ELSE)) {
                 // 处理 else 分支
-                const auto &elseToken = currentToken();
+                const auto elseToken = currentToken();
                 next(); // 消耗 ELSE 标记
 
                 if (currentTokenIs(TokenType::TOKEN_IF)) {
@@ -207,10 +207,10 @@ namespace parser {
                 }
 
                 const auto &bodyNode = buildBraceExpression();
-                const auto &elseBranchNode = std::make_shared<BranchNode>(
+                const auto &elseBranchNode = makeNode<BranchNode>(
                     elseToken,
-                    std::make_shared<BooleanLiteralNode>(
-                        Token(elseToken.getPos(), "true")),
+                    makeNode<BooleanLiteralNode>(
+                        Token(elseToken.getPos(), "true", TokenType::TOKEN_TRUE)),
                     bodyNode
                 );
 
@@ -233,7 +233,7 @@ namespace parser {
             next(); // 移动到下一个标记
         }
         if (hasError()) return nullptr;
-        return std::make_shared<ConditionNode>(branchNodes);
+        return makeNode<ConditionNode>(branchNodes);
     }
 
 
@@ -244,7 +244,7 @@ namespace parser {
     ExpressionNodePtr Parser::buildLabelExpression() {
         if (currentTokenIs(TokenType::TOKEN_LABEL) || currentTokenIs(TokenType::TOKEN_IDENTIFIER))
         {
-            const auto &labelNode = std::make_shared<LabelNode>(std::vector{currentToken()});
+            const auto &labelNode = makeNode<LabelNode>(std::vector{currentToken()});
             while (true)
             {
                 if (nextTokenIs(TokenType::TOKEN_LBRACKET)) {
@@ -284,7 +284,7 @@ namespace parser {
     };
 
     ExpressionNodePtr Parser::buildRangerExpression() {
-        const Token& beginToken = currentToken();
+        const Token beginToken = currentToken();
         if (const auto &it = rangerExpressionTypeMap.find(beginToken.getType());
             it == rangerExpressionTypeMap.end()) {
             recordUnexpectedTokenTypeError(beginToken,
@@ -306,7 +306,7 @@ namespace parser {
                 }
             }
             next();
-            rangerNode = std::make_shared<ParenRangerNode>(beginToken, currentToken(), rangerNode);
+            rangerNode = makeNode<ParenRangerNode>(beginToken, currentToken(), rangerNode);
             // 需要检查是否是anno function
             std::vector<std::shared_ptr<LabelNode>> labels{};
             if (nextTokenIs(TokenType::TOKEN_COLON)) {
@@ -315,7 +315,7 @@ namespace parser {
                     const auto &colonToken = std::make_shared<Token>(currentToken());
                     while (nextTokenIs(TokenType::TOKEN_LABEL) || nextTokenIs(TokenType::TOKEN_IDENTIFIER)) {
                         next();
-                        labels.push_back(std::make_shared<LabelNode>(std::vector{currentToken()}));
+                        labels.push_back(makeNode<LabelNode>(std::vector{currentToken()}));
                     }
                     if (nextTokenIs(TokenType::TOKEN_INDICATOR)) {
                         next();
@@ -332,10 +332,10 @@ namespace parser {
                         } else
                         {
                             const auto &expression = buildExpression(Precedence::LOWEST);
-                            bodyNode = std::make_shared<ReturnExpressionNode>(expression->getMainToken(), expression);
+                            bodyNode = makeNode<ReturnExpressionNode>(expression->getMainToken(), expression);
                             skipNextNewLineToken();
                         }
-                        return std::make_shared<AnonFunctionDefinitionNode>(
+                        return makeNode<AnonFunctionDefinitionNode>(
                             indicatorToken, rangerNode,
                             colonToken, labels, indicatorToken, bodyNode);
                     }
@@ -366,30 +366,30 @@ namespace parser {
             recordUnclosedExpressionError(beginToken, currentToken(), TokenType::TOKEN_RBRACE);
             return nullptr;
         }
-        return std::make_shared<BlockRangerNode>(beginToken, currentToken(), nodes);
+        return makeNode<BlockRangerNode>(beginToken, currentToken(), nodes);
     }
 
     ExpressionNodePtr Parser::buildNullExpression(){
-        return std::make_shared<NullLiteralNode>(currentToken());
+        return makeNode<NullLiteralNode>(currentToken());
     }
 
     ExpressionNodePtr Parser::buildReturnExpression(){
-        const auto &returnToken = currentToken();
+        const auto returnToken = currentToken();
         ExpressionNodePtr expression = nullptr;
         if (!nextTokenIs(TokenType::TOKEN_NEWLINE))
         {
             next();
             expression = buildExpression(Precedence::LOWEST);
         }
-        return std::make_shared<ReturnExpressionNode>(returnToken, expression);
+        return makeNode<ReturnExpressionNode>(returnToken, expression);
     }
 
     ExpressionNodePtr Parser::buildStringExpression(){
-        return std::make_shared<StringLiteralNode>(currentToken());
+        return makeNode<StringLiteralNode>(currentToken());
     }
 
     ExpressionNodePtr Parser::buildCharExpression() {
-        return std::make_shared<CharacterLiteralNode>(currentToken());
+        return makeNode<CharacterLiteralNode>(currentToken());
     }
 
     ExpressionNodePtr Parser::buildSuperExpression() {
@@ -401,7 +401,7 @@ namespace parser {
     }
 
     ExpressionNodePtr Parser::buildWhileExpression() {
-        const auto &whileToken = currentToken();
+        const auto whileToken = currentToken();
         next();
         const auto &condition = buildExpression(Precedence::LOWEST);
         if (!nextTokenIs(TokenType::TOKEN_LBRACE)) {
@@ -410,11 +410,11 @@ namespace parser {
         }
         next();
         const auto &body = buildBraceExpression();
-        return std::make_shared<WhileLoopNode>(whileToken, condition, body);
+        return makeNode<WhileLoopNode>(whileToken, condition, body);
     }
 
     ExpressionNodePtr Parser::buildUntilExpression() {
-        const auto &untilToken = currentToken();
+        const auto untilToken = currentToken();
         next();
         const auto &condition = buildExpression(Precedence::LOWEST);
         if (!nextTokenIs(TokenType::TOKEN_LBRACE)) {
@@ -423,19 +423,19 @@ namespace parser {
         }
         next();
         const auto &body = buildBraceExpression();
-        return std::make_shared<UntilLoopNode>(untilToken, condition, body);
+        return makeNode<UntilLoopNode>(untilToken, condition, body);
     }
 
     ExpressionNodePtr Parser::buildPassExpression() {
-        return std::make_shared<PassExpressionNode>(currentToken());
+        return makeNode<PassExpressionNode>(currentToken());
     }
 
     ExpressionNodePtr Parser::buildEncapsulatedExpression() {
-        return std::make_shared<EncapsulatedExpressionNode>(currentToken());
+        return makeNode<EncapsulatedExpressionNode>(currentToken());
     }
 
     ExpressionNodePtr Parser::buildConstructorExpression() {
-        const auto &ctorToken = currentToken();
+        const auto ctorToken = currentToken();
         if (!expectedNextTokenAndConsume(TokenType::TOKEN_LPAREN)) {
             recordUnexpectedTokenTypeError(nextToken(), TokenType::TOKEN_LPAREN);
             return nullptr;
@@ -448,7 +448,7 @@ namespace parser {
             colonToken = std::make_shared<Token>(currentToken());
             while (nextTokenIs(TokenType::TOKEN_LABEL)) {
                 next();
-                labelNodes.push_back(std::make_shared<LabelNode>(std::vector{currentToken()}));
+                labelNodes.push_back(makeNode<LabelNode>(std::vector{currentToken()}));
             }
         }
         if (!expectedNextTokenAndConsume(TokenType::TOKEN_LBRACE)) {
@@ -456,16 +456,16 @@ namespace parser {
             return nullptr;
         }
         auto bodyNode = buildBraceExpression();
-        return std::make_shared<ConstructorDefinitionNode>(ctorToken, paramNode, colonToken, labelNodes, bodyNode);
+        return makeNode<ConstructorDefinitionNode>(ctorToken, paramNode, colonToken, labelNodes, bodyNode);
     }
 
     ExpressionNodePtr Parser::buildDictionaryExpression() {
-        const auto &beginToken = currentToken();
+        const auto beginToken = currentToken();
         next();
         skipCurrentNewLineToken();
         if (currentTokenIs(TokenType::TOKEN_RBRACE))
         {
-            return std::make_shared<DictionaryExpressionNode>(beginToken, currentToken(), nullptr);
+            return makeNode<DictionaryExpressionNode>(beginToken, currentToken(), nullptr);
         }
         auto bodyNode = buildExpression(currentTokenPrecedence());
         next();
@@ -474,11 +474,11 @@ namespace parser {
             recordUnexpectedTokenTypeError(nextToken(), TokenType::TOKEN_RBRACE);
             return nullptr;
         }
-        return std::make_shared<DictionaryExpressionNode>(beginToken, currentToken(), bodyNode);
+        return makeNode<DictionaryExpressionNode>(beginToken, currentToken(), bodyNode);
     }
 
     ExpressionNodePtr Parser::buildListExpression() {
-        const auto &beginToken = currentToken();
+        const auto beginToken = currentToken();
         next();
         skipCurrentNewLineToken();
         ExpressionNodePtr bodyNode = nullptr;
@@ -492,7 +492,7 @@ namespace parser {
             recordUnexpectedTokenTypeError(nextToken(), TokenType::TOKEN_RBRACKET);
             return nullptr;
         }
-        return std::make_shared<ListExpressionNode>(beginToken, currentToken(), bodyNode);
+        return makeNode<ListExpressionNode>(beginToken, currentToken(), bodyNode);
     }
 
     ExpressionNodePtr Parser::buildVariableExpression() {
@@ -528,14 +528,14 @@ namespace parser {
                         return;
                     }
                     const auto &identNode = std::static_pointer_cast<IdentifierNode>(nameNode);
-                    varDefs.push_back(std::make_shared<VarDefData>(identNode,
+                    varDefs.push_back(makeNode<VarDefData>(identNode,
                         identNode->getColonTokenPtr() != nullptr,
                         identNode->getLabels(),
                         valueNode != nullptr, valueNode));
                 }
                 else if (exp->getType() == NodeType::IDENTIFIER) {
                     const auto &identNode = std::static_pointer_cast<IdentifierNode>(exp);
-                    varDefs.push_back(std::make_shared<VarDefData>(identNode,
+                    varDefs.push_back(makeNode<VarDefData>(identNode,
                         identNode->getColonTokenPtr() != nullptr,
                         identNode->getLabels(),
                         false,
@@ -547,18 +547,17 @@ namespace parser {
         };
 
         processExpressionNode(expression);
-        return std::make_shared<VariableDefinitionNode>(varToken, varDefs);
+        return makeNode<VariableDefinitionNode>(varToken, varDefs);
     }
 
     ExpressionNodePtr Parser::skipNewLineExpression()
     {
         next();
         skipCurrentNewLineToken();
-        const auto &mainToken = currentToken();
-        if (const auto &prefixBuilder = prefixExpressionBuilders.find(currentToken().getType());
-            prefixBuilder != prefixExpressionBuilders.end())
+        const auto mainToken = currentToken();
+        if (const auto prefixBuilder = prefixExpressionBuilders[tokenIndex(currentToken().getType())])
         {
-            return prefixBuilder->second(this);
+            return (this->*prefixBuilder)();
         }
         recordPrefixBuilderNotFoundError(mainToken, mainToken.getType());
         return nullptr;
@@ -566,7 +565,7 @@ namespace parser {
 
     ExpressionNodePtr Parser::buildTryExpression()
     {
-        const auto& mainToken = currentToken();
+        const auto mainToken = currentToken();
         skipNextNewLineToken();
         if (!nextTokenIs(TokenType::TOKEN_LBRACE))
         {
@@ -589,7 +588,7 @@ namespace parser {
             if (nextTokenIs(TokenType::TOKEN_CATCH))
             {
                 next();
-                const auto& catchToken = currentToken();
+                const auto catchToken = currentToken();
                 if (!nextTokenIs(TokenType::TOKEN_LPAREN))
                 {
                     recordUnexpectedTokenTypeError(nextToken(), TokenType::TOKEN_LPAREN);
@@ -655,19 +654,19 @@ namespace parser {
             }
             finallyBody = std::static_pointer_cast<BlockRangerNode>(finallyBodyNode);
         }
-        return std::make_shared<TryNode>(mainToken, tryBody, catchBodies, finallyBody);
+        return makeNode<TryNode>(mainToken, tryBody, catchBodies, finallyBody);
     }
 
     ExpressionNodePtr Parser::buildThrowExpression()
     {
-        const auto& mainToken = currentToken();
+        const auto mainToken = currentToken();
         next();
         const auto& throwExpression = buildExpression(Precedence::LOWEST);
-        return std::make_shared<ThrowNode>(mainToken, throwExpression);
+        return makeNode<ThrowNode>(mainToken, throwExpression);
     }
 
     ExpressionNodePtr Parser::buildForExpression() {
-        const auto& forToken = currentToken();
+        const auto forToken = currentToken();
         if (!expectedNextTokenAndConsume(TokenType::TOKEN_LPAREN))
         {
             recordUnexpectedTokenTypeError(nextToken(), TokenType::TOKEN_LPAREN);
@@ -702,7 +701,7 @@ namespace parser {
             return nullptr;
         }
         auto bodyNode = buildBraceExpression();
-        return std::make_shared<ForLoopNode>(forToken, initNode, conditionNode, updateNode, bodyNode);
+        return makeNode<ForLoopNode>(forToken, initNode, conditionNode, updateNode, bodyNode);
     }
 
     bool Parser::validateForRangeExpression(const ExpressionNodePtr& expr, const Token& forToken) {
@@ -721,14 +720,14 @@ namespace parser {
     }
 
     ExpressionNodePtr Parser::buildBracketExpression() {
-        const auto &beginToken = currentToken();
+        const auto beginToken = currentToken();
         next();
         auto indexNode = buildExpression(currentTokenPrecedence());
         if (!expectedNextTokenAndConsume(TokenType::TOKEN_RBRACKET)) {
             recordUnexpectedTokenTypeError(nextToken(), TokenType::TOKEN_LBRACKET);
             return nullptr;
         }
-        return std::make_shared<BracketExpressionNode>(beginToken, currentToken(), indexNode);
+        return makeNode<BracketExpressionNode>(beginToken, currentToken(), indexNode);
     }
 
     void enableDebugMode(bool cond)
@@ -0,0 +1,354 @@
+//
+// Created by RestRegular on 2025/6/29.
+//
+
+#include <algorithm>
+#include <stdexcept>
+#include "../../../include/rcc_base.h"
+#include "../../../include/analyzer/rcc_incremental_parser.h"
+
+namespace parser {
+
+    namespace {
+        // 同步点处新建锚点的 Token 流：锚点之后的 Token 以锚点为基址记录相对偏移
+        class AnchoredTokenSource final : public lexer::TokenSource {
+        public:
+            struct SyncAnchor {
+                size_t base;
+                uint32_t id;
+                char newline;
+            };
+
+            // newline 为扫描起点之前的换行词素首字符，从文件开头扫描时为 '\0'
+            AnchoredTokenSource(lexer::Lexer &lexer, const bool emitProgram, const char newline)
+                : _lexer(lexer), _programPending(emitProgram), _anchorId(lexer.getFileId()), _lastNewline(newline) {}
+
+            std::shared_ptr<Token> next() override
+            {
+                if (_programPending)
+                {
+                    _programPending = false;
+                    return std::make_shared<Token>(Pos(1, 0, 0, _lexer.getFilepath()));
+                }
+                lexer::TokenView view{};
+                if (!_lexer.scanNext(view))
+                {
+                    return nullptr;
+                }
+                if (_lexer.isSyncPoint(view.offset))
+                {
+                    _anchorBase = view.offset;
+                    _anchorId = SourceFileTable::getInstance().anchor(
+                        _lexer.getFileId(), static_cast<uint32_t>(_anchorBase));
+                    _anchors.push_back({_anchorBase, _anchorId, _lastNewline});
+                }
+                if (view.type == TokenType::TOKEN_NEWLINE)
+                {
+                    _lastNewline = view.text[0];
+                }
+                return lexer::Lexer::makeToken(view, {_anchorId,
+                    static_cast<uint32_t>(view.offset - _anchorBase), static_cast<uint32_t>(view.text.size())});
+            }
+
+            // 本次扫描产生的 Token 的绝对偏移；语句首 Token 总是最近产生的，因此从后向前查找锚点
+            [[nodiscard]] const SyncAnchor *findAnchor(const uint32_t anchorId) const
+            {
+                for (auto it = _anchors.rbegin(); it != _anchors.rend(); ++it)
+                {
+                    if (it->id == anchorId)
+                    {
+                        return &*it;
+                    }
+                }
+                return nullptr;
+            }
+
+            [[nodiscard]] const std::vector<SyncAnchor> &getAnchors() const
+            {
+                return _anchors;
+            }
+
+            // 释放本次扫描中基址不小于 from 的锚点（由它们记录位置的 Token 都不会被保留）
+            void releaseAnchorsFrom(const size_t from) const
+            {
+                std::vector<uint32_t> released;
+                for (const auto &anchor : _anchors)
+                {
+                    if (anchor.base >= from)
+                    {
+                        released.push_back(anchor.id);
+                    }
+                }
+                if (!released.empty())
+                {
+                    SourceFileTable::getInstance().releaseAnchors(released);
+                }
+            }
+
+        private:
+            lexer::Lexer &_lexer;
+            bool _programPending;
+            uint32_t _anchorId;
+            size_t _anchorBase = 0;
+            char _lastNewline = '\0';
+            std::vector<SyncAnchor> _anchors;
+        };
+    }
+
+    IncrementalParser::IncrementalParser(const std::string &filepath, const std::string &dirpath)
+        : _filepath(dirpath.empty() ? getAbsolutePath(filepath, getDefaultDir()) : getAbsolutePath(filepath, dirpath)),
+          _fileId(SourceFileTable::getInstance().intern(_filepath)),
+          _source(MappedFile(_filepath).view())
+    {
+        reparse(0, 0, 0);
+    }
+
+    IncrementalParser::IncrementalParser(const std::string &filepath, std::string source)
+        : _filepath(filepath),
+          _fileId(SourceFileTable::getInstance().intern(_filepath)),
+          _source(std::move(source))
+    {
+        reparse(0, 0, 0);
+    }
+
+    IncrementalParser::~IncrementalParser()
+    {
+        releaseAnchors();
+    }
+
+    void IncrementalParser::releaseAnchors()
+    {
+        std::vector<uint32_t> released;
+        released.reserve(_anchors.size());
+        for (const auto &anchor : _anchors)
+        {
+            released.push_back(anchor.id);
+        }
+        _anchors.clear();
+        if (!released.empty())
+        {
+            SourceFileTable::getInstance().releaseAnchors(released);
+        }
+    }
+
+    bool IncrementalParser::applyEdit(const size_t offset, const size_t length, const std::string &replacement)
+    {
+        if (offset > _source.size() || length > _source.size() - offset)
+        {
+            throw std::invalid_argument("Edit range [" + std::to_string(offset) + ", " +
+                std::to_string(offset + length) + ") is out of the source range of '" + _filepath + "'.");
+        }
+        _source.replace(offset, length, replacement);
+        // 从编辑位置之前最近的同步语句开始重新解析；前一条语句的解析可能向后查看了该语句的首个 Token，
+        // 因此要求编辑位置严格位于首个 Token 之后（首个 Token 的结束字符同样参与了词法判定）
+        auto first = static_cast<size_t>(std::lower_bound(_segments.begin(), _segments.end(), offset,
+            [](const Segment &segment, const size_t pos) { return segment.begin < pos; }) - _segments.begin());
+        while (first > 0 && (_segments[first - 1].newline == '\0' || _segments[first - 1].firstEnd >= offset))
+        {
+            --first;
+        }
+        // 找不到这样的语句时 first 为 0，即从文件开头重新解析
+        first = first > 0 ? first - 1 : 0;
+        try
+        {
+            reparse(first, offset + replacement.size(),
+                static_cast<int64_t>(replacement.size()) - static_cast<int64_t>(length));
+        } catch (...)
+        {
+            // 扫描或解析异常后旧的解析结果已不可复用，下次编辑时整体重新解析
+            _segments.clear();
+            releaseAnchors();
+            _program = nullptr;
+            throw;
+        }
+        return hasError();
+    }
+
+    void IncrementalParser::reparse(const size_t first, const size_t editEnd, const int64_t delta)
+    {
+        auto lexer = lexer::Lexer::fromSource(_filepath, _source);
+        lexer.buildLineIndex();
+        lexer.trackSyncPoints(true);
+        const bool fromStart = first == 0 || _segments.empty();
+        const size_t regionBegin = fromStart ? 0 : _segments[first].begin;
+        const char newline = fromStart ? '\0' : _segments[first].newline;
+        if (!fromStart)
+        {
+            lexer.rewind(regionBegin, newline);
+        }
+        const auto source = std::make_shared<AnchoredTokenSource>(lexer, fromStart, newline);
+        Parser parser(source);
+        if (fromStart)
+        {
+            _programToken = parser.beginProgram();
+            _programErrors = parser.getErrorMsgs();
+        }
+
+        // 只复用其后不再有错误的旧语句，保证复用语句的错误信息中的位置不会过期
+        const size_t replaceBegin = fromStart ? 0 : first;
+        size_t reuseFloor = replaceBegin;
+        for (size_t i = replaceBegin; i < _segments.size(); i++)
+        {
+            if (!_segments[i].errors.empty())
+            {
+                reuseFloor = i + 1;
+            }
+        }
+
+        std::vector<Segment> fresh;
+        size_t resume = _segments.size();
+        size_t resumeBegin = 0;
+        try
+        {
+            while (const Token *token = parser.seekStatement())
+            {
+                const SourceLoc loc = token->getLoc();
+                const auto *anchor = source->findAnchor(loc.fileId);
+                const size_t begin = anchor ? anchor->base + loc.offset : loc.offset;
+                const bool synced = anchor && loc.offset == 0;
+                if (synced && begin >= editEnd)
+                {
+                    // 编辑之后重新遇到旧 Token 流中的同步语句，后续 Token 与旧流完全一致
+                    const auto oldBegin = static_cast<size_t>(static_cast<int64_t>(begin) - delta);
+                    const auto it = std::lower_bound(
+                        _segments.begin() + static_cast<std::ptrdiff_t>(std::max(reuseFloor, replaceBegin)),
+                        _segments.end(), oldBegin,
+                        [](const Segment &segment, const size_t pos) { return segment.begin < pos; });
+                    if (it != _segments.end() && it->begin == oldBegin && it->newline == anchor->newline)
+                    {
+                        resume = static_cast<size_t>(it - _segments.begin());
+                        resumeBegin = begin;
+                        break;
+                    }
+                }
+                Segment segment;
+                segment.begin = begin;
+                segment.firstEnd = begin + loc.length;
+                segment.newline = synced ? anchor->newline : '\0';
+                segment.arena = parser.getArena();
+                segment.node = parser.parseStatement(segment.errors);
+                fresh.push_back(std::move(segment));
+            }
+        } catch (...)
+        {
+            source->releaseAnchorsFrom(0);
+            throw;
+        }
+
+        // 替换区间内的旧锚点作废，复用区间的锚点整体平移
+        const bool reusing = resume < _segments.size();
+        const size_t oldResumeBegin = reusing ? _segments[resume].begin : SIZE_MAX;
+        const auto anchorBegin = std::lower_bound(_anchors.begin(), _anchors.end(), regionBegin,
+            [](const Anchor &anchor, const size_t pos) { return anchor.base < pos; });
+        const auto anchorEnd = std::lower_bound(anchorBegin, _anchors.end(), oldResumeBegin,
+            [](const Anchor &anchor, const size_t pos) { return anchor.base < pos; });
+        std::vector<uint32_t> releasedIds;
+        releasedIds.reserve(static_cast<size_t>(anchorEnd - anchorBegin));
+        for (auto it = anchorBegin; it != anchorEnd; ++it)
+        {
+            releasedIds.push_back(it->id);
+        }
+        if (!releasedIds.empty())
+        {
+            SourceFileTable::getInstance().releaseAnchors(releasedIds);
+        }
+        std::vector<uint32_t> shiftedIds;
+        shiftedIds.reserve(static_cast<size_t>(_anchors.end() - anchorEnd));
+        for (auto it = anchorEnd; it != _anchors.end(); ++it)
+        {
+            it->base = static_cast<size_t>(static_cast<int64_t>(it->base) + delta);
+            shiftedIds.push_back(it->id);
+        }
+        if (delta != 0 && !shiftedIds.empty())
+        {
+            SourceFileTable::getInstance().shiftAnchors(shiftedIds, delta);
+        }
+        std::vector<Anchor> newAnchors;
+        for (const auto &anchor : source->getAnchors())
+        {
+            if (!reusing || anchor.base < resumeBegin)
+            {
+                newAnchors.push_back({anchor.base, anchor.id});
+            }
+        }
+        // 预读进入复用区间时产生的锚点不再需要
+        if (reusing)
+        {
+            source->releaseAnchorsFrom(resumeBegin);
+        }
+        const auto anchorPos = _anchors.erase(anchorBegin, anchorEnd);
+        _anchors.insert(anchorPos, newAnchors.begin(), newAnchors.end());
+
+        for (size_t i = resume; i < _segments.size(); i++)
+        {
+            _segments[i].begin = static_cast<size_t>(static_cast<int64_t>(_segments[i].begin) + delta);
+            _segments[i].firstEnd = static_cast<size_t>(static_cast<int64_t>(_segments[i].firstEnd) + delta);
+        }
+        _reparsedCount = fresh.size();
+        _reusedCount = _segments.size() - resume + replaceBegin;
+        const auto segmentPos = _segments.erase(_segments.begin() + static_cast<std::ptrdiff_t>(replaceBegin),
+            _segments.begin() + static_cast<std::ptrdiff_t>(resume));
+        _segments.insert(segmentPos, std::make_move_iterator(fresh.begin()), std::make_move_iterator(fresh.end()));
+        buildProgram();
+    }
+
+    void IncrementalParser::buildProgram()
+    {
+        std::vector<std::shared_ptr<StatementNode>> statements;
+        statements.reserve(_segments.size());
+        for (const auto &segment : _segments)
+        {
+            if (segment.node)
+            {
+                statements.push_back(segment.node);
+            }
+        }
+        _program = std::make_shared<ProgramNode>(_programToken, std::move(statements));
+        for (const auto &segment : _segments)
+        {
+            _program->addArena(segment.arena);
+        }
+    }
+
+    std::shared_ptr<ProgramNode> IncrementalParser::getProgram() const
+    {
+        return _program;
+    }
+
+    const std::string &IncrementalParser::getSource() const
+    {
+        return _source;
+    }
+
+    const std::string &IncrementalParser::getFilepath() const
+    {
+        return _filepath;
+    }
+
+    StringVector IncrementalParser::getErrorMsgs() const
+    {
+        StringVector errorMsgs = _programErrors;
+        for (const auto &segment : _segments)
+        {
+            errorMsgs.insert(errorMsgs.end(), segment.errors.begin(), segment.errors.end());
+        }
+        return errorMsgs;
+    }
+
+    bool IncrementalParser::hasError() const
+    {
+        return !_programErrors.empty() || std::any_of(_segments.begin(), _segments.end(),
+            [](const Segment &segment) { return !segment.errors.empty(); });
+    }
+
+    size_t IncrementalParser::getReparsedCount() const
+    {
+        return _reparsedCount;
+    }
+
+    size_t IncrementalParser::getReusedCount() const
+    {
+        return _reusedCount;
+    }
+
+} // parser
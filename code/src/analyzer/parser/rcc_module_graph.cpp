@@ -0,0 +1,251 @@
+//
+// Created by RestRegular on 2025/6/29.
+//
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <thread>
+#include <unordered_set>
+
+#include "../../../include/rcc_base.h"
+#include "../../../include/analyzer/rcc_ast_serializer.h"
+#include "../../../include/analyzer/rcc_module_graph.h"
+
+namespace parser {
+
+    namespace {
+        // 与 Lexer 打开文件时使用相同的路径规范化方式，保证预解析结果能按编译时的路径取回
+        std::string normalizeModulePath(const std::string &filepath)
+        {
+            return getAbsolutePath(filepath, getDefaultDir());
+        }
+
+        bool isImportCall(const std::shared_ptr<ExpressionNode> &node)
+        {
+            if (!node || node->getRealType() != NodeType::CALL)
+            {
+                return false;
+            }
+            const auto &callee = std::static_pointer_cast<FunctionCallNode>(node)->getLeftNode();
+            return callee && callee->getType() == NodeType::IDENTIFIER &&
+                std::static_pointer_cast<IdentifierNode>(callee)->getName() == "import";
+        }
+
+        // 实参可以是位置参数、关键字参数（dt="datatype"）及二者以逗号组成的并列节点
+        void collectImportArguments(const std::shared_ptr<ExpressionNode> &node, std::vector<std::string> &extNames)
+        {
+            if (!node)
+            {
+                return;
+            }
+            switch (node->getRealType())
+            {
+            case NodeType::RANGER:
+                if (const auto &rangerNode = std::static_pointer_cast<RangerNode>(node);
+                    rangerNode->getRangerType() == NodeType::PAREN)
+                {
+                    collectImportArguments(std::static_pointer_cast<ParenRangerNode>(node)->getRangerNode(), extNames);
+                }
+                break;
+            case NodeType::PARALLEL:
+                {
+                    const auto &parallelNode = std::static_pointer_cast<InfixExpressionNode>(node);
+                    collectImportArguments(parallelNode->getLeftNode(), extNames);
+                    collectImportArguments(parallelNode->getRightNode(), extNames);
+                }
+                break;
+            case NodeType::ASSIGNMENT:
+                collectImportArguments(std::static_pointer_cast<AssignmentNode>(node)->getAssignPair().second, extNames);
+                break;
+            case NodeType::STRING:
+                extNames.push_back(std::static_pointer_cast<StringLiteralNode>(node)->unescapedString());
+                break;
+            default:
+                break;
+            }
+        }
+
+        void collectImportCall(const std::shared_ptr<ExpressionNode> &node, std::vector<std::string> &extNames)
+        {
+            if (isImportCall(node))
+            {
+                collectImportArguments(std::static_pointer_cast<FunctionCallNode>(node)->getRightNode(), extNames);
+            }
+        }
+    }
+
+    std::vector<std::string> ModuleGraphParser::collectImports(const ProgramNode &program)
+    {
+        std::vector<std::string> extNames;
+        for (const auto &statement : program.getStatements())
+        {
+            if (!statement || statement->getRealType() != NodeType::EXPRESSION_STATEMENT)
+            {
+                continue;
+            }
+            const auto &expression = std::static_pointer_cast<ExpressionStatementNode>(statement)->getExpression();
+            if (!expression)
+            {
+                continue;
+            }
+            switch (expression->getRealType())
+            {
+            case NodeType::VAR:
+                // var lib: clas = import("io")
+                for (const auto &varDef : std::static_pointer_cast<VariableDefinitionNode>(expression)->getVarDefs())
+                {
+                    collectImportCall(varDef->getValueNode(), extNames);
+                }
+                break;
+            case NodeType::ASSIGNMENT:
+                collectImportCall(std::static_pointer_cast<AssignmentNode>(expression)->getAssignPair().second, extNames);
+                break;
+            default:
+                collectImportCall(expression, extNames);
+                break;
+            }
+        }
+        return extNames;
+    }
+
+    void ModuleGraphParser::parseAll(const std::string &entryPath, const ImportResolver &resolver, size_t threadCount)
+    {
+        if (threadCount == 0)
+        {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        // 解析单个模块并返回其依赖的绝对路径；任何失败都只放弃该模块，留给编译时的串行流程报告
+        const auto parseModule = [&](const std::string &filepath) -> std::vector<std::string> {
+            {
+                std::lock_guard lock(_mutex);
+                if (_modules.contains(filepath))
+                {
+                    return {};
+                }
+            }
+            try
+            {
+                auto module = std::make_unique<ParsedModule>();
+                module->lexer = std::make_shared<lexer::Lexer>(filepath);
+                const bool cacheable = AstCache::isCacheable(filepath);
+                if (cacheable)
+                {
+                    module->program = AstCache::load(*module->lexer);
+                }
+                if (!module->program)
+                {
+                    module->parser = std::make_unique<Parser>(module->lexer->tokenStream());
+                    module->program = module->parser->parseProgram();
+                    if (cacheable && !module->parser->hasError())
+                    {
+                        AstCache::store(*module->lexer, *module->program);
+                    }
+                }
+                std::vector<std::string> dependencies;
+                if (!module->parser || !module->parser->hasError())
+                {
+                    for (const auto &extName : collectImports(*module->program))
+                    {
+                        try
+                        {
+                            if (const auto &importedPath = resolver(filepath, extName);
+                                std::filesystem::is_regular_file(importedPath))
+                            {
+                                dependencies.push_back(normalizeModulePath(importedPath));
+                            }
+                        } catch (...) {}
+                    }
+                }
+                std::lock_guard lock(_mutex);
+                _modules.emplace(filepath, std::move(module));
+                _imports[filepath] = dependencies;
+                return dependencies;
+            } catch (...)
+            {
+                return {};
+            }
+        };
+
+        std::mutex queueMutex;
+        std::condition_variable ready;
+        std::deque<std::string> pending{normalizeModulePath(entryPath)};
+        std::unordered_set<std::string> discovered{pending.front()};
+        size_t active = 0;
+        // 队列为空且没有正在解析的模块时，依赖图已全部发现，所有工作线程退出
+        const auto worker = [&] {
+            std::unique_lock lock(queueMutex);
+            while (true)
+            {
+                ready.wait(lock, [&] { return !pending.empty() || active == 0; });
+                if (pending.empty())
+                {
+                    return;
+                }
+                const auto filepath = std::move(pending.front());
+                pending.pop_front();
+                active++;
+                lock.unlock();
+                const auto dependencies = parseModule(filepath);
+                lock.lock();
+                active--;
+                for (const auto &dependency : dependencies)
+                {
+                    if (discovered.insert(dependency).second)
+                    {
+                        pending.push_back(dependency);
+                    }
+                }
+                ready.notify_all();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+        for (size_t i = 1; i < threadCount; i++)
+        {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    std::unique_ptr<ParsedModule> ModuleGraphParser::take(const std::string &filepath)
+    {
+        std::lock_guard lock(_mutex);
+        const auto it = _modules.find(normalizeModulePath(filepath));
+        if (it == _modules.end())
+        {
+            return nullptr;
+        }
+        auto module = std::move(it->second);
+        _modules.erase(it);
+        return module;
+    }
+
+    bool ModuleGraphParser::hasParsed(const std::string &filepath)
+    {
+        std::lock_guard lock(_mutex);
+        const auto it = _modules.find(normalizeModulePath(filepath));
+        return it != _modules.end() && (!it->second->parser || !it->second->parser->hasError());
+    }
+
+    std::vector<std::string> ModuleGraphParser::getImports(const std::string &filepath)
+    {
+        std::lock_guard lock(_mutex);
+        const auto it = _imports.find(normalizeModulePath(filepath));
+        return it == _imports.end() ? std::vector<std::string>{} : it->second;
+    }
+
+    void ModuleGraphParser::clear()
+    {
+        std::lock_guard lock(_mutex);
+        _modules.clear();
+        _imports.clear();
+    }
+
+} // parser
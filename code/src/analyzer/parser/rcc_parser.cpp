@@ -21,130 +21,145 @@ namespace parser {
         }
     }
 
+    std::shared_ptr<ProgramNode> Parser::parseProgram() {
+        return buildProgram();
+    }
+
     Parser::Parser(std::queue<std::shared_ptr<Token>> tokens)
-    : _tokens(std::move(tokens)) {
+    : Parser(std::make_shared<lexer::QueueTokenSource>(std::move(tokens))) {}
+
+    Parser::Parser(std::shared_ptr<lexer::TokenSource> source)
+    : _source(std::move(source)) {
         next();
         next();
     }
 
-    Token Parser::STREAM_START_TOKEN = Token(Pos(), RCC_TOKEN_STREAM_START);
-    Token Parser::STREAM_END_TOKEN = Token(Pos(), RCC_TOKEN_STREAM_END);
+    Token Parser::STREAM_START_TOKEN = Token(Pos(), RCC_TOKEN_STREAM_START, TokenType::TOKEN_STREAM_START);
+    Token Parser::STREAM_END_TOKEN = Token(Pos(), RCC_TOKEN_STREAM_END, TokenType::TOKEN_STREAM_END);
 
-    std::map<core::TokenType, PrefixExpressionBuilder> Parser::prefixExpressionBuilders {
+    constinit const Parser::TokenTypeTable<PrefixExpressionBuilder> Parser::prefixExpressionBuilders = [] {
+        TokenTypeTable<PrefixExpressionBuilder> table{};
         // 字面量
-        {TokenType::TOKEN_INTEGER, &Parser::buildIntegerExpression},
-        {TokenType::TOKEN_FLOAT, &Parser::buildFloatExpression},
-        {TokenType::TOKEN_STRING, &Parser::buildStringExpression},
-        {TokenType::TOKEN_CHAR, &Parser::buildCharExpression},
-        {TokenType::TOKEN_TRUE, &Parser::buildBoolExpression},
-        {TokenType::TOKEN_FALSE, &Parser::buildBoolExpression},
-        {TokenType::TOKEN_NULL, &Parser::buildNullExpression},
+        table[tokenIndex(TokenType::TOKEN_INTEGER)] = &Parser::buildIntegerExpression;
+        table[tokenIndex(TokenType::TOKEN_FLOAT)] = &Parser::buildFloatExpression;
+        table[tokenIndex(TokenType::TOKEN_STRING)] = &Parser::buildStringExpression;
+        table[tokenIndex(TokenType::TOKEN_CHAR)] = &Parser::buildCharExpression;
+        table[tokenIndex(TokenType::TOKEN_TRUE)] = &Parser::buildBoolExpression;
+        table[tokenIndex(TokenType::TOKEN_FALSE)] = &Parser::buildBoolExpression;
+        table[tokenIndex(TokenType::TOKEN_NULL)] = &Parser::buildNullExpression;
         // 范围符
-        {TokenType::TOKEN_LPAREN, &Parser::buildRangerExpression},
-        {TokenType::TOKEN_LBRACKET, &Parser::buildListExpression},
-        {TokenType::TOKEN_LBRACE, &Parser::buildDictionaryExpression},
+        table[tokenIndex(TokenType::TOKEN_LPAREN)] = &Parser::buildRangerExpression;
+        table[tokenIndex(TokenType::TOKEN_LBRACKET)] = &Parser::buildListExpression;
+        table[tokenIndex(TokenType::TOKEN_LBRACE)] = &Parser::buildDictionaryExpression;
         // 标识符
-        {TokenType::TOKEN_IDENTIFIER, &Parser::buildIdentifierExpression},
-        {TokenType::TOKEN_LABEL, &Parser::buildLabelExpression},
+        table[tokenIndex(TokenType::TOKEN_IDENTIFIER)] = &Parser::buildIdentifierExpression;
+        table[tokenIndex(TokenType::TOKEN_LABEL)] = &Parser::buildLabelExpression;
         // 一元前缀运算符：+、-、!、*、**、:
-        {TokenType::TOKEN_PLUS, &Parser::buildPrefixExpression},
-        {TokenType::TOKEN_MINUS, &Parser::buildPrefixExpression},
-        {TokenType::TOKEN_NOT, &Parser::buildUnaryExpression},
-        {TokenType::TOKEN_STAR, &Parser::buildUnaryExpression},
-        {TokenType::TOKEN_DOUBLE_STAR, &Parser::buildUnaryExpression},
+        table[tokenIndex(TokenType::TOKEN_PLUS)] = &Parser::buildPrefixExpression;
+        table[tokenIndex(TokenType::TOKEN_MINUS)] = &Parser::buildPrefixExpression;
+        table[tokenIndex(TokenType::TOKEN_NOT)] = &Parser::buildUnaryExpression;
+        table[tokenIndex(TokenType::TOKEN_STAR)] = &Parser::buildUnaryExpression;
+        table[tokenIndex(TokenType::TOKEN_DOUBLE_STAR)] = &Parser::buildUnaryExpression;
         // 变量定义
-        {TokenType::TOKEN_VAR, &Parser::buildVariableExpression},
+        table[tokenIndex(TokenType::TOKEN_VAR)] = &Parser::buildVariableExpression;
         // 函数定义
-        {TokenType::TOKEN_FUNCTION, &Parser::buildFunctionExpression},
+        table[tokenIndex(TokenType::TOKEN_FUNCTION)] = &Parser::buildFunctionExpression;
         // 条件语句
-        {TokenType::TOKEN_IF, &Parser::buildConditionExpression},
+        table[tokenIndex(TokenType::TOKEN_IF)] = &Parser::buildConditionExpression;
         // 循环语句
-        {TokenType::TOKEN_WHILE, &Parser::buildWhileExpression},
-        {TokenType::TOKEN_UNTIL, &Parser::buildUntilExpression},
-        {TokenType::TOKEN_FOR, &Parser::buildForExpression},
+        table[tokenIndex(TokenType::TOKEN_WHILE)] = &Parser::buildWhileExpression;
+        table[tokenIndex(TokenType::TOKEN_UNTIL)] = &Parser::buildUntilExpression;
+        table[tokenIndex(TokenType::TOKEN_FOR)] = &Parser::buildForExpression;
         // pass 语句
-        {TokenType::TOKEN_PASS, &Parser::buildPassExpression},
+        table[tokenIndex(TokenType::TOKEN_PASS)] = &Parser::buildPassExpression;
         // encapsulated 语句
-        {TokenType::TOKEN_ENCAPSULATED, &Parser::buildEncapsulatedExpression},
+        table[tokenIndex(TokenType::TOKEN_ENCAPSULATED)] = &Parser::buildEncapsulatedExpression;
         // 构造函数
-        {TokenType::TOKEN_CTOR, &Parser::buildConstructorExpression},
+        table[tokenIndex(TokenType::TOKEN_CTOR)] = &Parser::buildConstructorExpression;
         // 类定义
-        {TokenType::TOKEN_CLASS, &Parser::buildClassExpression},
+        table[tokenIndex(TokenType::TOKEN_CLASS)] = &Parser::buildClassExpression;
         // 返回语句
-        {TokenType::TOKEN_RETURN, &Parser::buildReturnExpression},
+        table[tokenIndex(TokenType::TOKEN_RETURN)] = &Parser::buildReturnExpression;
         // 退出循环语句
-        {TokenType::TOKEN_BREAK, &Parser::buildBreakExpression},
+        table[tokenIndex(TokenType::TOKEN_BREAK)] = &Parser::buildBreakExpression;
         // 跳过新行
-        {TokenType::TOKEN_SKIP_NEWLINE, &Parser::skipNewLineExpression},
+        table[tokenIndex(TokenType::TOKEN_SKIP_NEWLINE)] = &Parser::skipNewLineExpression;
         // try 语句
-        {TokenType::TOKEN_TRY, &Parser::buildTryExpression},
+        table[tokenIndex(TokenType::TOKEN_TRY)] = &Parser::buildTryExpression;
         // throw 语句
-        {TokenType::TOKEN_THROW, &Parser::buildThrowExpression}
-    };
-
-    std::map<core::TokenType, InfixExpressionBuilder> Parser::infixExpressionBuilders {
-            {TokenType::TOKEN_PLUS, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_MINUS, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_STAR, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_SLASH, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_GREATER, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_LESS, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_GREATER_EQUAL, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_LESS_EQUAL, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_EQUAL, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_NOT_EQUAL, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_AND, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_OR, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_MODULO, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_ASSIGN, &Parser::buildAssignExpression},
-            {TokenType::TOKEN_COMMA, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_PLUS_ASSIGN, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_MINUS_ASSIGN, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_STAR_ASSIGN, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_SLASH_ASSIGN, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_MODULO_ASSIGN, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_COLON, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_INDICATOR, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_DOT, &Parser::buildInfixExpression},
-            {TokenType::TOKEN_LPAREN, &Parser::buildCallExpression},
-            {TokenType::TOKEN_LBRACKET, &Parser::buildIndexExpression}
-    };
-
-    std::map<core::TokenType, PostfixExpressionBuilder> Parser::postfixExpressionBuilders {
-            {TokenType::TOKEN_DOUBLE_PLUS, &Parser::buildPostfixExpression},
-            {TokenType::TOKEN_DOUBLE_MINUS, &Parser::buildPostfixExpression},
-            {TokenType::TOKEN_LBRACKET, &Parser::buildIndexExpression}
-    };
-
-    std::map<core::TokenType, Precedence> Parser::precedenceMap = {
-            {TokenType::TOKEN_PLUS, Precedence::SUM},
-            {TokenType::TOKEN_MINUS, Precedence::SUM},
-            {TokenType::TOKEN_STAR, Precedence::PRODUCT},
-            {TokenType::TOKEN_SLASH, Precedence::PRODUCT},
-            {TokenType::TOKEN_MODULO, Precedence::PRODUCT},
-            {TokenType::TOKEN_ASSIGN, Precedence::ASSIGN},
-            {TokenType::TOKEN_PLUS_ASSIGN, Precedence::ASSIGN},
-            {TokenType::TOKEN_MINUS_ASSIGN, Precedence::ASSIGN},
-            {TokenType::TOKEN_SLASH_ASSIGN, Precedence::ASSIGN},
-            {TokenType::TOKEN_STAR_ASSIGN, Precedence::ASSIGN},
-            {TokenType::TOKEN_MODULO_ASSIGN, Precedence::ASSIGN},
-            {TokenType::TOKEN_COMMA, Precedence::PARALLEL},
-            {TokenType::TOKEN_COLON, Precedence::KV_SEP},
-            {TokenType::TOKEN_GREATER, Precedence::COMPARE},
-            {TokenType::TOKEN_GREATER_EQUAL, Precedence::COMPARE},
-            {TokenType::TOKEN_LESS, Precedence::COMPARE},
-            {TokenType::TOKEN_LESS_EQUAL, Precedence::COMPARE},
-            {TokenType::TOKEN_EQUAL, Precedence::COMPARE},
-            {TokenType::TOKEN_NOT_EQUAL, Precedence::COMPARE},
-            {TokenType::TOKEN_AND, Precedence::LOGIC},
-            {TokenType::TOKEN_OR, Precedence::LOGIC},
-            {TokenType::TOKEN_DOUBLE_PLUS, Precedence::POSTFIX},
-            {TokenType::TOKEN_DOUBLE_MINUS, Precedence::POSTFIX},
-            {TokenType::TOKEN_INDICATOR, Precedence::INDICATOR},
-            {TokenType::TOKEN_DOT, Precedence::ATTRIBUTE},
-            {TokenType::TOKEN_LPAREN, Precedence::CALL},
-            {TokenType::TOKEN_LBRACKET, Precedence::INDEX}
-    };
+        table[tokenIndex(TokenType::TOKEN_THROW)] = &Parser::buildThrowExpression;
+        return table;
+    }();
+
+    constinit const Parser::TokenTypeTable<InfixExpressionBuilder> Parser::infixExpressionBuilders = [] {
+        TokenTypeTable<InfixExpressionBuilder> table{};
+        table[tokenIndex(TokenType::TOKEN_PLUS)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_MINUS)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_STAR)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_SLASH)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_GREATER)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_LESS)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_GREATER_EQUAL)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_LESS_EQUAL)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_EQUAL)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_NOT_EQUAL)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_AND)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_OR)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_MODULO)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_ASSIGN)] = &Parser::buildAssignExpression;
+        table[tokenIndex(TokenType::TOKEN_COMMA)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_PLUS_ASSIGN)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_MINUS_ASSIGN)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_STAR_ASSIGN)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_SLASH_ASSIGN)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_MODULO_ASSIGN)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_COLON)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_INDICATOR)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_DOT)] = &Parser::buildInfixExpression;
+        table[tokenIndex(TokenType::TOKEN_LPAREN)] = &Parser::buildCallExpression;
+        table[tokenIndex(TokenType::TOKEN_LBRACKET)] = &Parser::buildIndexExpression;
+        return table;
+    }();
+
+    constinit const Parser::TokenTypeTable<PostfixExpressionBuilder> Parser::postfixExpressionBuilders = [] {
+        TokenTypeTable<PostfixExpressionBuilder> table{};
+        table[tokenIndex(TokenType::TOKEN_DOUBLE_PLUS)] = &Parser::buildPostfixExpression;
+        table[tokenIndex(TokenType::TOKEN_DOUBLE_MINUS)] = &Parser::buildPostfixExpression;
+        table[tokenIndex(TokenType::TOKEN_LBRACKET)] = &Parser::buildIndexExpression;
+        return table;
+    }();
+
+    constinit const Parser::TokenTypeTable<Precedence> Parser::precedenceTable = [] {
+        TokenTypeTable<Precedence> table{};
+        table[tokenIndex(TokenType::TOKEN_PLUS)] = Precedence::SUM;
+        table[tokenIndex(TokenType::TOKEN_MINUS)] = Precedence::SUM;
+        table[tokenIndex(TokenType::TOKEN_STAR)] = Precedence::PRODUCT;
+        table[tokenIndex(TokenType::TOKEN_SLASH)] = Precedence::PRODUCT;
+        table[tokenIndex(TokenType::TOKEN_MODULO)] = Precedence::PRODUCT;
+        table[tokenIndex(TokenType::TOKEN_ASSIGN)] = Precedence::ASSIGN;
+        table[tokenIndex(TokenType::TOKEN_PLUS_ASSIGN)] = Precedence::ASSIGN;
+        table[tokenIndex(TokenType::TOKEN_MINUS_ASSIGN)] = Precedence::ASSIGN;
+        table[tokenIndex(TokenType::TOKEN_SLASH_ASSIGN)] = Precedence::ASSIGN;
+        table[tokenIndex(TokenType::TOKEN_STAR_ASSIGN)] = Precedence::ASSIGN;
+        table[tokenIndex(TokenType::TOKEN_MODULO_ASSIGN)] = Precedence::ASSIGN;
+        table[tokenIndex(TokenType::TOKEN_COMMA)] = Precedence::PARALLEL;
+        table[tokenIndex(TokenType::TOKEN_COLON)] = Precedence::KV_SEP;
+        table[tokenIndex(TokenType::TOKEN_GREATER)] = Precedence::COMPARE;
+        table[tokenIndex(TokenType::TOKEN_GREATER_EQUAL)] = Precedence::COMPARE;
+        table[tokenIndex(TokenType::TOKEN_LESS)] = Precedence::COMPARE;
+        table[tokenIndex(TokenType::TOKEN_LESS_EQUAL)] = Precedence::COMPARE;
+        table[tokenIndex(TokenType::TOKEN_EQUAL)] = Precedence::COMPARE;
+        table[tokenIndex(TokenType::TOKEN_NOT_EQUAL)] = Precedence::COMPARE;
+        table[tokenIndex(TokenType::TOKEN_AND)] = Precedence::LOGIC;
+        table[tokenIndex(TokenType::TOKEN_OR)] = Precedence::LOGIC;
+        table[tokenIndex(TokenType::TOKEN_DOUBLE_PLUS)] = Precedence::POSTFIX;
+        table[tokenIndex(TokenType::TOKEN_DOUBLE_MINUS)] = Precedence::POSTFIX;
+        table[tokenIndex(TokenType::TOKEN_INDICATOR)] = Precedence::INDICATOR;
+        table[tokenIndex(TokenType::TOKEN_DOT)] = Precedence::ATTRIBUTE;
+        table[tokenIndex(TokenType::TOKEN_LPAREN)] = Precedence::CALL;
+        table[tokenIndex(TokenType::TOKEN_LBRACKET)] = Precedence::INDEX;
+        return table;
+    }();
 
     const Token &Parser::currentToken()
     {
@@ -161,59 +176,59 @@ namespace parser {
 
     const Token &Parser::nextToken() const {
         if (!hasNext()) return STREAM_END_TOKEN;
-        return _next_token ?
-        *_next_token :
-        _tempTokens.empty() ?
-        *_tokens.front() :
-        *_tempTokens.front();
+        return *_next_token;
     }
 
     bool Parser::isAtEnd() {
         return currentTokenIs(TokenType::TOKEN_STREAM_END);
     }
 
+    void Parser::pushPrevious(std::shared_ptr<Token> token) {
+        _previous_top = (_previous_top + 1) % LOOK_BEHIND_CAPACITY;
+        _previous_tokens[_previous_top] = std::move(token);
+        if (_previous_count < LOOK_BEHIND_CAPACITY) {
+            _previous_count++;
+        }
+    }
+
+    std::shared_ptr<Token> Parser::pullToken() {
+        if (!_tempTokens.empty()) {
+            auto token = _tempTokens.front();
+            _tempTokens.pop_front();
+            return token;
+        }
+        return _source ? _source->next() : nullptr;
+    }
+
     void Parser::previous() {
-        if (_previous_tokens.empty()) throw std::runtime_error("No previous token");
+        if (_previous_count == 0) throw std::runtime_error("No previous token");
         _tempTokens.push_front(_next_token);
         _next_token = _current_token;
-        _current_token = _previous_tokens.top();
-        _previous_tokens.pop();
+        _current_token = std::move(_previous_tokens[_previous_top]);
+        _previous_top = (_previous_top + LOOK_BEHIND_CAPACITY - 1) % LOOK_BEHIND_CAPACITY;
+        _previous_count--;
     }
 
     const Token & Parser::previousToken() const {
-        if (_previous_tokens.empty()) throw std::runtime_error("No previous token");
-        return *_previous_tokens.top();
+        if (_previous_count == 0) throw std::runtime_error("No previous token");
+        return *_previous_tokens[_previous_top];
     }
 
     const Token &Parser::next() {
-        _previous_tokens.push(_current_token);
+        pushPrevious(_current_token);
         _current_token = _next_token;
-        if (!_tempTokens.empty()) {
-            _next_token = _tempTokens.front();
-            _tempTokens.pop_front();
-        } else if (!_tokens.empty()) {
-            _next_token = _tokens.front();
-            _tokens.pop();
-        } else {
-            _next_token = nullptr;
-        }
+        _next_token = pullToken();
         return _current_token ? currentToken() : *_current_token;
     }
 
     void Parser::consumeNext() {
-        if (!_tempTokens.empty()) {
-            _next_token = _tempTokens.front();
-            _tempTokens.pop_front();
-        } else if (!_tokens.empty()) {
-            _next_token = _tokens.front();
-            _tokens.pop();
-        } else {
-            _next_token = nullptr;
-        }
+        _next_token = pullToken();
     }
 
     void Parser::reset() {
         _previous_tokens = {};
+        _previous_top = 0;
+        _previous_count = 0;
         _current_token = nullptr;
         _next_token = nullptr;
         // 清空临时 token 队列
@@ -277,19 +292,11 @@ namespace parser {
 
     Precedence Parser::currentTokenPrecedence()
     {
-        if (const auto it = precedenceMap.find(currentToken().getType());
-            it != precedenceMap.end()) {
-            return it->second;
-        }
-        return Precedence::LOWEST;
+        return precedenceTable[tokenIndex(currentToken().getType())];
     }
 
     Precedence Parser::nextTokenPrecedence() const {
-        if (const auto it = precedenceMap.find(nextToken().getType());
-            it != precedenceMap.end()) {
-            return it->second;
-        }
-        return Precedence::LOWEST;
+        return precedenceTable[tokenIndex(nextToken().getType())];
     }
 
     void Parser::appendTemToken(const Token &token) {
@@ -311,19 +318,22 @@ namespace parser {
         return !errorMsgs.empty();
     }
 
+    std::shared_ptr<AstArena> Parser::getArena() const {
+        return _arena;
+    }
+
     ExpressionNodePtr Parser::buildExpression(Precedence precedence) {
-        const auto &prefixBuilder = prefixExpressionBuilders.find(currentToken().getType());
-        if (prefixBuilder == prefixExpressionBuilders.end()) {
+        const auto prefixBuilder = prefixExpressionBuilders[tokenIndex(currentToken().getType())];
+        if (!prefixBuilder) {
             recordPrefixBuilderNotFoundError(currentToken(), currentToken().getType());
             return nullptr;
         }
-        auto expressionNode = prefixBuilder->second(this);
+        auto expressionNode = (this->*prefixBuilder)();
         while (!isAtEnd() && !nextTokenIs(core::TokenType::TOKEN_NEWLINE)){
             // 检查当前 token 是否为后缀运算符
-            if (const auto &it = postfixExpressionBuilders.find(nextToken().getType());
-                it != postfixExpressionBuilders.end()) {
+            if (const auto postfixBuilder = postfixExpressionBuilders[tokenIndex(nextToken().getType())]) {
                 next();
-                expressionNode = it->second(this, expressionNode);
+                expressionNode = (this->*postfixBuilder)(expressionNode);
                 continue;
             }
 
@@ -334,11 +344,11 @@ namespace parser {
                     const auto &next_token = nextToken();
                     auto nextPos = next_token.getPos();
                     nextPos.setOffset(1);
-                    appendTemToken(Token(nextPos, "-"));
+                    appendTemToken(Token(nextPos, "-", TokenType::TOKEN_MINUS));
                     Pos newPos = nextPos;
                     newPos.setColumn(nextPos.getColumn() + 1);
                     newPos.setOffset(nextPos.getOffset() - 1);
-                    Token numToken(newPos,value.substr(1));
+                    Token numToken(newPos, value.substr(1), next_token.getType());
                     appendTemToken(numToken);
                     consumeNext();
                     continue;
@@ -352,12 +362,12 @@ namespace parser {
             }
 
             if (precedence < nextTokenPrecedence()) {
-                const auto &infixBuilder = infixExpressionBuilders.find(nextToken().getType());
-                if (infixBuilder == infixExpressionBuilders.end()) {
+                const auto infixBuilder = infixExpressionBuilders[tokenIndex(nextToken().getType())];
+                if (!infixBuilder) {
                     return expressionNode;
                 }
                 next();
-                expressionNode = infixBuilder->second(this, expressionNode);
+                expressionNode = (this->*infixBuilder)(expressionNode);
             } else {
                 break;
             }
@@ -366,21 +376,41 @@ namespace parser {
     }
 
     std::shared_ptr<ProgramNode> Parser::buildProgram() {
+        const auto programToken = beginProgram();
+        std::vector<std::shared_ptr<StatementNode>> statementNodes;
+        while (seekStatement()) {
+            if (auto statement = buildStatement()) {
+                statementNodes.emplace_back(statement);
+            }
+            next();
+        }
+        const auto program = std::make_shared<ProgramNode>(programToken, statementNodes);
+        program->addArena(_arena);
+        return program;
+    }
+
+    Token Parser::beginProgram() {
         if (!currentTokenIs(core::TokenType::TOKEN_PROGRAM)) {
             recordUnexpectedTokenTypeError(currentToken(), core::TokenType::TOKEN_PROGRAM);
         }
-        const auto &programToken = currentToken();
+        const auto programToken = currentToken();
         next();
-        std::vector<std::shared_ptr<StatementNode>> statementNodes;
-        while (hasNext()) {
-            if (!currentTokenIs(core::TokenType::TOKEN_NEWLINE)){
-                if (auto statement = buildStatement()) {
-                    statementNodes.emplace_back(statement);
-                }
-            }
+        return programToken;
+    }
+
+    const Token *Parser::seekStatement() {
+        while (hasNext() && currentTokenIs(core::TokenType::TOKEN_NEWLINE)) {
             next();
         }
-        return std::make_shared<ProgramNode>(programToken, statementNodes);
+        return hasNext() ? &currentToken() : nullptr;
+    }
+
+    std::shared_ptr<StatementNode> Parser::parseStatement(StringVector &errors) {
+        const size_t errorCount = errorMsgs.size();
+        auto statement = buildStatement();
+        next();
+        errors.assign(errorMsgs.begin() + static_cast<std::ptrdiff_t>(errorCount), errorMsgs.end());
+        return statement;
     }
 
     std::shared_ptr<StatementNode> Parser::buildStatement() {
@@ -388,10 +418,10 @@ namespace parser {
     }
 
     std::shared_ptr<ExpressionStatementNode> Parser::buildExpressionStatement() {
-        const auto &mainToken = currentToken();
+        const auto mainToken = currentToken();
         const auto &expression = buildExpression(Precedence::LOWEST);
         while (nextTokenIs(TokenType::TOKEN_NEWLINE)) next();
-        return std::make_shared<ExpressionStatementNode>(mainToken, expression);
+        return makeNode<ExpressionStatementNode>(mainToken, expression);
     }
 
     StringVector Parser::getErrorMsgs() const {
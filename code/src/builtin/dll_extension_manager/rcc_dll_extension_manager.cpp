@@ -101,18 +101,22 @@ namespace rccdll
 
     std::unordered_map<std::string, std::string> DLLExtensionManager::dllExtPathAliasMap = {};
 
+    std::shared_mutex DLLExtensionManager::dllExtMutex;
+
     void DLLExtensionManager::registerDllExt(const std::string& dllFilepath_,
                                              ast::IRCCCompileInterface* pCompileInterface,
                                              const std::string& alias)
     {
 
         auto dllExt = std::make_unique<DLLExtension>(dllFilepath_, pCompileInterface);
+        std::unique_lock lock(dllExtMutex);
         dllExtMap.insert({dllFilepath_, std::move(dllExt)});
         dllExtPathAliasMap.insert({alias, dllFilepath_});
     }
 
     void DLLExtensionManager::removeDllExt(const std::string& dllExtIdent)
     {
+        std::unique_lock lock(dllExtMutex);
         if (dllExtMap.contains(dllExtIdent))
         {
             dllExtMap.erase(dllExtIdent);
@@ -125,6 +129,7 @@ namespace rccdll
 
     bool DLLExtensionManager::hasFunc(const std::string& funcName)
     {
+        std::shared_lock lock(dllExtMutex);
         return std::any_of(dllExtMap.begin(), dllExtMap.end(), [funcName](const auto &it)
         {
             return it.second->hasFunc(funcName);
@@ -133,6 +138,7 @@ namespace rccdll
 
     std::pair<DLLExtension*, rinterface::DLL_EXT_FUNC> DLLExtensionManager::find(const std::string& funcName)
     {
+        std::shared_lock lock(dllExtMutex);
         for (const auto &dllExt: dllExtMap | std::views::values)
         {
             if (const auto &dllExtFunc = dllExt->find(funcName))
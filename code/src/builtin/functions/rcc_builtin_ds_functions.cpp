@@ -30,9 +30,9 @@ namespace builtin
     BuiltinFuncRetType rcc_listAppend(ast::CompileVisitor& visitor, const CallInfos& callInfos)
     {
         if (const auto &[typeLabel, valueType] = visitor.getTypesFromOpItem(callInfos.posArgOpItems.front());
-            typeLabel->is("list") || typeLabel->is("str") ||
-            (typeLabel->is("any") && (valueType->is("list") ||
-                valueType->is("str") || valueType->is("any"))))
+            typeLabel->isOneOf(symbol::BuiltinTypeLabel::LIST | symbol::BuiltinTypeLabel::STR) ||
+            (typeLabel->is(symbol::BuiltinTypeLabel::ANY) &&
+                valueType->isOneOf(symbol::BuiltinTypeLabel::LIST | symbol::BuiltinTypeLabel::STR | symbol::BuiltinTypeLabel::ANY)))
         {
             return ri::ITER_APND(
                 {callInfos.processedArgs.back()},
@@ -50,9 +50,9 @@ namespace builtin
     BuiltinFuncRetType rcc_listRemove(ast::CompileVisitor& visitor, const CallInfos& callInfos)
     {
         if (const auto &[typeLabel, valueType] = visitor.getTypesFromOpItem(callInfos.posArgOpItems.front());
-            typeLabel->is("list") || typeLabel->is("str") ||
-            (typeLabel->is("any") && (valueType->is("list") ||
-                valueType->is("str") || valueType->is("any"))))
+            typeLabel->isOneOf(symbol::BuiltinTypeLabel::LIST | symbol::BuiltinTypeLabel::STR) ||
+            (typeLabel->is(symbol::BuiltinTypeLabel::ANY) &&
+                valueType->isOneOf(symbol::BuiltinTypeLabel::LIST | symbol::BuiltinTypeLabel::STR | symbol::BuiltinTypeLabel::ANY)))
         {
             return ri::ITER_DEL(callInfos.processedArgs[0], callInfos.processedArgs[1]).toRACode();
         }
@@ -68,9 +68,9 @@ namespace builtin
     BuiltinFuncRetType rcc_dictRemove(ast::CompileVisitor& visitor, const CallInfos& callInfos)
     {
         if (const auto &[typeLabel, valueType] = visitor.getTypesFromOpItem(callInfos.posArgOpItems.front());
-                    typeLabel->is("dict") ||
-                    (typeLabel->is("any") && (valueType->is("dict") ||
-                        valueType->is("any"))))
+                    typeLabel->is(symbol::BuiltinTypeLabel::DICT) ||
+                    (typeLabel->is(symbol::BuiltinTypeLabel::ANY) &&
+                        valueType->isOneOf(symbol::BuiltinTypeLabel::DICT | symbol::BuiltinTypeLabel::ANY)))
         {
             return ri::DICT_DEL(callInfos.processedArgs[0], callInfos.processedArgs[1]).toRACode();
         }
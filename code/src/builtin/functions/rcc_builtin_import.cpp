@@ -6,6 +6,9 @@
 
 #include <filesystem>
 
+#include "../../../include/visitors/rcc_build_scheduler.h"
+#include "../../../include/visitors/rcc_module_cache.h"
+
 namespace builtin
 {
 
@@ -47,12 +50,17 @@ namespace builtin
         }
 
         std::string resolveImportedFilePath(const ast::CompileVisitor& visitor, const std::string& extName)
+        {
+            return resolveImportedFilePath(visitor.getProgramTargetFilePath(), extName);
+        }
+
+        std::string resolveImportedFilePath(const std::string& importerFilePath, const std::string& extName)
         {
             if (const auto &[isBuiltin, builtinExtPath] = isSystemExtensionFile(extName);
                 isBuiltin) {
                 return builtinExtPath;
             }
-            return getAbsolutePath(extName, getFileDirFromPath(visitor.getProgramTargetFilePath()));
+            return getAbsolutePath(extName, getFileDirFromPath(importerFilePath));
         }
 
         std::string generateVariableIdentifier(ast::CompileVisitor& visitor, const std::string& ident,
@@ -84,12 +92,64 @@ namespace builtin
             return raCode;
         }
 
-        std::string compileAndProcessNewExtension(ast::CompileVisitor& visitor,
-                                                  const std::string& importedFilePath,
-                                                  const ast::VarID& tempVarId)
+        std::shared_ptr<const ast::CompiledModule> compileExtensionModule(ast::CompilationSession& importer,
+                                                                          const std::string& entryFilePath,
+                                                                          const std::string& modulePath)
         {
-            std::string raCode;
-            const auto &clasTypeSymbol = symbol::TypeLabelSymbol::clasTypeSymbol(getUnknownPos(), visitor.curScopeLevel());
+            const auto &filepath = getAbsolutePath(modulePath, getDefaultDir());
+            // 源码与依赖均未变化时直接载入缓存的编译结果
+            const auto &cacheKey = ast::ModuleCache::computeKey(importer, filepath);
+            if (!cacheKey.empty())
+            {
+                if (const auto &cached = ast::ModuleCache::load(importer, filepath, cacheKey))
+                {
+                    return importer.getModuleRegistry().publish(cached);
+                }
+            }
+            const auto &session = importer.createModuleSession(filepath);
+            const auto &importVisitor = std::make_shared<ast::CompileVisitor>(session, entryFilePath, filepath, "", false);
+            if (!importVisitor->compile())
+            {
+                throw std::runtime_error("Failed to import extension.");
+            }
+            // 扩展类由模块自身定义，各导入处只生成指向它的别名
+            ast::CompilationSession::Activation activation(*session);
+            const auto &extensionId = ast::VarID(getFileNameFromPath(filepath), filepath,
+                                                 importVisitor->curScopeField(), importVisitor->curScopeLevel());
+            const auto extensionSymbol = std::make_shared<symbol::ClassSymbol>(
+                Pos{1, 1, 0, filepath},
+                extensionId.getNameField(), extensionId.getVid(),
+                std::unordered_set<std::shared_ptr<symbol::LabelSymbol>>{},
+                importVisitor->curScopeLevel(),
+                importVisitor->getSymbolTable());
+            auto module = std::make_shared<ast::CompiledModule>();
+            module->raCode = importVisitor->getCompileResult() + ri::TP_DEF(extensionSymbol->getRaVal()).toRACode()
+                + processImportedSymbols(*importVisitor, *importVisitor, extensionSymbol);
+            extensionSymbol->setCollectionFinished();
+            extensionSymbol->setVisitPermission(symbol::PermissionLabel::PUBLIC);
+            symbol::TypeLabelSymbol::createCustomType(extensionSymbol);
+            module->filepath = filepath;
+            module->session = session;
+            module->visitor = importVisitor;
+            module->extension = extensionSymbol;
+            module->dependencies = session->getImportedModules();
+            module->cacheKey = cacheKey;
+            if (!cacheKey.empty())
+            {
+                ast::ModuleCache::indexSymbols(*module);
+                ast::ModuleCache::store(*module);
+            }
+            return session->getModuleRegistry().publish(module);
+        }
+
+        std::shared_ptr<const ast::CompiledModule> importExtensionModule(ast::CompileVisitor& visitor,
+                                                                         const std::string& importedFilePath,
+                                                                         const ast::VarID& tempVarId)
+        {
+            if (const auto &module = visitor.getSession()->getModuleRegistry().find(importedFilePath))
+            {
+                return module;
+            }
             if (ast::CompileVisitor::checkIsRecursiveImportByLexerPath(importedFilePath))
             {
                 throw base::RCCCompilerError::recursiveImportError(
@@ -112,12 +172,8 @@ namespace builtin
                     "Refactor the code structure and extract the parts with circular dependencies into an independent public extension."
                 });
             }
-            ast::CompileVisitor importVisitor(visitor.getProgramEntryFilePath(), importedFilePath, "", false);
             try {
-                if (!importVisitor.compile())
-                {
-                    throw std::runtime_error("Failed to import extension.");
-                }
+                return compileExtensionModule(*visitor.getSession(), visitor.getProgramEntryFilePath(), importedFilePath);
             } catch (const base::RCCError &)
             {
                 throw;
@@ -134,22 +190,46 @@ namespace builtin
                         "please use the real absolute path for importing."
                     });
             }
-            raCode += importVisitor.getCompileResult();
-            const auto extensionSymbol = std::make_shared<symbol::ClassSymbol>(
-                Pos{1, 1, 0, tempVarId.getFileField()},
-                tempVarId.getNameField(), tempVarId.getVid(),
-                std::unordered_set<std::shared_ptr<symbol::LabelSymbol>>{},
-                visitor.curScopeLevel(),
-                visitor.getSymbolTable());
-            visitor.getSymbolTable().insert(extensionSymbol, false);
-            raCode += ri::TP_DEF(extensionSymbol->getRaVal()).toRACode();
-            raCode += processImportedSymbols(visitor, importVisitor, extensionSymbol);
-            extensionSymbol->setCollectionFinished();
-            extensionSymbol->setVisitPermission(symbol::PermissionLabel::PUBLIC);
-            symbol::TypeLabelSymbol::createCustomType(extensionSymbol);
-            ast::CompileVisitor::registerExtension(importedFilePath, extensionSymbol);
-            visitor.pushIdentItem(tempVarId, clasTypeSymbol, clasTypeSymbol, extensionSymbol);
-            return raCode;
+        }
+
+        std::string linkExtensionModule(ast::CompilationSession& session, const ast::CompiledModule& module)
+        {
+            if (auto &importedModules = session.getImportedModules();
+                std::ranges::find(importedModules, module.filepath) == importedModules.end())
+            {
+                importedModules.push_back(module.filepath);
+            }
+            // 模块会话编译完成后不再修改，合并其自定义类型时无需加锁
+            for (const auto &[uid, name] : module.session->getCustomTypeMap())
+            {
+                session.getCustomTypeMap().try_emplace(uid, name);
+            }
+            for (const auto &[uid, classSymbol] : module.session->getCustomClassSymbolMap())
+            {
+                session.getCustomClassSymbolMap().try_emplace(uid, classSymbol);
+            }
+            // 模块代码只由根会话并入输出：依赖在前，每个模块只出现一次
+            if (session.isModuleSession())
+            {
+                return "";
+            }
+            const auto collectModuleCode = [&session](const auto &self, const ast::CompiledModule &linkedModule) -> std::string {
+                if (!session.getLinkedModules().insert(linkedModule.filepath).second)
+                {
+                    return "";
+                }
+                std::string raCode;
+                for (const auto &dependency : linkedModule.dependencies)
+                {
+                    if (const auto &dependencyModule = session.getModuleRegistry().find(dependency))
+                    {
+                        raCode += self(self, *dependencyModule);
+                    }
+                }
+                session.getOptimizeStats() += linkedModule.session->getOptimizeStats();
+                return raCode + linkedModule.raCode;
+            };
+            return collectModuleCode(collectModuleCode, module);
         }
 
         std::string processImportedSymbols(const ast::CompileVisitor& visitor,
@@ -235,11 +315,9 @@ namespace builtin
                 varIDName, visitor.getCurrentProcessingFilePath(),
                 visitor.curScopeField(), visitor.curScopeLevel());
             ast::CompileVisitor::recordProcessingExtension(importedFilePath, unescapedExtNameArg);
-            if (const auto &registeredExtension = ast::CompileVisitor::getRegisteredExtension(importedFilePath)) {
-                raCode += handleRegisteredExtension(visitor, registeredExtension, tempVarId, isAutomaticForm);
-            } else {
-                raCode += compileAndProcessNewExtension(visitor, importedFilePath, tempVarId);
-            }
+            const auto &module = importExtensionModule(visitor, importedFilePath, tempVarId);
+            raCode += linkExtensionModule(*visitor.getSession(), *module);
+            raCode += handleRegisteredExtension(visitor, module->extension, tempVarId, isAutomaticForm);
             ast::CompileVisitor::popProcessingExtension();
         }
         return raCode;
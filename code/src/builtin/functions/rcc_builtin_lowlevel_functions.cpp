@@ -38,7 +38,7 @@ namespace builtin
     BuiltinFuncRetType rcc_unbindDllExt(ast::CompileVisitor& visitor, const CallInfos& callInfos)
     {
         const auto& aliasItem = callInfos.posArgOpItems.front();
-        if (aliasItem.is(ast::OpItemType::LITERAL_VALUE) && aliasItem.getTypeLabel()->is("str"))
+        if (aliasItem.is(ast::OpItemType::LITERAL_VALUE) && aliasItem.getTypeLabel()->is(symbol::BuiltinTypeLabel::STR))
         {
             rccdll::DLLExtensionManager::removeDllExt(utils::parseStringFormat(aliasItem.getVal()));
             return "";
@@ -100,6 +100,32 @@ namespace builtin
         throw std::runtime_error("Non-existent built-in function: '" + funcName + "'");
     }
 
+    BuiltinDispatch findBuiltinDispatch(const std::string& funcName)
+    {
+        if (const auto &it = pureBuiltinFunctionMap.find(funcName);
+            it != pureBuiltinFunctionMap.end())
+        {
+            return {&it->second, nullptr};
+        }
+        if (const auto &it = builtinFunctionMap.find(funcName);
+            it != builtinFunctionMap.end())
+        {
+            return {nullptr, &it->second};
+        }
+        return {};
+    }
+
+    BuiltinFuncRetType callBuiltinFunction(
+        ast::CompileVisitor &visitor,
+        const BuiltinDispatch &dispatch, const CallInfos& callInfos)
+    {
+        if (dispatch.pureBuiltinFunction)
+        {
+            return dispatch.pureBuiltinFunction->call(visitor, callInfos);
+        }
+        return (*dispatch.builtinFunction)(visitor, callInfos);
+    }
+
     void registerExternalPureBuiltinFunction(const std::string& funcName, const PureBuiltinFunction& func)
     {
         pureBuiltinFunctionMap.insert({funcName, func});
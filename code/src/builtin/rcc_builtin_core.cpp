@@ -166,7 +166,7 @@ namespace builtin
             posArgs.reserve(tempQueue.size());
             while (!tempQueue.empty())
             {
-                posArgs.push_back(tempQueue.front());
+                posArgs.push_back(std::move(tempQueue.front()));
                 tempQueue.pop();
             }
             irccCallInfos->posArgOpItems.size = posArgs.size();
@@ -174,7 +174,7 @@ namespace builtin
             for (size_t i = 0; i < posArgs.size(); ++i)
             {
                 // 假设ast::OpItem有方法转换为IRCCOpItemInterface*（此处为示例）
-                irccCallInfos->posArgOpItems.opItemIArray[i] = new ast::OpItem(posArgs[i]);
+                irccCallInfos->posArgOpItems.opItemIArray[i] = new ast::OpItem(std::move(posArgs[i]));
                 // 注意：实际场景可能需要管理接口指针的生命周期（如引用计数）
             }
 
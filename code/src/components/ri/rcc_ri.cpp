@@ -3,8 +3,14 @@
 //
 
 #include "../../../include/components/ri/rcc_ri.h"
+#include "../../../include/components/ri/rcc_ri_buffer.h"
 
 namespace ri {
+    void RI::emitTo(InstructionBuffer& buffer) const
+    {
+        buffer.appendRaw(toRACode());
+    }
+
     ANNOTATION::ANNOTATION(const std::string& comment)
         : comment(comment) {}
 
@@ -36,6 +42,11 @@ namespace ri {
         return "; ";
     }
 
+    void ANNOTATION::emitTo(InstructionBuffer& buffer) const
+    {
+        buffer.appendAnnotation(comment);
+    }
+
     BREAKPOINT::BREAKPOINT() {}
 
     std::string BREAKPOINT::toRACode() const
@@ -48,6 +59,11 @@ namespace ri {
         return "BREAKPOINT";
     }
 
+    void BREAKPOINT::emitTo(InstructionBuffer& buffer) const
+    {
+        buffer.appendFlag(getOpRI());
+    }
+
 
     FLAG::FLAG(const std::string& opRI, const std::string &comment)
         : opRI(opRI), comment(comment) {}
@@ -62,6 +78,11 @@ namespace ri {
         return opRI;
     }
 
+    void FLAG::emitTo(InstructionBuffer& buffer) const
+    {
+        buffer.appendFlag(opRI, comment);
+    }
+
     ATMP::ATMP()
         : FLAG("ATMP") {}
 
@@ -93,6 +114,11 @@ namespace ri {
         return opRI;
     }
 
+    void PARALLEL::emitTo(InstructionBuffer& buffer) const
+    {
+        buffer.appendOperands(opRI, idents);
+    }
+
     EXE_RASM::EXE_RASM(const std::vector<std::string>& idents)
         : PARALLEL("EXE_RASM", idents) {}
 
@@ -131,6 +157,16 @@ namespace ri {
         return code;
     }
 
+    void ITER_APND::emitTo(InstructionBuffer& buffer) const
+    {
+        if (getIdents().size() == 1)
+        {
+            buffer.appendAnnotation("To generate an empty list does not need to use the [ITER_APND] ri.");
+            return;
+        }
+        PARALLEL::emitTo(buffer);
+    }
+
     FUNC::FUNC(const std::string& ident, std::vector<std::string> params)
         : PARALLEL("FUNC", [&]() mutable
         {
@@ -190,6 +226,11 @@ namespace ri {
         return opRI;
     }
 
+    void UNARY::emitTo(InstructionBuffer& buffer) const
+    {
+        buffer.appendOperands(opRI, {ident});
+    }
+
     EXPOSE::EXPOSE(const std::string& ident)
         : UNARY("EXPOSE", ident) {}
 
@@ -230,6 +271,11 @@ namespace ri {
         return opRI;
     }
 
+    void BINARY::emitTo(InstructionBuffer& buffer) const
+    {
+        buffer.appendOperands(opRI, {rvalue, lvalue});
+    }
+
     DETECT::DETECT(const std::string& type, const std::string& ident)
         : BINARY("DETECT", type, ident) {}
 
@@ -273,6 +319,16 @@ namespace ri {
         return "TP_SET: " + getRValue() + ", " + getLValue() + "\n";
     }
 
+    void TP_SET::emitTo(InstructionBuffer& buffer) const
+    {
+        if (noNeedSetTypeLabels.contains(getRValue()))
+        {
+            buffer.appendAnnotation("No need to set '" + getRValue() + "' type.");
+            return;
+        }
+        BINARY::emitTo(buffer);
+    }
+
     UNTIL::UNTIL(const std::string& cmpData, const std::string& rel)
         : BINARY("UNTIL", cmpData, rel) {}
 
@@ -307,6 +363,11 @@ namespace ri {
         return opRI;
     }
 
+    void TERNARY::emitTo(InstructionBuffer& buffer) const
+    {
+        buffer.appendOperands(opRI, {rvalue1, rvalue2, lvalue});
+    }
+
     ADD::ADD(const std::string &rvalue1, const std::string &rvalue2,
              const std::string &lvalue)
             : TERNARY("ADD", rvalue1, rvalue2, lvalue) {}
@@ -0,0 +1,263 @@
+//
+// Created by RestRegular on 2025/7/16.
+//
+
+#include <stdexcept>
+
+#include "../../../include/components/ri/rcc_ri.h"
+#include "../../../include/components/ri/rcc_ri_buffer.h"
+
+namespace ri {
+
+    uint32_t OperandPool::intern(const std::string_view text)
+    {
+        if (const auto it = _ids.find(text); it != _ids.end())
+        {
+            return it->second;
+        }
+        const auto id = static_cast<uint32_t>(_texts.size());
+        _ids.emplace(_texts.emplace_back(text), id);
+        return id;
+    }
+
+    const std::string &OperandPool::get(const uint32_t id) const
+    {
+        return _texts.at(id);
+    }
+
+    size_t OperandPool::size() const
+    {
+        return _texts.size();
+    }
+
+    InstructionBuffer::InstructionBuffer()
+        : _pool(std::make_shared<OperandPool>()) {}
+
+    InstructionBuffer::InstructionBuffer(std::shared_ptr<OperandPool> pool)
+        : _pool(std::move(pool)) {}
+
+    void InstructionBuffer::appendRecord(const RecordForm form, const uint32_t op)
+    {
+        _records.push_back({form, op, static_cast<uint32_t>(_operands.size()), 0});
+    }
+
+    void InstructionBuffer::appendRaw(const std::string_view text)
+    {
+        if (text.empty()) return;
+        appendRecord(RecordForm::RAW, 0);
+        _operands.push_back(_pool->intern(text));
+        _records.back().operandCount = 1;
+    }
+
+    void InstructionBuffer::appendAnnotation(const std::string_view comment)
+    {
+        appendRecord(RecordForm::ANNOTATION, 0);
+        _operands.push_back(_pool->intern(comment));
+        _records.back().operandCount = 1;
+    }
+
+    void InstructionBuffer::appendFlag(const std::string_view op, const std::string_view comment)
+    {
+        appendRecord(RecordForm::FLAG, _pool->intern(op));
+        if (!comment.empty())
+        {
+            _operands.push_back(_pool->intern(comment));
+            _records.back().operandCount = 1;
+        }
+    }
+
+    void InstructionBuffer::appendOperands(const std::string_view op, const std::vector<std::string> &operands)
+    {
+        appendRecord(RecordForm::OPERANDS, _pool->intern(op));
+        for (const auto &operand : operands)
+        {
+            _operands.push_back(_pool->intern(operand));
+        }
+        _records.back().operandCount = static_cast<uint32_t>(operands.size());
+    }
+
+    void InstructionBuffer::appendOperands(const std::string_view op, const std::initializer_list<std::string_view> operands)
+    {
+        appendRecord(RecordForm::OPERANDS, _pool->intern(op));
+        for (const auto &operand : operands)
+        {
+            _operands.push_back(_pool->intern(operand));
+        }
+        _records.back().operandCount = static_cast<uint32_t>(operands.size());
+    }
+
+    void InstructionBuffer::appendInterned(const RecordForm form, const uint32_t op,
+                                           const std::vector<uint32_t> &operandIds)
+    {
+        appendRecord(form, op);
+        _operands.insert(_operands.end(), operandIds.begin(), operandIds.end());
+        _records.back().operandCount = static_cast<uint32_t>(operandIds.size());
+    }
+
+    InstructionBuffer &InstructionBuffer::operator<<(const RI &ri)
+    {
+        ri.emitTo(*this);
+        return *this;
+    }
+
+    InstructionBuffer InstructionBuffer::split(const size_t begin)
+    {
+        if (begin > _records.size())
+        {
+            throw std::out_of_range("InstructionBuffer::split: record index out of range.");
+        }
+        InstructionBuffer fragment(_pool);
+        if (begin == _records.size())
+        {
+            return fragment;
+        }
+        const auto operandBegin = _records[begin].operandBegin;
+        fragment._records.assign(_records.begin() + static_cast<std::ptrdiff_t>(begin), _records.end());
+        fragment._operands.assign(_operands.begin() + operandBegin, _operands.end());
+        for (auto &record : fragment._records)
+        {
+            record.operandBegin -= operandBegin;
+        }
+        truncate(begin);
+        return fragment;
+    }
+
+    void InstructionBuffer::splice(const InstructionBuffer &other)
+    {
+        if (other._pool != _pool)
+        {
+            // 来自其他编译过程的片段，操作数需重新驻留到本缓冲区的池中
+            for (const auto &record : other._records)
+            {
+                const auto op = record.form == RecordForm::RAW || record.form == RecordForm::ANNOTATION
+                    ? 0 : _pool->intern(other.getOp(record));
+                appendRecord(record.form, op);
+                for (size_t i = 0; i < record.operandCount; i++)
+                {
+                    _operands.push_back(_pool->intern(other.getOperand(record, i)));
+                }
+                _records.back().operandCount = record.operandCount;
+            }
+            return;
+        }
+        const auto operandBase = static_cast<uint32_t>(_operands.size());
+        _records.reserve(_records.size() + other._records.size());
+        for (auto record : other._records)
+        {
+            record.operandBegin += operandBase;
+            _records.push_back(record);
+        }
+        _operands.insert(_operands.end(), other._operands.begin(), other._operands.end());
+    }
+
+    void InstructionBuffer::truncate(const size_t count)
+    {
+        if (count >= _records.size())
+        {
+            return;
+        }
+        _operands.resize(_records[count].operandBegin);
+        _records.resize(count);
+    }
+
+    size_t InstructionBuffer::renderedSize(const size_t begin, const size_t end) const
+    {
+        size_t total = 0;
+        for (size_t i = begin; i < end; i++)
+        {
+            const auto &record = _records[i];
+            for (size_t j = 0; j < record.operandCount; j++)
+            {
+                total += getOperand(record, j).size() + 2;
+            }
+            if (record.form == RecordForm::FLAG || record.form == RecordForm::OPERANDS)
+            {
+                total += getOp(record).size() + 4;
+            }
+            total += 2;
+        }
+        return total;
+    }
+
+    void InstructionBuffer::render(const size_t begin, const size_t end, std::string &out) const
+    {
+        out.reserve(out.size() + renderedSize(begin, end));
+        for (size_t i = begin; i < end; i++)
+        {
+            switch (const auto &record = _records[i]; record.form)
+            {
+            case RecordForm::RAW:
+                out += getOperand(record, 0);
+                break;
+            case RecordForm::ANNOTATION:
+                out += "; ";
+                out += getOperand(record, 0);
+                out += '\n';
+                break;
+            case RecordForm::FLAG:
+                out += getOp(record);
+                out += ": ;";
+                if (record.operandCount > 0)
+                {
+                    out += ' ';
+                    out += getOperand(record, 0);
+                }
+                out += '\n';
+                break;
+            case RecordForm::OPERANDS:
+                out += getOp(record);
+                out += ": ";
+                for (size_t j = 0; j < record.operandCount; j++)
+                {
+                    if (j > 0) out += ", ";
+                    out += getOperand(record, j);
+                }
+                out += '\n';
+                break;
+            }
+        }
+    }
+
+    std::string InstructionBuffer::render() const
+    {
+        std::string out;
+        render(0, _records.size(), out);
+        return out;
+    }
+
+    size_t InstructionBuffer::size() const
+    {
+        return _records.size();
+    }
+
+    bool InstructionBuffer::empty() const
+    {
+        return _records.empty();
+    }
+
+    const InstructionRecord &InstructionBuffer::at(const size_t index) const
+    {
+        return _records.at(index);
+    }
+
+    const std::string &InstructionBuffer::getOp(const InstructionRecord &record) const
+    {
+        return _pool->get(record.op);
+    }
+
+    const std::string &InstructionBuffer::getOperand(const InstructionRecord &record, const size_t index) const
+    {
+        return _pool->get(_operands[record.operandBegin + index]);
+    }
+
+    uint32_t InstructionBuffer::getOperandId(const InstructionRecord &record, const size_t index) const
+    {
+        return _operands[record.operandBegin + index];
+    }
+
+    const std::shared_ptr<OperandPool> &InstructionBuffer::getPool() const
+    {
+        return _pool;
+    }
+
+}
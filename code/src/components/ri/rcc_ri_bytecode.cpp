@@ -0,0 +1,535 @@
+//
+// Created by RestRegular on 2025/7/16.
+//
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../../../include/components/ri/rcc_ri_bytecode.h"
+#include "../../../include/lib/rcc_utils.h"
+
+namespace ri {
+
+    namespace {
+        constexpr std::string_view RAB_MAGIC{"RAB\0", 4};
+
+        enum class SectionId : uint8_t {
+            STRINGS = 1,
+            SYMBOLS = 2,
+            SOURCE_MAP = 3,
+            CODE = 4
+        };
+
+        enum RecordCode : uint8_t {
+            REC_NEWLINE = 0x00,    // 空行
+            REC_RAW = 0x01,        // 原样保存的一行文本（不含换行符）
+            REC_RAW_TAIL = 0x02,   // 文本末尾不以换行符结束的部分
+            REC_ANNOTATION = 0x03, // "; <注释>"
+            REC_SOURCE = 0x04,     // 位置注释，内容取自 SOURCE_MAP 段的下一条目
+            REC_FLAG = 0x05,       // 操作码不在 KNOWN_OPS 中的 FLAG，操作码以字符串索引保存
+            REC_OPERANDS = 0x06,   // 操作码不在 KNOWN_OPS 中的指令
+            REC_KNOWN_OP = 0x10,   // REC_KNOWN_OP + 操作码在 KNOWN_OPS 中的序号
+            REC_FLAG_BIT = 0x80
+        };
+
+        // 操作码表的顺序属于格式的一部分：新的操作码只能追加在末尾，调整顺序需要提升 RAB_VERSION
+        constexpr std::string_view KNOWN_OPS[] = {
+            "BREAKPOINT", "ATMP", "PASS",
+            "EXE_RASM", "ALLOT", "DELETE", "SIN", "ITER_APND", "FUNC", "FUNI", "CALL", "IVOK", "SOUT",
+            "ITER_UNPACK", "TP_DEF",
+            "EXPOSE", "SET", "JMP", "EXIT", "END", "RET",
+            "DETECT", "TP_NEW", "TP_DERIVE", "ITER_SIZE", "PUT", "COPY", "OPP", "JT", "JF", "TP_SET", "UNTIL",
+            "TP_GET", "ITER_DEL", "DICT_KEYS", "DICT_VALUES", "DICT_DEL", "REPEAT",
+            "ADD", "MUL", "DIV", "MOD", "POW", "ROOT", "CMP", "CREL", "JR", "PAIR_SET", "ITER_GET",
+            "TP_ADD_TP_FIELD", "TP_ADD_INST_FIELD", "TP_GET_FIELD", "TP_SET_FIELD"
+        };
+        static_assert(REC_KNOWN_OP + std::size(KNOWN_OPS) <= REC_FLAG_BIT);
+
+        [[noreturn]] void invalidBytecode(const std::string &reason)
+        {
+            throw std::runtime_error("Invalid RAB bytecode: " + reason + ".");
+        }
+
+        void writeSection(std::string &out, const SectionId id, const std::string &payload)
+        {
+            out += static_cast<char>(id);
+            utils::appendVarint(out, payload.size());
+            out += payload;
+        }
+
+        // 十进制非负整数，不接受前导零，保证还原为文本时与原文一致
+        std::optional<uint64_t> parseCanonicalNumber(const std::string_view text)
+        {
+            if (text.empty() || (text.size() > 1 && text.front() == '0')) return std::nullopt;
+            uint64_t value = 0;
+            if (const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+                ec != std::errc{} || end != text.data() + text.size())
+            {
+                return std::nullopt;
+            }
+            return value;
+        }
+
+        class Reader {
+        public:
+            explicit Reader(const std::string_view data)
+                : data(data) {}
+
+            uint8_t byte()
+            {
+                if (offset >= data.size()) invalidBytecode("unexpected end of data");
+                return static_cast<uint8_t>(data[offset++]);
+            }
+
+            uint64_t varint()
+            {
+                uint64_t value = 0;
+                if (!utils::readVarint(data, offset, value)) invalidBytecode("truncated or overlong varint");
+                return value;
+            }
+
+            std::string_view bytes(const uint64_t count)
+            {
+                if (count > remaining()) invalidBytecode("unexpected end of data");
+                const auto result = data.substr(offset, count);
+                offset += count;
+                return result;
+            }
+
+            [[nodiscard]] size_t remaining() const
+            {
+                return data.size() - offset;
+            }
+
+        private:
+            std::string_view data;
+            size_t offset = 0;
+        };
+
+        class Encoder {
+        public:
+            std::string encode(const std::string_view raCode)
+            {
+                for (size_t begin = 0; begin < raCode.size();)
+                {
+                    const auto end = raCode.find('\n', begin);
+                    if (end == std::string_view::npos)
+                    {
+                        records.push_back({REC_RAW_TAIL, 0, {intern(raCode.substr(begin))}});
+                        break;
+                    }
+                    encodeLine(raCode.substr(begin, end - begin));
+                    begin = end + 1;
+                }
+                return write();
+            }
+
+        private:
+            struct Record {
+                uint8_t code;
+                uint32_t op; // 仅 REC_FLAG 与 REC_OPERANDS 使用
+                std::vector<uint32_t> operands;
+            };
+
+            struct SourceEntry {
+                size_t record;
+                uint32_t file;
+                uint64_t line;
+                uint64_t column;
+                uint32_t suffix;
+            };
+
+            // 字符串视图指向编码中的 RA 文本，编码结束前始终有效
+            std::vector<std::string_view> strings;
+            std::vector<size_t> uses;
+            std::unordered_map<std::string_view, uint32_t> ids;
+            std::vector<Record> records;
+            std::vector<uint32_t> symbols;
+            std::unordered_set<uint32_t> declared;
+            std::vector<SourceEntry> sourceMap;
+
+            uint32_t intern(const std::string_view text)
+            {
+                const auto [it, inserted] = ids.try_emplace(text, static_cast<uint32_t>(strings.size()));
+                if (inserted)
+                {
+                    strings.push_back(text);
+                    uses.push_back(0);
+                }
+                uses[it->second]++;
+                return it->second;
+            }
+
+            void declare(const uint32_t id)
+            {
+                if (declared.insert(id).second)
+                {
+                    symbols.push_back(id);
+                }
+            }
+
+            void encodeLine(const std::string_view line)
+            {
+                if (line.empty())
+                {
+                    records.push_back({REC_NEWLINE, 0, {}});
+                } else if (line.starts_with("; "))
+                {
+                    if (const auto comment = line.substr(2); !encodeSourcePosition(comment))
+                    {
+                        records.push_back({REC_ANNOTATION, 0, {intern(comment)}});
+                    }
+                } else if (!encodeInstruction(line))
+                {
+                    records.push_back({REC_RAW, 0, {intern(line)}});
+                }
+            }
+
+            // "<文件>:<行>:<列>, <后缀>"，即 Pos::toString 生成的位置注释
+            bool encodeSourcePosition(const std::string_view comment)
+            {
+                const auto comma = comment.find(", ");
+                if (comma == std::string_view::npos) return false;
+                const auto head = comment.substr(0, comma);
+                const auto columnColon = head.rfind(':');
+                if (columnColon == std::string_view::npos || columnColon == 0) return false;
+                const auto lineColon = head.rfind(':', columnColon - 1);
+                if (lineColon == std::string_view::npos || lineColon == 0) return false;
+                const auto line = parseCanonicalNumber(head.substr(lineColon + 1, columnColon - lineColon - 1));
+                const auto column = parseCanonicalNumber(head.substr(columnColon + 1));
+                if (!line || !column) return false;
+                sourceMap.push_back({records.size(), intern(head.substr(0, lineColon)), *line, *column,
+                    intern(comment.substr(comma + 2))});
+                records.push_back({REC_SOURCE, 0, {}});
+                return true;
+            }
+
+            bool encodeInstruction(const std::string_view line)
+            {
+                const auto colon = line.find(": ");
+                if (colon == std::string_view::npos || colon == 0 ||
+                    !std::ranges::all_of(line.substr(0, colon), [](const char c) {
+                        return std::isupper(static_cast<unsigned char>(c)) || c == '_';
+                    }))
+                {
+                    return false;
+                }
+                const auto opText = line.substr(0, colon);
+                const auto rest = line.substr(colon + 2);
+                const auto known = std::ranges::find(KNOWN_OPS, opText);
+                const bool isKnown = known != std::end(KNOWN_OPS);
+                Record record{
+                    static_cast<uint8_t>(isKnown ? REC_KNOWN_OP + (known - std::begin(KNOWN_OPS)) : +REC_OPERANDS),
+                    isKnown ? 0 : intern(opText), {}
+                };
+                if (rest == ";" || rest.starts_with("; "))
+                {
+                    record.code = static_cast<uint8_t>(isKnown ? record.code | REC_FLAG_BIT : REC_FLAG);
+                    if (rest.size() > 1) record.operands.push_back(intern(rest.substr(2)));
+                    records.push_back(std::move(record));
+                    return true;
+                }
+                // 以 ", " 分隔操作数，字符串字面量内部的分隔符不算
+                char quote = 0;
+                size_t operandBegin = 0;
+                for (size_t i = 0; i < rest.size(); i++)
+                {
+                    if (quote)
+                    {
+                        if (rest[i] == '\\') i++;
+                        else if (rest[i] == quote) quote = 0;
+                    } else if (rest[i] == '"' || rest[i] == '\'')
+                    {
+                        quote = rest[i];
+                    } else if (rest[i] == ',' && i + 1 < rest.size() && rest[i + 1] == ' ')
+                    {
+                        record.operands.push_back(intern(rest.substr(operandBegin, i - operandBegin)));
+                        operandBegin = ++i + 1;
+                    }
+                }
+                record.operands.push_back(intern(rest.substr(operandBegin)));
+                if (opText == "ALLOT")
+                {
+                    std::ranges::for_each(record.operands, [this](const uint32_t id) { declare(id); });
+                } else if (opText == "FUNC" || opText == "FUNI" || opText == "TP_DEF")
+                {
+                    declare(record.operands.front());
+                }
+                records.push_back(std::move(record));
+                return true;
+            }
+
+            [[nodiscard]] std::string write() const
+            {
+                // 按引用次数降序重排字符串表，使高频操作数的索引只占一个字节
+                std::vector<uint32_t> order(strings.size());
+                std::iota(order.begin(), order.end(), 0);
+                std::ranges::stable_sort(order, [this](const uint32_t lhs, const uint32_t rhs) {
+                    return uses[lhs] > uses[rhs];
+                });
+                std::vector<uint32_t> remap(strings.size());
+                for (uint32_t i = 0; i < order.size(); i++)
+                {
+                    remap[order[i]] = i;
+                }
+
+                std::string out(RAB_MAGIC);
+                out += static_cast<char>(RAB_VERSION);
+                utils::appendVarint(out, 4);
+
+                std::string section;
+                utils::appendVarint(section, strings.size());
+                for (const auto id : order)
+                {
+                    utils::appendVarint(section, strings[id].size());
+                    section += strings[id];
+                }
+                writeSection(out, SectionId::STRINGS, section);
+
+                section.clear();
+                utils::appendVarint(section, symbols.size());
+                for (const auto id : symbols)
+                {
+                    utils::appendVarint(section, remap[id]);
+                }
+                writeSection(out, SectionId::SYMBOLS, section);
+
+                section.clear();
+                utils::appendVarint(section, sourceMap.size());
+                size_t lastRecord = 0;
+                for (const auto &entry : sourceMap)
+                {
+                    utils::appendVarint(section, entry.record - lastRecord);
+                    utils::appendVarint(section, remap[entry.file]);
+                    utils::appendVarint(section, entry.line);
+                    utils::appendVarint(section, entry.column);
+                    utils::appendVarint(section, remap[entry.suffix]);
+                    lastRecord = entry.record;
+                }
+                writeSection(out, SectionId::SOURCE_MAP, section);
+
+                section.clear();
+                utils::appendVarint(section, records.size());
+                for (const auto &record : records)
+                {
+                    section += static_cast<char>(record.code);
+                    switch (record.code)
+                    {
+                    case REC_NEWLINE:
+                    case REC_SOURCE:
+                        break;
+                    case REC_RAW:
+                    case REC_RAW_TAIL:
+                    case REC_ANNOTATION:
+                        utils::appendVarint(section, remap[record.operands.front()]);
+                        break;
+                    default:
+                        if (record.code == REC_FLAG || record.code == REC_OPERANDS)
+                        {
+                            utils::appendVarint(section, remap[record.op]);
+                        }
+                        utils::appendVarint(section, record.operands.size());
+                        for (const auto id : record.operands)
+                        {
+                            utils::appendVarint(section, remap[id]);
+                        }
+                        break;
+                    }
+                }
+                writeSection(out, SectionId::CODE, section);
+                return out;
+            }
+        };
+
+        class Decoder {
+        public:
+            std::string decode(const std::string_view bytecode)
+            {
+                if (!isRabBytecode(bytecode)) invalidBytecode("missing RAB header");
+                Reader reader(bytecode.substr(RAB_MAGIC.size()));
+                if (const auto version = reader.byte(); version != RAB_VERSION)
+                {
+                    invalidBytecode("unsupported version " + std::to_string(version));
+                }
+                std::optional<std::string_view> code;
+                for (auto sectionCount = reader.varint(); sectionCount > 0; sectionCount--)
+                {
+                    const auto id = static_cast<SectionId>(reader.byte());
+                    Reader section(reader.bytes(reader.varint()));
+                    switch (id)
+                    {
+                    case SectionId::STRINGS:
+                        readStrings(section);
+                        break;
+                    case SectionId::SYMBOLS:
+                        for (auto count = section.varint(); count > 0; count--)
+                        {
+                            (void) getString(section.varint());
+                        }
+                        break;
+                    case SectionId::SOURCE_MAP:
+                        readSourceMap(section);
+                        break;
+                    case SectionId::CODE:
+                        code = section.bytes(section.remaining());
+                        break;
+                    default:
+                        // 更高版本追加的段，按长度跳过
+                        break;
+                    }
+                }
+                if (!code) invalidBytecode("missing CODE section");
+                return render(Reader(*code));
+            }
+
+        private:
+            struct SourceEntry {
+                uint64_t record;
+                std::string_view file;
+                uint64_t line;
+                uint64_t column;
+                std::string_view suffix;
+            };
+
+            std::vector<std::string_view> strings;
+            std::vector<SourceEntry> sourceMap;
+
+            [[nodiscard]] std::string_view getString(const uint64_t index) const
+            {
+                if (index >= strings.size()) invalidBytecode("string index out of range");
+                return strings[index];
+            }
+
+            void readStrings(Reader &section)
+            {
+                const auto count = section.varint();
+                strings.reserve(std::min<uint64_t>(count, section.remaining()));
+                for (uint64_t i = 0; i < count; i++)
+                {
+                    strings.push_back(section.bytes(section.varint()));
+                }
+            }
+
+            void readSourceMap(Reader &section)
+            {
+                uint64_t record = 0;
+                for (auto count = section.varint(); count > 0; count--)
+                {
+                    record += section.varint();
+                    const auto file = getString(section.varint());
+                    const auto line = section.varint();
+                    const auto column = section.varint();
+                    sourceMap.push_back({record, file, line, column, getString(section.varint())});
+                }
+            }
+
+            [[nodiscard]] std::string render(Reader code) const
+            {
+                std::string out;
+                out.reserve(code.remaining() * 4);
+                size_t nextSource = 0;
+                const auto recordCount = code.varint();
+                for (uint64_t index = 0; index < recordCount; index++)
+                {
+                    switch (const auto recordCode = code.byte(); recordCode)
+                    {
+                    case REC_NEWLINE:
+                        out += '\n';
+                        break;
+                    case REC_RAW:
+                        out += getString(code.varint());
+                        out += '\n';
+                        break;
+                    case REC_RAW_TAIL:
+                        out += getString(code.varint());
+                        break;
+                    case REC_ANNOTATION:
+                        out += "; ";
+                        out += getString(code.varint());
+                        out += '\n';
+                        break;
+                    case REC_SOURCE:
+                    {
+                        if (nextSource >= sourceMap.size() || sourceMap[nextSource].record != index)
+                        {
+                            invalidBytecode("source map does not match the code section");
+                        }
+                        const auto &entry = sourceMap[nextSource++];
+                        out += "; ";
+                        out += entry.file;
+                        out += ':' + std::to_string(entry.line) + ':' + std::to_string(entry.column) + ", ";
+                        out += entry.suffix;
+                        out += '\n';
+                        break;
+                    }
+                    default:
+                        renderInstruction(recordCode, code, out);
+                        break;
+                    }
+                }
+                return out;
+            }
+
+            void renderInstruction(const uint8_t recordCode, Reader &code, std::string &out) const
+            {
+                const bool isFlag = recordCode == REC_FLAG ||
+                    (recordCode >= REC_KNOWN_OP && (recordCode & REC_FLAG_BIT));
+                if (recordCode == REC_FLAG || recordCode == REC_OPERANDS)
+                {
+                    out += getString(code.varint());
+                } else
+                {
+                    const auto known = (recordCode & ~REC_FLAG_BIT) - REC_KNOWN_OP;
+                    if (recordCode < REC_KNOWN_OP || known < 0 || known >= static_cast<int>(std::size(KNOWN_OPS)))
+                    {
+                        invalidBytecode("unknown record code " + std::to_string(recordCode));
+                    }
+                    out += KNOWN_OPS[known];
+                }
+                const auto operandCount = code.varint();
+                if (isFlag)
+                {
+                    if (operandCount > 1) invalidBytecode("flag record with more than one comment");
+                    out += ": ;";
+                    if (operandCount > 0)
+                    {
+                        out += ' ';
+                        out += getString(code.varint());
+                    }
+                } else
+                {
+                    out += ": ";
+                    for (uint64_t i = 0; i < operandCount; i++)
+                    {
+                        if (i > 0) out += ", ";
+                        out += getString(code.varint());
+                    }
+                }
+                out += '\n';
+            }
+        };
+    }
+
+    bool isRabBytecode(const std::string_view data)
+    {
+        return data.size() > RAB_MAGIC.size() && data.starts_with(RAB_MAGIC);
+    }
+
+    std::string encodeRabBytecode(const std::string_view raCode)
+    {
+        return Encoder().encode(raCode);
+    }
+
+    std::string decodeRabBytecode(const std::string_view bytecode)
+    {
+        return Decoder().decode(bytecode);
+    }
+
+}
@@ -0,0 +1,223 @@
+//
+// Created by RestRegular on 2025/7/16.
+//
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+#include "../../../include/components/ri/rcc_ri_fold.h"
+
+namespace ri {
+
+    namespace {
+        struct Constant {
+            ConstantKind kind;
+            int64_t intValue = 0;
+            double floatValue = 0;
+            bool boolValue = false;
+
+            [[nodiscard]] bool isNumber() const
+            {
+                return kind == ConstantKind::INT || kind == ConstantKind::FLOAT;
+            }
+
+            [[nodiscard]] double asDouble() const
+            {
+                return kind == ConstantKind::INT ? static_cast<double>(intValue) : floatValue;
+            }
+        };
+
+        bool isDigits(const std::string_view text)
+        {
+            return !text.empty() && std::ranges::all_of(text, [](const char c) {
+                return std::isdigit(static_cast<unsigned char>(c));
+            });
+        }
+
+        std::optional<Constant> parseConstant(const std::string_view text)
+        {
+            Constant constant{ConstantKind::BOOL};
+            if (text == "true" || text == "false")
+            {
+                constant.boolValue = text == "true";
+                return constant;
+            }
+            if (text.size() >= 2 && text.front() == '"' && text.back() == '"')
+            {
+                constant.kind = ConstantKind::STR;
+                return constant;
+            }
+            const auto unsignedText = text.starts_with('-') ? text.substr(1) : text;
+            if (const auto dot = unsignedText.find('.'); dot == std::string_view::npos)
+            {
+                if (!isDigits(unsignedText) || (unsignedText.size() > 1 && unsignedText.front() == '0'))
+                {
+                    return std::nullopt;
+                }
+                constant.kind = ConstantKind::INT;
+                if (const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), constant.intValue);
+                    ec != std::errc{} || end != text.data() + text.size())
+                {
+                    return std::nullopt;
+                }
+                return constant;
+            } else if (!isDigits(unsignedText.substr(0, dot)) || !isDigits(unsignedText.substr(dot + 1)))
+            {
+                return std::nullopt;
+            }
+            constant.kind = ConstantKind::FLOAT;
+            if (const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), constant.floatValue);
+                ec != std::errc{} || end != text.data() + text.size())
+            {
+                return std::nullopt;
+            }
+            return constant;
+        }
+
+        std::string formatBool(const bool value)
+        {
+            return value ? "true" : "false";
+        }
+
+        // 取能精确还原的最短表示，整数值补上小数部分，保证运行时仍按 float 处理
+        std::optional<std::string> formatFloat(const double value)
+        {
+            if (!std::isfinite(value)) return std::nullopt;
+            char buffer[64];
+            const auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            if (ec != std::errc{}) return std::nullopt;
+            std::string text(buffer, end);
+            if (text.find_first_of("eE") != std::string::npos) return std::nullopt;
+            if (text.find('.') == std::string::npos) text += ".0";
+            return text;
+        }
+
+        std::optional<std::string> foldInt(const std::string_view op, const int64_t lhs, const int64_t rhs)
+        {
+            int64_t result = 0;
+            if (op == "ADD")
+            {
+                if (__builtin_add_overflow(lhs, rhs, &result)) return std::nullopt;
+            } else if (op == "MUL")
+            {
+                if (__builtin_mul_overflow(lhs, rhs, &result)) return std::nullopt;
+            } else if (op == "DIV" || op == "MOD")
+            {
+                if (rhs == 0 || (lhs == std::numeric_limits<int64_t>::min() && rhs == -1)) return std::nullopt;
+                result = op == "DIV" ? lhs / rhs : lhs % rhs;
+            } else
+            {
+                return std::nullopt;
+            }
+            return std::to_string(result);
+        }
+
+        std::optional<std::string> foldFloat(const std::string_view op, const double lhs, const double rhs)
+        {
+            if (op == "ADD") return formatFloat(lhs + rhs);
+            if (op == "MUL") return formatFloat(lhs * rhs);
+            if (op == "DIV" && rhs != 0) return formatFloat(lhs / rhs);
+            // 浮点取模的结果依赖运行时实现，不在编译期求值
+            return std::nullopt;
+        }
+    }
+
+    std::optional<ConstantKind> getConstantKind(const std::string_view text)
+    {
+        if (const auto constant = parseConstant(text))
+        {
+            return constant->kind;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<std::string> foldArithmetic(const std::string_view op, const std::string_view lhs,
+                                              const std::string_view rhs)
+    {
+        const auto left = parseConstant(lhs);
+        const auto right = parseConstant(rhs);
+        if (!left || !right) return std::nullopt;
+        if (left->kind == ConstantKind::INT && right->kind == ConstantKind::INT)
+        {
+            return foldInt(op, left->intValue, right->intValue);
+        }
+        if (left->isNumber() && right->isNumber())
+        {
+            return foldFloat(op, left->asDouble(), right->asDouble());
+        }
+        if (op == "ADD" && left->kind == ConstantKind::STR && right->kind == ConstantKind::STR)
+        {
+            std::string result(lhs.substr(0, lhs.size() - 1));
+            result += rhs.substr(1);
+            return result;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<std::string> foldOpposite(const std::string_view operand)
+    {
+        const auto constant = parseConstant(operand);
+        if (!constant) return std::nullopt;
+        switch (constant->kind)
+        {
+        case ConstantKind::INT:
+            if (constant->intValue == std::numeric_limits<int64_t>::min()) return std::nullopt;
+            return std::to_string(-constant->intValue);
+        case ConstantKind::FLOAT:
+            return formatFloat(-constant->floatValue);
+        case ConstantKind::BOOL:
+            return formatBool(!constant->boolValue);
+        default:
+            return std::nullopt;
+        }
+    }
+
+    std::optional<std::string> foldRelation(const std::string_view relation, const std::string_view lhs,
+                                            const std::string_view rhs)
+    {
+        const auto left = parseConstant(lhs);
+        const auto right = parseConstant(rhs);
+        if (!left || !right) return std::nullopt;
+        if (relation == "AND" || relation == "OR")
+        {
+            if (left->kind != ConstantKind::BOOL || right->kind != ConstantKind::BOOL) return std::nullopt;
+            return formatBool(relation == "AND"
+                                  ? left->boolValue && right->boolValue
+                                  : left->boolValue || right->boolValue);
+        }
+        if (left->isNumber() && right->isNumber())
+        {
+            // 两侧都是整数时按整数比较，避免大整数转换为 double 时的精度损失
+            const bool bothInt = left->kind == ConstantKind::INT && right->kind == ConstantKind::INT;
+            const auto less = bothInt ? left->intValue < right->intValue : left->asDouble() < right->asDouble();
+            const auto equal = bothInt ? left->intValue == right->intValue : left->asDouble() == right->asDouble();
+            if (relation == "RE") return formatBool(equal);
+            if (relation == "RNE") return formatBool(!equal);
+            if (relation == "RL") return formatBool(less);
+            if (relation == "RLE") return formatBool(less || equal);
+            if (relation == "RG") return formatBool(!less && !equal);
+            if (relation == "RGE") return formatBool(!less);
+            return std::nullopt;
+        }
+        if (left->kind != right->kind || (relation != "RE" && relation != "RNE")) return std::nullopt;
+        if (left->kind == ConstantKind::STR && lhs != rhs &&
+            (lhs.find('\\') != std::string_view::npos || rhs.find('\\') != std::string_view::npos))
+        {
+            // 转义序列有多种写法，文本不同不代表字符串不同
+            return std::nullopt;
+        }
+        const bool equal = left->kind == ConstantKind::BOOL ? left->boolValue == right->boolValue : lhs == rhs;
+        return formatBool(relation == "RE" ? equal : !equal);
+    }
+
+    std::optional<bool> getConstantTruth(const std::string_view text)
+    {
+        if (text == "true") return true;
+        if (text == "false") return false;
+        return std::nullopt;
+    }
+
+}
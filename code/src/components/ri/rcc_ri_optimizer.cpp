@@ -0,0 +1,1414 @@
+//
+// Created by RestRegular on 2025/7/16.
+//
+
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <map>
+#include <ranges>
+#include <sstream>
+#include <unordered_map>
+
+#include "../../../include/components/ri/rcc_ri.h"
+#include "../../../include/components/ri/rcc_ri_fold.h"
+#include "../../../include/components/ri/rcc_ri_optimizer.h"
+
+namespace ri {
+
+    namespace {
+        // 最后一个操作数的角色，其余操作数均只被读取
+        enum class LastOperand : uint8_t {
+            READ,   // 只读取
+            DEF,    // 整体覆盖写入，不读取旧值
+            MODIFY  // 在旧值上修改（设置类型、追加元素等）
+        };
+
+        struct OpInfo {
+            LastOperand last;
+            // 写入目标不再被读取时可整条删除（无其他副作用，也不会在运行时抛出异常）
+            bool removable;
+            // 不构成控制结构，位于不可达区域时可删除
+            bool straight;
+            // 执行后不会落到下一条指令
+            bool terminator;
+        };
+
+        // 未登记的操作码（FUNI、TP_DEF、ITER_DEL 等）按不透明处理：其操作数中的临时变量不做任何改写
+        const std::unordered_map<std::string, OpInfo> &getOpInfoMap()
+        {
+            static const std::unordered_map<std::string, OpInfo> opInfoMap = {
+                {"PUT", {LastOperand::DEF, true, true, false}},
+                {"COPY", {LastOperand::DEF, true, true, false}},
+                {"OPP", {LastOperand::DEF, true, true, false}},
+                {"ADD", {LastOperand::DEF, true, true, false}},
+                {"MUL", {LastOperand::DEF, true, true, false}},
+                {"POW", {LastOperand::DEF, true, true, false}},
+                {"CMP", {LastOperand::DEF, true, true, false}},
+                {"CREL", {LastOperand::DEF, true, true, false}},
+                {"TP_GET", {LastOperand::DEF, true, true, false}},
+                {"ITER_SIZE", {LastOperand::DEF, true, true, false}},
+                {"DICT_KEYS", {LastOperand::DEF, true, true, false}},
+                {"DICT_VALUES", {LastOperand::DEF, true, true, false}},
+                // 除零、越界、字段缺失与函数调用可能在运行时失败，不能随写入目标一起删除
+                {"DIV", {LastOperand::DEF, false, true, false}},
+                {"MOD", {LastOperand::DEF, false, true, false}},
+                {"ROOT", {LastOperand::DEF, false, true, false}},
+                {"ITER_GET", {LastOperand::DEF, false, true, false}},
+                {"TP_GET_FIELD", {LastOperand::DEF, false, true, false}},
+                {"TP_NEW", {LastOperand::DEF, false, true, false}},
+                {"IVOK", {LastOperand::DEF, false, true, false}},
+                {"TP_SET", {LastOperand::MODIFY, true, true, false}},
+                {"ITER_APND", {LastOperand::MODIFY, true, true, false}},
+                {"PAIR_SET", {LastOperand::MODIFY, true, true, false}},
+                {"SOUT", {LastOperand::READ, false, true, false}},
+                {"CALL", {LastOperand::READ, false, true, false}},
+                {"JT", {LastOperand::READ, false, true, false}},
+                {"JF", {LastOperand::READ, false, true, false}},
+                {"JR", {LastOperand::READ, false, true, false}},
+                {"JMP", {LastOperand::READ, false, true, true}},
+                {"RET", {LastOperand::READ, false, true, true}},
+                {"EXIT", {LastOperand::READ, false, true, true}},
+                {"SET", {LastOperand::READ, false, false, false}},
+                {"END", {LastOperand::READ, false, false, false}},
+            };
+            return opInfoMap;
+        }
+
+        // 分支与块结构指令：临时变量的活跃区间只在这些指令之间的直线代码中计算
+        const std::unordered_set<std::string> &getControlOps()
+        {
+            static const std::unordered_set<std::string> controlOps = {
+                "SET", "JMP", "JT", "JF", "JR", "RET", "EXIT", "UNTIL", "REPEAT", "END", "FUNI", "FUNC", "DETECT"
+            };
+            return controlOps;
+        }
+
+        struct Instruction {
+            RecordForm form;
+            uint32_t op;
+            std::vector<uint32_t> operands;
+            const OpInfo *info;
+            bool removed = false;
+        };
+
+        struct TempUsage {
+            size_t allotAt = SIZE_MAX;
+            uint32_t allots = 0;
+            uint32_t reads = 0;
+            std::vector<size_t> writes;
+            bool opaque = false;
+        };
+
+        bool isLiteral(const std::string &text)
+        {
+            if (text.empty()) return false;
+            if (text == "true" || text == "false" || text == "null") return true;
+            const auto first = static_cast<unsigned char>(text[0]);
+            if (std::isdigit(first) || first == '"' || first == '\'') return true;
+            return first == '-' && text.size() > 1 && std::isdigit(static_cast<unsigned char>(text[1]));
+        }
+
+        class Optimizer {
+        public:
+            Optimizer(InstructionBuffer &buffer, const std::unordered_set<std::string> &tempVars,
+                      const std::unordered_set<std::string> &externalNames, OptimizeStats &stats)
+                : pool(*buffer.getPool()), stats(stats)
+            {
+                const auto &opInfoMap = getOpInfoMap();
+                opAllot = pool.intern("ALLOT");
+                opPut = pool.intern("PUT");
+                opSet = pool.intern("SET");
+                opJmp = pool.intern("JMP");
+                opFuni = pool.intern("FUNI");
+                opFunc = pool.intern("FUNC");
+                opEnd = pool.intern("END");
+                opTpDef = pool.intern("TP_DEF");
+                opAddTpField = pool.intern("TP_ADD_TP_FIELD");
+                opAddInstField = pool.intern("TP_ADD_INST_FIELD");
+                opGetField = pool.intern("TP_GET_FIELD");
+                opSetField = pool.intern("TP_SET_FIELD");
+                opOpp = pool.intern("OPP");
+                opCmp = pool.intern("CMP");
+                opCrel = pool.intern("CREL");
+                opJt = pool.intern("JT");
+                opJf = pool.intern("JF");
+                opRet = pool.intern("RET");
+                opCall = pool.intern("CALL");
+                opIvok = pool.intern("IVOK");
+                for (const auto op : {"ADD", "MUL", "DIV", "MOD"})
+                {
+                    arithmeticOps.emplace(pool.intern(op), op);
+                }
+                // 只读取操作数的值、不会经由引用改写它的指令
+                for (const auto op : {"PUT", "OPP", "ADD", "MUL", "DIV", "MOD", "POW", "CMP", "CREL", "JT", "JF", "SOUT"})
+                {
+                    valueReadOps.insert(pool.intern(op));
+                }
+                code.reserve(buffer.size());
+                for (size_t i = 0; i < buffer.size(); i++)
+                {
+                    const auto &record = buffer.at(i);
+                    if (record.form == RecordForm::RAW && liftRaw(buffer.getOperand(record, 0)))
+                    {
+                        continue;
+                    }
+                    Instruction instruction{record.form, record.op, {}, nullptr};
+                    instruction.operands.reserve(record.operandCount);
+                    for (size_t j = 0; j < record.operandCount; j++)
+                    {
+                        instruction.operands.push_back(buffer.getOperandId(record, j));
+                    }
+                    if (record.form == RecordForm::OPERANDS)
+                    {
+                        if (const auto it = opInfoMap.find(buffer.getOp(record)); it != opInfoMap.end())
+                        {
+                            instruction.info = &it->second;
+                        }
+                    }
+                    code.push_back(std::move(instruction));
+                }
+                isTemp.assign(pool.size(), false);
+                for (uint32_t id = 0; id < pool.size(); id++)
+                {
+                    isTemp[id] = tempVars.contains(pool.get(id));
+                }
+                collectPinned(externalNames);
+                // 以拆分 RAW 之后的记录数为准，与输出的记录数可比
+                stats.inputRecords = code.size();
+            }
+
+            void run(const int compileLevel, const bool treeShake, const size_t inlineThreshold,
+                     const std::function<std::string()> &newName)
+            {
+                if (compileLevel < 2)
+                {
+                    // 低编译级别只按要求裁剪未引用的定义，保持其余输出便于调试
+                    if (treeShake) shakeTree();
+                    return;
+                }
+                // 内联只做一次：展开出的代码由之后的各轮优化继续处理（字面量实参的传播、返回值的转发等）
+                // 编译级别 2 只在展开不会使指令总数增加时展开，编译级别 3 则优先减少调用
+                if (inlineThreshold > 0 && newName) inlineCalls(inlineThreshold, newName, compileLevel >= 3);
+                // 每一轮的改写都可能为下一轮制造新的机会（例如复制传播之后临时变量成为死存储）
+                for (int round = 0; round < 8; round++)
+                {
+                    bool changed = removeUnreachable();
+                    changed |= removeRedundantJumps();
+                    changed |= foldConstants();
+                    changed |= forwardTemps();
+                    changed |= propagateCopies();
+                    changed |= propagateConstants();
+                    changed |= eliminateDeadStores();
+                    // 裁剪掉的定义留下的临时变量由下一轮的死存储消除清理
+                    if (treeShake) changed |= shakeTree();
+                    if (!changed) break;
+                }
+                allocateTempSlots();
+                if (compileLevel >= 3)
+                {
+                    stripAnnotations();
+                }
+            }
+
+            void writeTo(InstructionBuffer &buffer) const
+            {
+                InstructionBuffer optimized(buffer.getPool());
+                for (size_t i = 0; i < code.size(); i++)
+                {
+                    if (code[i].removed) continue;
+                    optimized.appendInterned(code[i].form, code[i].op, code[i].operands);
+                    if (const auto it = slotDeletes.find(i); it != slotDeletes.end())
+                    {
+                        std::vector<std::string> slots;
+                        slots.reserve(it->second.size());
+                        for (const auto slot : it->second)
+                        {
+                            slots.push_back(pool.get(slot));
+                        }
+                        optimized << RI_DELETE(slots);
+                    }
+                }
+                buffer = std::move(optimized);
+            }
+
+        private:
+            OperandPool &pool;
+            OptimizeStats &stats;
+            std::vector<Instruction> code;
+            std::vector<bool> isTemp;
+            // 在 RAW 记录中出现过的标识符与指令流之外引用的名称
+            std::unordered_set<uint32_t> pinned;
+            // 指令下标 -> 在该指令之后释放的临时变量槽位
+            std::unordered_map<size_t, std::vector<uint32_t>> slotDeletes;
+            uint32_t opAllot, opPut, opSet, opJmp, opFuni, opFunc, opEnd;
+            uint32_t opTpDef, opAddTpField, opAddInstField, opGetField, opSetField;
+            uint32_t opOpp, opCmp, opCrel, opJt, opJf, opRet, opCall, opIvok;
+            std::unordered_map<uint32_t, std::string_view> arithmeticOps;
+            std::unordered_set<uint32_t> valueReadOps;
+
+            // 内置函数与导入模块以 RA 文本的形式产出指令，逐行拆回结构化记录后才能参与数据流分析
+            // 只有每一行都能按原样重新生成时才拆分，否则整段保留为 RAW，其中的标识符全部视为外部引用
+            bool liftRaw(const std::string_view text)
+            {
+                if (text.empty() || text.back() != '\n') return false;
+                const auto &opInfoMap = getOpInfoMap();
+                std::vector<Instruction> lifted;
+                for (size_t begin = 0; begin < text.size();)
+                {
+                    const auto end = text.find('\n', begin);
+                    const auto line = text.substr(begin, end - begin);
+                    begin = end + 1;
+                    if (line.empty())
+                    {
+                        lifted.push_back({RecordForm::RAW, 0, {pool.intern("\n")}, nullptr});
+                        continue;
+                    }
+                    if (line.starts_with("; "))
+                    {
+                        lifted.push_back({RecordForm::ANNOTATION, 0, {pool.intern(line.substr(2))}, nullptr});
+                        continue;
+                    }
+                    const auto colon = line.find(": ");
+                    if (colon == std::string_view::npos || colon == 0 ||
+                        !std::ranges::all_of(line.substr(0, colon), [](const char c) {
+                            return std::isupper(static_cast<unsigned char>(c)) || c == '_';
+                        }))
+                    {
+                        return false;
+                    }
+                    const auto opText = line.substr(0, colon);
+                    const auto rest = line.substr(colon + 2);
+                    const auto infoIt = opInfoMap.find(std::string(opText));
+                    const auto info = infoIt == opInfoMap.end() ? nullptr : &infoIt->second;
+                    if (!info && rest.starts_with(';'))
+                    {
+                        if (rest.size() > 1 && !rest.starts_with("; ")) return false;
+                        Instruction flag{RecordForm::FLAG, pool.intern(opText), {}, nullptr};
+                        if (rest.size() > 2) flag.operands.push_back(pool.intern(rest.substr(2)));
+                        lifted.push_back(std::move(flag));
+                        continue;
+                    }
+                    // 以 ", " 分隔操作数，字符串字面量内部的分隔符不算
+                    Instruction instruction{RecordForm::OPERANDS, pool.intern(opText), {}, info};
+                    char quote = 0;
+                    size_t operandBegin = 0;
+                    for (size_t j = 0; j < rest.size(); j++)
+                    {
+                        if (quote)
+                        {
+                            if (rest[j] == '\\') j++;
+                            else if (rest[j] == quote) quote = 0;
+                        } else if (rest[j] == '"' || rest[j] == '\'')
+                        {
+                            quote = rest[j];
+                        } else if (rest[j] == ',' && j + 1 < rest.size() && rest[j + 1] == ' ')
+                        {
+                            instruction.operands.push_back(pool.intern(rest.substr(operandBegin, j - operandBegin)));
+                            operandBegin = ++j + 1;
+                        }
+                    }
+                    if (quote) return false;
+                    instruction.operands.push_back(pool.intern(rest.substr(operandBegin)));
+                    lifted.push_back(std::move(instruction));
+                }
+                code.insert(code.end(), std::make_move_iterator(lifted.begin()), std::make_move_iterator(lifted.end()));
+                return true;
+            }
+
+            void collectPinned(const std::unordered_set<std::string> &externalNames)
+            {
+                std::unordered_set<std::string_view> words(externalNames.begin(), externalNames.end());
+                for (const auto &instruction : code)
+                {
+                    if (instruction.form != RecordForm::RAW) continue;
+                    const std::string_view text = pool.get(instruction.operands[0]);
+                    size_t begin = 0;
+                    while (begin < text.size())
+                    {
+                        size_t end = begin;
+                        while (end < text.size() &&
+                            (std::isalnum(static_cast<unsigned char>(text[end])) || text[end] == '_'))
+                        {
+                            end++;
+                        }
+                        if (end > begin) words.insert(text.substr(begin, end - begin));
+                        begin = end + 1;
+                    }
+                }
+                if (words.empty()) return;
+                for (uint32_t id = 0; id < pool.size(); id++)
+                {
+                    if (words.contains(pool.get(id)))
+                    {
+                        pinned.insert(id);
+                    }
+                }
+            }
+
+            [[nodiscard]] bool isOperands(const Instruction &instruction, const uint32_t op) const
+            {
+                return !instruction.removed && instruction.form == RecordForm::OPERANDS && instruction.op == op;
+            }
+
+            // 跳过已删除的记录与注释，返回 index 之后的下一条有效指令
+            [[nodiscard]] size_t nextLive(size_t index) const
+            {
+                for (index++; index < code.size(); index++)
+                {
+                    if (!code[index].removed && code[index].form != RecordForm::ANNOTATION) break;
+                }
+                return index;
+            }
+
+            void remove(Instruction &instruction, size_t &counter)
+            {
+                instruction.removed = true;
+                counter++;
+            }
+
+            // 从 ALLOT 中去掉一个临时变量，ALLOT 为空时整条删除
+            void removeAllot(const size_t allotAt, const uint32_t temp, size_t &counter)
+            {
+                if (allotAt == SIZE_MAX) return;
+                auto &operands = code[allotAt].operands;
+                operands.erase(std::remove(operands.begin(), operands.end(), temp), operands.end());
+                if (operands.empty())
+                {
+                    remove(code[allotAt], counter);
+                }
+            }
+
+            bool removeUnreachable()
+            {
+                const auto before = stats.unreachable;
+                bool dead = false;
+                for (auto &instruction : code)
+                {
+                    if (instruction.removed || instruction.form == RecordForm::ANNOTATION) continue;
+                    if (dead)
+                    {
+                        // 标签、块结束与其他结构性指令之后的代码可能重新可达
+                        if (instruction.form == RecordForm::OPERANDS &&
+                            (instruction.op == opAllot || (instruction.info && instruction.info->straight)))
+                        {
+                            remove(instruction, stats.unreachable);
+                            continue;
+                        }
+                        dead = false;
+                    }
+                    dead = instruction.form == RecordForm::OPERANDS && instruction.info && instruction.info->terminator;
+                }
+                return stats.unreachable != before;
+            }
+
+            bool removeRedundantJumps()
+            {
+                const auto before = stats.redundantJumps;
+                // 跳转到紧随其后的标签
+                for (size_t i = 0; i < code.size(); i++)
+                {
+                    if (!isOperands(code[i], opJmp) || code[i].operands.size() != 1) continue;
+                    for (size_t j = nextLive(i); j < code.size() && isOperands(code[j], opSet); j = nextLive(j))
+                    {
+                        if (code[j].operands == code[i].operands)
+                        {
+                            remove(code[i], stats.redundantJumps);
+                            break;
+                        }
+                    }
+                }
+                // 没有任何跳转引用的标签
+                std::unordered_set<uint32_t> referenced;
+                for (const auto &instruction : code)
+                {
+                    if (instruction.removed || instruction.form != RecordForm::OPERANDS || instruction.op == opSet) continue;
+                    referenced.insert(instruction.operands.begin(), instruction.operands.end());
+                }
+                for (auto &instruction : code)
+                {
+                    if (isOperands(instruction, opSet) && instruction.operands.size() == 1 &&
+                        !referenced.contains(instruction.operands[0]) && !pinned.contains(instruction.operands[0]))
+                    {
+                        remove(instruction, stats.redundantJumps);
+                    }
+                }
+                return stats.redundantJumps != before;
+            }
+
+            [[nodiscard]] std::unordered_map<uint32_t, TempUsage> analyzeTemps() const
+            {
+                std::unordered_map<uint32_t, TempUsage> usages;
+                for (size_t i = 0; i < code.size(); i++)
+                {
+                    const auto &instruction = code[i];
+                    if (instruction.removed || instruction.form != RecordForm::OPERANDS) continue;
+                    const auto &operands = instruction.operands;
+                    for (size_t j = 0; j < operands.size(); j++)
+                    {
+                        if (!isTemp[operands[j]]) continue;
+                        auto &usage = usages[operands[j]];
+                        if (instruction.op == opAllot)
+                        {
+                            usage.allots++;
+                            usage.allotAt = i;
+                        } else if (!instruction.info)
+                        {
+                            usage.opaque = true;
+                        } else if (j + 1 < operands.size() || instruction.info->last == LastOperand::READ)
+                        {
+                            usage.reads++;
+                        } else
+                        {
+                            usage.writes.push_back(i);
+                        }
+                    }
+                }
+                for (auto &[temp, usage] : usages)
+                {
+                    if (pinned.contains(temp) || usage.allots > 1)
+                    {
+                        usage.opaque = true;
+                    }
+                }
+                return usages;
+            }
+
+            // 只在 ALLOT: t; <OP> ..., t; [ALLOT: x;] PUT: t, x 这一紧邻序列上改写，
+            // 让运算结果直接写入 x，省去临时变量 t 及其 ALLOT 与 PUT
+            bool forwardTemps()
+            {
+                const auto before = stats.forwarded;
+                auto usages = analyzeTemps();
+                std::vector<bool> touched(code.size(), false);
+                for (auto &[temp, usage] : usages)
+                {
+                    if (usage.opaque || usage.allots != 1 || usage.writes.size() != 1 || usage.reads != 1) continue;
+                    const auto def = usage.writes[0];
+                    auto &defInstruction = code[def];
+                    if (touched[def] || touched[usage.allotAt] || defInstruction.info->last != LastOperand::DEF) continue;
+                    auto put = nextLive(def);
+                    auto allot = SIZE_MAX;
+                    if (put < code.size() && isOperands(code[put], opAllot) && code[put].operands.size() == 1)
+                    {
+                        allot = put;
+                        put = nextLive(put);
+                    }
+                    if (put >= code.size() || touched[put] || !isOperands(code[put], opPut)) continue;
+                    const auto &putOperands = code[put].operands;
+                    if (putOperands.size() != 2 || putOperands[0] != temp || putOperands[1] == temp) continue;
+                    const auto target = putOperands[1];
+                    if (allot != SIZE_MAX)
+                    {
+                        // 目标变量的声明需提前到运算之前，要求运算本身不引用它
+                        if (touched[allot] || code[allot].operands[0] != target ||
+                            std::ranges::find(defInstruction.operands, target) != defInstruction.operands.end())
+                        {
+                            continue;
+                        }
+                    }
+                    defInstruction.operands.back() = target;
+                    touched[def] = touched[put] = true;
+                    if (allot != SIZE_MAX)
+                    {
+                        touched[allot] = true;
+                        std::swap(code[allot], code[def]);
+                    }
+                    remove(code[put], stats.forwarded);
+                    touched[usage.allotAt] = true;
+                    removeAllot(usage.allotAt, temp, stats.forwarded);
+                }
+                return stats.forwarded != before;
+            }
+
+            // 只赋值一次的临时变量，若赋的是字面量或只定义一次、从未被改写的函数，其所有读取都可以直接使用该值
+            bool propagateCopies()
+            {
+                const auto before = stats.propagated;
+                auto usages = analyzeTemps();
+                std::unordered_map<uint32_t, uint32_t> functionDecls;
+                std::unordered_set<uint32_t> written;
+                for (const auto &instruction : code)
+                {
+                    if (instruction.removed || instruction.form != RecordForm::OPERANDS) continue;
+                    const auto &operands = instruction.operands;
+                    if (operands.empty()) continue;
+                    if (instruction.op == opFuni || instruction.op == opFunc)
+                    {
+                        functionDecls[operands[0]]++;
+                        written.insert(operands.begin() + 1, operands.end());
+                    } else if (!instruction.info || instruction.op == opAllot)
+                    {
+                        written.insert(operands.begin(), operands.end());
+                    } else if (instruction.info->last != LastOperand::READ)
+                    {
+                        written.insert(operands.back());
+                    }
+                }
+                const auto isConstant = [&](const uint32_t id) {
+                    if (isLiteral(pool.get(id))) return true;
+                    const auto it = functionDecls.find(id);
+                    return it != functionDecls.end() && it->second == 1 && !written.contains(id) && !pinned.contains(id);
+                };
+
+                std::unordered_map<uint32_t, uint32_t> substitutions;
+                for (auto &[temp, usage] : usages)
+                {
+                    if (usage.opaque || usage.allots != 1 || usage.writes.size() != 1) continue;
+                    auto &put = code[usage.writes[0]];
+                    if (put.op != opPut || put.operands.size() != 2 || put.operands[0] == temp ||
+                        !isConstant(put.operands[0]))
+                    {
+                        continue;
+                    }
+                    substitutions.emplace(temp, put.operands[0]);
+                    remove(put, stats.propagated);
+                    removeAllot(usage.allotAt, temp, stats.propagated);
+                }
+                if (substitutions.empty()) return false;
+                // 被替换的临时变量只剩读取，可以逐条直接替换
+                for (auto &instruction : code)
+                {
+                    if (instruction.removed || instruction.form != RecordForm::OPERANDS) continue;
+                    for (auto &operand : instruction.operands)
+                    {
+                        if (const auto it = substitutions.find(operand); it != substitutions.end())
+                        {
+                            operand = it->second;
+                        }
+                    }
+                }
+                return stats.propagated != before;
+            }
+
+            // 将指令改写为 PUT: value, target
+            void rewriteToPut(Instruction &instruction, const std::string &value, const uint32_t target)
+            {
+                instruction.op = opPut;
+                instruction.operands = {pool.intern(value), target};
+                instruction.info = &getOpInfoMap().at("PUT");
+                stats.folded++;
+            }
+
+            // 常量折叠：运算数均为字面量的运算在编译期求值为 PUT，条件为字面量的跳转改为 JMP 或删除，
+            // 之后由复制传播与不可达代码删除继续清理
+            bool foldConstants()
+            {
+                const auto before = stats.folded;
+                for (size_t i = 0; i < code.size(); i++)
+                {
+                    auto &instruction = code[i];
+                    if (instruction.removed || instruction.form != RecordForm::OPERANDS) continue;
+                    auto &operands = instruction.operands;
+                    if (const auto it = arithmeticOps.find(instruction.op);
+                        it != arithmeticOps.end() && operands.size() == 3)
+                    {
+                        if (const auto value = foldArithmetic(it->second, pool.get(operands[0]), pool.get(operands[1])))
+                        {
+                            rewriteToPut(instruction, *value, operands[2]);
+                        }
+                    } else if (instruction.op == opOpp && operands.size() == 2)
+                    {
+                        if (const auto value = foldOpposite(pool.get(operands[0])))
+                        {
+                            rewriteToPut(instruction, *value, operands[1]);
+                        }
+                    } else if (instruction.op == opCmp && operands.size() == 3)
+                    {
+                        // 比较结果只经由紧随其后的 CREL: t, <关系>, t 转换为布尔值
+                        const auto next = nextLive(i);
+                        if (next >= code.size() || !isOperands(code[next], opCrel)) continue;
+                        const auto &relation = code[next].operands;
+                        if (relation.size() != 3 || relation[0] != operands[2] || relation[2] != operands[2]) continue;
+                        if (const auto value = foldRelation(pool.get(relation[1]), pool.get(operands[0]),
+                                                            pool.get(operands[1])))
+                        {
+                            rewriteToPut(instruction, *value, operands[2]);
+                            remove(code[next], stats.folded);
+                        }
+                    } else if ((instruction.op == opJt || instruction.op == opJf) && operands.size() == 2)
+                    {
+                        if (const auto truth = getConstantTruth(pool.get(operands[0])))
+                        {
+                            if (*truth == (instruction.op == opJt))
+                            {
+                                instruction.op = opJmp;
+                                instruction.operands = {operands[1]};
+                                instruction.info = &getOpInfoMap().at("JMP");
+                                stats.folded++;
+                            } else
+                            {
+                                remove(instruction, stats.folded);
+                            }
+                        }
+                    }
+                }
+                return stats.folded != before;
+            }
+
+            // 将指令流划分为直线代码段：分支与块结构指令各自单独成段，段内的指令按顺序执行一次。
+            // 段号随下标单调不减，已删除的记录与注释沿用前一条指令的段号
+            [[nodiscard]] std::vector<size_t> computeSegments() const
+            {
+                const auto &controlOps = getControlOps();
+                std::vector<size_t> segments(code.size(), 0);
+                size_t segment = 0;
+                for (size_t i = 0; i < code.size(); i++)
+                {
+                    const auto &instruction = code[i];
+                    if (instruction.removed || instruction.form == RecordForm::ANNOTATION)
+                    {
+                        segments[i] = segment;
+                        continue;
+                    }
+                    const bool boundary = instruction.form != RecordForm::OPERANDS ||
+                        controlOps.contains(pool.get(instruction.op));
+                    if (boundary) segment++;
+                    segments[i] = segment;
+                    if (boundary) segment++;
+                }
+                return segments;
+            }
+
+            // 常量传播：只声明一次、只以字面量赋值一次的变量，若其余出现都只读取值，且声明、赋值与所有读取
+            // 依次位于同一段直线代码中（赋值必然先于读取执行），读取处直接使用该字面量，变量本身随之删除。
+            // 作为调用参数、字段值或出现在不透明指令中的变量可能经由引用被改写，不做传播
+            bool propagateConstants()
+            {
+                struct Usage {
+                    uint32_t allots = 0;
+                    size_t allotAt = SIZE_MAX;
+                    std::vector<size_t> writes;
+                    size_t firstRead = SIZE_MAX;
+                    size_t lastRead = 0;
+                    bool escaped = false;
+                };
+                std::unordered_map<uint32_t, Usage> usages;
+                const auto track = [&](const uint32_t operand) -> Usage * {
+                    if (isTemp[operand] || pinned.contains(operand) || isLiteral(pool.get(operand))) return nullptr;
+                    return &usages[operand];
+                };
+                for (size_t i = 0; i < code.size(); i++)
+                {
+                    const auto &instruction = code[i];
+                    if (instruction.removed || instruction.form != RecordForm::OPERANDS) continue;
+                    const auto &operands = instruction.operands;
+                    for (size_t j = 0; j < operands.size(); j++)
+                    {
+                        const auto usage = track(operands[j]);
+                        if (!usage) continue;
+                        if (instruction.op == opAllot)
+                        {
+                            usage->allots++;
+                            usage->allotAt = i;
+                        } else if (!instruction.info)
+                        {
+                            usage->escaped = true;
+                        } else if (j + 1 == operands.size() && instruction.info->last != LastOperand::READ)
+                        {
+                            usage->writes.push_back(i);
+                        } else if (valueReadOps.contains(instruction.op))
+                        {
+                            usage->firstRead = std::min(usage->firstRead, i);
+                            usage->lastRead = std::max(usage->lastRead, i);
+                        } else
+                        {
+                            usage->escaped = true;
+                        }
+                    }
+                }
+                const auto segments = computeSegments();
+                std::unordered_map<uint32_t, uint32_t> substitutions;
+                for (const auto &[name, usage] : usages)
+                {
+                    if (usage.escaped || usage.allots != 1 || usage.writes.size() != 1) continue;
+                    const auto write = usage.writes[0];
+                    auto &put = code[write];
+                    if (put.op != opPut || put.operands.size() != 2 || !isLiteral(pool.get(put.operands[0])) ||
+                        usage.allotAt > write || usage.firstRead < write ||
+                        segments[usage.allotAt] != segments[std::max(write, usage.lastRead)])
+                    {
+                        continue;
+                    }
+                    substitutions.emplace(name, put.operands[0]);
+                    remove(put, stats.propagated);
+                    removeAllot(usage.allotAt, name, stats.propagated);
+                }
+                if (substitutions.empty()) return false;
+                for (auto &instruction : code)
+                {
+                    if (instruction.removed || instruction.form != RecordForm::OPERANDS) continue;
+                    for (auto &operand : instruction.operands)
+                    {
+                        if (const auto it = substitutions.find(operand); it != substitutions.end())
+                        {
+                            operand = it->second;
+                        }
+                    }
+                }
+                return true;
+            }
+
+            bool eliminateDeadStores()
+            {
+                const auto before = stats.deadStores;
+                for (auto &[temp, usage] : analyzeTemps())
+                {
+                    if (usage.opaque || usage.reads != 0) continue;
+                    if (!std::ranges::all_of(usage.writes, [&](const size_t index) {
+                        return code[index].info->removable;
+                    }))
+                    {
+                        continue;
+                    }
+                    for (const auto index : usage.writes)
+                    {
+                        // 同一条指令可能同时是多个死临时变量的写入
+                        if (!code[index].removed)
+                        {
+                            remove(code[index], stats.deadStores);
+                        }
+                    }
+                    removeAllot(usage.allotAt, temp, stats.deadStores);
+                }
+                return stats.deadStores != before;
+            }
+
+            // 可能在指令执行之后仍经由引用持有的临时变量：出现在不透明指令中的、作为元素或字段值存入容器的
+            // （ITER_APND、PAIR_SET 的值操作数）以及作为调用实参传给被调函数的。它们的最后一次出现并不是
+            // 最后一次使用，不能释放或复用其槽位
+            [[nodiscard]] std::unordered_set<uint32_t> collectRetainedTemps() const
+            {
+                std::unordered_set<uint32_t> retained;
+                for (const auto &instruction : code)
+                {
+                    if (instruction.removed || instruction.form != RecordForm::OPERANDS || instruction.op == opAllot) continue;
+                    const auto &operands = instruction.operands;
+                    size_t begin = 0;
+                    size_t end = 0;
+                    if (!instruction.info)
+                    {
+                        end = operands.size();
+                    } else if (instruction.op == opCall || instruction.op == opIvok)
+                    {
+                        // IVOK 的最后一个操作数是返回值的写入目标
+                        begin = 1;
+                        end = instruction.op == opIvok && !operands.empty() ? operands.size() - 1 : operands.size();
+                    } else if (instruction.info->last == LastOperand::MODIFY && !operands.empty())
+                    {
+                        end = operands.size() - 1;
+                    }
+                    for (auto j = begin; j < end; j++)
+                    {
+                        if (isTemp[operands[j]]) retained.insert(operands[j]);
+                    }
+                }
+                return retained;
+            }
+
+            // 基于活跃区间的临时变量槽位复用（线性扫描）：区间为临时变量从 ALLOT 到最后一次出现，
+            // 且不跨越任何分支或块结构，保证区间内的指令按顺序执行一次。区间结束时发出 DELETE 释放槽位，
+            // 同一函数体中之后开始的区间复用该槽位；槽位沿用首个占用者的名称，因此在所有模块之间仍然唯一
+            void allocateTempSlots()
+            {
+                struct Interval {
+                    uint32_t temp;
+                    size_t first;
+                    size_t last;
+                    size_t segment;
+                    size_t region;
+                    bool valid;
+                };
+                const auto segments = computeSegments();
+                const auto retained = collectRetainedTemps();
+                std::unordered_map<uint32_t, Interval> intervals;
+                // 函数体（FUNI/FUNC 到对应的 END）与其外层使用各自的槽位
+                std::vector<std::pair<size_t, uint32_t>> regionStack{{0, UINT32_MAX}};
+                size_t regionCount = 1;
+                for (size_t i = 0; i < code.size(); i++)
+                {
+                    const auto &instruction = code[i];
+                    if (instruction.removed || instruction.form != RecordForm::OPERANDS) continue;
+                    const auto region = regionStack.back().first;
+                    for (const auto operand : instruction.operands)
+                    {
+                        if (!isTemp[operand] || pinned.contains(operand) || retained.contains(operand)) continue;
+                        if (auto [it, inserted] = intervals.try_emplace(operand, Interval{
+                            operand, i, i, segments[i], region,
+                            instruction.op == opAllot && instruction.operands.size() == 1
+                        }); !inserted)
+                        {
+                            auto &interval = it->second;
+                            interval.last = i;
+                            interval.valid = interval.valid && interval.segment == segments[i];
+                        }
+                    }
+                    if ((instruction.op == opFuni || instruction.op == opFunc) && !instruction.operands.empty())
+                    {
+                        regionStack.emplace_back(regionCount++, instruction.operands[0]);
+                    } else if (instruction.op == opEnd && instruction.operands.size() == 1 &&
+                        regionStack.size() > 1 && regionStack.back().second == instruction.operands[0])
+                    {
+                        regionStack.pop_back();
+                    }
+                }
+
+                std::vector<const Interval *> sorted;
+                for (const auto &interval : intervals | std::views::values)
+                {
+                    if (interval.valid) sorted.push_back(&interval);
+                }
+                std::ranges::sort(sorted, [](const Interval *lhs, const Interval *rhs) {
+                    return lhs->first < rhs->first;
+                });
+                // 按区间结束位置排序的活跃区间，用于在新区间开始前回收已结束的槽位
+                std::multimap<size_t, std::pair<size_t, uint32_t>> active;
+                std::unordered_map<size_t, std::vector<uint32_t>> freeSlots;
+                std::unordered_map<uint32_t, uint32_t> renames;
+                for (const auto *interval : sorted)
+                {
+                    while (!active.empty() && active.begin()->first < interval->first)
+                    {
+                        const auto [region, slot] = active.begin()->second;
+                        freeSlots[region].push_back(slot);
+                        active.erase(active.begin());
+                    }
+                    auto slot = interval->temp;
+                    if (auto &slots = freeSlots[interval->region]; !slots.empty())
+                    {
+                        slot = slots.back();
+                        slots.pop_back();
+                        renames.emplace(interval->temp, slot);
+                        stats.reusedSlots++;
+                    }
+                    slotDeletes[interval->last].push_back(slot);
+                    stats.releasedSlots++;
+                    active.emplace(interval->last, std::make_pair(interval->region, slot));
+                }
+                if (renames.empty()) return;
+                for (auto &instruction : code)
+                {
+                    if (instruction.removed || instruction.form != RecordForm::OPERANDS) continue;
+                    for (auto &operand : instruction.operands)
+                    {
+                        if (const auto it = renames.find(operand); it != renames.end())
+                        {
+                            operand = it->second;
+                        }
+                    }
+                }
+            }
+
+            // 从程序入口出发的可达性分析：顶层代码总是可达，函数（FUNI/FUNC 到对应 END）与类（TP_DEF）
+            // 只有被可达代码引用时才可达。顶层以函数或类为值的字段注册（模块成员、方法）只在其字段名
+            // 被可达代码访问时保留；存在以非字面量访问字段的指令时，字段一律保留
+            bool shakeTree()
+            {
+                struct Unit {
+                    std::vector<size_t> records;
+                    bool live = false;
+                };
+                struct Registration {
+                    uint32_t type;
+                    uint32_t field;
+                    uint32_t value;
+                    size_t record;
+                    bool live = false;
+                };
+                // 单元 0 为顶层代码；函数单元记录其完整的指令区间
+                std::vector<Unit> units(1);
+                std::unordered_map<size_t, std::pair<size_t, size_t>> functionBlocks;
+                std::unordered_map<uint32_t, size_t> definitions;
+                std::unordered_set<uint32_t> redefined;
+                std::vector<Registration> registrations;
+                std::vector<std::pair<size_t, uint32_t>> blockStack;
+                const auto define = [&](const uint32_t name) {
+                    const auto unit = units.size();
+                    units.emplace_back();
+                    if (!definitions.emplace(name, unit).second) redefined.insert(name);
+                    return unit;
+                };
+                for (size_t i = 0; i < code.size(); i++)
+                {
+                    const auto &instruction = code[i];
+                    if (instruction.removed) continue;
+                    const auto current = blockStack.empty() ? 0 : blockStack.back().first;
+                    if (instruction.form == RecordForm::OPERANDS && !instruction.operands.empty())
+                    {
+                        const auto &operands = instruction.operands;
+                        if (instruction.op == opFuni || instruction.op == opFunc)
+                        {
+                            const auto unit = define(operands[0]);
+                            units[unit].records.push_back(i);
+                            functionBlocks[unit].first = i;
+                            blockStack.emplace_back(unit, operands[0]);
+                            continue;
+                        }
+                        if (instruction.op == opEnd && !blockStack.empty() && operands[0] == blockStack.back().second)
+                        {
+                            units[current].records.push_back(i);
+                            functionBlocks[current].second = i;
+                            blockStack.pop_back();
+                            continue;
+                        }
+                        if (blockStack.empty() && instruction.op == opTpDef)
+                        {
+                            units[define(operands[0])].records.push_back(i);
+                            continue;
+                        }
+                        if (blockStack.empty() && operands.size() == 3 &&
+                            (instruction.op == opAddTpField || instruction.op == opAddInstField))
+                        {
+                            registrations.push_back({operands[0], operands[1], operands[2], i});
+                            continue;
+                        }
+                    }
+                    units[current].records.push_back(i);
+                }
+                // 函数块不配对时无法确定定义的边界，放弃裁剪
+                if (!blockStack.empty()) return false;
+
+                std::vector<size_t> worklist;
+                std::unordered_set<uint32_t> liveFields;
+                bool dynamicFields = false;
+                const auto markUnit = [&](const size_t unit) {
+                    if (!units[unit].live)
+                    {
+                        units[unit].live = true;
+                        worklist.push_back(unit);
+                    }
+                };
+                const auto isLiveDefinition = [&](const uint32_t name) {
+                    const auto it = definitions.find(name);
+                    return it == definitions.end() || units[it->second].live;
+                };
+                const auto scan = [&](const Instruction &instruction) {
+                    if (instruction.form != RecordForm::OPERANDS) return;
+                    for (const auto operand : instruction.operands)
+                    {
+                        if (const auto it = definitions.find(operand); it != definitions.end())
+                        {
+                            markUnit(it->second);
+                        } else if (pool.get(operand).starts_with('"'))
+                        {
+                            liveFields.insert(operand);
+                        }
+                    }
+                    if ((instruction.op == opGetField || instruction.op == opSetField) &&
+                        instruction.operands.size() > 1 && !pool.get(instruction.operands[1]).starts_with('"'))
+                    {
+                        dynamicFields = true;
+                    }
+                };
+                markUnit(0);
+                for (const auto &[name, unit] : definitions)
+                {
+                    // 重复定义或在 RAW 文本中出现的名称无法可靠追踪，视为可达
+                    if (redefined.contains(name) || pinned.contains(name)) markUnit(unit);
+                }
+                bool changed = true;
+                while (changed)
+                {
+                    while (!worklist.empty())
+                    {
+                        const auto unit = worklist.back();
+                        worklist.pop_back();
+                        for (const auto index : units[unit].records)
+                        {
+                            scan(code[index]);
+                        }
+                    }
+                    changed = false;
+                    for (auto &registration : registrations)
+                    {
+                        if (registration.live || !isLiveDefinition(registration.type)) continue;
+                        // 数据字段随类型一起保留，函数与类成员还要求字段名被访问过
+                        if (definitions.contains(registration.value) && !dynamicFields &&
+                            !liveFields.contains(registration.field))
+                        {
+                            continue;
+                        }
+                        registration.live = true;
+                        scan(code[registration.record]);
+                        changed = true;
+                    }
+                }
+
+                const auto before = stats.shaken;
+                for (size_t unit = 1; unit < units.size(); unit++)
+                {
+                    if (units[unit].live) continue;
+                    if (const auto it = functionBlocks.find(unit); it != functionBlocks.end())
+                    {
+                        for (auto i = it->second.first; i <= it->second.second; i++)
+                        {
+                            if (!code[i].removed) remove(code[i], stats.shaken);
+                        }
+                    } else
+                    {
+                        for (const auto index : units[unit].records)
+                        {
+                            if (!code[index].removed) remove(code[index], stats.shaken);
+                        }
+                    }
+                }
+                for (const auto &registration : registrations)
+                {
+                    if (!registration.live) remove(code[registration.record], stats.shaken);
+                }
+                return stats.shaken != before;
+            }
+
+            // 小函数内联：只定义一次、从未被改写的顶层函数，若函数体是直线代码（不含标签、跳转、嵌套函数与
+            // 不透明指令，以 RET 或 END 结束），除 ALLOT 与 RET 外不超过 threshold 条指令，不引用自身，
+            // 且参数只被读取（不被写入，也不作为调用参数传出，避免经由引用改写），则它的直接调用（CALL / IVOK）
+            // 就地展开：参数与函数体中声明的变量改用新名称，实参以 PUT 绑定到参数，返回值以 PUT 写入 IVOK 的目标。
+            // 实参已由编译器按函数的参数表补齐默认值并打包变长参数，与参数逐个对应；个数不符的调用不展开。
+            // 函数体取自展开前的指令流，因此只展开一层。RAW 文本或模块导出（externalNames）中出现的函数不展开。
+            // allowGrowth 为假时，只展开全部引用都是可展开调用、且展开后的指令数不超过原调用与函数定义之和的函数。
+            // 展开后不再被引用的函数定义随即删除，计入 shaken
+            void inlineCalls(const size_t threshold, const std::function<std::string()> &newName, const bool allowGrowth)
+            {
+                struct Callee {
+                    size_t header;
+                    size_t end;      // RET 或 END 的下标，函数体为 (header, end)
+                    size_t blockEnd; // 函数块 END 的下标
+                    bool returns;    // 以带返回值的 RET 结束
+                    size_t bodySize; // 函数体中展开时复制的指令数
+                    std::vector<uint32_t> locals;
+                };
+                const auto &controlOps = getControlOps();
+
+                std::unordered_map<uint32_t, uint32_t> functionDecls;
+                std::unordered_set<uint32_t> written;
+                std::vector<std::pair<size_t, size_t>> topLevelFunctions;
+                std::vector<std::pair<size_t, uint32_t>> blockStack;
+                for (size_t i = 0; i < code.size(); i++)
+                {
+                    const auto &instruction = code[i];
+                    if (instruction.removed || instruction.form != RecordForm::OPERANDS) continue;
+                    const auto &operands = instruction.operands;
+                    if (operands.empty()) continue;
+                    if (instruction.op == opFuni || instruction.op == opFunc)
+                    {
+                        functionDecls[operands[0]]++;
+                        written.insert(operands.begin() + 1, operands.end());
+                        blockStack.emplace_back(i, operands[0]);
+                    } else if (instruction.op == opEnd && !blockStack.empty() && operands[0] == blockStack.back().second)
+                    {
+                        if (blockStack.size() == 1) topLevelFunctions.emplace_back(blockStack.back().first, i);
+                        blockStack.pop_back();
+                    } else if (instruction.op == opAddTpField || instruction.op == opAddInstField)
+                    {
+                        // 成员注册只改写类型，函数以值的形式登记；方法调用已由编译器静态解析为直接调用
+                        written.insert(operands[0]);
+                    } else if (!instruction.info || instruction.op == opAllot)
+                    {
+                        written.insert(operands.begin(), operands.end());
+                    } else if (instruction.info->last != LastOperand::READ)
+                    {
+                        written.insert(operands.back());
+                    }
+                }
+                // 函数块不配对时无法确定函数体的边界
+                if (!blockStack.empty()) return;
+
+                std::unordered_map<uint32_t, Callee> callees;
+                for (const auto &[header, end] : topLevelFunctions)
+                {
+                    const auto &signature = code[header].operands;
+                    const auto name = signature[0];
+                    if (functionDecls[name] != 1 || written.contains(name) || pinned.contains(name)) continue;
+                    const std::unordered_set<uint32_t> params(signature.begin() + 1, signature.end());
+                    if (params.size() + 1 != signature.size()) continue;
+                    Callee callee{header, end, end, false, 0, {}};
+                    size_t size = 0;
+                    bool inlinable = true;
+                    for (size_t i = header + 1; i < end && inlinable; i++)
+                    {
+                        const auto &instruction = code[i];
+                        if (instruction.removed || instruction.form == RecordForm::ANNOTATION) continue;
+                        const auto &operands = instruction.operands;
+                        if (instruction.form != RecordForm::OPERANDS || std::ranges::find(operands, name) != operands.end())
+                        {
+                            inlinable = false;
+                        } else if (instruction.op == opAllot)
+                        {
+                            for (const auto operand : operands)
+                            {
+                                inlinable = inlinable && !params.contains(operand);
+                                callee.locals.push_back(operand);
+                            }
+                        } else if (instruction.op == opRet)
+                        {
+                            // 直线代码中 RET 之后的指令不可达
+                            inlinable = operands.size() <= 1;
+                            callee.end = i;
+                            callee.returns = operands.size() == 1;
+                            break;
+                        } else if (!instruction.info || controlOps.contains(pool.get(instruction.op)) || ++size > threshold)
+                        {
+                            inlinable = false;
+                        } else
+                        {
+                            for (size_t j = 0; j < operands.size() && inlinable; j++)
+                            {
+                                inlinable = !params.contains(operands[j]) ||
+                                    (instruction.op != opCall && instruction.op != opIvok &&
+                                        (j + 1 < operands.size() || instruction.info->last == LastOperand::READ));
+                            }
+                        }
+                    }
+                    if (!inlinable) continue;
+                    for (size_t i = header + 1; i < callee.end; i++)
+                    {
+                        if (!code[i].removed && code[i].form != RecordForm::ANNOTATION) callee.bodySize++;
+                    }
+                    callees.emplace(name, std::move(callee));
+                }
+                if (callees.empty()) return;
+
+                const auto isExpandable = [&](const Instruction &instruction, const Callee &callee) {
+                    const bool invoke = instruction.op == opIvok;
+                    return instruction.operands.size() == code[callee.header].operands.size() + (invoke ? 1 : 0) &&
+                        (!invoke || callee.returns);
+                };
+                if (!allowGrowth)
+                {
+                    struct Usage {
+                        size_t references = 0;
+                        size_t expandable = 0;
+                        size_t expandedSize = 0;
+                    };
+                    std::unordered_map<uint32_t, Usage> usages;
+                    for (size_t i = 0; i < code.size(); i++)
+                    {
+                        const auto &instruction = code[i];
+                        if (instruction.removed || instruction.form != RecordForm::OPERANDS) continue;
+                        for (size_t j = 0; j < instruction.operands.size(); j++)
+                        {
+                            const auto it = callees.find(instruction.operands[j]);
+                            if (it == callees.end() || (it->second.header <= i && i <= it->second.blockEnd)) continue;
+                            auto &usage = usages[it->first];
+                            usage.references++;
+                            if (j == 0 && (instruction.op == opCall || instruction.op == opIvok) &&
+                                isExpandable(instruction, it->second))
+                            {
+                                usage.expandable++;
+                                // ALLOT 与 PUT 绑定每个参数，IVOK 另以 PUT 写回返回值
+                                usage.expandedSize += 2 * (code[it->second.header].operands.size() - 1) +
+                                    it->second.bodySize + (instruction.op == opIvok ? 1 : 0);
+                            }
+                        }
+                    }
+                    std::erase_if(callees, [&](const auto &entry) {
+                        const auto &[name, callee] = entry;
+                        const auto &usage = usages[name];
+                        size_t definitionSize = 0;
+                        for (size_t i = callee.header; i <= callee.blockEnd; i++)
+                        {
+                            if (!code[i].removed && code[i].form != RecordForm::ANNOTATION) definitionSize++;
+                        }
+                        return usage.references == 0 || usage.references != usage.expandable ||
+                            usage.expandedSize > usage.expandable + definitionSize;
+                    });
+                    if (callees.empty()) return;
+                }
+
+                const auto fresh = [&](const uint32_t original, const bool temp) {
+                    const auto id = pool.intern(newName());
+                    if (isTemp.size() < pool.size()) isTemp.resize(pool.size(), false);
+                    // 用户变量改名后仍按用户变量对待，只有参数与编译器临时变量参与临时变量优化
+                    isTemp[id] = temp || isTemp[original];
+                    return id;
+                };
+                const auto &putInfo = getOpInfoMap().at("PUT");
+                std::unordered_set<uint32_t> expandedCallees;
+                std::vector<Instruction> expanded;
+                expanded.reserve(code.size());
+                for (const auto &instruction : code)
+                {
+                    const auto it = instruction.removed || instruction.form != RecordForm::OPERANDS ||
+                        (instruction.op != opCall && instruction.op != opIvok) || instruction.operands.empty()
+                            ? callees.end()
+                            : callees.find(instruction.operands[0]);
+                    if (it == callees.end())
+                    {
+                        expanded.push_back(instruction);
+                        continue;
+                    }
+                    const auto &callee = it->second;
+                    const auto &signature = code[callee.header].operands;
+                    const auto &operands = instruction.operands;
+                    const bool invoke = instruction.op == opIvok;
+                    if (!isExpandable(instruction, callee))
+                    {
+                        expanded.push_back(instruction);
+                        continue;
+                    }
+                    std::unordered_map<uint32_t, uint32_t> renames;
+                    for (size_t k = 1; k < signature.size(); k++)
+                    {
+                        const auto param = fresh(signature[k], true);
+                        renames.emplace(signature[k], param);
+                        expanded.push_back({RecordForm::OPERANDS, opAllot, {param}, nullptr});
+                        expanded.push_back({RecordForm::OPERANDS, opPut, {operands[k], param}, &putInfo});
+                    }
+                    for (const auto local : callee.locals)
+                    {
+                        if (!renames.contains(local)) renames.emplace(local, fresh(local, false));
+                    }
+                    const auto rename = [&](const uint32_t operand) {
+                        const auto renamed = renames.find(operand);
+                        return renamed == renames.end() ? operand : renamed->second;
+                    };
+                    for (size_t i = callee.header + 1; i < callee.end; i++)
+                    {
+                        const auto &bodyInstruction = code[i];
+                        if (bodyInstruction.removed || bodyInstruction.form == RecordForm::ANNOTATION) continue;
+                        auto &copied = expanded.emplace_back(bodyInstruction);
+                        std::ranges::transform(copied.operands, copied.operands.begin(), rename);
+                    }
+                    if (invoke)
+                    {
+                        expanded.push_back({
+                            RecordForm::OPERANDS, opPut, {rename(code[callee.end].operands[0]), operands.back()}, &putInfo
+                        });
+                    }
+                    stats.inlined++;
+                    expandedCallees.insert(it->first);
+                }
+                code = std::move(expanded);
+                removeDeadCallees(expandedCallees);
+            }
+
+            // 删除内联之后不再被引用的函数定义（callees 为被展开过的函数）：被删除的定义中的引用不计，直到不再有定义被删除
+            void removeDeadCallees(const std::unordered_set<uint32_t> &callees)
+            {
+                std::unordered_map<uint32_t, std::pair<size_t, size_t>> blocks;
+                size_t depth = 0;
+                size_t header = 0;
+                for (size_t i = 0; i < code.size(); i++)
+                {
+                    const auto &instruction = code[i];
+                    if (instruction.removed || instruction.form != RecordForm::OPERANDS || instruction.operands.empty()) continue;
+                    if (instruction.op == opFuni || instruction.op == opFunc)
+                    {
+                        if (depth++ == 0) header = i;
+                    } else if (instruction.op == opEnd && depth > 0 && --depth == 0 &&
+                        callees.contains(code[header].operands[0]) && instruction.operands[0] == code[header].operands[0])
+                    {
+                        blocks.emplace(code[header].operands[0], std::make_pair(header, i));
+                    }
+                }
+                std::unordered_set<uint32_t> dead;
+                bool changed = true;
+                while (changed)
+                {
+                    changed = false;
+                    std::unordered_set<uint32_t> referenced;
+                    for (size_t i = 0; i < code.size(); i++)
+                    {
+                        const auto &instruction = code[i];
+                        if (instruction.removed || instruction.form != RecordForm::OPERANDS) continue;
+                        for (const auto operand : instruction.operands)
+                        {
+                            const auto it = blocks.find(operand);
+                            if (it == blocks.end() || (it->second.first <= i && i <= it->second.second)) continue;
+                            const bool inDeadBlock = std::ranges::any_of(dead, [&](const uint32_t name) {
+                                const auto &[begin, end] = blocks.at(name);
+                                return begin <= i && i <= end;
+                            });
+                            if (!inDeadBlock) referenced.insert(operand);
+                        }
+                    }
+                    for (const auto &name : blocks | std::views::keys)
+                    {
+                        if (!referenced.contains(name) && dead.insert(name).second) changed = true;
+                    }
+                }
+                for (const auto name : dead)
+                {
+                    const auto &[begin, end] = blocks.at(name);
+                    for (size_t i = begin; i <= end; i++)
+                    {
+                        if (!code[i].removed) remove(code[i], stats.shaken);
+                    }
+                }
+            }
+
+            void stripAnnotations()
+            {
+                // 保留文件头部的注释块（程序签名、源文件与目标文件等信息）
+                size_t i = 0;
+                while (i < code.size() && (code[i].removed || code[i].form == RecordForm::ANNOTATION)) i++;
+                for (; i < code.size(); i++)
+                {
+                    if (!code[i].removed && code[i].form == RecordForm::ANNOTATION)
+                    {
+                        remove(code[i], stats.annotations);
+                    }
+                }
+            }
+        };
+    }
+
+    size_t OptimizeStats::removed() const
+    {
+        return unreachable + redundantJumps + forwarded + propagated + deadStores + annotations + shaken;
+    }
+
+    OptimizeStats &OptimizeStats::operator+=(const OptimizeStats &other)
+    {
+        inputRecords += other.inputRecords;
+        outputRecords += other.outputRecords;
+        unreachable += other.unreachable;
+        redundantJumps += other.redundantJumps;
+        forwarded += other.forwarded;
+        folded += other.folded;
+        propagated += other.propagated;
+        deadStores += other.deadStores;
+        annotations += other.annotations;
+        shaken += other.shaken;
+        inlined += other.inlined;
+        reusedSlots += other.reusedSlots;
+        releasedSlots += other.releasedSlots;
+        return *this;
+    }
+
+    std::string OptimizeStats::toString() const
+    {
+        std::ostringstream oss;
+        oss << "RA optimization: " << inputRecords << " -> " << outputRecords
+            << " records (" << removed() << " removed)\n"
+            << "  unreachable code:   " << unreachable << "\n"
+            << "  redundant jumps:    " << redundantJumps << "\n"
+            << "  temp forwarding:    " << forwarded << "\n"
+            << "  constant folding:   " << folded << "\n"
+            << "  copy propagation:   " << propagated << "\n"
+            << "  dead stores:        " << deadStores << "\n"
+            << "  annotations:        " << annotations << "\n"
+            << "  unused definitions: " << shaken << "\n"
+            << "inlined calls: " << inlined << "\n"
+            << "temp slots: " << reusedSlots << " temps reuse a released slot, "
+            << releasedSlots << " slots released by DELETE\n";
+        return oss.str();
+    }
+
+    RaOptimizer::RaOptimizer(const int compileLevel, const std::unordered_set<std::string> &tempVars,
+                             const bool treeShake, const size_t inlineThreshold,
+                             std::function<std::string()> newName, std::unordered_set<std::string> externalNames)
+        : compileLevel(compileLevel), treeShake(treeShake), tempVars(tempVars),
+          inlineThreshold(inlineThreshold), newName(std::move(newName)), externalNames(std::move(externalNames)) {}
+
+    OptimizeStats RaOptimizer::run(InstructionBuffer &buffer) const
+    {
+        OptimizeStats stats;
+        Optimizer optimizer(buffer, tempVars, externalNames, stats);
+        optimizer.run(compileLevel, treeShake, inlineThreshold, newName);
+        optimizer.writeTo(buffer);
+        stats.outputRecords = buffer.size();
+        return stats;
+    }
+
+}
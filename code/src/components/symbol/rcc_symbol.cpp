@@ -2,7 +2,11 @@
 // Created by RestRegular on 2025/7/12.
 //
 
+#include <array>
+#include <atomic>
+#include <mutex>
 #include <ranges>
+#include <shared_mutex>
 #include <utility>
 #include <algorithm>
 
@@ -50,11 +54,14 @@ namespace symbol {
         case BuiltinTypeLabel::NUL: return "nul";
         case BuiltinTypeLabel::ANY: return "any";
         case BuiltinTypeLabel::FUNC: return "func";
-        case BuiltinTypeLabel::CLS: return "cls";
+        case BuiltinTypeLabel::CLS: return "clas";
         case BuiltinTypeLabel::LIST: return "list";
         case BuiltinTypeLabel::DICT: return "dict";
         case BuiltinTypeLabel::SERIES: return "series";
         case BuiltinTypeLabel::FLAG: return "flag";
+        case BuiltinTypeLabel::FUNI: return "funi";
+        case BuiltinTypeLabel::VAR_ARGS: return "..";
+        case BuiltinTypeLabel::KW_VAR_ARGS: return ".*";
         default: return RCC_UNKNOWN_CONST;
         }
     }
@@ -172,6 +179,9 @@ namespace symbol {
             it != labelTypeMap.end()) {
             return it->second;
         }
+        if (TypeLabelSymbol::isCustomType(name)) {
+            return LabelType::TYPE_LABEL;
+        }
         throw std::runtime_error("Unknown label type: " + name);
     }
 
@@ -337,7 +347,8 @@ namespace symbol {
 
     std::string Symbol::getSymbolPosInfoString() const
     {
-        if (ast::CompileVisitor::getRegisteredExtension(pos.getFilepath()))
+        if (ast::CompileVisitor::getRegisteredExtension(pos.getFilepath()) &&
+            ast::CompileVisitor::checkIsProcessedExtension(pos.getFilepath()))
         {
             return utils::makeFileIdentStr(
                 ast::CompileVisitor::getExtensionName(pos.getFilepath()),
@@ -421,7 +432,9 @@ namespace symbol {
                              const size_t &scopeLevel, const LabelType &labelType)
         : Symbol(pos, SymbolType::LABEL, name, raValue, scopeLevel),
           isBuiltIn_(isBuiltInLabel(name)),
-          labelType(labelType == LabelType::UNKNOWN_TYPE_LABEL ? getLabelTypeByName(name) : labelType) {}
+          labelType(labelType == LabelType::UNKNOWN_TYPE_LABEL ? getLabelTypeByName(name) : labelType),
+          typeId(this->labelType == LabelType::TYPE_LABEL
+              ? TypeLabelSymbol::getBuiltinTypeId(name) : BuiltinTypeLabel::CUSTOM) {}
 
     LabelSymbol::~LabelSymbol() {}
 
@@ -451,8 +464,8 @@ namespace symbol {
     }
 
     const IRCCLabelSymbolInterface::LabelDesI* LabelSymbol::GetLabelDesIS() const {
-        // 动态生成接口指针数组（注意：这里用 static 避免重复分配，但需确保线程安全和数据同步）
-        static std::vector<LabelDesI> tempArray;
+        // 动态生成接口指针数组（用 thread_local 避免重复分配，模块并行编译时各线程互不干扰）
+        thread_local std::vector<LabelDesI> tempArray;
         tempArray.clear();
 
         // 遍历内部 shared_ptr 容器，转换为接口指针
@@ -638,25 +651,24 @@ namespace symbol {
         return Symbol::TransformToSI();
     }
 
-    std::unordered_set<std::string> TypeLabelSymbol::builtInTypes = {
-        "int", "float", "char", "str", "bool", "void", "nul",
-        "list", "func", "funi", "dict", "series", "any", "flag",
-        "clas", "..", ".*"
+    std::unordered_map<std::string, BuiltinTypeLabel> TypeLabelSymbol::builtInTypes = {
+        {"int", BuiltinTypeLabel::INT}, {"float", BuiltinTypeLabel::FLOAT}, {"char", BuiltinTypeLabel::CHAR},
+        {"str", BuiltinTypeLabel::STR}, {"bool", BuiltinTypeLabel::BOOL}, {"void", BuiltinTypeLabel::VOID_BTL},
+        {"nul", BuiltinTypeLabel::NUL}, {"list", BuiltinTypeLabel::LIST}, {"func", BuiltinTypeLabel::FUNC},
+        {"funi", BuiltinTypeLabel::FUNI}, {"dict", BuiltinTypeLabel::DICT}, {"series", BuiltinTypeLabel::SERIES},
+        {"any", BuiltinTypeLabel::ANY}, {"flag", BuiltinTypeLabel::FLAG}, {"clas", BuiltinTypeLabel::CLS},
+        {"..", BuiltinTypeLabel::VAR_ARGS}, {".*", BuiltinTypeLabel::KW_VAR_ARGS}
     };
     std::unordered_map<std::string, std::string> TypeLabelSymbol::builtInTypeRaCodeMap = {
         {"..", "tp-args"},
         {".*", "tp-kwargs"},
         {"nul", "tp-null"}
     };
-    std::unordered_map<std::string, std::string> TypeLabelSymbol::customTypeMap = {};
-
     const char* IRCCTypeLabelSymbolInterface::GetTypeLabelRaCode(
         const std::string &name, const std::string &raValue) {
         return TypeLabelSymbol::getTypeLabelRaCode(name, raValue).c_str();
     }
 
-    std::unordered_map<std::string, std::shared_ptr<ClassSymbol>> TypeLabelSymbol::customClassSymbolMap = {};
-
     TypeLabelSymbol::TypeLabelSymbol(const utils::Pos &pos, const std::string &name,
                                      const size_t &scopeLevel, const std::string &uid)
         : LabelSymbol(pos, name, getTypeLabelRaCode(name, uid), scopeLevel, LabelType::TYPE_LABEL) {}
@@ -675,7 +687,7 @@ namespace symbol {
         if (builtInTypes.contains(name)) {
             return "tp-" + name;
         }
-        if (customTypeMap.contains(raValue)) {
+        if (isCustomType(raValue)) {
             return raValue;
         }
         return "tp-any";
@@ -695,13 +707,21 @@ namespace symbol {
         return builtInTypes.contains(name);
     }
 
+    BuiltinTypeLabel TypeLabelSymbol::getBuiltinTypeId(const std::string& name)
+    {
+        const auto &it = builtInTypes.find(name);
+        return it == builtInTypes.end() ? BuiltinTypeLabel::CUSTOM : it->second;
+    }
+
     bool IRCCTypeLabelSymbolInterface::IsBuiltInType(const char* name)
     {
         return TypeLabelSymbol::isBuiltInType(name);
     }
 
     bool TypeLabelSymbol::isCustomType(const std::string &uid) {
-        return customTypeMap.contains(uid);
+        // 自定义类型只存在于编译会话中，会话之外没有任何自定义类型
+        return ast::CompilationSession::hasCurrent() &&
+            ast::CompilationSession::current().getCustomTypeMap().contains(uid);
     }
 
     bool IRCCTypeLabelSymbolInterface::IsCustomType(const char* uid)
@@ -711,9 +731,9 @@ namespace symbol {
 
     void TypeLabelSymbol::createCustomType(
         const std::string &name, const std::string &uid, const std::shared_ptr<ClassSymbol> &classSymbol) {
-        customTypeMap[uid] = name;
-        labelTypeMap[uid] = LabelType::TYPE_LABEL;
-        customClassSymbolMap[uid] = classSymbol;
+        auto &session = ast::CompilationSession::current();
+        session.getCustomTypeMap()[uid] = name;
+        session.getCustomClassSymbolMap()[uid] = classSymbol;
     }
 
     void TypeLabelSymbol::createCustomType(const std::shared_ptr<ClassSymbol>& classSymbol)
@@ -723,9 +743,8 @@ namespace symbol {
 
     void TypeLabelSymbol::deleteCustomType(const std::string &uid)
     {
-        if (customTypeMap.contains(uid)) {
-            customTypeMap.erase(uid);
-            labelTypeMap.erase(uid);
+        if (isCustomType(uid)) {
+            ast::CompilationSession::current().getCustomTypeMap().erase(uid);
         } else
         {
             throw base::RCCCompilerError::symbolNotFoundError(
@@ -744,9 +763,13 @@ namespace symbol {
 
     std::shared_ptr<ClassSymbol> TypeLabelSymbol::getCustomClassSymbol(const std::string& uid)
     {
-        if (const auto& it = customClassSymbolMap.find(uid); it != customClassSymbolMap.end())
+        if (ast::CompilationSession::hasCurrent())
         {
-            return it->second;
+            const auto &customClassSymbolMap = ast::CompilationSession::current().getCustomClassSymbolMap();
+            if (const auto& it = customClassSymbolMap.find(uid); it != customClassSymbolMap.end())
+            {
+                return it->second;
+            }
         }
         throw base::RCCCompilerError::symbolNotFoundError(
             ast::CompileVisitor::currentPos().toString(),
@@ -787,6 +810,26 @@ namespace symbol {
         return isNot(name);
     }
 
+    BuiltinTypeLabel TypeLabelSymbol::getTypeId() const
+    {
+        return typeId;
+    }
+
+    bool TypeLabelSymbol::is(const BuiltinTypeLabel& type) const
+    {
+        return typeId == type;
+    }
+
+    bool TypeLabelSymbol::isNot(const BuiltinTypeLabel& type) const
+    {
+        return typeId != type;
+    }
+
+    bool TypeLabelSymbol::isOneOf(const TypeLabelSet& types) const
+    {
+        return types.contains(typeId);
+    }
+
     bool TypeLabelSymbol::isCustomType() const
     {
         return isCustomType(getRaVal());
@@ -827,7 +870,7 @@ namespace symbol {
 
     bool TypeLabelSymbol::isIterable() const
     {
-        return is("str") || is("list") || is("dict") || is("series");
+        return isOneOf(BuiltinTypeLabel::STR | BuiltinTypeLabel::LIST | BuiltinTypeLabel::DICT | BuiltinTypeLabel::SERIES);
     }
 
     bool TypeLabelSymbol::equalWith(const std::shared_ptr<Symbol>& other) const
@@ -847,8 +890,9 @@ namespace symbol {
             return getCustomClassSymbol()->equalWith(otherTypeLabelSymbol->getCustomClassSymbol());
         } else
         {
-            if ((isNot("any") && otherTypeLabelSymbol->isNot("any") &&
-                getVal() != otherTypeLabelSymbol->getVal()) ||
+            if ((isNot(BuiltinTypeLabel::ANY) && otherTypeLabelSymbol->isNot(BuiltinTypeLabel::ANY) &&
+                (typeId != otherTypeLabelSymbol->getTypeId() ||
+                    (typeId == BuiltinTypeLabel::CUSTOM && getVal() != otherTypeLabelSymbol->getVal()))) ||
                 (getLabelDesS().size() > 0 && otherTypeLabelSymbol->getLabelDesS().size() > 0 &&
                     getLabelDesS().size() != otherTypeLabelSymbol->getLabelDesS().size()))
             {
@@ -957,50 +1001,81 @@ namespace symbol {
         return this;
     }
 
+    const std::shared_ptr<TypeLabelSymbol>& TypeLabelSymbol::builtinTypeSymbol(const BuiltinTypeLabel& type)
+    {
+        // 函数内静态数组只初始化一次，模块并行编译时各线程可安全共享
+        static const auto canonicalTypes = [] {
+            std::array<std::shared_ptr<TypeLabelSymbol>, static_cast<size_t>(BuiltinTypeLabel::CUSTOM)> types{};
+            for (const auto &[name, typeId] : builtInTypes)
+            {
+                types[static_cast<size_t>(typeId)] = std::make_shared<TypeLabelSymbol>(utils::getUnknownPos(), name, 0);
+            }
+            return types;
+        }();
+        if (type == BuiltinTypeLabel::CUSTOM)
+        {
+            throw std::runtime_error("No canonical type label for custom types");
+        }
+        return canonicalTypes[static_cast<size_t>(type)];
+    }
+
+    std::shared_ptr<TypeLabelSymbol> TypeLabelSymbol::builtinTypeSymbol(const BuiltinTypeLabel& type,
+                                                                        const utils::Pos& pos,
+                                                                        const size_t& scopeLevel)
+    {
+        if (const auto& unknownPos = utils::getUnknownPos();
+            &pos == &unknownPos || (pos.getFilepath() == unknownPos.getFilepath() &&
+                pos.getLine() == unknownPos.getLine() && pos.getColumn() == unknownPos.getColumn()))
+        {
+            return builtinTypeSymbol(type);
+        }
+        return std::make_shared<TypeLabelSymbol>(pos, builtinTypeLabelToString(type), scopeLevel);
+    }
+
     std::shared_ptr<TypeLabelSymbol> TypeLabelSymbol::intTypeSymbol(const utils::Pos &pos, const size_t &scopeLevel) {
-        return std::make_shared<TypeLabelSymbol>(pos, "int", scopeLevel);
+        return builtinTypeSymbol(BuiltinTypeLabel::INT, pos, scopeLevel);
     }
 
     std::shared_ptr<TypeLabelSymbol> TypeLabelSymbol::floatTypeSymbol(const utils::Pos &pos, const size_t &scopeLevel) {
-        return std::make_shared<TypeLabelSymbol>(pos, "float", scopeLevel);
+        return builtinTypeSymbol(BuiltinTypeLabel::FLOAT, pos, scopeLevel);
     }
 
     std::shared_ptr<TypeLabelSymbol> TypeLabelSymbol::strTypeSymbol(const utils::Pos &pos, const size_t &scopeLevel) {
-        return std::make_shared<TypeLabelSymbol>(pos, "str", scopeLevel);
+        return builtinTypeSymbol(BuiltinTypeLabel::STR, pos, scopeLevel);
     }
 
     std::shared_ptr<TypeLabelSymbol> TypeLabelSymbol::boolTypeSymbol(const utils::Pos &pos, const size_t &scopeLevel) {
-        return std::make_shared<TypeLabelSymbol>(pos, "bool", scopeLevel);
+        return builtinTypeSymbol(BuiltinTypeLabel::BOOL, pos, scopeLevel);
     }
 
     std::shared_ptr<TypeLabelSymbol> TypeLabelSymbol::voidTypeSymbol(const utils::Pos &pos, const size_t &scopeLevel) {
-        return std::make_shared<TypeLabelSymbol>(pos, "void", scopeLevel);
+        return builtinTypeSymbol(BuiltinTypeLabel::VOID_BTL, pos, scopeLevel);
     }
 
     std::shared_ptr<TypeLabelSymbol> TypeLabelSymbol::nulTypeSymbol(const utils::Pos &pos, const size_t &scopeLevel) {
-        return std::make_shared<TypeLabelSymbol>(pos, "nul", scopeLevel);
+        return builtinTypeSymbol(BuiltinTypeLabel::NUL, pos, scopeLevel);
     }
 
     std::shared_ptr<TypeLabelSymbol> TypeLabelSymbol::anyTypeSymbol(const utils::Pos &pos, const size_t &scopeLevel) {
-        return std::make_shared<TypeLabelSymbol>(pos, "any", scopeLevel);
+        return builtinTypeSymbol(BuiltinTypeLabel::ANY, pos, scopeLevel);
     }
 
     std::shared_ptr<TypeLabelSymbol> TypeLabelSymbol::charTypeSymbol(const utils::Pos &pos, const size_t &scopeLevel) {
-        return std::make_shared<TypeLabelSymbol>(pos, "char", scopeLevel);
+        return builtinTypeSymbol(BuiltinTypeLabel::CHAR, pos, scopeLevel);
     }
 
     std::shared_ptr<TypeLabelSymbol> TypeLabelSymbol::listTypeSymbol(const utils::Pos &pos, const size_t &scopeLevel) {
-        return std::make_shared<TypeLabelSymbol>(pos, "list", scopeLevel);
+        return builtinTypeSymbol(BuiltinTypeLabel::LIST, pos, scopeLevel);
     }
 
     std::shared_ptr<TypeLabelSymbol> TypeLabelSymbol::dictTypeSymbol(const utils::Pos& pos, const size_t& scopeLevel)
     {
-        return std::make_shared<TypeLabelSymbol>(pos, "dict", scopeLevel);
+        return builtinTypeSymbol(BuiltinTypeLabel::DICT, pos, scopeLevel);
     }
 
     std::shared_ptr<TypeLabelSymbol> TypeLabelSymbol::flagTypeSymbol(const utils::Pos& pos, const size_t& scopeLevel)
     {
-        return std::make_shared<TypeLabelSymbol>(pos, "flag", scopeLevel);
+        return builtinTypeSymbol(BuiltinTypeLabel::FLAG, pos, scopeLevel);
     }
 
     std::shared_ptr<TypeLabelSymbol> TypeLabelSymbol::seriesTypeSymbol(const utils::Pos& pos, const size_t& scopeLevel)
@@ -1020,18 +1095,18 @@ namespace symbol {
 
     std::shared_ptr<TypeLabelSymbol> TypeLabelSymbol::clasTypeSymbol(const utils::Pos& pos, const size_t& scopeLevel)
     {
-        return std::make_shared<TypeLabelSymbol>(pos, "clas", scopeLevel);
+        return builtinTypeSymbol(BuiltinTypeLabel::CLS, pos, scopeLevel);
     }
 
     std::shared_ptr<TypeLabelSymbol> TypeLabelSymbol::varArgTypeSymbol(const utils::Pos& pos, const size_t& scopeLevel)
     {
-        return std::make_shared<TypeLabelSymbol>(pos, "..", scopeLevel);
+        return builtinTypeSymbol(BuiltinTypeLabel::VAR_ARGS, pos, scopeLevel);
     }
 
     std::shared_ptr<TypeLabelSymbol> TypeLabelSymbol::kwVarArgTypeSymbol(const utils::Pos& pos,
         const size_t& scopeLevel)
     {
-        return std::make_shared<TypeLabelSymbol>(pos, ".*", scopeLevel);
+        return builtinTypeSymbol(BuiltinTypeLabel::KW_VAR_ARGS, pos, scopeLevel);
     }
 
     std::shared_ptr<TypeLabelSymbol> TypeLabelSymbol::getTypeLabelSymbolByStr(const std::string& str,
@@ -1040,6 +1115,16 @@ namespace symbol {
         return std::make_shared<TypeLabelSymbol>(utils::getUnknownPos(), str, scopeLevel);
     }
 
+    LabelMarkManager::LabelMarkManager(const int permissionLabelMark, const int objectOrientedLabelMarks,
+                                       const int lifeCycleLabelMarks, const int restrictionLabelMarks,
+                                       std::unordered_set<std::string> typeLabelMarks)
+        : permissionLabelMark(permissionLabelMark), objectOrientedLabelMarks(objectOrientedLabelMarks),
+          lifeCycleLabelMarks(lifeCycleLabelMarks), restrictionLabelMarks(restrictionLabelMarks),
+          typeLabelMarks(std::move(typeLabelMarks))
+    {
+        displayResult();
+    }
+
     void LabelMarkManager::markLabels(const std::unordered_set<std::shared_ptr<LabelSymbol>>& labels)
     {
         for (const auto& label : labels)
@@ -1222,6 +1307,21 @@ namespace symbol {
         return typeLabelMarks;
     }
 
+    int LabelMarkManager::getObjectOrientedLabelMarks() const
+    {
+        return objectOrientedLabelMarks;
+    }
+
+    int LabelMarkManager::getLifeCycleLabelMarks() const
+    {
+        return lifeCycleLabelMarks;
+    }
+
+    int LabelMarkManager::getRestrictionLabelMarks() const
+    {
+        return restrictionLabelMarks;
+    }
+
     void LabelMarkManager::markPermissionLabel(const PermissionLabel& permissionLabel)
     {
         if (permissionLabelMark != -1)
@@ -1273,10 +1373,10 @@ namespace symbol {
         if (!typeLabel) {
             typeLabel = std::make_shared<TypeLabelSymbol>(pos, "any", scopeLevel);
         }
-        if (typeLabel->is(".."))
+        if (typeLabel->is(BuiltinTypeLabel::VAR_ARGS))
         {
             this->paramType = ParamType::PARAM_VAR_LEN_POSITIONAL;
-        } else if (typeLabel->is(".*"))
+        } else if (typeLabel->is(BuiltinTypeLabel::KW_VAR_ARGS))
         {
             this->paramType = ParamType::PARAM_VAR_LEN_KEYWORD;
         } else if (this->paramType == ParamType::PARAM_VAR_LEN_POSITIONAL)
@@ -1297,8 +1397,8 @@ namespace symbol {
 
     bool ParameterSymbol::typeIs(const std::string& type) const
     {
-        return typeLabel->is(type) || valueType->is(type) || typeLabel->is("any") ||
-            valueType->is("any");
+        return typeLabel->is(type) || valueType->is(type) || typeLabel->is(BuiltinTypeLabel::ANY) ||
+            valueType->is(BuiltinTypeLabel::ANY);
     }
 
     bool ParameterSymbol::typeIsNot(const std::string& type) const
@@ -1356,7 +1456,7 @@ namespace symbol {
 
     void ParameterSymbol::setValueType(const std::shared_ptr<TypeLabelSymbol>& labelSymbol)
     {
-        if (typeLabel->is("any") || labelSymbol->is("any") ||
+        if (typeLabel->is(BuiltinTypeLabel::ANY) || labelSymbol->is(BuiltinTypeLabel::ANY) ||
             typeLabel->equalWith(labelSymbol) || typeLabel->relatedTo(labelSymbol))
         {
             this->valueType = labelSymbol;
@@ -1824,7 +1924,7 @@ namespace symbol {
 
     bool FunctionSymbol::hasReturnValue() const
     {
-        return returnType != nullptr && returnType->isNot("void");
+        return returnType != nullptr && returnType->isNot(BuiltinTypeLabel::VOID_BTL);
     }
 
     bool FunctionSymbol::hasSetReturnType() const
@@ -2799,6 +2899,11 @@ namespace symbol {
         return it != table.end() ? it->second.second : nullptr;
     }
 
+    std::shared_ptr<Symbol> SymbolTable::find(const SymbolKey &key) const {
+        const auto & it = table.find(key);
+        return it != table.end() ? it->second.second : nullptr;
+    }
+
     IRCCSymbolInterface* SymbolTable::Find(const char* name)
     {
         const auto &res = find(name);
@@ -2809,16 +2914,20 @@ namespace symbol {
         return table.contains(name);
     }
 
+    bool SymbolTable::contains(const SymbolKey &key) const {
+        return table.contains(key);
+    }
+
     bool SymbolTable::Contains(const char* name)
     {
         return contains(name);
     }
 
-    std::unordered_map<std::string, std::pair<int, std::shared_ptr<Symbol>>> SymbolTable::getTable() const {
+    const SymbolMap &SymbolTable::getTable() const {
         return table;
     }
 
-    std::vector<std::string> SymbolTable::getNameIndex() const {
+    const std::vector<std::string> &SymbolTable::getNameIndex() const {
         return nameIndex;
     }
 
@@ -2846,26 +2955,205 @@ namespace symbol {
         for (const auto &s : *this)
         {
             copied->insertByName(std::static_pointer_cast<Symbol>(Symbol::copySymbolPtr(s)),
-                std::ranges::find(sysDefinitionRecord, s->getRaVal())
-                != sysDefinitionRecord.end());
+                sysDefinitionRecord.contains(s->getRaVal()));
         }
         return copied;
     }
 
-    std::unordered_set<std::string> SymbolTable::getSysDefinedRecord() const
+    const std::unordered_set<std::string> &SymbolTable::getSysDefinedRecord() const
     {
         return sysDefinitionRecord;
     }
 
+    namespace
+    {
+        // 原子表按名称的哈希分片，各编译线程登记与查找原子时只锁定其中一片
+        constexpr size_t ATOM_SHARD_COUNT = 16;
+
+        struct AtomShard {
+            std::shared_mutex mutex;
+            std::unordered_map<std::string, SymbolAtom, SymbolKeyHash, std::equal_to<>> atoms;
+        };
+
+        std::array<AtomShard, ATOM_SHARD_COUNT> atomShards;
+        std::atomic<SymbolAtom> nextAtom = 0;
+    }
+
+    SymbolAtom SymbolAtomTable::intern(const std::string_view name)
+    {
+        const SymbolKey key(name);
+        auto &shard = atomShards[key.getHash() % ATOM_SHARD_COUNT];
+        {
+            std::shared_lock lock(shard.mutex);
+            if (const auto it = shard.atoms.find(key); it != shard.atoms.end())
+            {
+                return it->second;
+            }
+        }
+        std::unique_lock lock(shard.mutex);
+        if (const auto it = shard.atoms.find(key); it != shard.atoms.end())
+        {
+            return it->second;
+        }
+        return shard.atoms.emplace(std::string(name), nextAtom++).first->second;
+    }
+
+    std::optional<SymbolAtom> SymbolAtomTable::find(const std::string_view name)
+    {
+        const SymbolKey key(name);
+        auto &shard = atomShards[key.getHash() % ATOM_SHARD_COUNT];
+        std::shared_lock lock(shard.mutex);
+        if (const auto it = shard.atoms.find(key); it != shard.atoms.end())
+        {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
     void SymbolTableManager::appendScope(const std::shared_ptr<SymbolTable>& nameScope,
                                          const std::shared_ptr<SymbolTable>& idScope)
     {
         scopes.emplace_back(nameScope, idScope);
+        declarations.emplace_back();
+        bindScope(scopes.size() - 1);
+    }
+
+    void SymbolTableManager::bind(BindingChains &chains, std::vector<SymbolAtom> &declared, const std::string &key,
+                                  const size_t level, const std::shared_ptr<Symbol> &symbol) const
+    {
+        const auto atom = SymbolAtomTable::intern(key);
+        auto &chain = chains[atom];
+        // 通常在链尾追加；向外层作用域插入声明时从链尾向前找到插入位置
+        auto pos = chain.end();
+        while (pos != chain.begin() && std::prev(pos)->level > level)
+        {
+            --pos;
+        }
+        if (pos != chain.begin() && std::prev(pos)->level == level)
+        {
+            // 同一作用域重复声明 "_" 时后者覆盖前者，与作用域符号表一致
+            std::prev(pos)->symbol = symbol;
+            return;
+        }
+        chain.insert(pos, {level, symbol});
+        declared.push_back(atom);
+    }
+
+    void SymbolTableManager::unbind(BindingChains &chains, std::vector<SymbolAtom> &declared, const std::string &key,
+                                    const size_t level) const
+    {
+        const auto atom = SymbolAtomTable::find(key);
+        if (!atom)
+        {
+            return;
+        }
+        if (const auto chainIt = chains.find(*atom); chainIt != chains.end())
+        {
+            auto &chain = chainIt->second;
+            for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+            {
+                if (it->level == level)
+                {
+                    chain.erase(std::next(it).base());
+                    break;
+                }
+            }
+            if (chain.empty())
+            {
+                chains.erase(chainIt);
+            }
+        }
+        if (const auto it = std::ranges::find(declared, *atom); it != declared.end())
+        {
+            declared.erase(it);
+        }
+    }
+
+    void SymbolTableManager::unbindScope(const size_t level) const
+    {
+        const auto undo = [level](BindingChains &chains, std::vector<SymbolAtom> &declared) {
+            for (const auto atom : declared)
+            {
+                const auto chainIt = chains.find(atom);
+                if (chainIt == chains.end())
+                {
+                    continue;
+                }
+                auto &chain = chainIt->second;
+                // 退出最内层作用域时，其声明都在各自的链尾
+                for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+                {
+                    if (it->level == level)
+                    {
+                        chain.erase(std::next(it).base());
+                        break;
+                    }
+                }
+                if (chain.empty())
+                {
+                    chains.erase(chainIt);
+                }
+            }
+            declared.clear();
+        };
+        undo(nameBindings, declarations[level].names);
+        undo(ridBindings, declarations[level].rids);
+    }
+
+    void SymbolTableManager::bindScope(const size_t level) const
+    {
+        for (const auto &[name, entry] : scopes[level].first->getTable())
+        {
+            bind(nameBindings, declarations[level].names, name, level, entry.second);
+        }
+        for (const auto &[rid, entry] : scopes[level].second->getTable())
+        {
+            bind(ridBindings, declarations[level].rids, rid, level, entry.second);
+        }
+    }
+
+    void SymbolTableManager::shiftLevels(const size_t from, const int delta) const
+    {
+        const auto shift = [delta](BindingChains &chains, const SymbolAtom atom, const size_t level) {
+            for (auto &binding : chains.at(atom))
+            {
+                if (binding.level == level)
+                {
+                    binding.level = static_cast<size_t>(static_cast<long long>(level) + delta);
+                    return;
+                }
+            }
+        };
+        // 上移时从外到内、下移时从内到外依次处理，同一条链上不会出现两个相同的层级
+        const auto shiftScope = [&](const size_t level) {
+            for (const auto atom : declarations[level].names) shift(nameBindings, atom, level);
+            for (const auto atom : declarations[level].rids) shift(ridBindings, atom, level);
+        };
+        if (delta > 0)
+        {
+            for (size_t level = declarations.size(); level-- > from;) shiftScope(level);
+        } else
+        {
+            for (size_t level = from; level < declarations.size(); level++) shiftScope(level);
+        }
+    }
+
+    const std::vector<SymbolTableManager::ScopedBinding> *SymbolTableManager::findChain(
+        const BindingChains &chains, const std::string_view key)
+    {
+        const auto atom = SymbolAtomTable::find(key);
+        if (!atom)
+        {
+            return nullptr;
+        }
+        const auto it = chains.find(*atom);
+        return it == chains.end() ? nullptr : &it->second;
     }
 
     SymbolTableManager::SymbolTableManager() {
         scopes.emplace_back(std::make_shared<SymbolTable>(),
             std::make_shared<SymbolTable>());
+        declarations.emplace_back();
         currentScopeLevel_ = 0; // 全局作用域
     }
 
@@ -2899,9 +3187,12 @@ namespace symbol {
     }
 
     void SymbolTableManager::enterScope() {
+        // 当前作用域不是最内层时，新作用域插在其后，更内层作用域的声明层级依次加一
+        shiftLevels(currentScopeLevel_ + 1, 1);
         scopes.insert(scopes.begin() + static_cast<int>(currentScopeLevel_) + 1,
                       {std::make_shared<SymbolTable>(),
                           std::make_shared<SymbolTable>()});
+        declarations.insert(declarations.begin() + static_cast<int>(currentScopeLevel_) + 1, ScopeDeclarations{});
         currentScopeLevel_++;
     }
 
@@ -2934,7 +3225,10 @@ namespace symbol {
                     TypeLabelSymbol::deleteCustomType(symbol->getRaVal());
                 }
             }
+            unbindScope(currentScopeLevel_);
             scopes.erase(scopes.begin() + static_cast<int>(currentScopeLevel_));
+            declarations.erase(declarations.begin() + static_cast<int>(currentScopeLevel_));
+            shiftLevels(currentScopeLevel_, -1);
             currentScopeLevel_--;
         }
         else {
@@ -2944,8 +3238,11 @@ namespace symbol {
 
     void SymbolTableManager::insert(const std::shared_ptr<Symbol> &symbol, const bool &systemDefined) const
     {
-        scopes[symbol->getScopeLevel()].first->insertByName(symbol, systemDefined);
-        scopes[symbol->getScopeLevel()].second->insertByRID(symbol, systemDefined);
+        const auto level = symbol->getScopeLevel();
+        scopes[level].first->insertByName(symbol, systemDefined);
+        scopes[level].second->insertByRID(symbol, systemDefined);
+        bind(nameBindings, declarations[level].names, symbol->getVal(), level, symbol);
+        bind(ridBindings, declarations[level].rids, symbol->getRaVal(), level, symbol);
     }
 
     void SymbolTableManager::removeByName(const std::string& name, const std::optional<size_t>& specifiedLevel) const
@@ -2955,6 +3252,8 @@ namespace symbol {
         {
             scopes[level].second->remove(symbol->getRaVal());
             scopes[level].first->remove(name);
+            unbind(ridBindings, declarations[level].rids, symbol->getRaVal(), level);
+            unbind(nameBindings, declarations[level].names, name, level);
         } else
         {
             throw std::runtime_error("SymbolTableManager::remove:: cannot remove '" + name + "' because it does not exist.");
@@ -2968,6 +3267,8 @@ namespace symbol {
         {
             scopes[level].first->remove(symbol->getVal());
             scopes[level].second->remove(rid);
+            unbind(nameBindings, declarations[level].names, symbol->getVal(), level);
+            unbind(ridBindings, declarations[level].rids, rid, level);
         } else
         {
             throw std::runtime_error("SymbolTableManager::remove:: cannot remove '" + rid + "' because it does not exist.");
@@ -2975,24 +3276,12 @@ namespace symbol {
     }
 
     std::pair<long long int, std::shared_ptr<Symbol>> SymbolTableManager::findByName(const std::string &name, const std::optional<size_t>& specifiedLevel) const {
-        for (int i = static_cast<int>(specifiedLevel.has_value()
-            ? specifiedLevel.value() : currentScopeLevel_); i >= 0; --i) {
-            const auto &scope = scopes[i].first;
-            if (const auto &it = scope->find(name)) {
-                return {i, it};
-            }
-        }
-        return {-1, nullptr};
+        return lookup(nameBindings, name, specifiedLevel.value_or(currentScopeLevel_), false,
+                      [](const Symbol &) { return true; });
     }
 
     std::pair<long long int, std::shared_ptr<Symbol>> SymbolTableManager::findByRID(const std::string &rid) const {
-        for (int i = static_cast<int>(currentScopeLevel_); i >= 0; --i) {
-            const auto &scope = scopes[i].second;
-            if (const auto &it = scope->find(rid)) {
-                return {i, it};
-            }
-        }
-        return {-1, nullptr};
+        return lookup(ridBindings, rid, currentScopeLevel_, false, [](const Symbol &) { return true; });
     }
 
     std::shared_ptr<Symbol> SymbolTableManager::findInCurrentScope(const std::string &name) const {
@@ -3000,17 +3289,21 @@ namespace symbol {
     }
 
     bool SymbolTableManager::containsName(const std::string &name) const {
-        return std::ranges::any_of(scopes.rbegin(), scopes.rend(),
-            [name](const auto &it)
-        {
-            return it.first->contains(name);
-        });
+        return findChain(nameBindings, name) != nullptr;
     }
 
     bool SymbolTableManager::currentScopeContains(const std::string &name) const {
         return currentNameMapScope().contains(name);
     }
 
+    void SymbolTableManager::restoreCurrentScope(const SymbolTable &nameScope, const SymbolTable &ridScope)
+    {
+        unbindScope(currentScopeLevel_);
+        *scopes[currentScopeLevel_].first = *std::static_pointer_cast<SymbolTable>(nameScope.copySelf());
+        *scopes[currentScopeLevel_].second = *std::static_pointer_cast<SymbolTable>(ridScope.copySelf());
+        bindScope(currentScopeLevel_);
+    }
+
     size_t SymbolTableManager::curScopeLevel() const {
         return currentScopeLevel_;
     }
@@ -3094,27 +3387,15 @@ namespace symbol {
 
     std::pair<long long int, std::shared_ptr<VariableSymbol>>
     SymbolTableManager::findVariableSymbolByName(const std::string &name) const {
-        for (int i = static_cast<int>(currentScopeLevel_); i >= 0; --i) {
-            const auto &scope = scopes[i].first;
-            if (const auto &it = scope->find(name)) {
-                if (it->getType() == SymbolType::VARIABLE) {
-                    return {i, std::static_pointer_cast<VariableSymbol>(it)};
-                }
-            }
-        }
-        return {-1, nullptr};
+        const auto &[level, symbol] = lookup(nameBindings, name, currentScopeLevel_, false,
+            [](const Symbol &it) { return it.getType() == SymbolType::VARIABLE; });
+        return {level, std::static_pointer_cast<VariableSymbol>(symbol)};
     }
 
     std::pair<long long int, std::shared_ptr<VariableSymbol>>
     SymbolTableManager::findVariableSymbolByRID(const std::string &rid) const {
-        for (int i = static_cast<int>(currentScopeLevel_); i >= 0; --i) {
-            const auto &scope = scopes[i].second;
-            if (const auto &it = scope->find(rid)) {
-                if (it->getType() == SymbolType::VARIABLE) {
-                    return {i, std::static_pointer_cast<VariableSymbol>(it)};
-                }
-            }
-        }
-        return {-1, nullptr};
+        const auto &[level, symbol] = lookup(ridBindings, rid, currentScopeLevel_, false,
+            [](const Symbol &it) { return it.getType() == SymbolType::VARIABLE; });
+        return {level, std::static_pointer_cast<VariableSymbol>(symbol)};
     }
 }
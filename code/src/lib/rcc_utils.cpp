@@ -3,6 +3,7 @@
 //
 
 #define  NOMINMAX
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <cmath>
@@ -12,6 +13,7 @@
 #include <utility>
 #include <set>
 #include <chrono>
+#include <cstdlib>
 #include <functional>
 #include "../../include/lib/rcc_utils.h"
 #include "../../include/rcc_base.h"
@@ -27,12 +29,15 @@
 #include <pwd.h>
 #include <cstring>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #endif
 
 namespace utils
 {
-    size_t Object::_id = 0;
+    std::atomic<size_t> Object::_id = 0;
 
     Object::Object() : id(_id++)
     {
@@ -162,6 +167,49 @@ namespace utils
         return static_cast<ArgType>(value);
     }
 
+    void appendVarint(std::string &out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    void appendBytes(std::string &out, const std::string_view bytes)
+    {
+        appendVarint(out, bytes.size());
+        out.append(bytes);
+    }
+
+    bool readVarint(const std::string_view data, size_t &pos, uint64_t &value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64 && pos < data.size(); shift += 7)
+        {
+            const auto byte = static_cast<uint8_t>(data[pos++]);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool readBytes(const std::string_view data, size_t &pos, std::string_view &bytes)
+    {
+        uint64_t size = 0;
+        if (!readVarint(data, pos, size) || data.size() - pos < size)
+        {
+            return false;
+        }
+        bytes = data.substr(pos, size);
+        pos += size;
+        return true;
+    }
+
     Number::Number(const int int_value) :
         type(NumType::int_type), int_value(int_value), double_value(0)
     {
@@ -264,6 +312,26 @@ namespace utils
 #endif
     }
 
+    std::string getCacheDir()
+    {
+        if (const char *xdgCacheHome = std::getenv("XDG_CACHE_HOME"); xdgCacheHome && *xdgCacheHome)
+        {
+            return (std::filesystem::path(xdgCacheHome) / "rcc").string();
+        }
+#ifdef _WIN32
+        if (const char *localAppData = std::getenv("LOCALAPPDATA"); localAppData && *localAppData)
+        {
+            return (std::filesystem::path(localAppData) / "rcc").string();
+        }
+#else
+        if (const char *home = std::getenv("HOME"); home && *home)
+        {
+            return (std::filesystem::path(home) / ".cache" / "rcc").string();
+        }
+#endif
+        return (std::filesystem::path(getRCCDir()) / ".cache").string();
+    }
+
     std::string getDefaultDir()
     {
         const std::filesystem::path current_path = std::filesystem::current_path();
@@ -1135,10 +1203,163 @@ namespace utils
         return needEscape(c) ? escapeCharToStr(c)[0] : c;
     }
 
+    SourceFileTable& SourceFileTable::getInstance()
+    {
+        static SourceFileTable instance;
+        return instance;
+    }
+
+    SourceFileTable::SourceFileTable()
+    {
+        // ID 0 保留给空路径，默认构造的位置均指向它
+        intern("");
+    }
+
+    uint32_t SourceFileTable::intern(const std::string& filepath)
+    {
+        {
+            std::shared_lock lock(_mutex);
+            if (const auto it = _ids.find(filepath); it != _ids.end())
+            {
+                return it->second;
+            }
+        }
+        std::unique_lock lock(_mutex);
+        if (const auto it = _ids.find(filepath); it != _ids.end())
+        {
+            return it->second;
+        }
+        const auto fileId = static_cast<uint32_t>(_entries.size());
+        _entries.push_back(std::make_unique<Entry>(Entry{filepath, {}}));
+        _ids.emplace(filepath, fileId);
+        return fileId;
+    }
+
+    uint32_t SourceFileTable::anchor(const uint32_t fileId, const uint32_t base)
+    {
+        std::unique_lock lock(_mutex);
+        // 锚点总是直接挂在文件表项下，解析时只需一次跳转
+        const uint32_t parent = _entries.at(fileId)->parent == NO_PARENT ? fileId : _entries.at(fileId)->parent;
+        if (!_freeAnchors.empty())
+        {
+            const auto anchorId = _freeAnchors.back();
+            _freeAnchors.pop_back();
+            *_entries[anchorId] = Entry{"", {}, parent, base};
+            return anchorId;
+        }
+        const auto anchorId = static_cast<uint32_t>(_entries.size());
+        _entries.push_back(std::make_unique<Entry>(Entry{"", {}, parent, base}));
+        return anchorId;
+    }
+
+    void SourceFileTable::releaseAnchors(const std::vector<uint32_t>& anchorIds)
+    {
+        std::unique_lock lock(_mutex);
+        for (const auto anchorId : anchorIds)
+        {
+            if (_entries.at(anchorId)->parent == NO_PARENT)
+            {
+                throw std::invalid_argument("Source file id " + std::to_string(anchorId) + " is not an anchor.");
+            }
+            _freeAnchors.push_back(anchorId);
+        }
+    }
+
+    SourceLoc SourceFileTable::resolveLoc(const SourceLoc& loc) const
+    {
+        std::shared_lock lock(_mutex);
+        const auto& entry = *_entries.at(loc.fileId);
+        if (entry.parent == NO_PARENT)
+        {
+            return loc;
+        }
+        return {entry.parent, loc.hasOffset() ? loc.offset + entry.base : loc.offset, loc.length};
+    }
+
+    void SourceFileTable::shiftAnchors(const std::vector<uint32_t>& anchorIds, const int64_t delta)
+    {
+        std::unique_lock lock(_mutex);
+        for (const auto anchorId : anchorIds)
+        {
+            auto& entry = *_entries.at(anchorId);
+            entry.base = static_cast<uint32_t>(static_cast<int64_t>(entry.base) + delta);
+        }
+    }
+
+    const SourceFileTable::Entry& SourceFileTable::resolve(const uint32_t fileId, uint32_t& offset) const
+    {
+        const auto& entry = *_entries.at(fileId);
+        if (entry.parent == NO_PARENT)
+        {
+            return entry;
+        }
+        offset += entry.base;
+        return *_entries[entry.parent];
+    }
+
+    const std::string& SourceFileTable::getFilepath(const uint32_t fileId) const
+    {
+        std::shared_lock lock(_mutex);
+        uint32_t offset = 0;
+        return resolve(fileId, offset).filepath;
+    }
+
+    void SourceFileTable::setLineOffsets(const uint32_t fileId, std::vector<uint32_t> lineOffsets)
+    {
+        std::unique_lock lock(_mutex);
+        _entries.at(fileId)->lineOffsets = std::move(lineOffsets);
+    }
+
+    std::pair<size_t, size_t> SourceFileTable::getLineColumn(const SourceLoc& loc) const
+    {
+        if (!loc.hasOffset())
+        {
+            return {0, 0};
+        }
+        std::shared_lock lock(_mutex);
+        uint32_t offset = loc.offset;
+        const auto& lineOffsets = resolve(loc.fileId, offset).lineOffsets;
+        if (lineOffsets.empty())
+        {
+            return {0, 0};
+        }
+        const auto it = std::upper_bound(lineOffsets.begin(), lineOffsets.end(), offset);
+        const auto lineIndex = static_cast<size_t>(it - lineOffsets.begin()) - 1;
+        return {lineIndex + 1, offset - lineOffsets[lineIndex] + 1};
+    }
+
+    uint32_t SourceFileTable::getOffset(const uint32_t fileId, const size_t line, const size_t column) const
+    {
+        std::shared_lock lock(_mutex);
+        uint32_t base = 0;
+        const auto& lineOffsets = resolve(fileId, base).lineOffsets;
+        if (line == 0 || line > lineOffsets.size())
+        {
+            return SourceLoc::NO_OFFSET;
+        }
+        return lineOffsets[line - 1] + static_cast<uint32_t>(column > 0 ? column - 1 : 0) - base;
+    }
+
     // Pos具体实现
-    Pos::Pos(const size_t line, const size_t column, const size_t offset, std::string filepath) :
-        line(line), column(column), offset(offset), filepath(std::move(filepath))
+    Pos::Pos(const size_t line, const size_t column, const size_t offset, const std::string& filepath) :
+        line(line), column(column), offset(offset), fileId(SourceFileTable::getInstance().intern(filepath))
+    {
+    }
+
+    Pos::Pos(const SourceLoc& loc) :
+        offset(loc.length), fileId(loc.fileId)
+    {
+        std::tie(line, column) = SourceFileTable::getInstance().getLineColumn(loc);
+    }
+
+    SourceLoc Pos::getLoc() const
     {
+        return {fileId, SourceFileTable::getInstance().getOffset(fileId, line, column), static_cast<uint32_t>(offset)};
+    }
+
+    uint32_t Pos::getFileId() const
+    {
+        return fileId;
     }
 
     size_t Pos::getLine() const
@@ -1178,13 +1399,13 @@ namespace utils
 
     std::string Pos::toString() const
     {
-        return filepath + ":" + std::to_string(line) + ":" + (column > 0 ? std::to_string(column) : "1") + ", line " +
+        return getFilepath() + ":" + std::to_string(line) + ":" + (column > 0 ? std::to_string(column) : "1") + ", line " +
             std::to_string(line) + (column > 1 ? ", column " + std::to_string(column) : "");
     }
 
-    std::string Pos::getFilepath() const
+    const std::string& Pos::getFilepath() const
     {
-        return filepath;
+        return SourceFileTable::getInstance().getFilepath(fileId);
     }
 
     const char* Pos::GetFilepath() const
@@ -1194,7 +1415,7 @@ namespace utils
 
     std::string Pos::getFileField() const
     {
-        return getFileNameFromPath(filepath);
+        return getFileNameFromPath(getFilepath());
     }
 
     const char* Pos::GetFileField() const
@@ -1221,6 +1442,7 @@ namespace utils
             out.write(reinterpret_cast<const char*>(&column), sizeof(column));
 
             // 写入字符串的长度
+            const std::string& filepath = getFilepath();
             const size_t filepathLength = filepath.size();
             out.write(reinterpret_cast<const char*>(&filepathLength), sizeof(filepathLength));
 
@@ -1245,15 +1467,13 @@ namespace utils
             in.read(reinterpret_cast<char*>(&filepathLength), sizeof(filepathLength));
 
             // 读取字符串的内容
+            std::string filepath;
             if (filepathLength > 0)
             {
                 filepath.resize(filepathLength); // 调整字符串大小
                 in.read(&filepath[0], static_cast<int>(filepathLength));
             }
-            else
-            {
-                filepath.clear(); // 如果长度为0，清空字符串
-            }
+            fileId = SourceFileTable::getInstance().intern(filepath);
         }
     }
 
@@ -1289,24 +1509,24 @@ namespace utils
 
     void Pos::setFilepath(const std::string& filepath_)
     {
-        this->filepath = filepath_;
+        fileId = SourceFileTable::getInstance().intern(filepath_);
     }
 
     void Pos::SetFilepath(const char* filepath_)
     {
-        filepath = std::string(filepath_);
+        setFilepath(std::string(filepath_));
     }
 
     bool Pos::compare(const Pos& other) const
     {
         return other.line == line && other.column == column &&
-            other.offset == offset && other.filepath == filepath;
+            other.offset == offset && other.fileId == fileId;
     }
 
     bool Pos::Compare(const IRCCPosInterface* other)
     {
         return line == other->GetLine() && column == other->GetColumn() &&
-            offset == other->GetOffset() && filepath == other->GetFilepath();
+            offset == other->GetOffset() && getFilepath() == other->GetFilepath();
     }
 
     const Pos* Pos::TransformToPI() const
@@ -1320,7 +1540,7 @@ namespace utils
 
     std::string Pos::briefString() const
     {
-        return getFileFromPath(filepath) + ":" + std::to_string(line) + ":" + std::to_string(column);
+        return getFileFromPath(getFilepath()) + ":" + std::to_string(line) + ":" + std::to_string(column);
     }
 
     const char* Pos::ToString() const
@@ -1336,7 +1556,7 @@ namespace utils
     std::string Pos::professionalString() const
     {
         return "Pos{line=" + std::to_string(line) + ", column=" + std::to_string(column) + ", offset=" +
-            std::to_string(offset) + ", file=" + getFileFromPath(filepath) + "}";
+            std::to_string(offset) + ", file=" + getFileFromPath(getFilepath()) + "}";
     }
 
     std::string Pos::formatString(size_t indent, size_t level) const
@@ -1345,7 +1565,7 @@ namespace utils
             spaceString(indent * (level + 1)) + "line=" + std::to_string(line) + ",\n" +
             spaceString(indent * (level + 1)) + "column=" + std::to_string(column) + ",\n" +
             spaceString(indent * (level + 1)) + "offset=" + std::to_string(offset) + ",\n" +
-            spaceString(indent * (level + 1)) + "file=" + getFileFromPath(filepath) + "\n" +
+            spaceString(indent * (level + 1)) + "file=" + getFileFromPath(getFilepath()) + "\n" +
             spaceString(indent * level) + "}";
     }
 
@@ -1645,6 +1865,100 @@ namespace utils
         }
     }
 
+    MappedFile::MappedFile(const std::string& path)
+        : _path(processRCCPath(path))
+    {
+        if (!std::filesystem::exists(_path))
+        {
+            throw std::runtime_error("Failed to read file: " + _path);
+        }
+#ifdef _WIN32
+        const HANDLE file = CreateFileA(_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw std::runtime_error("Unable to open file: " + _path);
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize))
+        {
+            CloseHandle(file);
+            throw std::runtime_error("Unable to open file: " + _path);
+        }
+        _fileHandle = file;
+        _size = static_cast<size_t>(fileSize.QuadPart);
+        // 空文件无法建立映射，直接以空视图表示
+        if (_size == 0) return;
+        const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+        {
+            CloseHandle(file);
+            _fileHandle = nullptr;
+            throw std::runtime_error("Unable to map file: " + _path);
+        }
+        _mappingHandle = mapping;
+        _data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!_data)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            _mappingHandle = _fileHandle = nullptr;
+            throw std::runtime_error("Unable to map file: " + _path);
+        }
+#else
+        const int fd = open(_path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Unable to open file: " + _path);
+        }
+        struct stat st{};
+        if (fstat(fd, &st) != 0)
+        {
+            close(fd);
+            throw std::runtime_error("Unable to open file: " + _path);
+        }
+        _size = static_cast<size_t>(st.st_size);
+        if (_size > 0)
+        {
+            void* addr = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED)
+            {
+                close(fd);
+                throw std::runtime_error("Unable to map file: " + _path);
+            }
+            _data = static_cast<const char*>(addr);
+        }
+        // 映射建立后即可关闭文件描述符
+        close(fd);
+#endif
+    }
+
+    MappedFile::~MappedFile()
+    {
+#ifdef _WIN32
+        if (_data) UnmapViewOfFile(_data);
+        if (_mappingHandle) CloseHandle(_mappingHandle);
+        if (_fileHandle) CloseHandle(_fileHandle);
+#else
+        if (_data) munmap(const_cast<char*>(_data), _size);
+#endif
+    }
+
+    std::string_view MappedFile::view() const
+    {
+        return _data ? std::string_view(_data, _size) : std::string_view{};
+    }
+
+    size_t MappedFile::size() const
+    {
+        return _data ? _size : 0;
+    }
+
+    const std::string& MappedFile::getPath() const
+    {
+        return _path;
+    }
+
     bool isValidIdentifier(const std::string& content)
     {
         // Check if the string is empty or if the first character is not a letter or an underscore
@@ -1673,7 +1987,7 @@ namespace utils
         return content.size() >= 2 && content.front() == '"' && content.back() == '"';
     }
 
-    bool isValidNumber(const std::string& content)
+    bool isValidNumber(const std::string_view content)
     {
         if (content.empty()) return false;
 
@@ -2557,7 +2871,7 @@ namespace utils
         pass(vectorJoin(annotations, "\n~ "));
     }
 
-    uint64_t hashToCode(const std::string& str)
+    uint64_t hashToCode(const std::string_view str)
     {
         constexpr uint64_t fnv_offset_basis = 14695981039346656037ULL;
 
@@ -2575,8 +2889,10 @@ namespace utils
 
     std::string generateUniqueId(const std::string& str)
     {
+        static std::mutex idMutex;
         static std::unordered_map<std::string, std::string> idMap;
         static uint64_t counter = 0;
+        std::lock_guard lock(idMutex);
 
         if (!idMap.contains(str))
         {
@@ -2658,27 +2974,27 @@ namespace utils
     }
 
     RangerPos::RangerPos(size_t startLine, size_t startColumn, size_t endLine, size_t endColumn, std::string filepath)
-        : Pos(startLine, startColumn, -1, std::move(filepath)), endLine(endLine), endColumn(endColumn)
+        : Pos(startLine, startColumn, -1, filepath), endLine(endLine), endColumn(endColumn)
     {
     }
 
     std::string RangerPos::toString() const
     {
-        return filepath + ":" + std::to_string(line) + ":" + (column > 0 ? std::to_string(column) : "1") + ", line " +
+        return getFilepath() + ":" + std::to_string(line) + ":" + (column > 0 ? std::to_string(column) : "1") + ", line " +
             std::to_string(line) + (column > 1 ? ", column " + std::to_string(column) : "") + " to " +
             "line " + std::to_string(endLine) + (endColumn > 1 ? ", column " + std::to_string(endColumn) : "");
     }
 
     std::string RangerPos::briefString() const
     {
-        return getFileFromPath(filepath) + ":" + std::to_string(line) + ":" + std::to_string(column) + " ~ " +
+        return getFileFromPath(getFilepath()) + ":" + std::to_string(line) + ":" + std::to_string(column) + " ~ " +
             std::to_string(endLine) + ":" + std::to_string(endColumn);
     }
 
     std::string RangerPos::professionalString() const
     {
         return "Pos{startLine=" + std::to_string(line) + ", startColumn=" + std::to_string(column) + ", endLine=" +
-            std::to_string(endLine) + ", endColumn=" + std::to_string(endColumn) + ", file=" + getFileFromPath(filepath)
+            std::to_string(endLine) + ", endColumn=" + std::to_string(endColumn) + ", file=" + getFileFromPath(getFilepath())
             + "}";
     }
 
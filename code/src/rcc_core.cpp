@@ -2,6 +2,7 @@
 // Created by RestRegular on 2025/6/28.
 //
 
+#include <array>
 #include <utility>
 #include "../include/rcc_base.h"
 #include "../include/rcc_core.h"
@@ -10,164 +11,307 @@
 
 namespace core {
 
-    Token::Token(): type(TokenType::TOKEN_UNKNOWN) {}
+    namespace {
+        struct SymbolEntry {
+            std::string_view text;
+            TokenType type;
+        };
 
-    Token::Token(const utils::Pos &pos, std::string content)
-            : pos(pos), value(std::move(content)), type(parseType()) {}
+        // 关键字、符号与描述标签，与 KEYWORDS、DELIMITERS、RANGERS、OPERATORS、DESCRIBE_LABELS 等集合保持一致
+        constexpr SymbolEntry SYMBOL_ENTRIES[] = {
+            {"true", TokenType::TOKEN_TRUE},
+            {"false", TokenType::TOKEN_FALSE},
+            {"null", TokenType::TOKEN_NULL},
+            {"class", TokenType::TOKEN_CLASS},
+            {"fun", TokenType::TOKEN_FUNCTION},
+            {"if", TokenType::TOKEN_IF},
+            {"else", TokenType::TOKEN_ELSE},
+            {"elif", TokenType::TOKEN_ELIF},
+            {"for", TokenType::TOKEN_FOR},
+            {"while", TokenType::TOKEN_WHILE},
+            {"return", TokenType::TOKEN_RETURN},
+            {"break", TokenType::TOKEN_BREAK},
+            {"continue", TokenType::TOKEN_CONTINUE},
+            {"try", TokenType::TOKEN_TRY},
+            {"catch", TokenType::TOKEN_CATCH},
+            {"finally", TokenType::TOKEN_FINALLY},
+            {"throw", TokenType::TOKEN_THROW},
+            {"until", TokenType::TOKEN_UNTIL},
+            {"ctor", TokenType::TOKEN_CTOR},
+            {"pass", TokenType::TOKEN_PASS},
+            {"link", TokenType::TOKEN_LINK},
+            {"var", TokenType::TOKEN_VAR},
+            {"encapsulated", TokenType::TOKEN_ENCAPSULATED},
+            {"ret", TokenType::TOKEN_RETURN},
+            {"+", TokenType::TOKEN_PLUS},
+            {"-", TokenType::TOKEN_MINUS},
+            {"*", TokenType::TOKEN_STAR},
+            {"/", TokenType::TOKEN_SLASH},
+            {"%", TokenType::TOKEN_MODULO},
+            {"&", TokenType::TOKEN_BIT_AND},
+            {"|", TokenType::TOKEN_BIT_OR},
+            {"^", TokenType::TOKEN_BIT_XOR},
+            {"<<", TokenType::TOKEN_BIT_LEFT_SHIFT},
+            {">>", TokenType::TOKEN_BIT_RIGHT_SHIFT},
+            {"==", TokenType::TOKEN_EQUAL},
+            {"!=", TokenType::TOKEN_NOT_EQUAL},
+            {">", TokenType::TOKEN_GREATER},
+            {">=", TokenType::TOKEN_GREATER_EQUAL},
+            {"<", TokenType::TOKEN_LESS},
+            {"<=", TokenType::TOKEN_LESS_EQUAL},
+            {"&&", TokenType::TOKEN_AND},
+            {"||", TokenType::TOKEN_OR},
+            {"=", TokenType::TOKEN_ASSIGN},
+            {":", TokenType::TOKEN_COLON},
+            {"?", TokenType::TOKEN_QUESTION},
+            {"::", TokenType::TOKEN_DOUBLE_COLON},
+            {"**", TokenType::TOKEN_DOUBLE_STAR},
+            {"++", TokenType::TOKEN_DOUBLE_PLUS},
+            {"--", TokenType::TOKEN_DOUBLE_MINUS},
+            {"~", TokenType::TOKEN_TILDE},
+            {"@", TokenType::TOKEN_AT},
+            {"&=", TokenType::TOKEN_BIT_AND_ASSIGN},
+            {"|=", TokenType::TOKEN_BIT_OR_ASSIGN},
+            {"^=", TokenType::TOKEN_BIT_XOR_ASSIGN},
+            {"+=", TokenType::TOKEN_PLUS_ASSIGN},
+            {"-=", TokenType::TOKEN_MINUS_ASSIGN},
+            {"*=", TokenType::TOKEN_STAR_ASSIGN},
+            {"/=", TokenType::TOKEN_SLASH_ASSIGN},
+            {"%=", TokenType::TOKEN_MODULO_ASSIGN},
+            {".", TokenType::TOKEN_DOT},
+            {"(", TokenType::TOKEN_LPAREN},
+            {")", TokenType::TOKEN_RPAREN},
+            {"[", TokenType::TOKEN_LBRACKET},
+            {"]", TokenType::TOKEN_RBRACKET},
+            {"{", TokenType::TOKEN_LBRACE},
+            {"}", TokenType::TOKEN_RBRACE},
+            {"!", TokenType::TOKEN_NOT},
+            {",", TokenType::TOKEN_COMMA},
+            {"->", TokenType::TOKEN_INDICATOR},
+            {"\n", TokenType::TOKEN_NEWLINE},
+            {"\r", TokenType::TOKEN_NEWLINE},
+            {"..", TokenType::TOKEN_LABEL},
+            {".*", TokenType::TOKEN_LABEL},
+            {"\\", TokenType::TOKEN_SKIP_NEWLINE},
+            {";", TokenType::TOKEN_DELIMITER},
+            {RCC_TOKEN_STREAM_START, TokenType::TOKEN_STREAM_START},
+            {RCC_TOKEN_STREAM_END, TokenType::TOKEN_STREAM_END},
+            // 描述标签
+            {"public", TokenType::TOKEN_LABEL},
+            {"private", TokenType::TOKEN_LABEL},
+            {"protected", TokenType::TOKEN_LABEL},
+            {"builtin", TokenType::TOKEN_LABEL},
+            {"const", TokenType::TOKEN_LABEL},
+            {"quote", TokenType::TOKEN_LABEL},
+            {"static", TokenType::TOKEN_LABEL},
+            {"global", TokenType::TOKEN_LABEL},
+            {"overwrite", TokenType::TOKEN_LABEL},
+            {"interface", TokenType::TOKEN_LABEL},
+            {"virtual", TokenType::TOKEN_LABEL},
+            {"int", TokenType::TOKEN_LABEL},
+            {"float", TokenType::TOKEN_LABEL},
+            {"str", TokenType::TOKEN_LABEL},
+            {"bool", TokenType::TOKEN_LABEL},
+            {"char", TokenType::TOKEN_LABEL},
+            {"any", TokenType::TOKEN_LABEL},
+            {"list", TokenType::TOKEN_LABEL},
+            {"dict", TokenType::TOKEN_LABEL},
+            {"series", TokenType::TOKEN_LABEL},
+            {"func", TokenType::TOKEN_LABEL},
+            {"funi", TokenType::TOKEN_LABEL},
+            {"void", TokenType::TOKEN_LABEL},
+            {"nul", TokenType::TOKEN_LABEL},
+            {"clas", TokenType::TOKEN_LABEL},
+        };
+        constexpr size_t SYMBOL_COUNT = std::size(SYMBOL_ENTRIES);
+        // 两级完美哈希（hash and displace）：先按 seed 0 分桶，再为每个桶挑选使桶内条目互不冲突的 seed
+        constexpr size_t SYMBOL_BUCKET_COUNT = 64;
+        constexpr size_t SYMBOL_SLOT_COUNT = 256;
+        constexpr uint16_t EMPTY_SLOT = UINT16_MAX;
 
-    Token::Token(utils::Pos pos)
-        : pos(std::move(pos)), value(RIO_PROGRAM_SIGN), type(TokenType::TOKEN_PROGRAM){
-    }
+        constexpr uint32_t symbolHash(const std::string_view text, const uint32_t seed)
+        {
+            uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+            for (const char c : text) {
+                hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+            }
+            return hash ^ (hash >> 16);
+        }
 
-    utils::Pos Token::getPos() const {
-        return pos;
-    }
+        struct SymbolTable {
+            std::array<uint16_t, SYMBOL_BUCKET_COUNT> seeds{};
+            std::array<uint16_t, SYMBOL_SLOT_COUNT> slots{};
+        };
 
-    const std::string &Token::getValue() const {
-        return value;
-    }
+        constexpr SymbolTable buildSymbolTable()
+        {
+            SymbolTable table{};
+            table.slots.fill(EMPTY_SLOT);
+            std::array<std::array<uint16_t, SYMBOL_COUNT>, SYMBOL_BUCKET_COUNT> buckets{};
+            std::array<size_t, SYMBOL_BUCKET_COUNT> bucketSizes{};
+            for (size_t i = 0; i < SYMBOL_COUNT; i++) {
+                const size_t bucket = symbolHash(SYMBOL_ENTRIES[i].text, 0) % SYMBOL_BUCKET_COUNT;
+                buckets[bucket][bucketSizes[bucket]++] = static_cast<uint16_t>(i);
+            }
+            // 条目多的桶先放置
+            std::array<size_t, SYMBOL_BUCKET_COUNT> order{};
+            for (size_t i = 0; i < SYMBOL_BUCKET_COUNT; i++) {
+                order[i] = i;
+            }
+            for (size_t i = 1; i < SYMBOL_BUCKET_COUNT; i++) {
+                for (size_t j = i; j > 0 && bucketSizes[order[j - 1]] < bucketSizes[order[j]]; j--) {
+                    std::swap(order[j - 1], order[j]);
+                }
+            }
+            for (const size_t bucket : order) {
+                if (bucketSizes[bucket] == 0) {
+                    break;
+                }
+                for (uint32_t seed = 1;; seed++) {
+                    if (seed == EMPTY_SLOT) {
+                        throw "no perfect hash seed found for symbol table";
+                    }
+                    std::array<size_t, SYMBOL_COUNT> candidate{};
+                    bool fits = true;
+                    for (size_t k = 0; k < bucketSizes[bucket] && fits; k++) {
+                        candidate[k] = symbolHash(SYMBOL_ENTRIES[buckets[bucket][k]].text, seed) % SYMBOL_SLOT_COUNT;
+                        fits = table.slots[candidate[k]] == EMPTY_SLOT;
+                        for (size_t m = 0; m < k && fits; m++) {
+                            fits = candidate[m] != candidate[k];
+                        }
+                    }
+                    if (fits) {
+                        table.seeds[bucket] = static_cast<uint16_t>(seed);
+                        for (size_t k = 0; k < bucketSizes[bucket]; k++) {
+                            table.slots[candidate[k]] = buckets[bucket][k];
+                        }
+                        break;
+                    }
+                }
+            }
+            return table;
+        }
 
-    static std::unordered_map<std::string, TokenType> tokenMap = {
-        {"true", TokenType::TOKEN_TRUE},
-        {"false", TokenType::TOKEN_FALSE},
-        {"null", TokenType::TOKEN_NULL},
-        {"class", TokenType::TOKEN_CLASS},
-        {"fun", TokenType::TOKEN_FUNCTION},
-        {"if", TokenType::TOKEN_IF},
-        {"else", TokenType::TOKEN_ELSE},
-        {"elif", TokenType::TOKEN_ELIF},
-        {"for", TokenType::TOKEN_FOR},
-        {"while", TokenType::TOKEN_WHILE},
-        {"return", TokenType::TOKEN_RETURN},
-        {"break", TokenType::TOKEN_BREAK},
-        {"continue", TokenType::TOKEN_CONTINUE},
-        {"try", TokenType::TOKEN_TRY},
-        {"catch", TokenType::TOKEN_CATCH},
-        {"finally", TokenType::TOKEN_FINALLY},
-        {"throw", TokenType::TOKEN_THROW},
-        {"until", TokenType::TOKEN_UNTIL},
-        {"ctor", TokenType::TOKEN_CTOR},
-        {"pass", TokenType::TOKEN_PASS},
-        {"link", TokenType::TOKEN_LINK},
-        {"var", TokenType::TOKEN_VAR},
-        {"encapsulated", TokenType::TOKEN_ENCAPSULATED},
-        {"ret", TokenType::TOKEN_RETURN},
-        {"+", TokenType::TOKEN_PLUS},
-        {"-", TokenType::TOKEN_MINUS},
-        {"*", TokenType::TOKEN_STAR},
-        {"/", TokenType::TOKEN_SLASH},
-        {"%", TokenType::TOKEN_MODULO},
-        {"&", TokenType::TOKEN_BIT_AND},
-        {"|", TokenType::TOKEN_BIT_OR},
-        {"^", TokenType::TOKEN_BIT_XOR},
-        {"<<", TokenType::TOKEN_BIT_LEFT_SHIFT},
-        {">>", TokenType::TOKEN_BIT_RIGHT_SHIFT},
-        {"==", TokenType::TOKEN_EQUAL},
-        {"!=", TokenType::TOKEN_NOT_EQUAL},
-        {">", TokenType::TOKEN_GREATER},
-        {">=", TokenType::TOKEN_GREATER_EQUAL},
-        {"<", TokenType::TOKEN_LESS},
-        {"<=", TokenType::TOKEN_LESS_EQUAL},
-        {"&&", TokenType::TOKEN_AND},
-        {"||", TokenType::TOKEN_OR},
-        {"=", TokenType::TOKEN_ASSIGN},
-        {":", TokenType::TOKEN_COLON},
-        {"?", TokenType::TOKEN_QUESTION},
-        {"::", TokenType::TOKEN_DOUBLE_COLON},
-        {"**", TokenType::TOKEN_DOUBLE_STAR},
-        {"++", TokenType::TOKEN_DOUBLE_PLUS},
-        {"--", TokenType::TOKEN_DOUBLE_MINUS},
-        {"~", TokenType::TOKEN_TILDE},
-        {"@", TokenType::TOKEN_AT},
-        {"&=", TokenType::TOKEN_BIT_AND_ASSIGN},
-        {"|=", TokenType::TOKEN_BIT_OR_ASSIGN},
-        {"^=", TokenType::TOKEN_BIT_XOR_ASSIGN},
-        {"+=", TokenType::TOKEN_PLUS_ASSIGN},
-        {"-=", TokenType::TOKEN_MINUS_ASSIGN},
-        {"*=", TokenType::TOKEN_STAR_ASSIGN},
-        {"/=", TokenType::TOKEN_SLASH_ASSIGN},
-        {"%=", TokenType::TOKEN_MODULO_ASSIGN},
-        {".", TokenType::TOKEN_DOT},
-        {"(", TokenType::TOKEN_LPAREN},
-        {")", TokenType::TOKEN_RPAREN},
-        {"[", TokenType::TOKEN_LBRACKET},
-        {"]", TokenType::TOKEN_RBRACKET},
-        {"{", TokenType::TOKEN_LBRACE},
-        {"}", TokenType::TOKEN_RBRACE},
-        {"!", TokenType::TOKEN_NOT},
-        {",", TokenType::TOKEN_COMMA},
-        {"->", TokenType::TOKEN_INDICATOR},
-        {"\n", TokenType::TOKEN_NEWLINE},
-        {"\r", TokenType::TOKEN_NEWLINE},
-        {"..", TokenType::TOKEN_LABEL},
-        {".*", TokenType::TOKEN_LABEL},
-        {"\\", TokenType::TOKEN_SKIP_NEWLINE}
-    };
+        constexpr SymbolTable SYMBOL_TABLE = buildSymbolTable();
 
-    TokenType Token::getType() const {
-        return type;
-    }
-
-    TokenType Token::parseType()
-    {
-        // 处理空值情况
-        if (value.empty()) {
-            return TokenType::TOKEN_UNDEFINED;
-        }
-        if (value == RCC_TOKEN_STREAM_END) {
-            return TokenType::TOKEN_STREAM_END;
-        }
-        if (value == RCC_TOKEN_STREAM_START) {
-            return TokenType::TOKEN_STREAM_START;
-        }
-        // 优先检查特殊格式（字符、字符串、数字）
-        if (utils::StringManager::isCharFormat(value)) {
-            return TokenType::TOKEN_CHAR;
-        }
-        if (const auto &[res, str] = utils::StringManager::isStringFormat(value);
-            res) {
-            value = str;
-            return TokenType::TOKEN_STRING;
+        // 判断是否为可带符号、至多一个小数点的数字字面量，返回其类型
+        TokenType classifyNumber(const std::string_view text)
+        {
+            size_t i = text[0] == '+' || text[0] == '-' ? 1 : 0;
+            bool hasDigit = false, hasDot = false;
+            for (; i < text.size(); i++) {
+                if (text[i] >= '0' && text[i] <= '9') {
+                    hasDigit = true;
+                } else if (text[i] == '.' && !hasDot) {
+                    hasDot = true;
+                } else {
+                    return TokenType::TOKEN_UNDEFINED;
+                }
+            }
+            if (!hasDigit) {
+                return TokenType::TOKEN_UNDEFINED;
+            }
+            return hasDot ? TokenType::TOKEN_FLOAT : TokenType::TOKEN_INTEGER;
         }
-        if (utils::isNumber(value)) {
-            const auto& num = utils::stringToNumber(value);
-            if (num.type == utils::NumType::int_type) {
-                return TokenType::TOKEN_INTEGER;
+
+        bool isIdentifierText(const std::string_view text)
+        {
+            const auto isAlpha = [](const char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; };
+            if (!isAlpha(text[0])) {
+                return false;
             }
-            if (num.type == utils::NumType::double_type) {
-                return TokenType::TOKEN_FLOAT;
+            for (size_t i = 1; i < text.size(); i++) {
+                if (!isAlpha(text[i]) && !(text[i] >= '0' && text[i] <= '9')) {
+                    return false;
+                }
             }
-            return TokenType::TOKEN_UNDEFINED;
+            return true;
         }
-        // 在映射表中查找，找到则返回对应类型，否则返回标识符或未定义
-        if (const auto it = tokenMap.find(value); it != tokenMap.end()) {
-            return it->second;
+
+        // 字符串字面量的值保留外层引号并转义其内容
+        std::string normalizeValue(std::string value, const TokenType type)
+        {
+            if (type == TokenType::TOKEN_STRING) {
+                return utils::StringManager::toStringFormat(value.substr(1, value.size() - 2));
+            }
+            return value;
         }
-        // 检查是否是关键字
-        if (base::KEYWORDS.contains(value)) {
-            return TokenType::TOKEN_KEYWORD;
+    }
+
+    TokenType lookupSymbolType(const std::string_view text)
+    {
+        const uint16_t seed = SYMBOL_TABLE.seeds[symbolHash(text, 0) % SYMBOL_BUCKET_COUNT];
+        if (seed == 0) {
+            return TokenType::TOKEN_UNDEFINED;
         }
-        // 检查是否是分隔符
-        if (base::DELIMITERS.contains(value)) {
-            return TokenType::TOKEN_DELIMITER;
+        if (const uint16_t index = SYMBOL_TABLE.slots[symbolHash(text, seed) % SYMBOL_SLOT_COUNT];
+            index != EMPTY_SLOT && SYMBOL_ENTRIES[index].text == text) {
+            return SYMBOL_ENTRIES[index].type;
         }
-        // 检查是否是范围符
-        if (base::RANGERS.contains(value)) {
-            return TokenType::TOKEN_RANGER;
+        return TokenType::TOKEN_UNDEFINED;
+    }
+
+    TokenType classifyLexeme(const std::string_view text)
+    {
+        if (text.empty()) {
+            return TokenType::TOKEN_UNDEFINED;
         }
-        // 检查是否是操作符
-        if (base::OPERATORS.contains(value)) {
-            return TokenType::TOKEN_OPERATOR;
+        // 按首字符分派，依次对应字符、字符串、数字、关键字与符号、标识符
+        switch (text.front()) {
+        case '\'':
+            return text.back() == '\'' && (text.size() == 3 || (text.size() == 4 && text[1] == '\\'))
+                ? TokenType::TOKEN_CHAR : TokenType::TOKEN_UNDEFINED;
+        case '"':
+            return text.size() >= 2 && text.back() == '"' ? TokenType::TOKEN_STRING : TokenType::TOKEN_UNDEFINED;
+        default:
+            break;
         }
-        // 检查是否是标签
-        if (base::DESCRIBE_LABELS.contains(value)){
-            return TokenType::TOKEN_LABEL;
+        if ((text.front() >= '0' && text.front() <= '9') || text.front() == '.' ||
+            ((text.front() == '+' || text.front() == '-') && text.size() > 1)) {
+            if (const auto type = classifyNumber(text); type != TokenType::TOKEN_UNDEFINED) {
+                return type;
+            }
         }
-        // 若未匹配到关键字或符号，则检查是否是合法标识符
-        if (utils::isValidIdentifier(value)) {
-            return TokenType::TOKEN_IDENTIFIER;
+        if (const auto type = lookupSymbolType(text); type != TokenType::TOKEN_UNDEFINED) {
+            return type;
         }
-        return TokenType::TOKEN_UNDEFINED;
+        return isIdentifierText(text) ? TokenType::TOKEN_IDENTIFIER : TokenType::TOKEN_UNDEFINED;
+    }
+
+    Token::Token(): type(TokenType::TOKEN_UNKNOWN) {}
+
+    Token::Token(const utils::Pos &pos, std::string content)
+            : Token(pos.getLoc(), std::move(content)) {}
+
+    Token::Token(const utils::SourceLoc &loc, std::string content)
+            : loc(loc), type(classifyLexeme(content)) {
+        value = normalizeValue(std::move(content), type);
+    }
+
+    Token::Token(const utils::Pos &pos, std::string content, const TokenType type)
+            : value(std::move(content)), loc(pos.getLoc()), type(type) {}
+
+    Token::Token(const utils::SourceLoc &loc, std::string content, const TokenType type)
+            : value(std::move(content)), loc(loc), type(type) {}
+
+    Token::Token(const utils::Pos &pos)
+        : value(RIO_PROGRAM_SIGN), loc(pos.getLoc()), type(TokenType::TOKEN_PROGRAM){
+    }
+
+    utils::Pos Token::getPos() const {
+        return utils::Pos(loc);
+    }
+
+    const utils::SourceLoc &Token::getLoc() const {
+        return loc;
+    }
+
+    const std::string &Token::getValue() const {
+        return value;
+    }
+
+    TokenType Token::getType() const {
+        return type;
     }
 
     std::string Token::toString() const {
@@ -176,12 +320,12 @@ namespace core {
 
     std::string Token::briefString() const {
         return "[<" + getTokenTypeName(type) + "> \"" + utils::StringManager::escape(value) + "\" (" +
-               pos.briefString() + ")]";
+               getPos().briefString() + ")]";
     }
 
     std::string Token::professionalString() const {
         return "Token{type=" + getTokenTypeName(type) + ", value=\"" + utils::StringManager::escape(value) +
-               "\", pos=" + pos.professionalString() + "}";
+               "\", pos=" + getPos().professionalString() + "}";
     }
 
     void Token::setValue(std::string value_) {
@@ -189,11 +333,11 @@ namespace core {
     }
 
     std::string Token::getPosString() const {
-        return pos.toString();
+        return getPos().toString();
     }
 
-    void Token::setPos(utils::Pos pos_) {
-        this->pos = std::move(pos_);
+    void Token::setPos(const utils::Pos &pos_) {
+        this->loc = pos_.getLoc();
     }
 
     void Token::setType(TokenType type_) {
@@ -204,7 +348,7 @@ namespace core {
         return utils::spaceString(indent * level) + "Token{\n"
         + utils::spaceString(indent * (level + 1)) + "type=" + getTokenTypeName(type) + ",\n"
         + utils::spaceString(indent * (level + 1)) + "value=\"" + utils::StringManager::escape(value) + "\",\n"
-        + utils::spaceString(indent * (level + 1)) + "pos={\n" + pos.formatString(indent, level + 2) + "\n"
+        + utils::spaceString(indent * (level + 1)) + "pos={\n" + getPos().formatString(indent, level + 2) + "\n"
         + utils::spaceString(indent * (level + 1)) + "}\n"
         + utils::spaceString(indent * level) + "}";
     }
@@ -5,11 +5,17 @@
 #include <chrono>
 #include <iostream>
 #include <string>
+#include <thread>
 
 #include "../declarations/builtin/functions/rcc_builtin_export_dec.h"
 #include "../include/rcc_base.h"
+#include "../include/analyzer/rcc_lexer_kernels.h"
 #include "../include/analyzer/rcc_parser.h"
+#include "../include/analyzer/rcc_incremental_parser.h"
+#include "../include/analyzer/rcc_ast_serializer.h"
+#include "../include/components/ri/rcc_ri_bytecode.h"
 #include "../include/visitors/rcc_visitors.h"
+#include "../include/visitors/rcc_builtin_snapshot.h"
 #include "../include/lib/RJson/RJson_error.h"
 #include "../include/lib/rcc_utils.h"
 
@@ -30,6 +36,17 @@ bool __time_info__ = false;
 bool __symbol_flag_builtin__ = false;
 bool __llvm_flag__ = false;
 bool __llvm_verify__ = false;
+bool __bench_lexer_flag__ = false;
+bool __bench_parser_flag__ = false;
+bool __rab_decode_flag__ = false;
+bool __ast_verify_flag__ = false;
+bool __build_snapshot_flag__ = false;
+bool __watch_flag__ = false;
+bool __watch_verify_flag__ = false;
+int __bench_iterations__ = 20;
+int __bench_statements__ = 10000;
+int __watch_interval__ = 200;
+int __watch_updates__ = 0;
 
 // 参数解析器实例
 ProgArgParser argParser{};
@@ -62,8 +79,9 @@ void initializeArgumentParser() {
         "", "", {"e", "ext"})
     .addOption<OutputFormat>("format", &ast::CompileVisitor::__symbol_option_format__,
                                     OutputFormat::TXT,
-                                    "Specify the output mode for the analyzed content. The default mode is 'txt',"
-                                    " and the supported modes include: 'json', 'txt'.",
+                                    "Specify the output mode for the analyzed or compiled content. The default mode is 'txt'."
+                                    " The symbol command supports 'txt' and 'json', the compile command supports"
+                                    " 'txt' and 'rab' (binary RA bytecode).",
                                     {"fmt"})
     .addFlag("export", &ast::CompileVisitor::__symbol_flag_export__, false,
              true, "Only display exported symbols (all symbols are displayed by default)",
@@ -93,11 +111,37 @@ void initializeArgumentParser() {
         "This option is used to specify the compile level for RCC."
         "0 -> Debug, 1 -> Testing, 2 -> Release, 3 -> Minified",
         {"cl"})
+    .addFlag("opt-stats", &ast::CompileVisitor::__compile_flag_opt_stats__, false, true,
+             "Print the number of RA instructions removed by each optimization pass "
+             "(the optimizer runs at compile level 2 and above)",
+             {"os"})
+    .addFlag("tree-shake", &ast::CompileVisitor::__compile_flag_tree_shake__, false, true,
+             "Omit functions, classes and extension members that are unreachable from the program entry "
+             "(enabled by default at compile level 3)",
+             {"ts"})
+    .addOption<int>("inline-threshold", &ast::CompileVisitor::__compile_option_inline_threshold__, 8,
+        "Maximum number of RA instructions in the body of a small function whose direct calls are inlined "
+        "(inlining runs at compile level 2 when it does not grow the output and always at level 3; "
+        "functions exported by a module are not inlined, and definitions left unreferenced are omitted). "
+        "0 disables inlining.",
+        {"it"})
+    .addOption<int>("jobs", &ast::CompileVisitor::__compile_option_jobs__, 0,
+        "Number of threads used to parse and compile imported extensions in parallel "
+        "(the number of hardware threads by default). The output does not depend on it.",
+        {"j"})
+    .addFlag("no-module-cache", &ast::CompileVisitor::__compile_flag_no_module_cache__, false, true,
+             "Compile every imported extension from source instead of loading unchanged ones from the module cache",
+             {"nmc"})
     .addDependent("compile", "output", ProgArgParser::CheckDir::UniDir)
     .addMutuallyExclusive("compile",
-        std::vector<std::string>{"extension", "export", "format", "builtin", "spec-symbol", "symbol"},
+        std::vector<std::string>{"extension", "export", "builtin", "spec-symbol", "symbol"},
         ProgArgParser::CheckDir::BiDir)
-    .addDependent("compile-level", "compile", ProgArgParser::CheckDir::UniDir);
+    .addDependent("compile-level", "compile", ProgArgParser::CheckDir::UniDir)
+    .addDependent("opt-stats", "compile", ProgArgParser::CheckDir::UniDir)
+    .addDependent("tree-shake", "compile", ProgArgParser::CheckDir::UniDir)
+    .addDependent("inline-threshold", "compile", ProgArgParser::CheckDir::UniDir)
+    .addDependent("jobs", "compile", ProgArgParser::CheckDir::UniDir)
+    .addDependent("no-module-cache", "compile", ProgArgParser::CheckDir::UniDir);
 
     // LLVM IR 生成 flag 及相关配置
     argParser.addFlag("llvm", &__llvm_flag__, false, true,
@@ -116,6 +160,81 @@ void initializeArgumentParser() {
         std::vector<std::string>{"compile", "symbol"},
         ProgArgParser::CheckDir::BiDir);
 
+    // 性能基准测试 flag
+    argParser.addFlag("bench-lexer", &__bench_lexer_flag__, false, true,
+                      "Measure the lexer throughput (MB/s) on the file specified by path",
+                      {"bl"})
+    .addOption<int>("bench-iterations", &__bench_iterations__, 20,
+        "Number of iterations run by the benchmark flags",
+        {"bi"})
+    .addFlag("bench-parser", &__bench_parser_flag__, false, true,
+             "Measure the parser throughput (statements/s) on the file specified by path, "
+             "or on a synthetic corpus when no path is given",
+             {"bp"})
+    .addOption<int>("bench-statements", &__bench_statements__, 10000,
+        "Number of top-level statements in the synthetic corpus used by bench-parser",
+        {"bs"})
+    .addDependent("bench-lexer", "path", ProgArgParser::CheckDir::UniDir)
+    .addDependent("bench-statements", "bench-parser", ProgArgParser::CheckDir::UniDir)
+    .addMutuallyExclusive("bench-lexer",
+        std::vector<std::string>{"compile", "symbol", "llvm", "bench-parser"},
+        ProgArgParser::CheckDir::BiDir)
+    .addMutuallyExclusive("bench-parser",
+        std::vector<std::string>{"compile", "symbol", "llvm"},
+        ProgArgParser::CheckDir::BiDir);
+
+    // 增量语法检查 flag
+    argParser.addFlag("watch", &__watch_flag__, false, true,
+                      "Watch the file specified by path and re-parse only the edited statements after every change, "
+                      "reporting the syntax errors",
+                      {"w"})
+    .addOption<int>("watch-interval", &__watch_interval__, 200,
+        "Interval in milliseconds between two checks of the watched file",
+        {"wi"})
+    .addOption<int>("watch-updates", &__watch_updates__, 0,
+        "Stop watching after this number of changes have been parsed (0 watches until interrupted)",
+        {"wu"})
+    .addFlag("watch-verify", &__watch_verify_flag__, false, true,
+             "After every change also parse the whole file and fail if the result differs from the incremental one",
+             {"wv"})
+    .addDependent("watch", "path", ProgArgParser::CheckDir::UniDir)
+    .addDependent("watch-interval", "watch", ProgArgParser::CheckDir::UniDir)
+    .addDependent("watch-updates", "watch", ProgArgParser::CheckDir::UniDir)
+    .addDependent("watch-verify", "watch", ProgArgParser::CheckDir::UniDir)
+    .addMutuallyExclusive("watch",
+        std::vector<std::string>{"compile", "symbol", "llvm", "bench-lexer", "bench-parser"},
+        ProgArgParser::CheckDir::BiDir);
+
+    // RAB 字节码反编译 flag
+    argParser.addFlag("rab-decode", &__rab_decode_flag__, false, true,
+                      "Decode the RAB bytecode file specified by path back to RA text "
+                      "and output to console or the file specified by output",
+                      {"rd"})
+    .addDependent("rab-decode", "path", ProgArgParser::CheckDir::UniDir)
+    .addMutuallyExclusive("rab-decode",
+        std::vector<std::string>{"compile", "symbol", "llvm", "bench-lexer", "bench-parser"},
+        ProgArgParser::CheckDir::BiDir);
+
+    // 语法树序列化往返校验 flag，用于测试语法树缓存
+    argParser.addFlag("ast-verify", &__ast_verify_flag__, false, true,
+                      "Parse the file specified by path, serialize its syntax tree as the AST cache does, "
+                      "load it back and fail if the loaded tree serializes differently",
+                      {"av"})
+    .addDependent("ast-verify", "path", ProgArgParser::CheckDir::UniDir)
+    .addMutuallyExclusive("ast-verify",
+        std::vector<std::string>{"compile", "symbol", "llvm", "bench-lexer", "bench-parser", "rab-decode", "watch"},
+        ProgArgParser::CheckDir::BiDir);
+
+    // 内置扩展快照 flag，由构建过程调用
+    argParser.addFlag("build-snapshot", &__build_snapshot_flag__, false, true,
+                      "Precompile the builtin extensions (or the extensions in the directory specified by path) "
+                      "and write the snapshot embedded into RCC as a C++ source file to the file specified by output",
+                      {"bsn"})
+    .addDependent("build-snapshot", "output", ProgArgParser::CheckDir::UniDir)
+    .addMutuallyExclusive("build-snapshot",
+        std::vector<std::string>{"compile", "symbol", "llvm", "bench-lexer", "bench-parser", "rab-decode"},
+        ProgArgParser::CheckDir::BiDir);
+
     argParser.addFlag("time-info", &__time_info__, false, true,
                       "Enables timing information during execution. "
                       "This flag outputs detailed timing metrics for the program's execution, "
@@ -132,6 +251,10 @@ void initializeArgumentParser() {
 
 void handleSymbolFlag()
 {
+    if (ast::CompileVisitor::__symbol_option_format__ == OutputFormat::RAB)
+    {
+        throw std::runtime_error("The 'rab' format is only supported by the compile command.");
+    }
     if (!__symbol_option_spec_symbol__.empty())
     {
         ast::CompileVisitor::__symbol_option_format__ = OutputFormat::JSON;
@@ -160,7 +283,7 @@ void handleSymbolFlag()
         outputPath = getAbsolutePath(outputPath, __working_directory__);
     }
 
-    if (ast::CompileVisitor visitor(targetPath, targetPath,
+    if (ast::CompileVisitor visitor(std::make_shared<ast::CompilationSession>(), targetPath, targetPath,
         outputPath, false);
         visitor.compile())
     {
@@ -204,12 +327,157 @@ void handleSymbolFlag()
 
 void handleCompileFlag()
 {
+    if (ast::CompileVisitor::__symbol_option_format__ == OutputFormat::JSON)
+    {
+        throw std::runtime_error("The 'json' format is not supported by the compile command.");
+    }
     const auto& targetPath = getAbsolutePath(__general_option_path__, __working_directory__);
     const auto& outputPath = getAbsolutePath(__general_option_output__, __working_directory__);
-    if (ast::CompileVisitor visitor (targetPath, targetPath, outputPath);
+    const auto session = std::make_shared<ast::CompilationSession>();
+    if (ast::CompileVisitor visitor (session, targetPath, targetPath, outputPath);
         visitor.compile())
     {
         std::cout << "Compilation succeeded!\nOutput is saved to: " << outputPath << std::endl;
+        if (ast::CompileVisitor::__compile_flag_opt_stats__)
+        {
+            std::cout << session->getOptimizeStats().toString();
+        }
+    }
+}
+
+void handleRabDecodeFlag()
+{
+    const auto& targetPath = getAbsolutePath(__general_option_path__, __working_directory__);
+    const auto& raCode = ri::decodeRabBytecode(MappedFile(targetPath).view());
+    if (__general_option_output__ == "console")
+    {
+        std::cout << raCode;
+        return;
+    }
+    const auto& outputPath = getAbsolutePath(__general_option_output__, __working_directory__);
+    if (!writeFile(outputPath, raCode))
+    {
+        throw std::runtime_error("Can not write file: " + outputPath);
+    }
+    std::cout << "Decoding succeeded!\nOutput is saved to: " << outputPath << std::endl;
+}
+
+void handleAstVerifyFlag()
+{
+    const auto& targetPath = getAbsolutePath(__general_option_path__, __working_directory__);
+    lexer::Lexer lexer(targetPath);
+    parser::Parser parser(lexer.tokenStream());
+    const auto &[hasError, program] = parser.parse();
+    if (hasError)
+    {
+        throw std::runtime_error("Can not verify the syntax tree of '" + targetPath + "': the file has syntax errors.");
+    }
+    const auto sourceHash = hashToCode(lexer.getSource());
+    const auto &data = ast::AstSerializer::serialize(*program, sourceHash);
+    const auto &loaded = ast::AstSerializer::deserialize(data, sourceHash, std::make_shared<ast::AstArena>());
+    if (!loaded || ast::AstSerializer::serialize(*loaded, sourceHash) != data)
+    {
+        throw std::runtime_error("The syntax tree of '" + targetPath + "' changes after a serialization round trip.");
+    }
+    std::cout << "Verified: " << program->getStatements().size() << " statements, "
+              << data.size() << " bytes" << std::endl;
+}
+
+void handleBuildSnapshotFlag()
+{
+    if (__general_option_output__ == "console")
+    {
+        throw std::runtime_error("The build-snapshot command requires an output file.");
+    }
+    const auto& libDir = __general_option_path__.empty()
+        ? RCC_BUILTIN_LIB_DIR
+        : getAbsolutePath(__general_option_path__, __working_directory__);
+    const auto& outputPath = getAbsolutePath(__general_option_output__, __working_directory__);
+    const auto& snapshot = ast::BuiltinSnapshot::build(libDir);
+    if (!writeFile(outputPath, ast::BuiltinSnapshot::toSource(snapshot)))
+    {
+        throw std::runtime_error("Can not write file: " + outputPath);
+    }
+    std::cout << "Snapshot succeeded!\nOutput is saved to: " << outputPath << std::endl;
+}
+
+void printWatchErrors(const StringVector &errorMsgs)
+{
+    if (errorMsgs.empty())
+    {
+        std::cout << "  No syntax errors." << std::endl;
+        return;
+    }
+    for (const auto &errorMsg : errorMsgs)
+    {
+        std::cout << errorMsg << std::endl;
+    }
+}
+
+// 整体重新解析 source，与增量解析的结果（含各 Token 的位置）逐字节比较
+void verifyIncrementalParse(const parser::IncrementalParser &incremental)
+{
+    auto lexer = lexer::Lexer::fromSource(incremental.getFilepath(), incremental.getSource());
+    parser::Parser parser(lexer.tokenStream());
+    const auto &[hasError, program] = parser.parse();
+    if (hasError != incremental.hasError() || parser.getErrorMsgs() != incremental.getErrorMsgs() ||
+        ast::AstSerializer::serialize(*program, 0) != ast::AstSerializer::serialize(*incremental.getProgram(), 0))
+    {
+        throw std::runtime_error("The incremental parse of '" + incremental.getFilepath() +
+            "' differs from a full parse.");
+    }
+    std::cout << "  Verified against a full parse." << std::endl;
+}
+
+void handleWatchFlag()
+{
+    const auto& targetPath = getAbsolutePath(__general_option_path__, __working_directory__);
+    parser::IncrementalParser incremental(targetPath);
+    std::cout << "Watching: " << targetPath << " (" << incremental.getReparsedCount() << " statements)" << std::endl;
+    printWatchErrors(incremental.getErrorMsgs());
+    if (__watch_verify_flag__)
+    {
+        verifyIncrementalParse(incremental);
+    }
+    for (int updates = 0; __watch_updates__ <= 0 || updates < __watch_updates__;)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(std::max(1, __watch_interval__)));
+        std::string source;
+        try
+        {
+            source = std::string(MappedFile(targetPath).view());
+        } catch (const std::exception &)
+        {
+            // 编辑器保存文件时可能短暂地删除或替换它，下次检查时再读取
+            continue;
+        }
+        const auto &previous = incremental.getSource();
+        if (source == previous)
+        {
+            continue;
+        }
+        // 新旧内容的公共前缀与公共后缀之间即为编辑区间
+        size_t prefix = 0;
+        while (prefix < source.size() && prefix < previous.size() && source[prefix] == previous[prefix])
+        {
+            prefix++;
+        }
+        size_t suffix = 0;
+        while (suffix < source.size() - prefix && suffix < previous.size() - prefix &&
+            source[source.size() - 1 - suffix] == previous[previous.size() - 1 - suffix])
+        {
+            suffix++;
+        }
+        incremental.applyEdit(prefix, previous.size() - prefix - suffix,
+            source.substr(prefix, source.size() - prefix - suffix));
+        updates++;
+        std::cout << "Updated: reparsed " << incremental.getReparsedCount() << " statements, reused "
+                  << incremental.getReusedCount() << " statements" << std::endl;
+        printWatchErrors(incremental.getErrorMsgs());
+        if (__watch_verify_flag__)
+        {
+            verifyIncrementalParse(incremental);
+        }
     }
 }
 
@@ -246,6 +514,106 @@ void handleLlvmFlag()
     }
 }
 
+void handleBenchLexerFlag()
+{
+    using Clock = std::chrono::steady_clock;
+    const auto& targetPath = getAbsolutePath(__general_option_path__, __working_directory__);
+    const int iterations = std::max(1, __bench_iterations__);
+    size_t sourceSize = 0;
+    size_t lexemeCount = 0;
+    double scanSeconds = 0;
+    double streamSeconds = 0;
+    // 每轮使用新的 Lexer，文件映射不计入耗时
+    for (int i = 0; i < iterations; i++)
+    {
+        lexer::Lexer scanLexer(targetPath);
+        auto begin = Clock::now();
+        lexemeCount = scanLexer.scan().size();
+        scanSeconds += std::chrono::duration<double>(Clock::now() - begin).count();
+        sourceSize = scanLexer.getSource().size();
+
+        lexer::Lexer streamLexer(targetPath);
+        begin = Clock::now();
+        for (const auto &source = streamLexer.tokenStream(); source->next();) {}
+        streamSeconds += std::chrono::duration<double>(Clock::now() - begin).count();
+    }
+    const auto throughput = [&](const double seconds) {
+        return seconds > 0
+            ? static_cast<double>(sourceSize) * iterations / (1024.0 * 1024.0) / seconds
+            : 0.0;
+    };
+    std::cout << "Lexer benchmark: " << targetPath << "\n"
+              << "  Kernel       : " << lexer::kernels::activeKernelName() << "\n"
+              << "  Source       : " << sourceSize << " bytes, " << lexemeCount << " lexemes\n"
+              << "  Iterations   : " << iterations << "\n"
+              << "  Scan         : " << throughput(scanSeconds) << " MB/s\n"
+              << "  Token stream : " << throughput(streamSeconds) << " MB/s" << std::endl;
+}
+
+// 合成语料：循环拼接覆盖常见语法结构的代码片段，直到顶层语句数达到 statementCount
+std::string makeParserBenchCorpus(const size_t statementCount)
+{
+    static constexpr std::string_view SNIPPETS[] = {
+        "var a = 1 + 2 * (3 - 4) / 5 % 6\n",
+        "var s: str = \"text\", c = 'c', f = 1.5, flag = true && !false\n",
+        "var items = [1, 2, 3, [4, 5]], table = {\"k\": 1, \"v\": [2, 3]}\n",
+        "fun add(x: int, y: int): int {\n    ret x + y\n}\n",
+        "a = add(a, items[0]) - table[\"k\"]\n",
+        "if a > 10 {\n    a -= 1\n} elif a < 0 {\n    a += 1\n} else {\n    pass\n}\n",
+        "while a <= 100 {\n    a *= 2\n}\n",
+        "var g = (x, y) -> {\n    ret x.y(y)\n}\n",
+        "class Point {\n    var x: int, y: int\n    ctor(a: int, b: int) {\n        this.x = a\n        this.y = b\n    }\n}\n",
+        "var p = Point(a, -2).x + a++\n",
+    };
+    std::string corpus;
+    for (size_t i = 0; i < statementCount; i++)
+    {
+        corpus += SNIPPETS[i % std::size(SNIPPETS)];
+    }
+    return corpus;
+}
+
+void handleBenchParserFlag()
+{
+    using Clock = std::chrono::steady_clock;
+    const bool synthetic = __general_option_path__.empty();
+    const auto& targetPath = synthetic
+        ? getAbsolutePath("bench-parser-corpus.rio", __working_directory__)
+        : getAbsolutePath(__general_option_path__, __working_directory__);
+    const std::string source = synthetic
+        ? makeParserBenchCorpus(static_cast<size_t>(std::max(1, __bench_statements__)))
+        : std::string(MappedFile(targetPath).view());
+    const int iterations = std::max(1, __bench_iterations__);
+    size_t statementCount = 0;
+    size_t nodeCount = 0;
+    double parseSeconds = 0;
+    // 词法分析以流的方式与语法分析交错进行，因此计入耗时
+    for (int i = 0; i < iterations; i++)
+    {
+        auto lexer = lexer::Lexer::fromSource(targetPath, source);
+        const auto begin = Clock::now();
+        parser::Parser parser(lexer.tokenStream());
+        const auto &[hasError, program] = parser.parse();
+        parseSeconds += std::chrono::duration<double>(Clock::now() - begin).count();
+        if (hasError)
+        {
+            parser.printParserErrors();
+        }
+        statementCount = program->getStatements().size();
+        nodeCount = parser.getArena()->getAllocationCount();
+    }
+    const auto perSecond = [&](const double amount) {
+        return parseSeconds > 0 ? amount * iterations / parseSeconds : 0.0;
+    };
+    std::cout << "Parser benchmark: " << (synthetic ? "<synthetic corpus>" : targetPath) << "\n"
+              << "  Source       : " << source.size() << " bytes, " << statementCount << " statements, "
+              << nodeCount << " AST allocations\n"
+              << "  Iterations   : " << iterations << "\n"
+              << "  Statements   : " << perSecond(static_cast<double>(statementCount)) << " statements/s\n"
+              << "  Throughput   : " << perSecond(static_cast<double>(source.size()) / (1024.0 * 1024.0))
+              << " MB/s" << std::endl;
+}
+
 int main(const int argc, char *argv[]) {
     try {
         setDeveloperModel(true);
@@ -274,11 +642,41 @@ int main(const int argc, char *argv[]) {
             handleCompileFlag();
         }
 
+        if (__rab_decode_flag__)
+        {
+            handleRabDecodeFlag();
+        }
+
+        if (__ast_verify_flag__)
+        {
+            handleAstVerifyFlag();
+        }
+
+        if (__build_snapshot_flag__)
+        {
+            handleBuildSnapshotFlag();
+        }
+
         if (__llvm_flag__)
         {
             handleLlvmFlag();
         }
 
+        if (__bench_lexer_flag__)
+        {
+            handleBenchLexerFlag();
+        }
+
+        if (__bench_parser_flag__)
+        {
+            handleBenchParserFlag();
+        }
+
+        if (__watch_flag__)
+        {
+            handleWatchFlag();
+        }
+
         // 输出程序运行时间信息
         if (__time_info__) {
             std::cout << printProgramSpentTimeInfo();
@@ -0,0 +1,234 @@
+//
+// Created by RestRegular on 2025/7/20.
+//
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_set>
+
+#include "../../include/rcc_base.h"
+#include "../../include/visitors/rcc_build_scheduler.h"
+#include "../../declarations/builtin/functions/rcc_builtin_import_dec.h"
+
+namespace ast
+{
+    namespace
+    {
+        // 与预解析相同的路径规范化方式，保证注册表与导入图使用同一个键
+        std::string normalizeModulePath(const std::string& filepath)
+        {
+            return utils::getAbsolutePath(filepath, utils::getDefaultDir());
+        }
+    }
+
+    std::shared_ptr<const CompiledModule> ModuleRegistry::publish(const std::shared_ptr<const CompiledModule>& module)
+    {
+        std::unique_lock lock(_mutex);
+        return _modules.try_emplace(normalizeModulePath(module->filepath), module).first->second;
+    }
+
+    std::shared_ptr<const CompiledModule> ModuleRegistry::find(const std::string& filepath) const
+    {
+        std::shared_lock lock(_mutex);
+        const auto it = _modules.find(normalizeModulePath(filepath));
+        return it == _modules.end() ? nullptr : it->second;
+    }
+
+    void ModuleRegistry::clear()
+    {
+        std::unique_lock lock(_mutex);
+        _modules.clear();
+    }
+
+    void BuildScheduler::build(CompilationSession& session, const std::string& entryPath, size_t threadCount)
+    {
+        auto& moduleGraph = session.getModuleGraph();
+        const auto entry = normalizeModulePath(entryPath);
+
+        // 从入口出发收集导入图：remaining 为模块尚未发布的依赖数，dependents 为直接导入该模块的模块
+        // 导入入口文件的模块处于循环中，它依赖的入口永远不会发布，因而不会被调度
+        std::vector<std::string> modules;
+        std::unordered_set<std::string> parsed;
+        std::unordered_map<std::string, size_t> remaining;
+        std::unordered_map<std::string, std::vector<std::string>> dependents;
+        std::unordered_set<std::string> discovered{entry};
+        std::deque<std::string> frontier{entry};
+        while (!frontier.empty())
+        {
+            const auto filepath = std::move(frontier.front());
+            frontier.pop_front();
+            std::unordered_set<std::string> counted;
+            for (const auto& dependency : moduleGraph.getImports(filepath))
+            {
+                if (!counted.insert(dependency).second)
+                {
+                    continue;
+                }
+                if (filepath != entry)
+                {
+                    remaining[filepath]++;
+                    dependents[dependency].push_back(filepath);
+                }
+                if (discovered.insert(dependency).second)
+                {
+                    modules.push_back(dependency);
+                    frontier.push_back(dependency);
+                    // 有语法错误的模块留给导入处报告，避免错误信息在工作线程中重复输出
+                    if (moduleGraph.hasParsed(dependency))
+                    {
+                        parsed.insert(dependency);
+                    }
+                }
+            }
+        }
+        if (modules.empty())
+        {
+            return;
+        }
+        if (threadCount == 0)
+        {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threadCount = std::min(threadCount, modules.size());
+
+        // 每个工作线程有自己的就绪队列，各由一把锁保护：新就绪的模块放入完成其依赖的线程的队列尾部，
+        // 线程优先从自己的队列尾部取出模块，自己的队列为空时逐个锁住其他线程的队列，从头部窃取
+        // pending 为已入队但尚未编译完成的模块数，降为 0 时全部工作线程退出
+        struct WorkQueue
+        {
+            std::mutex mutex;
+            std::deque<std::string> modules;
+        };
+        std::vector<WorkQueue> queues(threadCount);
+        std::mutex idleMutex;
+        std::condition_variable idle;
+        size_t queued = 0;
+        size_t pending = 0;
+        // 模块中的编译错误（RCCError）留给导入处的串行编译报告，其他异常记录下来，停止调度后在调用线程重新抛出
+        std::exception_ptr failure;
+        std::unordered_map<std::string, std::atomic<size_t>> waiting;
+        for (const auto& [module, count] : remaining)
+        {
+            waiting[module] = count;
+        }
+
+        const auto push = [&](const size_t index, std::string filepath) {
+            {
+                std::lock_guard lock(queues[index].mutex);
+                queues[index].modules.push_back(std::move(filepath));
+            }
+            {
+                std::lock_guard lock(idleMutex);
+                queued++;
+                pending++;
+            }
+            idle.notify_one();
+        };
+        const auto pop = [&](const size_t index) -> std::optional<std::string> {
+            for (size_t offset = 0; offset < threadCount; offset++)
+            {
+                auto& queue = queues[(index + offset) % threadCount];
+                std::lock_guard lock(queue.mutex);
+                if (queue.modules.empty())
+                {
+                    continue;
+                }
+                std::string filepath;
+                if (offset == 0)
+                {
+                    filepath = std::move(queue.modules.back());
+                    queue.modules.pop_back();
+                } else
+                {
+                    filepath = std::move(queue.modules.front());
+                    queue.modules.pop_front();
+                }
+                return filepath;
+            }
+            return std::nullopt;
+        };
+
+        size_t next = 0;
+        for (const auto& module : modules)
+        {
+            if (!remaining.contains(module) && parsed.contains(module))
+            {
+                push(next++ % threadCount, module);
+            }
+        }
+
+        const auto worker = [&](const size_t index) {
+            while (true)
+            {
+                {
+                    std::unique_lock lock(idleMutex);
+                    idle.wait(lock, [&] { return queued > 0 || pending == 0 || failure; });
+                    if (pending == 0 || failure)
+                    {
+                        return;
+                    }
+                    queued--;
+                }
+                // queued 计入的模块一定还在某个队列中，只是可能已被其他线程的窃取提前取走，此时重试
+                auto filepath = pop(index);
+                while (!filepath)
+                {
+                    std::this_thread::yield();
+                    filepath = pop(index);
+                }
+                bool published = false;
+                try
+                {
+                    builtin::rcc_import_utils::compileExtensionModule(session, entryPath, *filepath);
+                    published = true;
+                } catch (const base::RCCError&)
+                {
+                    // 不发布，导入处重新编译该模块并按串行编译的顺序报告错误
+                } catch (...)
+                {
+                    std::lock_guard lock(idleMutex);
+                    if (!failure)
+                    {
+                        failure = std::current_exception();
+                    }
+                }
+                if (published)
+                {
+                    for (const auto& dependent : dependents[*filepath])
+                    {
+                        if (waiting.at(dependent).fetch_sub(1) == 1 && parsed.contains(dependent))
+                        {
+                            push(index, dependent);
+                        }
+                    }
+                }
+                {
+                    std::lock_guard lock(idleMutex);
+                    pending--;
+                }
+                idle.notify_all();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+        for (size_t i = 1; i < threadCount; i++)
+        {
+            threads.emplace_back(worker, i);
+        }
+        worker(0);
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        if (failure)
+        {
+            std::rethrow_exception(failure);
+        }
+    }
+}
@@ -0,0 +1,170 @@
+//
+// Created by RestRegular on 2025/7/20.
+//
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../../include/rcc_base.h"
+#include "../../include/visitors/rcc_builtin_snapshot.h"
+#include "../../include/visitors/rcc_module_cache.h"
+#include "../../include/visitors/rcc_compile_visitor.h"
+#include "../../declarations/builtin/functions/rcc_builtin_import_dec.h"
+
+namespace ast
+{
+    namespace
+    {
+        // 快照的缓存键索引；文件头与当前编译器不符或数据损坏时为空
+        std::unordered_map<std::string_view, std::string_view> buildSnapshotIndex()
+        {
+            const std::string_view data(BUILTIN_SNAPSHOT_DATA, BUILTIN_SNAPSHOT_SIZE);
+            std::unordered_map<std::string_view, std::string_view> index;
+            if (data.size() < sizeof(BuiltinSnapshot::MAGIC) ||
+                std::memcmp(data.data(), BuiltinSnapshot::MAGIC, sizeof(BuiltinSnapshot::MAGIC)) != 0)
+            {
+                return index;
+            }
+            size_t pos = sizeof(BuiltinSnapshot::MAGIC);
+            uint64_t version = 0;
+            uint64_t count = 0;
+            std::string_view compilerVersion;
+            if (!utils::readVarint(data, pos, version) || version != BuiltinSnapshot::FORMAT_VERSION ||
+                !utils::readBytes(data, pos, compilerVersion) || compilerVersion != RCC_VERSION ||
+                !utils::readVarint(data, pos, count))
+            {
+                return index;
+            }
+            for (uint64_t i = 0; i < count; i++)
+            {
+                std::string_view key;
+                std::string_view entry;
+                if (!utils::readBytes(data, pos, key) || !utils::readBytes(data, pos, entry))
+                {
+                    return {};
+                }
+                index.emplace(key, entry);
+            }
+            return index;
+        }
+    }
+
+    std::string_view BuiltinSnapshot::find(const std::string& cacheKey)
+    {
+        static const auto index = buildSnapshotIndex();
+        const auto it = index.find(cacheKey);
+        return it == index.end() ? std::string_view{} : it->second;
+    }
+
+    std::string BuiltinSnapshot::build(const std::string& libDir)
+    {
+        std::vector<std::string> extensions;
+        std::error_code errorCode;
+        for (const auto &entry : std::filesystem::directory_iterator(libDir, errorCode))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".rio")
+            {
+                extensions.push_back(utils::getAbsolutePath(entry.path().string(), utils::getDefaultDir()));
+            }
+        }
+        std::ranges::sort(extensions);
+
+        // 扩展按被导入的方式编译：入口是一个不存在的文件，各扩展都不是程序入口
+        const auto entryPath = (std::filesystem::path(libDir) / "<snapshot>.rio").string();
+        const auto compileLevel = CompileVisitor::__compile_option_compile_level__;
+        std::map<std::string, std::string> entries;
+        for (int level = 0; level <= 3; level++)
+        {
+            CompileVisitor::__compile_option_compile_level__ = level;
+            const auto session = std::make_shared<CompilationSession>();
+            auto &moduleGraph = session->getModuleGraph();
+            for (const auto &extension : extensions)
+            {
+                moduleGraph.parseAll(extension, [](const std::string& importerPath, const std::string& extName) {
+                    return builtin::rcc_import_utils::resolveImportedFilePath(importerPath, extName);
+                }, static_cast<size_t>(std::max(CompileVisitor::__compile_option_jobs__, 0)));
+            }
+            // 依赖先于导入它的扩展编译，依赖的缓存键才能参与计算
+            std::unordered_set<std::string> visited;
+            std::vector<std::string> compiled;
+            const std::function<void(const std::string&)> compile = [&](const std::string& filepath) {
+                if (!visited.insert(filepath).second)
+                {
+                    return;
+                }
+                for (const auto &dependency : moduleGraph.getImports(filepath))
+                {
+                    compile(dependency);
+                }
+                try
+                {
+                    builtin::rcc_import_utils::compileExtensionModule(*session, entryPath, filepath);
+                    compiled.push_back(filepath);
+                } catch (...) {}
+            };
+            for (const auto &extension : extensions)
+            {
+                compile(extension);
+            }
+            for (const auto &filepath : compiled)
+            {
+                const auto &module = session->getModuleRegistry().find(filepath);
+                if (!module || module->cacheKey.empty())
+                {
+                    continue;
+                }
+                try
+                {
+                    entries.try_emplace(module->cacheKey, ModuleCache::serialize(*module));
+                } catch (...) {}
+            }
+        }
+        CompileVisitor::__compile_option_compile_level__ = compileLevel;
+
+        std::string snapshot(MAGIC, sizeof(MAGIC));
+        utils::appendVarint(snapshot, FORMAT_VERSION);
+        utils::appendBytes(snapshot, RCC_VERSION);
+        utils::appendVarint(snapshot, entries.size());
+        for (const auto &[key, entry] : entries)
+        {
+            utils::appendBytes(snapshot, key);
+            utils::appendBytes(snapshot, entry);
+        }
+        return snapshot;
+    }
+
+    std::string BuiltinSnapshot::toSource(const std::string_view snapshot)
+    {
+        static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+        std::string source = "// Generated by RCC -build-snapshot. Do not edit.\n"
+                             "#include <cstddef>\n\n"
+                             "namespace ast\n{\n"
+                             "    extern const size_t BUILTIN_SNAPSHOT_SIZE = " + std::to_string(snapshot.size()) + ";\n"
+                             "    extern const char BUILTIN_SNAPSHOT_DATA[] =\n";
+        source.reserve(source.size() + snapshot.size() * 4 + snapshot.size() / 16 + 64);
+        // 以十六进制转义的字符串字面量写出，每行 32 字节
+        for (size_t offset = 0; offset < snapshot.size(); offset += 32)
+        {
+            source += "        \"";
+            for (const auto byte : snapshot.substr(offset, 32))
+            {
+                const auto value = static_cast<uint8_t>(byte);
+                source += "\\x";
+                source.push_back(HEX_DIGITS[value >> 4]);
+                source.push_back(HEX_DIGITS[value & 0xF]);
+            }
+            source += "\"\n";
+        }
+        if (snapshot.empty())
+        {
+            source += "        \"\"\n";
+        }
+        source += "        ;\n}\n";
+        return source;
+    }
+}
@@ -0,0 +1,12 @@
+//
+// Created by RestRegular on 2025/7/20.
+//
+
+#include "../../include/visitors/rcc_builtin_snapshot.h"
+
+namespace ast
+{
+    // 不嵌入快照时使用的空数据：RCCBootstrap 以此生成快照，关闭 RCC_EMBED_BUILTIN_SNAPSHOT 时 RCC 也使用它
+    const size_t BUILTIN_SNAPSHOT_SIZE = 0;
+    const char BUILTIN_SNAPSHOT_DATA[] = "";
+}
@@ -0,0 +1,318 @@
+//
+// Created by RestRegular on 2025/7/20.
+//
+
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+
+#include "../../include/rcc_base.h"
+#include "../../include/visitors/rcc_compilation_session.h"
+#include "../../include/visitors/rcc_build_scheduler.h"
+
+namespace ast
+{
+    namespace
+    {
+        thread_local CompilationSession* activeSession = nullptr;
+
+        constexpr size_t MODULE_NAME_PREFIX_LENGTH = 10;
+
+        // 模块标识符前缀取模块键的散列，不同模块生成的标识符互不冲突
+        std::string makeModuleNamePrefix(const std::string& modulePath)
+        {
+            char buffer[16];
+            std::snprintf(buffer, sizeof(buffer), "m%08x_",
+                          static_cast<unsigned>(utils::hashToCode(CompilationSession::getModuleKey(modulePath)) &
+                              0xffffffffu));
+            return buffer;
+        }
+
+        bool isNameChar(const char c)
+        {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+        }
+
+        // 将标识符中位于开头或紧跟在 '_' 之后的模块前缀全部替换为 replacement（临时变量名本身也可能带有前缀）
+        std::string replaceModuleNamePrefix(const std::string_view name, const std::string_view prefix,
+                                            const std::string_view replacement)
+        {
+            std::string result;
+            for (size_t i = 0; i < name.size();)
+            {
+                if ((i == 0 || name[i - 1] == '_') && name.substr(i, prefix.size()) == prefix)
+                {
+                    result += replacement;
+                    i += prefix.size();
+                } else
+                {
+                    result.push_back(name[i++]);
+                }
+            }
+            return result;
+        }
+    }
+
+    CompilationSession::CompilationSession()
+        : moduleRegistry(std::make_shared<ModuleRegistry>()),
+          moduleGraph(std::make_shared<parser::ModuleGraphParser>()) {}
+
+    std::shared_ptr<CompilationSession> CompilationSession::createModuleSession(const std::string& modulePath) const
+    {
+        auto session = std::make_shared<CompilationSession>();
+        session->namePrefix = makeModuleNamePrefix(modulePath);
+        session->moduleRegistry = moduleRegistry;
+        session->moduleGraph = moduleGraph;
+        session->lexerPaths = lexerPaths;
+        session->extensionPathNameMap = extensionPathNameMap;
+        session->processingExtensionStack = processingExtensionStack;
+        return session;
+    }
+
+    CompilationSession::Activation::Activation(CompilationSession& session)
+        : previous(activeSession)
+    {
+        activeSession = &session;
+    }
+
+    CompilationSession::Activation::~Activation()
+    {
+        activeSession = previous;
+    }
+
+    CompilationSession& CompilationSession::current()
+    {
+        if (!activeSession)
+        {
+            throw std::runtime_error("No compilation session is active on the current thread.");
+        }
+        return *activeSession;
+    }
+
+    bool CompilationSession::hasCurrent()
+    {
+        return activeSession != nullptr;
+    }
+
+    std::string CompilationSession::getModuleKey(const std::string& modulePath)
+    {
+        static const auto libDir = std::filesystem::path(base::RCC_LIB_DIR).lexically_normal();
+        const auto path = std::filesystem::path(modulePath).lexically_normal();
+        if (const auto relative = path.lexically_relative(libDir);
+            !relative.empty() && *relative.begin() != "..")
+        {
+            return relative.generic_string();
+        }
+        return path.generic_string();
+    }
+
+    std::string CompilationSession::shortenModuleNames(const std::string_view raCode) const
+    {
+        std::unordered_set<std::string> prefixes;
+        for (const auto& modulePath : linkedModules)
+        {
+            prefixes.insert(makeModuleNamePrefix(modulePath));
+        }
+        if (prefixes.empty())
+        {
+            return std::string(raCode);
+        }
+        // 第一遍：按出现顺序找出带模块前缀的标识符（前缀位于开头或紧跟在 '_' 之后，如编译级别 0、1 的 "name_m..._vid3"），
+        // 字符串与注释中的词一并计入，其余的词都保持原样，新名称不能与它们相同
+        struct PrefixedName
+        {
+            std::string_view name;
+            size_t prefixAt;
+        };
+        std::vector<PrefixedName> prefixedNames;
+        std::unordered_set<std::string_view> keptNames;
+        for (size_t begin = 0; begin < raCode.size();)
+        {
+            if (!isNameChar(raCode[begin]))
+            {
+                begin++;
+                continue;
+            }
+            size_t end = begin;
+            while (end < raCode.size() && isNameChar(raCode[end]))
+            {
+                end++;
+            }
+            const auto name = raCode.substr(begin, end - begin);
+            size_t prefixAt = std::string_view::npos;
+            for (size_t i = 0; i + MODULE_NAME_PREFIX_LENGTH <= name.size(); i++)
+            {
+                if (name[i] == 'm' && (i == 0 || name[i - 1] == '_') &&
+                    prefixes.contains(std::string(name.substr(i, MODULE_NAME_PREFIX_LENGTH))))
+                {
+                    prefixAt = i;
+                    break;
+                }
+            }
+            if (prefixAt == std::string_view::npos)
+            {
+                keptNames.insert(name);
+            } else
+            {
+                prefixedNames.push_back({name, prefixAt});
+            }
+            begin = end;
+        }
+        // 按首次出现的顺序为每个名称选择去掉前缀后的名称、短前缀的名称或原名中第一个未被占用的
+        std::unordered_map<std::string_view, std::string> renames;
+        std::unordered_map<std::string_view, std::string> shortPrefixes;
+        std::unordered_set<std::string> taken;
+        for (const auto& [name, prefixAt] : prefixedNames)
+        {
+            if (renames.contains(name))
+            {
+                continue;
+            }
+            const auto prefix = name.substr(prefixAt, MODULE_NAME_PREFIX_LENGTH);
+            const auto isFree = [&](const std::string& candidate) {
+                return !keptNames.contains(candidate) && !taken.contains(candidate);
+            };
+            auto renamed = replaceModuleNamePrefix(name, prefix, "");
+            if (!isFree(renamed))
+            {
+                const auto& shortPrefix = shortPrefixes.try_emplace(
+                    prefix, "m" + std::to_string(shortPrefixes.size() + 1) + "_").first->second;
+                renamed = replaceModuleNamePrefix(name, prefix, shortPrefix);
+                if (!isFree(renamed))
+                {
+                    renamed = std::string(name);
+                }
+            }
+            taken.insert(renamed);
+            renames.emplace(name, std::move(renamed));
+        }
+        // 第二遍：替换
+        std::string result;
+        result.reserve(raCode.size());
+        for (size_t begin = 0; begin < raCode.size();)
+        {
+            if (!isNameChar(raCode[begin]))
+            {
+                result.push_back(raCode[begin++]);
+                continue;
+            }
+            size_t end = begin;
+            while (end < raCode.size() && isNameChar(raCode[end]))
+            {
+                end++;
+            }
+            const auto name = raCode.substr(begin, end - begin);
+            if (const auto it = renames.find(name); it != renames.end())
+            {
+                result += it->second;
+            } else
+            {
+                result += name;
+            }
+            begin = end;
+        }
+        return result;
+    }
+
+    bool CompilationSession::isModuleSession() const
+    {
+        return !namePrefix.empty();
+    }
+
+    const std::string& CompilationSession::getNamePrefix() const
+    {
+        return namePrefix;
+    }
+
+    size_t CompilationSession::nextVarId()
+    {
+        return varId++;
+    }
+
+    size_t CompilationSession::nextSetId()
+    {
+        return setId++;
+    }
+
+    size_t CompilationSession::nextNameId()
+    {
+        return nameId++;
+    }
+
+    size_t CompilationSession::nextTempVarId()
+    {
+        return ++tempVarId;
+    }
+
+    size_t CompilationSession::nextSetLabelId()
+    {
+        return ++setLabelId;
+    }
+
+    std::stack<std::shared_ptr<lexer::Lexer>>& CompilationSession::getLexers()
+    {
+        return lexers;
+    }
+
+    std::list<std::string>& CompilationSession::getLexerPaths()
+    {
+        return lexerPaths;
+    }
+
+    std::stack<utils::Pos>& CompilationSession::getProcessingPosStack()
+    {
+        return processingPosStack;
+    }
+
+    std::string& CompilationSession::getErrorFileRecord()
+    {
+        return errorFileRecord;
+    }
+
+    std::unordered_map<std::string, std::string>& CompilationSession::getExtensionPathNameMap()
+    {
+        return extensionPathNameMap;
+    }
+
+    std::stack<std::string>& CompilationSession::getProcessingExtensionStack()
+    {
+        return processingExtensionStack;
+    }
+
+    std::vector<std::string>& CompilationSession::getImportedModules()
+    {
+        return importedModules;
+    }
+
+    std::unordered_set<std::string>& CompilationSession::getLinkedModules()
+    {
+        return linkedModules;
+    }
+
+    ModuleRegistry& CompilationSession::getModuleRegistry()
+    {
+        return *moduleRegistry;
+    }
+
+    std::unordered_map<std::string, std::string>& CompilationSession::getCustomTypeMap()
+    {
+        return customTypeMap;
+    }
+
+    std::unordered_map<std::string, std::shared_ptr<symbol::ClassSymbol>>&
+    CompilationSession::getCustomClassSymbolMap()
+    {
+        return customClassSymbolMap;
+    }
+
+    parser::ModuleGraphParser& CompilationSession::getModuleGraph()
+    {
+        return *moduleGraph;
+    }
+
+    ri::OptimizeStats& CompilationSession::getOptimizeStats()
+    {
+        return optimizeStats;
+    }
+}
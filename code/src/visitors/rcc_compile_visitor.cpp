@@ -14,13 +14,18 @@
 
 #include "../../include/rcc_base.h"
 #include "../../include/builtin/rcc_builtin.h"
+#include "../../declarations/builtin/functions/rcc_builtin_import_dec.h"
 #include "../../include/components/ri/rcc_ri.h"
+#include "../../include/components/ri/rcc_ri_bytecode.h"
+#include "../../include/components/ri/rcc_ri_fold.h"
 #include "../../include/lib/RLogSystem/rlog_system.h"
 #include "../../include/analyzer/rcc_ast_components.h"
 #include "../../include/analyzer/rcc_parser.h"
+#include "../../include/analyzer/rcc_module_graph.h"
 #include "../../include/components/symbol/rcc_symbol.h"
 #include "../../include/lib/RJson/RJson_error.h"
 #include "../../include/visitors/rcc_compile_visitor.h"
+#include "../../include/visitors/rcc_build_scheduler.h"
 
 namespace ast
 {
@@ -31,15 +36,24 @@ namespace ast
         enterScope();
     }
 
+    void ContentBuilder::checkScope(const std::string& operation) const
+    {
+        if (scopeStarts.empty()) throw std::runtime_error("RaCodeBuilder::" + operation + ": raCodeStack is empty.");
+    }
+
     std::string ContentBuilder::buildAll()
     {
         if (raCode.empty())
         {
-            while (!raCodeStack.empty())
+            // 与逐层出栈拼接的顺序一致：从最内层作用域开始依次输出
+            size_t end = buffer.size();
+            while (!scopeStarts.empty())
             {
-                raCode += raCodeStack.top().str();
-                raCodeStack.pop();
+                buffer.render(scopeStarts.back(), end, raCode);
+                end = scopeStarts.back();
+                scopeStarts.pop_back();
             }
+            buffer.truncate(0);
         }
         return raCode;
     }
@@ -47,56 +61,86 @@ namespace ast
     ContentBuilder& ContentBuilder::appendCode(const std::string& code)
     {
         if (code.empty()) return *this;
-        if (raCodeStack.empty()) throw std::runtime_error("RaCodeBuilder::appendCode: raCodeStack is empty.");
-        raCodeStack.top() << code;
+        checkScope("appendCode");
+        buffer.appendRaw(code);
         return *this;
     }
 
     ContentBuilder& ContentBuilder::operator<<(const std::string& code)
     {
-        if (code.empty()) return *this;
-        if (raCodeStack.empty()) throw std::runtime_error("RaCodeBuilder::appendCode: raCodeStack is empty.");
-        raCodeStack.top() << code;
-        return *this;
+        return appendCode(code);
     }
 
     ContentBuilder& ContentBuilder::operator<<(const ri::RI& ri)
     {
-        *this << ri.toRACode();
+        checkScope("appendCode");
+        buffer << ri;
+        return *this;
+    }
+
+    ContentBuilder& ContentBuilder::operator<<(const ri::InstructionBuffer& fragment)
+    {
+        checkScope("appendCode");
+        buffer.splice(fragment);
         return *this;
     }
 
     void ContentBuilder::enterScope()
     {
-        raCodeStack.emplace();
+        scopeStarts.push_back(buffer.size());
     }
 
     void ContentBuilder::exitScope()
     {
-        if (raCodeStack.empty()) throw std::runtime_error("RaCodeBuilder::exitScope: raCodeStack is empty.");
-        raCodeStack.pop();
+        checkScope("exitScope");
+        buffer.truncate(scopeStarts.back());
+        scopeStarts.pop_back();
+    }
+
+    ContentBuilder& ContentBuilder::mergeScope()
+    {
+        if (scopeStarts.size() < 2) throw std::runtime_error("RaCodeBuilder::mergeScope: no outer scope to merge into.");
+        scopeStarts.pop_back();
+        return *this;
+    }
+
+    ri::OptimizeStats ContentBuilder::optimize(const ri::RaOptimizer& optimizer)
+    {
+        if (scopeStarts.size() != 1) throw std::runtime_error("RaCodeBuilder::optimize: nested scopes are still open.");
+        return optimizer.run(buffer);
+    }
+
+    ri::InstructionBuffer ContentBuilder::takeCurScope()
+    {
+        checkScope("takeCurScope");
+        auto fragment = buffer.split(scopeStarts.back());
+        scopeStarts.pop_back();
+        return fragment;
     }
 
     ContentBuilder& ContentBuilder::buildCurScope(std::string& target)
     {
-        if (raCodeStack.empty()) throw std::runtime_error("RaCodeBuilder::buildCurScopeAndExit: raCodeStack is empty.");
-        target = raCodeStack.top().str();
+        checkScope("buildCurScopeAndExit");
+        target.clear();
+        buffer.render(scopeStarts.back(), buffer.size(), target);
         return *this;
     }
 
     ContentBuilder& ContentBuilder::buildCurScope(ContentBuilder& builder)
     {
-        if (raCodeStack.empty()) throw std::runtime_error("RaCodeBuilder::buildCurScopeAndExit: raCodeStack is empty.");
-        builder << raCodeStack.top().str();
+        checkScope("buildCurScopeAndExit");
+        std::string code;
+        buffer.render(scopeStarts.back(), buffer.size(), code);
+        builder << code;
         return *this;
     }
 
     ContentBuilder& ContentBuilder::operator>>(std::string& target)
     {
-        if (!raCodeStack.empty())
+        if (!scopeStarts.empty())
         {
-            target = raCodeStack.top().str();
-            raCodeStack.pop();
+            buildCurScope(target);
+            exitScope();
         }
         else
         {
@@ -107,17 +151,23 @@ namespace ast
 
     ContentBuilder& ContentBuilder::operator>>(ContentBuilder& builder)
     {
-        if (!raCodeStack.empty())
+        if (!scopeStarts.empty())
         {
-            builder << raCodeStack.top().str();
-            raCodeStack.pop();
+            builder << takeCurScope();
         }
         return *this;
     }
 
     std::string ContentBuilder::getCurScopeResult() const
     {
-        return raCodeStack.top().str();
+        std::string result;
+        buffer.render(scopeStarts.back(), buffer.size(), result);
+        return result;
+    }
+
+    const ri::InstructionBuffer& ContentBuilder::getBuffer() const
+    {
+        return buffer;
     }
 
     std::string opItemTypeToString(const OpItemType& type)
@@ -139,19 +189,27 @@ namespace ast
         return "[OpItemType: " + opItemTypeToString(type) + "]";
     }
 
-    size_t VarID::_varId = 0;
+    std::atomic<size_t> VarID::_builtinVarId = 0;
 
     std::string VarID::rccVarPrefixField = "v";
 
+    std::string VarID::rccBuiltinVarPrefixField = "vb";
+
     std::string VarID::_toVarID()
     {
-        return (CompileVisitor::__compile_option_compile_level__ < 2 ?
-        nameField + "_" : "") + rccVarPrefixField + uniqueId();
+        const auto& prefix = CompileVisitor::__compile_option_compile_level__ < 2 ? nameField + "_" : "";
+        if (!CompilationSession::hasCurrent())
+        {
+            return prefix + rccBuiltinVarPrefixField + "id" + std::to_string(id);
+        }
+        auto& session = CompilationSession::current();
+        return prefix + session.getNamePrefix() + rccVarPrefixField + "id" + std::to_string(session.nextNameId());
     }
 
     VarID::VarID(const std::string& name, const std::string& fileField, const std::string& scopeField,
                  const size_t& scopeLevel)
-        : id(_varId++), fileField(fileField),
+        : id(CompilationSession::hasCurrent() ? CompilationSession::current().nextVarId() : _builtinVarId++),
+          fileField(fileField),
           scopeField(scopeField), nameField(name),
           vid(_toVarID()), scopeLevel(scopeLevel)
     {
@@ -193,20 +251,19 @@ namespace ast
         return vid;
     }
 
-    size_t SetID::_setId = 0;
-
     std::string SetID::rccSetPrefixField = "s";
 
     std::string SetID::_toSetID()
     {
+        auto& session = CompilationSession::current();
         return (CompileVisitor::__compile_option_compile_level__ < 2 ?
-        nameField + "_" : "") + rccSetPrefixField + uniqueId();
+        nameField + "_" : "") + session.getNamePrefix() + rccSetPrefixField + "id" + std::to_string(session.nextNameId());
     }
 
     SetID::SetID(
         const std::string& name, const std::string& fileField,
         const std::string& scopeField)
-        : id(_setId++), fileField(fileField),
+        : id(CompilationSession::current().nextSetId()), fileField(fileField),
           scopeField(scopeField), nameField(name), sid(_toSetID())
     {
     }
@@ -295,7 +352,7 @@ namespace ast
         return result;
     }
 
-    Pos OpItem::getPos() const
+    const Pos& OpItem::getPos() const
     {
         return pos;
     }
@@ -305,7 +362,7 @@ namespace ast
         this->pos = pos_;
     }
 
-    std::string OpItem::getVal() const
+    const std::string& OpItem::getVal() const
     {
         return value;
     }
@@ -332,27 +389,27 @@ namespace ast
         return raValue;
     }
 
-    std::shared_ptr<TypeLabelSymbol> OpItem::getTypeLabel() const
+    const std::shared_ptr<TypeLabelSymbol>& OpItem::getTypeLabel() const
     {
         return typeLabel;
     }
 
-    std::shared_ptr<TypeLabelSymbol> OpItem::getValueType() const
+    const std::shared_ptr<TypeLabelSymbol>& OpItem::getValueType() const
     {
         return valueType;
     }
 
-    std::shared_ptr<Symbol> OpItem::getBelonging() const
+    const std::shared_ptr<Symbol>& OpItem::getBelonging() const
     {
         return belonging;
     }
 
-    std::string OpItem::getBelongAttrRaValue() const
+    const std::string& OpItem::getBelongAttrRaValue() const
     {
         return belongAttrRaValue;
     }
 
-    std::shared_ptr<Symbol> OpItem::getReferencedSymbol() const
+    const std::shared_ptr<Symbol>& OpItem::getReferencedSymbol() const
     {
         return referencedSymbol;
     }
@@ -364,7 +421,7 @@ namespace ast
 
     void OpItem::setValueType(const std::shared_ptr<TypeLabelSymbol>& valueTypeSymbol)
     {
-        if (typeLabel->is("any") || valueTypeSymbol->is("any") || typeLabel->equalWith(valueTypeSymbol))
+        if (typeLabel->is(BuiltinTypeLabel::ANY) || valueTypeSymbol->is(BuiltinTypeLabel::ANY) || typeLabel->equalWith(valueTypeSymbol))
         {
             this->valueType = valueTypeSymbol;
         }
@@ -474,23 +531,6 @@ namespace ast
         return this;
     }
 
-    size_t CompileVisitor::_temVarId = 0;
-
-    size_t CompileVisitor::_setId = 0;
-
-    std::unordered_map<std::string,
-                       std::shared_ptr<ClassSymbol>> CompileVisitor::extensionMap = {};
-
-    std::stack<std::shared_ptr<lexer::Lexer>> CompileVisitor::_lexers{};
-
-    std::list<std::string> CompileVisitor::_lexer_paths = {};
-
-    std::string CompileVisitor::fileRecord{};
-
-    std::unordered_map<std::string, std::string> CompileVisitor::extensionPathNameMap = {};
-
-    std::stack<std::string> CompileVisitor::processingExtensionStack = {};
-
     OutputFormat CompileVisitor::__symbol_option_format__ = OutputFormat::TXT;
 
     bool CompileVisitor::__symbol_flag__ = false;
@@ -501,6 +541,16 @@ namespace ast
 
     int CompileVisitor::__compile_option_compile_level__ = 0;
 
+    bool CompileVisitor::__compile_flag_opt_stats__ = false;
+
+    bool CompileVisitor::__compile_flag_tree_shake__ = false;
+
+    int CompileVisitor::__compile_option_inline_threshold__ = 8;
+
+    int CompileVisitor::__compile_option_jobs__ = 0;
+
+    bool CompileVisitor::__compile_flag_no_module_cache__ = false;
+
     // 辅助函数：获取符号的类型标签
     std::shared_ptr<TypeLabelSymbol> CompileVisitor::getTypeLabelFromSymbol(const std::shared_ptr<Symbol>& symbol)
     {
@@ -523,12 +573,14 @@ namespace ast
 
     void CompileVisitor::recordProcessingExtension(const std::string& extensionPath, const std::string& extensionName)
     {
-        extensionPathNameMap.insert({extensionPath, extensionName});
-        processingExtensionStack.push(extensionPath);
+        auto& session = CompilationSession::current();
+        session.getExtensionPathNameMap().insert({extensionPath, extensionName});
+        session.getProcessingExtensionStack().push(extensionPath);
     }
 
     void CompileVisitor::popProcessingExtension()
     {
+        auto& processingExtensionStack = CompilationSession::current().getProcessingExtensionStack();
         if (processingExtensionStack.empty())
         {
             throw std::runtime_error("Invalid operation.");
@@ -538,7 +590,8 @@ namespace ast
 
     bool CompileVisitor::checkIsProcessedExtension(const std::string& extensionPath)
     {
-        return extensionPathNameMap.contains(extensionPath);
+        return CompilationSession::hasCurrent() &&
+            CompilationSession::current().getExtensionPathNameMap().contains(extensionPath);
     }
 
     std::string CompileVisitor::getExtensionName(const std::string& extensionPath)
@@ -547,11 +600,12 @@ namespace ast
         {
             throw std::runtime_error("Invalid operation.");
         }
-        return extensionPathNameMap.at(extensionPath);
+        return CompilationSession::current().getExtensionPathNameMap().at(extensionPath);
     }
 
     std::string CompileVisitor::topProcessingExtensionPath()
     {
+        const auto& processingExtensionStack = CompilationSession::current().getProcessingExtensionStack();
         if (processingExtensionStack.empty())
         {
             throw std::runtime_error("Invalid operation.");
@@ -650,13 +704,13 @@ namespace ast
         }
 
         // 处理any类型，any可以匹配任何类型
-        if (leftTypeSymbol->is("any") || rightTypeSymbol->is("any"))
+        if (leftTypeSymbol->is(BuiltinTypeLabel::ANY) || rightTypeSymbol->is(BuiltinTypeLabel::ANY))
         {
             return true;
         }
 
         // 处理null类型，通常null只能匹配引用类型或any
-        if (leftTypeSymbol->is("nul") || rightTypeSymbol->is("nul"))
+        if (leftTypeSymbol->is(BuiltinTypeLabel::NUL) || rightTypeSymbol->is(BuiltinTypeLabel::NUL))
         {
             return true;
         }
@@ -690,7 +744,7 @@ namespace ast
         const auto leftType = getTypeLabelFromSymbol(leftSymbol);
 
         if (const auto rightType = getTypeLabelFromSymbol(rightSymbol);
-            rightType && rightType->isNot("any"))
+            rightType && rightType->isNot(BuiltinTypeLabel::ANY))
         {
             return checkTypeMatch(leftType, rightType, true);
         }
@@ -701,21 +755,24 @@ namespace ast
         return checkTypeMatch(leftType, rightValueType, true);
     }
 
-    std::stack<Pos> CompileVisitor::_currentProcessingPos {};
-
     Pos CompileVisitor::currentPos()
     {
-        return _currentProcessingPos.empty() ? getUnknownPos() : _currentProcessingPos.top();
+        if (!CompilationSession::hasCurrent())
+        {
+            return getUnknownPos();
+        }
+        const auto& processingPosStack = CompilationSession::current().getProcessingPosStack();
+        return processingPosStack.empty() ? getUnknownPos() : processingPosStack.top();
     }
 
     void CompileVisitor::pushProcessingPos(const Pos& pos)
     {
-        _currentProcessingPos.push(pos);
+        CompilationSession::current().getProcessingPosStack().push(pos);
     }
 
     void CompileVisitor::popProcessingPos()
     {
-        _currentProcessingPos.pop();
+        CompilationSession::current().getProcessingPosStack().pop();
     }
 
     // 从OpItem获取符号
@@ -772,7 +829,7 @@ namespace ast
         }
 
         // 特殊处理any类型
-        if (rightTypeLabel->is("any"))
+        if (rightTypeLabel->is(BuiltinTypeLabel::ANY))
         {
             return true;
         }
@@ -800,14 +857,14 @@ namespace ast
                                                   : targetOpItem.getTypeLabel();
 
                 // 源类型为"any"时，直接采用目标值类型
-                if (varSymbol->getTypeLabel()->is("any"))
+                if (varSymbol->getTypeLabel()->is(BuiltinTypeLabel::ANY))
                 {
                     varSymbol->setValueType(targetValueType);
                     return; // 早期返回，减少嵌套
                 }
 
                 // 目标类型为"any"的情况处理
-                if (targetTypeLabel->is("any"))
+                if (targetTypeLabel->is(BuiltinTypeLabel::ANY))
                 {
                     // 确保目标值类型不为空
                     if (!targetValueType)
@@ -819,7 +876,7 @@ namespace ast
                     }
 
                     // 类型不匹配则抛出异常
-                    if (targetValueType->isNot("any") &&
+                    if (targetValueType->isNot(BuiltinTypeLabel::ANY) &&
                         !checkTypeMatch(varSymbol->getTypeLabel(),
                                         targetValueType, false))
                     {
@@ -877,41 +934,41 @@ namespace ast
 
     std::shared_ptr<TypeLabelSymbol> CompileVisitor::getBuiltinTypeSymbol(const Pos& pos, const BuiltinType& type) const
     {
-        std::string name;
+        BuiltinTypeLabel typeId;
         switch (type)
         {
-        case BuiltinType::B_ANY: name = "any";
+        case BuiltinType::B_ANY: typeId = BuiltinTypeLabel::ANY;
             break;
-        case BuiltinType::B_BOOL: name = "bool";
+        case BuiltinType::B_BOOL: typeId = BuiltinTypeLabel::BOOL;
             break;
-        case BuiltinType::B_CHAR: name = "char";
+        case BuiltinType::B_CHAR: typeId = BuiltinTypeLabel::CHAR;
             break;
         // ReSharper disable once CppDFAUnreachableCode
-        case BuiltinType::B_DICT: name = "dict";
+        case BuiltinType::B_DICT: typeId = BuiltinTypeLabel::DICT;
             break;
-        case BuiltinType::B_FLOAT: name = "float";
+        case BuiltinType::B_FLOAT: typeId = BuiltinTypeLabel::FLOAT;
             break;
-        case BuiltinType::B_INT: name = "int";
+        case BuiltinType::B_INT: typeId = BuiltinTypeLabel::INT;
             break;
         // ReSharper disable once CppDFAUnreachableCode
-        case BuiltinType::B_LIST: name = "list";
-            break;
-        case BuiltinType::B_STR: name = "str";
-            break;
-        case BuiltinType::B_VOID: name = "void";
+        case BuiltinType::B_LIST: typeId = BuiltinTypeLabel::LIST;
             break;
-        case BuiltinType::B_NUL: name = "nul";
+        case BuiltinType::B_STR: typeId = BuiltinTypeLabel::STR;
             break;
-        case BuiltinType::B_FLAG: name = "flag";
+        case BuiltinType::B_VOID: typeId = BuiltinTypeLabel::VOID_BTL;
             break;
-        case BuiltinType::B_FUNC: name = "func";
+        case BuiltinType::B_NUL: typeId = BuiltinTypeLabel::NUL;
             break;
-        case BuiltinType::B_FUNI: name = "funi";
+        case BuiltinType::B_FLAG: typeId = BuiltinTypeLabel::FLAG;
             break;
+        // 函数类型会追加签名，不能共享规范实例
+        case BuiltinType::B_FUNC: return TypeLabelSymbol::funcTypeSymbol(pos, symbolTable.curScopeLevel());
+        case BuiltinType::B_FUNI: return TypeLabelSymbol::funiTypeSymbol(pos, symbolTable.curScopeLevel());
         default:
             pass("To process other builtin type");
+            return std::make_shared<TypeLabelSymbol>(pos, "", symbolTable.curScopeLevel());
         }
-        return std::make_shared<TypeLabelSymbol>(pos, name, symbolTable.curScopeLevel());
+        return TypeLabelSymbol::builtinTypeSymbol(typeId, pos, symbolTable.curScopeLevel());
     }
 
     std::pair<std::shared_ptr<TypeLabelSymbol>, std::shared_ptr<TypeLabelSymbol>> CompileVisitor::
@@ -931,7 +988,7 @@ namespace ast
         const OpItem& opItem) const
     {
         const auto& [lt, vt] = getTypesFromOpItem(opItem);
-        return lt->is("any") ? vt : lt;
+        return lt->is(BuiltinTypeLabel::ANY) ? vt : lt;
     }
 
     std::string CompileVisitor::formatAttrField(const std::string& field)
@@ -986,25 +1043,19 @@ namespace ast
         return reference;
     }
 
-    void CompileVisitor::registerExtension(const std::string& extensionPath,
-                                           const std::shared_ptr<ClassSymbol>& extensionClass)
-    {
-        extensionMap[extensionPath] = extensionClass;
-    }
-
     std::shared_ptr<ClassSymbol> CompileVisitor::getRegisteredExtension(const std::string& extensionPath)
     {
-        if (const auto& it = extensionMap.find(extensionPath);
-            it != extensionMap.end())
+        if (!CompilationSession::hasCurrent())
         {
-            return it->second;
+            return nullptr;
         }
-        return nullptr;
+        const auto& module = CompilationSession::current().getModuleRegistry().find(extensionPath);
+        return module ? module->extension : nullptr;
     }
 
     bool CompileVisitor::isExtensionRegistered(const std::string& extensionPath)
     {
-        return extensionMap.contains(extensionPath);
+        return getRegisteredExtension(extensionPath) != nullptr;
     }
 
     void CompileVisitor::setSymbolBuiltinType(const std::shared_ptr<Symbol>& processingSymbol,
@@ -1170,17 +1221,17 @@ namespace ast
 
     std::string CompileVisitor::getNewTempVarName()
     {
-        _temVarId++;
-        return "tv" + std::to_string(_temVarId);
+        auto& session = CompilationSession::current();
+        return session.getNamePrefix() + "tv" + std::to_string(session.nextTempVarId());
     }
 
     std::string CompileVisitor::getNewSetLabelName()
     {
-        _setId++;
-        return "sl" + std::to_string(_setId);
+        auto& session = CompilationSession::current();
+        return session.getNamePrefix() + "sl" + std::to_string(session.nextSetLabelId());
     }
 
-    OpItem CompileVisitor::pushTemOpVarItemWithRecord(
+    const OpItem& CompileVisitor::pushTemOpVarItemWithRecord(
         const Pos& pos, const std::shared_ptr<TypeLabelSymbol>& valueType,
         const std::shared_ptr<Symbol>& referencedSymbol, const bool& sysDefined,
         const std::shared_ptr<TypeLabelSymbol>& typeLabel)
@@ -1197,18 +1248,67 @@ namespace ast
                                false,
                                valueType ? valueType : anyType,
                                nullptr, referencedSymbol), sysDefined);
+        tempVarIds.insert(tempVarId.getVid());
         raCodeBuilder << ri::ALLOT({tempVarId.getVid()});
         return topOpItem();
     }
 
-    OpItem CompileVisitor::pushTemOpSetItem(const Pos& pos)
+    std::optional<std::string> CompileVisitor::getConstantRaVal(const OpItem& opItem) const
+    {
+        if (__compile_option_compile_level__ < 2 || opItem.isNot(OpItemType::LITERAL_VALUE))
+        {
+            return std::nullopt;
+        }
+        const auto& raVal = opItem.getVal();
+        const auto& kind = ri::getConstantKind(raVal);
+        if (!kind)
+        {
+            return std::nullopt;
+        }
+        // 字面量文本须与编译期类型一致：例如 2.0 的 RA 文本为 "2"，运行时按整数运算，不能按 float 的规则折叠
+        if (const auto& typeLabel = opItem.getTypeLabel();
+            typeLabel->is(BuiltinTypeLabel::ANY) ||
+            (typeLabel->is(BuiltinTypeLabel::INT) && kind == ri::ConstantKind::INT) ||
+            (typeLabel->is(BuiltinTypeLabel::FLOAT) && kind == ri::ConstantKind::FLOAT) ||
+            (typeLabel->is(BuiltinTypeLabel::STR) && kind == ri::ConstantKind::STR) ||
+            (typeLabel->is(BuiltinTypeLabel::BOOL) && kind == ri::ConstantKind::BOOL))
+        {
+            return raVal;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<bool> CompileVisitor::getConstantCondition(const OpItem& opItem) const
+    {
+        if (const auto& raVal = getConstantRaVal(opItem))
+        {
+            return ri::getConstantTruth(*raVal);
+        }
+        return std::nullopt;
+    }
+
+    bool CompileVisitor::pushConstantItem(const Pos& pos, const std::optional<std::string>& raVal,
+                                          const std::shared_ptr<TypeLabelSymbol>& valueType)
+    {
+        if (!raVal)
+        {
+            return false;
+        }
+        // 折叠结果的有效类型与运行时求值时压入的临时变量相同，类型检查的结论不随编译级别变化
+        pushOpItem(OpItemType::LITERAL_VALUE,
+                   valueType ? valueType : getBuiltinTypeSymbol(pos, BuiltinType::B_ANY),
+                   *raVal, *raVal, nullptr, nullptr, pos);
+        return true;
+    }
+
+    const OpItem& CompileVisitor::pushTemOpSetItem(const Pos& pos)
     {
         const auto& setId = SetID(getNewSetLabelName(), pos.getFileField(), curScopeField());
-        pushOpItem(std::make_shared<OpItem>(
+        opItemStack.emplace_back(
             OpItemType::SET_LABEL,
             TypeLabelSymbol::flagTypeSymbol(pos, symbolTable.curScopeLevel()),
             setId.getSid(),
-            setId.getSid()));
+            setId.getSid());
         return topOpItem();
     }
 
@@ -1244,46 +1344,49 @@ namespace ast
 
     void CompileVisitor::pushLexer(const std::shared_ptr<lexer::Lexer>& lexer)
     {
-        _lexers.push(lexer);
-        _lexer_paths.push_back(lexer->getFilepath());
+        auto& session = CompilationSession::current();
+        session.getLexers().push(lexer);
+        session.getLexerPaths().push_back(lexer->getFilepath());
     }
 
     void CompileVisitor::popLexer()
     {
-        if (_lexers.empty())
+        auto& session = CompilationSession::current();
+        if (session.getLexers().empty())
         {
             throw RCCCompilerError::compilerError(RCC_UNKNOWN_CONST,
                                                   getCodeLine(currentPos()),
-                                                  "[void CompileVisitor::popLexer] if (_lexers.empty())  // true",
+                                                  "[void CompileVisitor::popLexer] if (session.getLexers().empty())  // true",
                                                   "Before removing the lexical analyzer, ensure that there is at least one lexical analyzer already available.");
         }
-        _lexers.pop();
-        _lexer_paths.pop_back();
+        session.getLexers().pop();
+        session.getLexerPaths().pop_back();
     }
 
     std::shared_ptr<lexer::Lexer> CompileVisitor::topLexer()
     {
-        return _lexers.top();
+        return CompilationSession::current().getLexers().top();
     }
 
     std::string CompileVisitor::topLexerPath()
     {
-        return _lexer_paths.back();
+        return CompilationSession::current().getLexerPaths().back();
     }
 
     std::list<std::string> CompileVisitor::getLexerFilePaths()
     {
-        return _lexer_paths;
+        return CompilationSession::current().getLexerPaths();
     }
 
     bool CompileVisitor::checkIsRecursiveImportByLexerPath(const std::string& extPath)
     {
-        return std::ranges::find(_lexer_paths, extPath) != _lexer_paths.end();
+        const auto& lexerPaths = CompilationSession::current().getLexerPaths();
+        return std::ranges::find(lexerPaths, extPath) != lexerPaths.end();
     }
 
-    void CompileVisitor::pushOpItem(const std::shared_ptr<OpItem>& opItem)
+    void CompileVisitor::pushOpItem(OpItem opItem)
     {
-        opItemStack.push(opItem);
+        opItemStack.push_back(std::move(opItem));
     }
 
     OpItem CompileVisitor::rPopOpItem()
@@ -1297,8 +1400,8 @@ namespace ast
                                                       " that is, we must first add new operation items to the stack."
                                                   });
         }
-        auto item = *opItemStack.top();
-        opItemStack.pop();
+        auto item = std::move(opItemStack.back());
+        opItemStack.pop_back();
         return item;
     }
 
@@ -1313,7 +1416,7 @@ namespace ast
                                                       " that is, we must first add new operation items to the stack."
                                                   });
         }
-        opItemStack.pop();
+        opItemStack.pop_back();
     }
 
     void CompileVisitor::pushOpItem(
@@ -1324,9 +1427,9 @@ namespace ast
         const std::shared_ptr<Symbol>& referencedSymbol, const std::shared_ptr<TypeLabelSymbol>& valueTypeSymbol,
         const Pos& pos)
     {
-        pushOpItem(std::make_shared<OpItem>(
+        opItemStack.emplace_back(
             type, typeLabelSymbol, value, racode,
-            valueTypeSymbol, referencedSymbol, pos));
+            valueTypeSymbol, referencedSymbol, pos);
     }
 
     void CompileVisitor::pushOpItem(
@@ -1335,11 +1438,11 @@ namespace ast
         const std::string& scopeField,
         const std::shared_ptr<TypeLabelSymbol>& typeLabelSymbol)
     {
-        pushOpItem(std::make_shared<OpItem>(
+        opItemStack.emplace_back(
             OpItemType::IDENTIFIER,
             typeLabelSymbol,
             name,
-            VarID(name, fileField, scopeField, curScopeLevel()).getVid()));
+            VarID(name, fileField, scopeField, curScopeLevel()).getVid());
     }
 
     void CompileVisitor::pushIdentItem(
@@ -1348,17 +1451,17 @@ namespace ast
         const std::shared_ptr<TypeLabelSymbol>& valueType,
         const std::shared_ptr<Symbol>& referencedSymbol, const Pos& pos)
     {
-        pushOpItem(std::make_shared<OpItem>(
+        opItemStack.emplace_back(
             OpItemType::IDENTIFIER,
             typeLabelSymbol,
             varID.getNameField(),
             varID.getVid(),
             valueType,
             referencedSymbol,
-            pos));
+            pos);
     }
 
-    OpItem CompileVisitor::topOpItem() const
+    const OpItem& CompileVisitor::topOpItem() const
     {
         if (!hasNextOpItem())
         {
@@ -1369,21 +1472,21 @@ namespace ast
                                                       " that is, we must first add new operation items to the stack."
                                                   });
         }
-        return *opItemStack.top();
+        return opItemStack.back();
     }
 
-    std::shared_ptr<OpItem> CompileVisitor::topOpItemPtr() const
+    OpItem& CompileVisitor::topOpItemRef()
     {
         if (!hasNextOpItem())
         {
             throw RCCCompilerError::compilerError(RCC_UNKNOWN_CONST, RCC_UNKNOWN_CONST,
-                                                  "[std::shared_ptr<OpItem> CompileVisitor::topOpItemPtr] if (!hasNextOpItem())  // true"
+                                                  "[OpItem& CompileVisitor::topOpItemRef] if (!hasNextOpItem())  // true"
                                                   , {
                                                       "When obtaining operation items, we must ensure that the operation item stack is not empty,"
                                                       " that is, we must first add new operation items to the stack."
                                                   });
         }
-        return opItemStack.top();
+        return opItemStack.back();
     }
 
     std::string CompileVisitor::topOpRaVal() const
@@ -1412,11 +1515,13 @@ namespace ast
     }
 
     CompileVisitor::CompileVisitor(
+        const std::shared_ptr<CompilationSession>& session,
         const std::string& programEntryFilePath,
         const std::string& programTargetFilePath,
         const std::string& compileOutputFilePath,
         const bool& needSaveOutput)
-        : programEntryFilePath(programEntryFilePath),
+        : session(session),
+          programEntryFilePath(programEntryFilePath),
           programTagetFilePath(programTargetFilePath),
           compileOutputFilePath(compileOutputFilePath),
           needSaveOutputToFile(needSaveOutput) {}
@@ -1441,7 +1546,7 @@ namespace ast
         return processingSymbolStack;
     }
 
-    std::stack<std::shared_ptr<OpItem>>& CompileVisitor::getOpItemStack()
+    std::deque<OpItem>& CompileVisitor::getOpItemStack()
     {
         return opItemStack;
     }
@@ -1476,6 +1581,11 @@ namespace ast
         currentProcessingFilePath = filePath;
     }
 
+    const std::shared_ptr<CompilationSession>& CompileVisitor::getSession() const
+    {
+        return session;
+    }
+
     void CompileVisitor::enableDebugMode(bool cond)
     {
     }
@@ -1610,7 +1720,7 @@ namespace ast
 
     utils::IRCCPosInterface* CompileVisitor::CurrentPos() const
     {
-        return &_currentProcessingPos.top();
+        return &CompilationSession::current().getProcessingPosStack().top();
     }
 
     void CompileVisitor::SetCurrentPos(const utils::IRCCPosInterface* pos)
@@ -1805,14 +1915,40 @@ namespace ast
 
     bool CompileVisitor::compile()
     {
-        const auto& lexer = std::make_shared<lexer::Lexer>(programTagetFilePath);
-        pushLexer(lexer);
-        parser::Parser parser(topLexer()->tokenize());
-        const auto& [hasError, programNode] = parser.parse();
-        if (hasError)
+        CompilationSession::Activation activation(*session);
+        auto& moduleGraph = session->getModuleGraph();
+        if (programEntryFilePath == programTagetFilePath)
         {
-            parser.printParserErrors();
-            return false;
+            // 入口文件：语义分析之前并行解析整个导入图，再按依赖关系并行编译导入的模块，
+            // 编译到导入处时直接取用注册表中的模块
+            const auto threadCount = static_cast<size_t>(std::max(__compile_option_jobs__, 0));
+            moduleGraph.parseAll(programTagetFilePath,
+                [](const std::string& importerPath, const std::string& extName) {
+                    return builtin::rcc_import_utils::resolveImportedFilePath(importerPath, extName);
+                }, threadCount);
+            BuildScheduler::build(*session, programTagetFilePath, threadCount);
+        }
+        if (const auto& module = moduleGraph.take(programTagetFilePath))
+        {
+            pushLexer(module->lexer);
+            if (module->parser && module->parser->hasError())
+            {
+                module->parser->printParserErrors();
+                return false;
+            }
+            programNode = module->program;
+        } else
+        {
+            const auto& lexer = std::make_shared<lexer::Lexer>(programTagetFilePath);
+            pushLexer(lexer);
+            parser::Parser parser(topLexer()->tokenStream());
+            const auto& [hasError, program] = parser.parse();
+            if (hasError)
+            {
+                parser.printParserErrors();
+                return false;
+            }
+            programNode = program;
         }
         if (needSaveOutputToFile)
         {
@@ -1831,10 +1967,46 @@ namespace ast
         try
         {
             programNode->acceptVisitor(*this);
-            const std::string raCode = raCodeBuilder.buildAll();
+            // 裁剪只在入口文件上进行：此时导入模块的指令已全部并入，成员的使用情况完整可见
+            const bool treeShake = programEntryFilePath == programTagetFilePath &&
+                (__compile_flag_tree_shake__ || __compile_option_compile_level__ >= 3);
+            if (__compile_option_compile_level__ >= 2 || treeShake)
+            {
+                // 导入模块的全局变量与函数在优化之后才由导入方登记为模块成员（见 processImportedSymbols），
+                // 优化时看不到这些引用，需要保留，导出的函数也不内联
+                std::unordered_set<std::string> moduleMembers;
+                if (programEntryFilePath != programTagetFilePath)
+                {
+                    const auto scopeLevel = symbolTable.curScopeLevel();
+                    symbolTable.enterGlobalScope();
+                    for (const auto &member : symbolTable.currentNameMapScope())
+                    {
+                        if (member->is(symbol::SymbolType::VARIABLE) || member->is(symbol::SymbolType::FUNCTION) ||
+                            member->is(symbol::SymbolType::CLASS))
+                        {
+                            moduleMembers.insert(member->getRaVal());
+                        }
+                    }
+                    symbolTable.enterScope(scopeLevel);
+                }
+                // 内联展开出的参数与局部变量沿用 VarID 的命名，在整个编译会话中唯一
+                session->getOptimizeStats() += raCodeBuilder.optimize(
+                    ri::RaOptimizer(__compile_option_compile_level__, tempVarIds, treeShake,
+                                    static_cast<size_t>(std::max(__compile_option_inline_threshold__, 0)),
+                                    [this] {
+                                        return VarID("inl", currentPos().getFileField(), curScopeField(),
+                                                     curScopeLevel()).getVid();
+                                    }, std::move(moduleMembers)));
+            }
+            // 根会话的输出中，模块标识符的前缀只在与其他标识符冲突时保留
+            const std::string raCode = session->isModuleSession()
+                ? raCodeBuilder.buildAll()
+                : session->shortenModuleNames(raCodeBuilder.buildAll());
             if (needSaveOutputToFile)
             {
-                if (!writeFile(compileOutputFilePath, raCode))
+                if (!writeFile(compileOutputFilePath, __symbol_option_format__ == OutputFormat::RAB
+                                                          ? ri::encodeRabBytecode(raCode)
+                                                          : raCode))
                 {
                     throw std::runtime_error("Can not write file: " + compileOutputFilePath);
                 }
@@ -2041,10 +2213,9 @@ namespace ast
         pass("To visit " + getNodeTypeName(node.getRealType()) + " type node.");
     }
 
-    std::string CompileVisitor::compileConstructorNode(
+    ri::InstructionBuffer CompileVisitor::compileConstructorNode(
         const std::shared_ptr<FunctionSymbol>& ctorSymbol)
     {
-        std::stringstream code{};
         const auto& node = std::static_pointer_cast<ConstructorDefinitionNode>(ctorSymbol->getDefinitionNode());
         const auto& topSymbol = topProcessingSymbol();
         if (topSymbol->getType() != SymbolType::CLASS)
@@ -2068,25 +2239,23 @@ namespace ast
             paramIdents.push_back(param->getRaVal());
             symbolTable.insert(VariableSymbol::paramSymbolToVarSymbol(param, symbolTable.curScopeLevel()), false);
         }
-        // 定义构造函数，构造一个 this 字段用于存储构造的对象
-        code
-            << ri::FUNI(ctorSymbol->getRaVal(), paramIdents).toRACode()
-            << ri::ALLOT({thisFieldSymbol->getRaVal()}).toRACode()
-            << ri::TP_NEW(classSymbol->getRaVal(), thisFieldSymbol->getRaVal()).toRACode();
-        // 执行构造函数体
+        // 定义构造函数，构造一个 this 字段用于存储构造的对象；构造函数在独立的作用域中编译，由调用方决定放置位置
         raCodeBuilder.enterScope();
+        raCodeBuilder
+            << ri::FUNI(ctorSymbol->getRaVal(), paramIdents)
+            << ri::ALLOT({thisFieldSymbol->getRaVal()})
+            << ri::TP_NEW(classSymbol->getRaVal(), thisFieldSymbol->getRaVal());
+        // 执行构造函数体
         node->getBodyNode()->acceptVisitor(*this);
-        std::string ctorBody{};
-        raCodeBuilder.buildCurScope(ctorBody).exitScope();
         // 构造函数返回 this
-        code
-            << ctorBody
-            << ri::RET(thisFieldSymbol->getRaVal()).toRACode()
-            << ri::END(ctorSymbol->getRaVal()).toRACode();
+        raCodeBuilder
+            << ri::RET(thisFieldSymbol->getRaVal())
+            << ri::END(ctorSymbol->getRaVal());
+        auto ctorCode = raCodeBuilder.takeCurScope();
         ctorSymbol->
             reSetReturnType(TypeLabelSymbol::getCustomTypeLabelSymbol(classSymbol->getRaVal(), curScopeLevel()));
         exitScope(ScopeType::FUNCTION);
-        return code.str();
+        return ctorCode;
     }
 
     void CompileVisitor::compileClassMembers(const std::string& classIdent, const std::shared_ptr<SymbolTable>& members,
@@ -2130,12 +2299,9 @@ namespace ast
                 // symbolTable.insert(functionSymbol, false);
                 raCodeBuilder.enterScope();
                 functionSymbol->getDefinitionNode()->acceptVisitor(*this);
-                std::string methodCode{};
-                raCodeBuilder
-                    .buildCurScope(methodCode)
-                    .exitScope();
+                const auto& methodCode = raCodeBuilder.takeCurScope();
                 raCodeBuilder
-                    << ri::ANNOTATION(member->getPos().toString()).toRACode()
+                    << ri::ANNOTATION(member->getPos().toString())
                     << methodCode;
                 defaultValue = member->getRaVal();
             }
@@ -2230,11 +2396,7 @@ namespace ast
             raCodeBuilder << ctorCode;
         }
         exitScope(ScopeType::CLASS);
-        std::string classDefCode{};
-        raCodeBuilder
-            .buildCurScope(classDefCode)
-            .exitScope();
-        raCodeBuilder << classDefCode;
+        raCodeBuilder.mergeScope();
         popProcessingSymbol();
         classSymbol->setDefaultVisitPermission();
     }
@@ -2262,16 +2424,16 @@ namespace ast
                 auto resultOpItem = rPopOpItem();
                 resultOpItem.setPos(valueNode->getPos());
                 checkExists(resultOpItem);
-                orderedArgs.push_back({identName, resultOpItem});
-                namedArgs.insert({identName, resultOpItem});
+                orderedArgs.emplace_back(identName, resultOpItem);
+                namedArgs.try_emplace(identName, std::move(resultOpItem));
             }
             else
             {
                 arg->acceptVisitor(*this);
                 auto resultOpItem = rPopOpItem();
                 resultOpItem.setPos(arg->getPos());
-                orderedArgs.push_back({"", resultOpItem});
-                posArgs.push(resultOpItem);
+                orderedArgs.emplace_back("", resultOpItem);
+                posArgs.push(std::move(resultOpItem));
             }
         }
     }
@@ -2283,7 +2445,7 @@ namespace ast
         const Pos& ctorCallPos,
         const std::vector<std::pair<std::string, OpItem>>& orderedArgs) const
     {
-        const auto& argTypeStrings = [orderedArgs]
+        const auto& argTypeStrings = [&orderedArgs]
         {
             std::vector<std::string> typeStrs = {};
             for (const auto& arg : orderedArgs | std::views::values)
@@ -2297,13 +2459,19 @@ namespace ast
         std::queue<OpItem> tempQueue = posArgs; // 复制队列
         while (!tempQueue.empty())
         {
-            posArgsVec.push_back(tempQueue.front());
+            posArgsVec.push_back(std::move(tempQueue.front()));
             tempQueue.pop();
         }
+        // 逐个构造函数匹配时只复制命名参数的指针，不复制操作数
+        std::unordered_map<std::string_view, const OpItem*> namedArgRefs;
+        for (const auto& [name, arg] : namedArgs)
+        {
+            namedArgRefs.emplace(name, &arg);
+        }
         for (const auto& ctor : *classSymbol->getConstructors())
         {
             size_t posArgIndex = 0;
-            auto tempNamedArgs = namedArgs; // 仍需复制，但比复制整个参数环境开销小
+            auto tempNamedArgs = namedArgRefs;
             bool matched = true;
             auto funcSymbol = std::static_pointer_cast<FunctionSymbol>(ctor);
             for (const auto& param : funcSymbol->getParameters())
@@ -2326,7 +2494,7 @@ namespace ast
                         if (auto it = tempNamedArgs.find(param->getVal());
                             it != tempNamedArgs.end())
                         {
-                            matchedParam = checkTypeMatch(param, it->second);
+                            matchedParam = checkTypeMatch(param, *it->second);
                             tempNamedArgs.erase(it);
                             hasNamed = true;
                         }
@@ -2348,7 +2516,7 @@ namespace ast
                 case ParamType::PARAM_VAR_LEN_KEYWORD:
                     for (const auto& arg : tempNamedArgs | std::views::values)
                     {
-                        matchedParam = checkTypeMatch(param, arg);
+                        matchedParam = checkTypeMatch(param, *arg);
                         if (!matchedParam) break;
                     }
                     tempNamedArgs.clear();
@@ -2435,6 +2603,7 @@ namespace ast
         catch (RCCError& e)
         {
             const auto& errorFilePath = errorPos.getFilepath();
+            auto& fileRecord = session->getErrorFileRecord();
             if (fileRecord.empty())
             {
                 fileRecord = errorFilePath;
@@ -2447,7 +2616,7 @@ namespace ast
                 getPosStrFromFilePath(errorFilePath),
                 makeFileIdentStr(
                     isExt
-                    ? extensionPathNameMap.at(errorFilePath)
+                    ? getExtensionName(errorFilePath)
                     : errorFilePath,
                     isExt)));
             if (fileRecord != errorFilePath)
@@ -2465,44 +2634,51 @@ namespace ast
         checkExists(left, node.getLeftNode()->getPos());
         const auto& [leftLabelType, leftValueType] = getTypesFromOpItem(left);
         const auto& leftType =
-            leftLabelType && leftLabelType->equalWith(leftValueType) && leftLabelType->isNot("any")
+            leftLabelType && leftLabelType->equalWith(leftValueType) && leftLabelType->isNot(BuiltinTypeLabel::ANY)
                 ? leftLabelType
-                : leftValueType && leftValueType->is("nul")
+                : leftValueType && leftValueType->is(BuiltinTypeLabel::NUL)
                 ? leftLabelType
                 : leftValueType;
         node.getRightNode()->acceptVisitor(*this);
         const auto& right = rPopOpItem();
         const auto& [rightLabelType, rightValueType] = getTypesFromOpItem(right);
         const auto& rightType =
-            rightLabelType && rightLabelType->equalWith(rightValueType) && rightLabelType->isNot("any")
+            rightLabelType && rightLabelType->equalWith(rightValueType) && rightLabelType->isNot(BuiltinTypeLabel::ANY)
                 ? rightLabelType
-                : rightValueType && rightValueType->is("nul")
+                : rightValueType && rightValueType->is(BuiltinTypeLabel::NUL)
                 ? rightLabelType
                 : rightValueType;
+        // 两侧均为字面量时在编译期求值，不再生成运算指令
+        const auto& leftConstant = getConstantRaVal(left);
+        const auto& rightConstant = getConstantRaVal(right);
+        const bool foldable = leftConstant && rightConstant;
         std::shared_ptr<TypeLabelSymbol> resultValueType = nullptr;
         switch (node.getInfixType())
         {
         case NodeType::PLUS:
             {
-                if (leftType->is("any") || rightType->is("any"))
+                // 以类型编号与位集合判断操作数类型
+                constexpr TypeLabelSet numberTypes = BuiltinTypeLabel::INT | BuiltinTypeLabel::FLOAT;
+                const auto leftTypeId = leftType->getTypeId();
+                const auto rightTypeId = rightType->getTypeId();
+                if (leftTypeId == BuiltinTypeLabel::ANY || rightTypeId == BuiltinTypeLabel::ANY)
                 {
                     resultValueType = TypeLabelSymbol::anyTypeSymbol(node.getPos(), symbolTable.curScopeLevel());
                 }
-                else if (leftType->is("str") || rightType->is("str"))
+                else if (leftTypeId == BuiltinTypeLabel::STR || rightTypeId == BuiltinTypeLabel::STR)
                 {
                     resultValueType = TypeLabelSymbol::strTypeSymbol(node.getPos(), symbolTable.curScopeLevel());
                 }
-                else if (leftType->is("int") && rightType->is("int"))
+                else if (leftTypeId == BuiltinTypeLabel::INT && rightTypeId == BuiltinTypeLabel::INT)
                 {
                     resultValueType = TypeLabelSymbol::intTypeSymbol(node.getPos(), symbolTable.curScopeLevel());
                 }
-                else if ((leftType->is("int") || leftType->is("float")) &&
-                    (rightType->is("int") || rightType->is("float")) &&
-                    (leftType->is("float") || rightType->is("float")))
+                else if (numberTypes.contains(leftTypeId) && numberTypes.contains(rightTypeId))
                 {
+                    // 两侧均为数值且不全为 int，至少一侧为 float
                     resultValueType = TypeLabelSymbol::floatTypeSymbol(node.getPos(), symbolTable.curScopeLevel());
                 }
-                else if (leftType->is("list") || rightType->is("list"))
+                else if (leftTypeId == BuiltinTypeLabel::LIST || rightTypeId == BuiltinTypeLabel::LIST)
                 {
                     resultValueType = TypeLabelSymbol::listTypeSymbol(node.getPos(), symbolTable.curScopeLevel());
                 }
@@ -2517,18 +2693,34 @@ namespace ast
                                                                + ")",
                                                                {});
                 }
+                if (foldable && pushConstantItem(node.getPos(),
+                                                 ri::foldArithmetic("ADD", *leftConstant, *rightConstant),
+                                                 resultValueType))
+                {
+                    break;
+                }
                 pushTemOpVarItemWithRecord(node.getPos(), resultValueType);
                 raCodeBuilder << ri::ADD(raVal(left, true), raVal(right, true), topOpRaVal());
             }
             break;
         case NodeType::DIVIDE:
             {
+                if (foldable && pushConstantItem(node.getPos(),
+                                                 ri::foldArithmetic("DIV", *leftConstant, *rightConstant)))
+                {
+                    break;
+                }
                 pushTemOpVarItemWithRecord(node.getPos());
                 raCodeBuilder << ri::DIV(raVal(left, true), raVal(right, true), topOpRaVal());
             }
             break;
         case NodeType::MINUS:
             {
+                if (const auto& opposite = foldable ? ri::foldOpposite(*rightConstant) : std::nullopt;
+                    opposite && pushConstantItem(node.getPos(), ri::foldArithmetic("ADD", *leftConstant, *opposite)))
+                {
+                    break;
+                }
                 pushTemOpVarItemWithRecord(node.getPos());
                 raCodeBuilder << ri::OPP(raVal(right, true), topOpRaVal())
                     << ri::ADD(raVal(left, true), topOpRaVal(), topOpRaVal());
@@ -2536,12 +2728,22 @@ namespace ast
             break;
         case NodeType::MULTIPLY:
             {
+                if (foldable && pushConstantItem(node.getPos(),
+                                                 ri::foldArithmetic("MUL", *leftConstant, *rightConstant)))
+                {
+                    break;
+                }
                 pushTemOpVarItemWithRecord(node.getPos());
                 raCodeBuilder << ri::MUL(raVal(left, true), raVal(right, true), topOpRaVal());
             }
             break;
         case NodeType::MODULO:
             {
+                if (foldable && pushConstantItem(node.getPos(),
+                                                 ri::foldArithmetic("MOD", *leftConstant, *rightConstant)))
+                {
+                    break;
+                }
                 pushTemOpVarItemWithRecord(node.getPos());
                 raCodeBuilder << ri::MOD(raVal(left, true), raVal(right, true), topOpRaVal());
             }
@@ -2555,10 +2757,15 @@ namespace ast
         case NodeType::COMPARE:
         case NodeType::LOGICAL:
             {
-                pushTemOpVarItemWithRecord(node.getPos());
                 if (const auto& it = RELATION_MAP.find(node.getOpToken().getValue());
                     it != RELATION_MAP.end())
                 {
+                    if (foldable && pushConstantItem(node.getPos(),
+                                                     ri::foldRelation(it->second, *leftConstant, *rightConstant)))
+                    {
+                        break;
+                    }
+                    pushTemOpVarItemWithRecord(node.getPos());
                     raCodeBuilder << ri::CMP(raVal(left, true), raVal(right, true), topOpRaVal())
                         << ri::CREL(topOpRaVal(), it->second, topOpRaVal());
                 }
@@ -2646,7 +2853,7 @@ namespace ast
                     const VarID attrVarID(getNewTempVarName(), node.getPos().getFileField(), curScopeField(),
                                           curScopeLevel());
                     pushIdentItem(attrVarID, typeLabelSymbol, typeLabelSymbol, memberSymbol, node.getPos());
-                    topOpItemPtr()->setBelonging(getSymbolFromOpItem(left), memberSymbol->getRaVal());
+                    topOpItemRef().setBelonging(getSymbolFromOpItem(left), memberSymbol->getRaVal());
                     std::shared_ptr<Symbol> attrSymbol;
                     if (memberSymbol->is(SymbolType::VARIABLE) || memberSymbol->is(SymbolType::CLASS))
                     {
@@ -2727,6 +2934,12 @@ namespace ast
             node.getRightNode()->acceptVisitor(*this);
             auto resultOpItem = rPopOpItem();
             resultOpItem.setPos(node.getRightNode()->getPos());
+            if (const auto& condition = getConstantCondition(resultOpItem);
+                condition && pushConstantItem(node.getPos(), *condition ? RCC_FALSE : RCC_TRUE,
+                                              TypeLabelSymbol::boolTypeSymbol(node.getPos(), curScopeLevel())))
+            {
+                return;
+            }
             pushTemOpVarItemWithRecord(node.getPos(), TypeLabelSymbol::boolTypeSymbol(node.getPos(), curScopeLevel()),
                 nullptr, true, nullptr);
             raCodeBuilder
@@ -2797,10 +3010,14 @@ namespace ast
                 nullptr, true);
             const auto& tempOpItemRaVal = topOpRaVal();
             raCodeBuilder
-            << ri::TP_SET(builtinTypeToString(BuiltinType::B_SERIES), tempOpItemRaVal)
-            << (itemIds.empty()
-            ? ri::ANNOTATION("Empty series is no need to used `ITER_APND` RI to set value.").toRACode()
-            : ri::ITER_APND(itemIds, tempOpItemRaVal).toRACode());
+            << ri::TP_SET(builtinTypeToString(BuiltinType::B_SERIES), tempOpItemRaVal);
+            if (itemIds.empty())
+            {
+                raCodeBuilder << ri::ANNOTATION("Empty series is no need to used `ITER_APND` RI to set value.");
+            } else
+            {
+                raCodeBuilder << ri::ITER_APND(itemIds, tempOpItemRaVal);
+            }
         } else
         {
             node.getRangerNode()->acceptVisitor(*this);
@@ -2824,6 +3041,7 @@ namespace ast
         catch (RCCError& e)
         {
             const auto& errorFilePath = errorPos.getFilepath();
+            auto& fileRecord = session->getErrorFileRecord();
             if (fileRecord.empty())
             {
                 fileRecord = errorFilePath;
@@ -3099,14 +3317,18 @@ namespace ast
             functionSymbol->setReturnType(getBuiltinTypeSymbol(functionSymbol->getPos(), BuiltinType::B_ANY));
         }
         pushNewProcessingSymbol(functionSymbol);
-        raCodeBuilder << (functionSymbol->hasReturnValue()
-                              ? ri::FUNI(functionSymbol->getRaVal(), paramIdents).toRACode()
-                              : ri::FUNC(functionSymbol->getRaVal(), paramIdents).toRACode());
+        if (functionSymbol->hasReturnValue())
+        {
+            raCodeBuilder << ri::FUNI(functionSymbol->getRaVal(), paramIdents);
+        } else
+        {
+            raCodeBuilder << ri::FUNC(functionSymbol->getRaVal(), paramIdents);
+        }
         node.getBodyNode()->acceptVisitor(*this);
         if (!functionSymbol->is(TypeOfBuiltin::BUILTIN) &&
             functionSymbol->hasReturnValue() && !functionSymbol->hasReturned())
         {
-            if (functionSymbol->getReturnType()->isNot("any"))
+            if (functionSymbol->getReturnType()->isNot(BuiltinTypeLabel::ANY))
             {
                 throw RCCCompilerError::semanticError(node.getPos().toString(), getCodeLine(node.getPos()),
                                                       StringVector{
@@ -3301,7 +3523,18 @@ namespace ast
             << ri::ANNOTATION(node.getPos().toString());
         const auto& endSetLabel = rPopOpItemRaVal();
         node.getConditionNode()->acceptVisitor(*this);
-        const auto& conditionVal = rPopOpItemRaVal();
+        const auto& conditionItem = rPopOpItem();
+        if (const auto& condition = getConstantCondition(conditionItem))
+        {
+            // 条件恒定：恒假的分支体仍需编译以完成语义检查，但不保留其指令；
+            // 恒真的分支体无需跳转，同一条件语句中其后的分支交由 visitConditionNode 丢弃
+            if (!*condition) raCodeBuilder.enterScope();
+            node.getBodyNode()->acceptVisitor(*this);
+            if (!*condition) raCodeBuilder.exitScope();
+            branchAlwaysTaken = *condition;
+            return;
+        }
+        const auto& conditionVal = raVal(conditionItem, true);
         const auto& skipSetLabel = newTemOpSetItem(node.getPos()).getRaVal(symbolTable);
         raCodeBuilder
             << ri::JF(conditionVal, skipSetLabel);
@@ -3313,25 +3546,27 @@ namespace ast
 
     void CompileVisitor::visitConditionNode(ConditionNode& node)
     {
-        const auto& [nameMapScope, ridMapScope]
-            = symbolTable.currentScopeCopied();
-        const auto& nameMapScopeRecord = std::static_pointer_cast<SymbolTable>(nameMapScope.copySelf());
-        const auto& ridMapScopeRecord = std::static_pointer_cast<SymbolTable>(ridMapScope.copySelf());
+        const auto& nameMapScopeRecord = std::static_pointer_cast<SymbolTable>(symbolTable.currentNameMapScope().copySelf());
+        const auto& ridMapScopeRecord = std::static_pointer_cast<SymbolTable>(symbolTable.currentRIDMapScope().copySelf());
         // 条件语句的结束 SET 标签
-        const auto& endSetLabel = std::make_shared<OpItem>(
+        const OpItem endSetLabel(
             OpItemType::SET_LABEL,
             getBuiltinTypeSymbol(node.getPos(), BuiltinType::B_FLAG),
             SetID(getNewSetLabelName(), node.getPos().getFileField(), curScopeField()).getSid());
+        bool unreachable = false;
         for (const auto& branchNode : node.getBranchNodes())
         {
             pushOpItem(endSetLabel);
             enterScope(ScopeType::CONDITION);
+            branchAlwaysTaken = false;
+            if (unreachable) raCodeBuilder.enterScope();
             branchNode->acceptVisitor(*this);
+            if (unreachable) raCodeBuilder.exitScope();
+            unreachable = unreachable || branchAlwaysTaken;
             exitScope(ScopeType::CONDITION);
-            symbolTable.currentNameMapScope() = *std::static_pointer_cast<SymbolTable>(nameMapScopeRecord->copySelf());
-            symbolTable.currentRIDMapScope() = *std::static_pointer_cast<SymbolTable>(ridMapScopeRecord->copySelf());
+            symbolTable.restoreCurrentScope(*nameMapScopeRecord, *ridMapScopeRecord);
         }
-        raCodeBuilder << ri::SET(endSetLabel->getRaVal(symbolTable));
+        raCodeBuilder << ri::SET(endSetLabel.getRaVal(symbolTable));
     }
 
     void CompileVisitor::visitLoopNode(LoopNode& node)
@@ -3342,21 +3577,19 @@ namespace ast
         case LoopType::FOR:
         case LoopType::WHILE:
             {
+                raCodeBuilder.enterScope();
                 pushTemOpVarItemWithRecord(node.getPos());
                 raCodeBuilder
                     << ri::CMP(RCC_TRUE, RCC_FALSE, topOpRaVal())
                     << ri::UNTIL(rPopOpItemRaVal(), RCC_REL_RE);
                 node.getConditionNode()->acceptVisitor(*this);
-                const auto& continueSetLabel = newTemOpSetItem(node.getPos());
-                raCodeBuilder
-                    << ri::JT(rPopOpItemRaVal(), continueSetLabel.getRaVal(symbolTable))
-                    << ri::EXIT("UNTIL")
-                    << ri::SET(continueSetLabel.getRaVal(symbolTable));
+                const auto& condition = compileLoopCondition(node.getPos());
                 enterScope(ScopeType::LOOP);
                 node.getBodyNode()->acceptVisitor(*this);
                 exitScope(ScopeType::LOOP);
                 raCodeBuilder
                     << ri::END("UNTIL");
+                finishLoop(condition);
             }
             break;
         case LoopType::UNTIL:
@@ -3366,26 +3599,54 @@ namespace ast
         exitLoopScope();
     }
 
+    std::optional<bool> CompileVisitor::compileLoopCondition(const Pos& pos)
+    {
+        const auto& conditionItem = rPopOpItem();
+        const auto& condition = getConstantCondition(conditionItem);
+        if (condition)
+        {
+            // 条件恒真时循环只能由循环体中的 break 结束，无需每轮检查
+            return condition;
+        }
+        const auto& continueSetLabel = newTemOpSetItem(pos);
+        raCodeBuilder
+            << ri::JT(raVal(conditionItem, true), continueSetLabel.getRaVal(symbolTable))
+            << ri::EXIT("UNTIL")
+            << ri::SET(continueSetLabel.getRaVal(symbolTable));
+        return condition;
+    }
+
+    void CompileVisitor::finishLoop(const std::optional<bool>& condition)
+    {
+        if (condition == false)
+        {
+            // 条件恒假的循环体一次也不会执行，循环体仍已编译完成语义检查
+            raCodeBuilder.exitScope();
+        }
+        else
+        {
+            raCodeBuilder.mergeScope();
+        }
+    }
+
     void CompileVisitor::visitForLoopNode(ForLoopNode& node)
     {
         enterLoopScope();
         node.getInitNode()->acceptVisitor(*this);
+        raCodeBuilder.enterScope();
         pushTemOpVarItemWithRecord(node.getPos());
         raCodeBuilder
             << ri::CMP(RCC_TRUE, RCC_FALSE, topOpRaVal())
             << ri::UNTIL(rPopOpItemRaVal(), RCC_REL_RE);
         node.getConditionNode()->acceptVisitor(*this);
-        const auto& continueSetLabel = newTemOpSetItem(node.getPos());
-        raCodeBuilder
-            << ri::JT(rPopOpItemRaVal(), continueSetLabel.getRaVal(symbolTable))
-            << ri::EXIT("UNTIL")
-            << ri::SET(continueSetLabel.getRaVal(symbolTable));
+        const auto& condition = compileLoopCondition(node.getPos());
         enterScope(ScopeType::LOOP);
         node.getBodyNode()->acceptVisitor(*this);
         exitScope(ScopeType::LOOP);
         node.getUpdateNode()->acceptVisitor(*this);
         raCodeBuilder
             << ri::END("UNTIL");
+        finishLoop(condition);
         exitLoopScope();
     }
 
@@ -3438,7 +3699,7 @@ namespace ast
         funcSymbol->setHasReturned(true);
         if (funcSymbol->hasReturnValue() && !node.getReturnNode())
         {
-            if (funcSymbol->getReturnType()->isNot("any"))
+            if (funcSymbol->getReturnType()->isNot(BuiltinTypeLabel::ANY))
             {
                 throw RCCCompilerError::semanticError(
                     node.getPosStr(),
@@ -3486,7 +3747,7 @@ namespace ast
                     [this, returnVal]
                     {
                         const auto& [tl, vl] = getTypesFromOpItem(returnVal);
-                        if (tl && tl->isNot("any")) return tl->toString();
+                        if (tl && tl->isNot(BuiltinTypeLabel::ANY)) return tl->toString();
                         if (vl) return vl->toString();
                         return returnVal.toString();
                     }(),
@@ -3589,14 +3850,18 @@ namespace ast
             functionSymbol->setReturnType(getBuiltinTypeSymbol(functionSymbol->getPos(), BuiltinType::B_ANY));
         }
         pushNewProcessingSymbol(functionSymbol);
-        raCodeBuilder << (functionSymbol->hasReturnValue()
-                              ? ri::FUNI(functionSymbol->getRaVal(), paramIdents).toRACode()
-                              : ri::FUNC(functionSymbol->getRaVal(), paramIdents).toRACode());
+        if (functionSymbol->hasReturnValue())
+        {
+            raCodeBuilder << ri::FUNI(functionSymbol->getRaVal(), paramIdents);
+        } else
+        {
+            raCodeBuilder << ri::FUNC(functionSymbol->getRaVal(), paramIdents);
+        }
         node.getBodyNode()->acceptVisitor(*this);
         if (!builtin::isBuiltinFunction(functionSymbol->getVal()) && functionSymbol->hasReturnValue() && !functionSymbol
             ->hasReturned())
         {
-            if (functionSymbol->getReturnType()->isNot("any"))
+            if (functionSymbol->getReturnType()->isNot(BuiltinTypeLabel::ANY))
             {
                 throw RCCCompilerError::semanticError(
                     node.getPosStr(),
@@ -3690,6 +3955,7 @@ namespace ast
         catch (RCCError& e)
         {
             const auto& errorFilePath = errorPos.getFilepath();
+            auto& fileRecord = session->getErrorFileRecord();
             if (fileRecord.empty())
             {
                 fileRecord = errorFilePath;
@@ -3715,9 +3981,9 @@ namespace ast
         node.getIndexNode()->acceptVisitor(*this);
         const auto& indexItem = rPopOpItem();
         if (const auto& [targetTypeLabel, targetValueType] = getTypesFromOpItem(targetItem);
-            targetTypeLabel->is("any"))
+            targetTypeLabel->is(BuiltinTypeLabel::ANY))
         {
-            if (targetValueType->is("any") || targetValueType->is("nul"))
+            if (targetValueType->is(BuiltinTypeLabel::ANY) || targetValueType->is(BuiltinTypeLabel::NUL))
             {
                 pushTemOpVarItemWithRecord(node.getPos());
                 raCodeBuilder
@@ -3823,7 +4089,8 @@ namespace ast
         for (const auto& varDef : node.getVarDefs())
         {
             varDef->getNameNode()->acceptVisitor(*this);
-            if (const auto& varRefSymbol = topOpItem().getReferencedSymbol();
+            // 复制引用符号：下方会弹出栈顶操作数
+            if (const auto varRefSymbol = topOpItem().getReferencedSymbol();
                 varRefSymbol && varRefSymbol->getScopeLevel() == curScopeLevel())
             {
                 throw RCCCompilerError::symbolDuplicateError(varDef->getNameNode()->getPosStr(),
@@ -4143,7 +4410,7 @@ namespace ast
 
     void CompileVisitor::PushOpItem(const IRCCOpItemInterface* opItemI)
     {
-        pushOpItem(std::static_pointer_cast<OpItem>(opItemI->TransformToOII()->copySelf()));
+        pushOpItem(*opItemI->TransformToOII());
     }
 
     void CompileVisitor::PushOpItem(const OpItemType& opItemType,
@@ -4183,7 +4450,7 @@ namespace ast
 
     IRCCOpItemInterface* CompileVisitor::TopOpItemI() const
     {
-        return opItemStack.top().get();
+        return const_cast<OpItem*>(&opItemStack.back());
     }
 
     const char* CompileVisitor::TopOpRaVal() const
@@ -3217,10 +3217,8 @@ namespace ast
 
         // 词法分析
         const auto& lexer = std::make_shared<lexer::Lexer>(filePath);
-        auto tokens = lexer->tokenize();
-
-        // 语法分析
-        parser::Parser parser(tokens);
+        // 语法分析，Token 由词法分析器按需产生
+        parser::Parser parser(lexer->tokenStream());
         const auto& [hasError, programNode] = parser.parse();
         if (hasError)
         {
@@ -0,0 +1,1230 @@
+//
+// Created by RestRegular on 2025/7/20.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "../../include/rcc_base.h"
+#include "../../include/visitors/rcc_module_cache.h"
+#include "../../include/visitors/rcc_builtin_snapshot.h"
+#include "../../include/components/symbol/rcc_symbol.h"
+#include "../../include/visitors/rcc_compile_visitor.h"
+
+namespace ast
+{
+    using namespace symbol;
+
+    namespace
+    {
+        // 对象类型标签；只能在末尾追加，调整已有标签时须递增 FORMAT_VERSION
+        enum class ObjectTag : uint8_t {
+            SYMBOL_TABLE = 1,
+            VARIABLE,
+            PARAMETER,
+            FUNCTION,
+            CLASS,
+            LABEL
+        };
+
+        // 对象引用：0 为空，1 为本模块的对象，k >= 2 为依赖路径表中第 k - 2 个模块的对象
+        constexpr uint64_t NULL_REF = 0;
+        constexpr uint64_t LOCAL_REF = 1;
+
+        std::string normalizeModulePath(const std::string &filepath)
+        {
+            return utils::getAbsolutePath(filepath, utils::getDefaultDir());
+        }
+
+        // 缓存项中 RCC 库目录下的路径（字符串表、依赖路径表与 RA 代码的注释）以占位符记录，载入时换成当前的库目录，
+        // 缓存项与嵌入的快照因此与 RCC 的安装位置无关
+        constexpr std::string_view LIB_DIR_MARK = "\x01";
+
+        const std::string &getLibDirPrefix()
+        {
+            static const auto prefix = [] {
+                auto libDir = normalizeModulePath(base::RCC_LIB_DIR);
+                if (!libDir.ends_with('/') && !libDir.ends_with('\\'))
+                {
+                    libDir.push_back('/');
+                }
+                return libDir;
+            }();
+            return prefix;
+        }
+
+        std::string replaceAll(const std::string_view text, const std::string_view from, const std::string_view to)
+        {
+            std::string result;
+            result.reserve(text.size());
+            size_t pos = 0;
+            for (auto found = text.find(from); found != std::string_view::npos; found = text.find(from, pos))
+            {
+                result.append(text.substr(pos, found - pos)).append(to);
+                pos = found + from.size();
+            }
+            return result.append(text.substr(pos));
+        }
+
+        std::string encodeLibPaths(const std::string_view text)
+        {
+            return replaceAll(text, getLibDirPrefix(), LIB_DIR_MARK);
+        }
+
+        std::string decodeLibPaths(const std::string_view text)
+        {
+            return replaceAll(text, LIB_DIR_MARK, getLibDirPrefix());
+        }
+
+        // 写入缓存项时使用的临时文件后缀：进程号区分同时运行的编译进程，进程内序号区分同一进程的各个线程
+        std::string makeTempSuffix()
+        {
+            static std::atomic<uint64_t> sequence = 0;
+#ifdef _WIN32
+            const auto processId = _getpid();
+#else
+            const auto processId = getpid();
+#endif
+            return "." + std::to_string(processId) + "." + std::to_string(sequence++) + ".tmp";
+        }
+
+        // 模块依赖的全部模块拥有的对象及其所在的（模块路径，序号）
+        using ForeignIndex = std::unordered_map<const utils::Object *, std::pair<std::string, size_t>>;
+
+        ForeignIndex collectForeignIndex(const CompiledModule &module)
+        {
+            ForeignIndex index;
+            auto &registry = module.session->getModuleRegistry();
+            std::unordered_set<std::string> visited;
+            std::deque<std::string> frontier(module.dependencies.begin(), module.dependencies.end());
+            while (!frontier.empty())
+            {
+                const auto filepath = std::move(frontier.front());
+                frontier.pop_front();
+                if (!visited.insert(filepath).second)
+                {
+                    continue;
+                }
+                const auto &dependency = registry.find(filepath);
+                if (!dependency)
+                {
+                    throw std::runtime_error("Dependency is not published: " + filepath);
+                }
+                for (size_t i = 0; i < dependency->symbolIndex.size(); i++)
+                {
+                    index.try_emplace(dependency->symbolIndex[i].get(), dependency->filepath, i);
+                }
+                frontier.insert(frontier.end(), dependency->dependencies.begin(), dependency->dependencies.end());
+            }
+            return index;
+        }
+
+        std::vector<std::shared_ptr<LabelSymbol>> sortedLabels(const std::unordered_set<std::shared_ptr<LabelSymbol>> &labels)
+        {
+            std::vector sorted(labels.begin(), labels.end());
+            std::ranges::sort(sorted, [](const auto &lhs, const auto &rhs) {
+                return std::pair{lhs->getVal(), lhs->getRaVal()} < std::pair{rhs->getVal(), rhs->getRaVal()};
+            });
+            return sorted;
+        }
+
+        // 从模块的扩展类与自定义类出发，按广度优先顺序收集模块拥有的对象，依赖模块的对象不展开
+        // 依赖模块中的类在本模块定义派生类时会记录派生类的副本，这些副本同样属于本模块
+        class SymbolCollector {
+        public:
+            SymbolCollector(const CompiledModule &module, const ForeignIndex &foreign)
+                : _module(module), _foreign(foreign) {}
+
+            std::vector<std::shared_ptr<utils::Object>> collect()
+            {
+                visit(_module.extension);
+                std::vector<std::pair<std::string, std::shared_ptr<ClassSymbol>>> customClasses(
+                    _module.session->getCustomClassSymbolMap().begin(), _module.session->getCustomClassSymbolMap().end());
+                std::ranges::sort(customClasses, {}, &decltype(customClasses)::value_type::first);
+                for (const auto &classSymbol : customClasses | std::views::values)
+                {
+                    visit(classSymbol);
+                }
+                size_t scanned = 0;
+                while (_next < _objects.size() || scanned < _foreignClasses.size())
+                {
+                    if (_next < _objects.size())
+                    {
+                        expand(_objects[_next++]);
+                        continue;
+                    }
+                    for (const auto &derived : _foreignClasses[scanned++]->getDerivedClasses())
+                    {
+                        if (derived->getPos().getFilepath() == _module.filepath)
+                        {
+                            visit(derived);
+                        }
+                    }
+                }
+                return std::move(_objects);
+            }
+
+        private:
+            const CompiledModule &_module;
+            const ForeignIndex &_foreign;
+            std::vector<std::shared_ptr<utils::Object>> _objects;
+            std::unordered_set<const utils::Object *> _visited;
+            std::vector<std::shared_ptr<ClassSymbol>> _foreignClasses;
+            size_t _next = 0;
+
+            void visit(const std::shared_ptr<utils::Object> &object)
+            {
+                if (!object || !_visited.insert(object.get()).second)
+                {
+                    return;
+                }
+                if (_foreign.contains(object.get()))
+                {
+                    if (const auto &classSymbol = std::dynamic_pointer_cast<ClassSymbol>(object))
+                    {
+                        _foreignClasses.push_back(classSymbol);
+                    }
+                    return;
+                }
+                _objects.push_back(object);
+            }
+
+            void expand(const std::shared_ptr<utils::Object> &object)
+            {
+                if (const auto &table = std::dynamic_pointer_cast<SymbolTable>(object))
+                {
+                    for (const auto &key : table->getNameIndex())
+                    {
+                        visit(table->find(key));
+                    }
+                } else if (const auto &varSymbol = std::dynamic_pointer_cast<VariableSymbol>(object))
+                {
+                    visit(varSymbol->getClassSymbol());
+                    visit(varSymbol->getReferencedSymbol());
+                } else if (const auto &funcSymbol = std::dynamic_pointer_cast<FunctionSymbol>(object))
+                {
+                    visit(funcSymbol->getClassSymbol());
+                } else if (const auto &classSymbol = std::dynamic_pointer_cast<ClassSymbol>(object))
+                {
+                    for (const auto &baseClass : classSymbol->getBaseClasses())
+                    {
+                        visit(baseClass);
+                    }
+                    for (const auto &derivedClass : classSymbol->getDerivedClasses())
+                    {
+                        visit(derivedClass);
+                    }
+                    visit(classSymbol->getMembers());
+                    visit(classSymbol->getStaticMembers());
+                    visit(classSymbol->getConstructors());
+                }
+            }
+        };
+
+        class ModuleWriter {
+        public:
+            ModuleWriter(const CompiledModule &module, const ForeignIndex &foreign)
+                : _module(module), _foreign(foreign)
+            {
+                for (size_t i = 0; i < module.symbolIndex.size(); i++)
+                {
+                    _local.emplace(module.symbolIndex[i].get(), i);
+                }
+            }
+
+            std::string finish()
+            {
+                utils::appendBytes(_body, encodeLibPaths(_module.raCode));
+                writeCount(_module.dependencies.size());
+                for (const auto &dependency : _module.dependencies)
+                {
+                    writeString(dependency);
+                }
+                const auto &stats = _module.session->getOptimizeStats();
+                for (const auto value : {stats.inputRecords, stats.outputRecords, stats.unreachable,
+                                         stats.redundantJumps, stats.forwarded, stats.folded, stats.propagated,
+                                         stats.deadStores, stats.annotations, stats.shaken, stats.inlined,
+                                         stats.reusedSlots, stats.releasedSlots})
+                {
+                    utils::appendVarint(_body, value);
+                }
+                std::vector<std::pair<std::string, std::string>> customTypes(
+                    _module.session->getCustomTypeMap().begin(), _module.session->getCustomTypeMap().end());
+                std::ranges::sort(customTypes);
+                writeCount(customTypes.size());
+                for (const auto &[uid, name] : customTypes)
+                {
+                    writeString(uid);
+                    writeString(name);
+                }
+
+                writeCount(_module.symbolIndex.size());
+                for (const auto &object : _module.symbolIndex)
+                {
+                    writeObject(object);
+                }
+
+                std::vector<std::pair<std::string, std::shared_ptr<ClassSymbol>>> customClasses(
+                    _module.session->getCustomClassSymbolMap().begin(), _module.session->getCustomClassSymbolMap().end());
+                std::ranges::sort(customClasses, {}, &decltype(customClasses)::value_type::first);
+                writeCount(customClasses.size());
+                for (const auto &[uid, classSymbol] : customClasses)
+                {
+                    writeString(uid);
+                    writeRef(classSymbol);
+                }
+                writeRef(_module.extension);
+                // 本模块在依赖模块的类中登记的派生类副本，载入时重新登记
+                writeCount(_derivedRecords.size());
+                for (const auto &[baseClass, derivedClass] : _derivedRecords)
+                {
+                    writeRef(baseClass);
+                    writeRef(derivedClass);
+                }
+
+                std::string tables;
+                utils::appendVarint(tables, _strings.size());
+                for (const auto &str : _strings)
+                {
+                    utils::appendBytes(tables, encodeLibPaths(str));
+                }
+                utils::appendVarint(tables, _modulePaths.size());
+                for (const auto &path : _modulePaths)
+                {
+                    utils::appendBytes(tables, encodeLibPaths(path));
+                }
+
+                std::string data(ModuleCache::MAGIC, sizeof(ModuleCache::MAGIC));
+                utils::appendVarint(data, ModuleCache::FORMAT_VERSION);
+                utils::appendBytes(data, RCC_VERSION);
+                utils::appendBytes(data, _module.cacheKey);
+                data.reserve(data.size() + tables.size() + _body.size());
+                data += tables;
+                data += _body;
+                return data;
+            }
+
+        private:
+            const CompiledModule &_module;
+            const ForeignIndex &_foreign;
+            std::unordered_map<const utils::Object *, size_t> _local;
+            std::string _body;
+            std::vector<std::string> _strings;
+            std::unordered_map<std::string, size_t> _stringIds;
+            std::vector<std::string> _modulePaths;
+            std::unordered_map<std::string, size_t> _modulePathIds;
+            std::vector<std::pair<std::shared_ptr<ClassSymbol>, std::shared_ptr<ClassSymbol>>> _derivedRecords;
+
+            void writeCount(const size_t count)
+            {
+                utils::appendVarint(_body, count);
+            }
+
+            void writeBool(const bool value)
+            {
+                _body.push_back(value ? 1 : 0);
+            }
+
+            void writeInt(const int value)
+            {
+                // 标记位可能为 -1，按 zigzag 编码
+                utils::appendVarint(_body, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 31));
+            }
+
+            void writeString(const std::string &str)
+            {
+                const auto [it, inserted] = _stringIds.try_emplace(str, _strings.size());
+                if (inserted)
+                {
+                    _strings.push_back(str);
+                }
+                utils::appendVarint(_body, it->second);
+            }
+
+            void writeRef(const std::shared_ptr<utils::Object> &object)
+            {
+                if (!object)
+                {
+                    utils::appendVarint(_body, NULL_REF);
+                    return;
+                }
+                if (const auto it = _local.find(object.get()); it != _local.end())
+                {
+                    utils::appendVarint(_body, LOCAL_REF);
+                    utils::appendVarint(_body, it->second);
+                    return;
+                }
+                const auto it = _foreign.find(object.get());
+                if (it == _foreign.end())
+                {
+                    throw std::runtime_error("Unresolvable symbol reference: " + object->toString());
+                }
+                const auto &[path, index] = it->second;
+                const auto [pathIt, inserted] = _modulePathIds.try_emplace(path, _modulePaths.size());
+                if (inserted)
+                {
+                    _modulePaths.push_back(path);
+                }
+                utils::appendVarint(_body, pathIt->second + 2);
+                utils::appendVarint(_body, index);
+                if (const auto &classSymbol = std::dynamic_pointer_cast<ClassSymbol>(object))
+                {
+                    recordDerivedClasses(classSymbol);
+                }
+            }
+
+            void recordDerivedClasses(const std::shared_ptr<ClassSymbol> &foreignClass)
+            {
+                if (std::ranges::any_of(_derivedRecords, [&](const auto &record) { return record.first == foreignClass; }))
+                {
+                    return;
+                }
+                for (const auto &derived : foreignClass->getDerivedClasses())
+                {
+                    if (_local.contains(derived.get()))
+                    {
+                        _derivedRecords.emplace_back(foreignClass, derived);
+                    }
+                }
+            }
+
+            void writePos(const utils::Pos &pos)
+            {
+                utils::appendVarint(_body, pos.getLine());
+                utils::appendVarint(_body, pos.getColumn());
+                utils::appendVarint(_body, pos.getOffset());
+                writeString(pos.getFilepath());
+            }
+
+            void writeSymbolHeader(const Symbol &symbol)
+            {
+                writePos(symbol.getPos());
+                writeString(symbol.getVal());
+                writeString(symbol.getRaVal());
+                utils::appendVarint(_body, symbol.getScopeLevel());
+            }
+
+            // 标签按值写入：类型标签只以 uid 引用自定义类
+            void writeLabel(const std::shared_ptr<LabelSymbol> &label)
+            {
+                writeBool(label != nullptr);
+                if (!label)
+                {
+                    return;
+                }
+                writeBool(std::dynamic_pointer_cast<TypeLabelSymbol>(label) != nullptr);
+                writeSymbolHeader(*label);
+                utils::appendVarint(_body, static_cast<uint64_t>(label->getLabelType()));
+                const auto &labelDesS = label->getLabelDesS();
+                writeCount(labelDesS.size());
+                for (const auto &labelDes : labelDesS)
+                {
+                    writeCount(labelDes.size());
+                    for (const auto &des : labelDes)
+                    {
+                        writeLabel(des);
+                    }
+                }
+            }
+
+            void writeLabels(const std::unordered_set<std::shared_ptr<LabelSymbol>> &labels)
+            {
+                writeCount(labels.size());
+                for (const auto &label : sortedLabels(labels))
+                {
+                    writeLabel(label);
+                }
+            }
+
+            void writeLabelMarks(const LabelMarkManager &marks)
+            {
+                const auto &permission = marks.getPermissionLabelMark();
+                writeInt(permission.has_value() ? static_cast<int>(permission.value()) : -1);
+                writeInt(marks.getObjectOrientedLabelMarks());
+                writeInt(marks.getLifeCycleLabelMarks());
+                writeInt(marks.getRestrictionLabelMarks());
+                const auto &typeLabelMarks = marks.getTypeLabelMarks();
+                std::vector<std::string> sortedMarks(typeLabelMarks.begin(), typeLabelMarks.end());
+                std::ranges::sort(sortedMarks);
+                writeCount(sortedMarks.size());
+                for (const auto &mark : sortedMarks)
+                {
+                    writeString(mark);
+                }
+            }
+
+            void writeParameterFields(const ParameterSymbol &param)
+            {
+                writeSymbolHeader(param);
+                utils::appendVarint(_body, static_cast<uint64_t>(param.getParamType()));
+                writeLabels(param.getLabels());
+                writeLabelMarks(param.getLabelMarkManager());
+                writeLabel(param.getTypeLabel());
+                writeLabel(param.getValueType());
+                const auto &defaultValue = param.getDefaultValue();
+                writeBool(defaultValue.has_value());
+                if (defaultValue.has_value())
+                {
+                    writeString(defaultValue.value());
+                }
+            }
+
+            void writeObject(const std::shared_ptr<utils::Object> &object)
+            {
+                if (const auto &table = std::dynamic_pointer_cast<SymbolTable>(object))
+                {
+                    _body.push_back(static_cast<char>(ObjectTag::SYMBOL_TABLE));
+                    const auto &nameIndex = table->getNameIndex();
+                    const auto &sysDefinedRecord = table->getSysDefinedRecord();
+                    writeCount(nameIndex.size());
+                    for (const auto &key : nameIndex)
+                    {
+                        const auto &symbol = table->find(key);
+                        // 符号表以名称或 RA 标识符为键
+                        const bool byRid = key != symbol->getVal();
+                        if (byRid && key != symbol->getRaVal())
+                        {
+                            throw std::runtime_error("Unsupported symbol table key: " + key);
+                        }
+                        writeBool(byRid);
+                        writeBool(sysDefinedRecord.contains(symbol->getRaVal()));
+                        writeRef(symbol);
+                    }
+                    return;
+                }
+                const auto &symbol = std::dynamic_pointer_cast<Symbol>(object);
+                if (!symbol)
+                {
+                    throw std::runtime_error("Unsupported cached object: " + object->toString());
+                }
+                switch (symbol->getType())
+                {
+                case SymbolType::VARIABLE:
+                    {
+                        const auto &varSymbol = std::dynamic_pointer_cast<VariableSymbol>(symbol);
+                        if (!varSymbol)
+                        {
+                            throw std::runtime_error("Unsupported variable symbol: " + symbol->toString());
+                        }
+                        _body.push_back(static_cast<char>(ObjectTag::VARIABLE));
+                        writeParameterFields(*varSymbol);
+                        writeRef(varSymbol->getClassSymbol());
+                        writeRef(varSymbol->getReferencedSymbol());
+                    } break;
+                case SymbolType::PARAMETER:
+                    {
+                        _body.push_back(static_cast<char>(ObjectTag::PARAMETER));
+                        writeParameterFields(*std::static_pointer_cast<ParameterSymbol>(symbol));
+                    } break;
+                case SymbolType::FUNCTION:
+                    {
+                        const auto &funcSymbol = std::static_pointer_cast<FunctionSymbol>(symbol);
+                        _body.push_back(static_cast<char>(ObjectTag::FUNCTION));
+                        writeSymbolHeader(*funcSymbol);
+                        writeLabels(funcSymbol->getLabels());
+                        writeLabelMarks(funcSymbol->getLabelMarkManager());
+                        const auto &parameters = funcSymbol->getParameters();
+                        writeCount(parameters.size());
+                        for (const auto &param : parameters)
+                        {
+                            if (param->getType() != SymbolType::PARAMETER)
+                            {
+                                throw std::runtime_error("Unsupported parameter symbol: " + param->toString());
+                            }
+                            writeParameterFields(*param);
+                        }
+                        writeLabel(funcSymbol->getSignature());
+                        writeLabel(funcSymbol->getReturnType());
+                        writeBool(funcSymbol->hasReturned());
+                        utils::appendVarint(_body, static_cast<uint64_t>(funcSymbol->getBuiltInType()));
+                        utils::appendVarint(_body, static_cast<uint64_t>(funcSymbol->getFunctionType()));
+                        writeRef(funcSymbol->getClassSymbol());
+                    } break;
+                case SymbolType::CLASS:
+                    {
+                        const auto &classSymbol = std::static_pointer_cast<ClassSymbol>(symbol);
+                        _body.push_back(static_cast<char>(ObjectTag::CLASS));
+                        writeSymbolHeader(*classSymbol);
+                        writeLabelMarks(classSymbol->getLabelMarkManager());
+                        writeBool(classSymbol->hasCollectionFinished());
+                        utils::appendVarint(_body, static_cast<uint64_t>(classSymbol->getVisitPermission()));
+                        writeCount(classSymbol->getBaseClasses().size());
+                        for (const auto &baseClass : classSymbol->getBaseClasses())
+                        {
+                            writeRef(baseClass);
+                        }
+                        writeCount(classSymbol->getDerivedClasses().size());
+                        for (const auto &derivedClass : classSymbol->getDerivedClasses())
+                        {
+                            writeRef(derivedClass);
+                        }
+                        writeRef(classSymbol->getMembers());
+                        writeRef(classSymbol->getStaticMembers());
+                        writeRef(classSymbol->getConstructors());
+                    } break;
+                case SymbolType::LABEL:
+                    {
+                        _body.push_back(static_cast<char>(ObjectTag::LABEL));
+                        writeLabel(std::static_pointer_cast<LabelSymbol>(symbol));
+                    } break;
+                default:
+                    throw std::runtime_error("Unsupported cached symbol: " + symbol->toString());
+                }
+            }
+        };
+
+        // 两遍还原：先按顺序构造全部对象，再连接对象之间的引用；连接在对象全部构造后进行，引用可以成环
+        class ModuleReader {
+        public:
+            ModuleReader(const std::string_view data, CompilationSession &session)
+                : _data(data), _session(session) {}
+
+            // 读取并校验文件头，任一字段不一致时返回 false
+            bool readHeader(const std::string &cacheKey)
+            {
+                if (_data.size() < sizeof(ModuleCache::MAGIC) ||
+                    std::memcmp(_data.data(), ModuleCache::MAGIC, sizeof(ModuleCache::MAGIC)) != 0)
+                {
+                    return false;
+                }
+                _pos = sizeof(ModuleCache::MAGIC);
+                return readVarint() == ModuleCache::FORMAT_VERSION && readBytes() == RCC_VERSION &&
+                    readBytes() == cacheKey;
+            }
+
+            std::shared_ptr<CompiledModule> readModule(const std::string &filepath)
+            {
+                const auto stringCount = readCount();
+                _strings.reserve(stringCount);
+                for (size_t i = 0; i < stringCount; i++)
+                {
+                    _strings.push_back(decodeLibPaths(readBytes()));
+                }
+                const auto pathCount = readCount();
+                for (size_t i = 0; i < pathCount; i++)
+                {
+                    const auto &dependency = _session.getModuleRegistry().find(decodeLibPaths(readBytes()));
+                    if (!dependency)
+                    {
+                        throw std::runtime_error("Cached module depends on an unpublished module.");
+                    }
+                    _modules.push_back(dependency);
+                }
+
+                auto module = std::make_shared<CompiledModule>();
+                module->filepath = filepath;
+                module->raCode = decodeLibPaths(readBytes());
+                const auto dependencyCount = readCount();
+                for (size_t i = 0; i < dependencyCount; i++)
+                {
+                    module->dependencies.push_back(readString());
+                    if (!_session.getModuleRegistry().find(module->dependencies.back()))
+                    {
+                        throw std::runtime_error("Cached module depends on an unpublished module.");
+                    }
+                }
+                auto &stats = _session.getOptimizeStats();
+                for (auto *value : {&stats.inputRecords, &stats.outputRecords, &stats.unreachable,
+                                    &stats.redundantJumps, &stats.forwarded, &stats.folded, &stats.propagated,
+                                    &stats.deadStores, &stats.annotations, &stats.shaken, &stats.inlined,
+                                    &stats.reusedSlots, &stats.releasedSlots})
+                {
+                    *value = readVarint();
+                }
+                // 类型标签的 RA 标识符取决于自定义类型表，构造符号之前先还原类型名
+                const auto customTypeCount = readCount();
+                for (size_t i = 0; i < customTypeCount; i++)
+                {
+                    auto uid = readString();
+                    _session.getCustomTypeMap()[uid] = readString();
+                }
+
+                const auto objectCount = readCount();
+                _objects.reserve(objectCount);
+                for (size_t i = 0; i < objectCount; i++)
+                {
+                    _objects.push_back(readObject());
+                }
+                for (const auto &link : _links)
+                {
+                    link();
+                }
+
+                const auto customClassCount = readCount();
+                for (size_t i = 0; i < customClassCount; i++)
+                {
+                    auto uid = readString();
+                    _session.getCustomClassSymbolMap()[uid] = resolveAs<ClassSymbol>(readRef());
+                }
+                module->extension = resolveAs<ClassSymbol>(readRef());
+                if (!module->extension)
+                {
+                    corrupt("missing extension");
+                }
+                std::vector<std::pair<std::shared_ptr<ClassSymbol>, std::shared_ptr<ClassSymbol>>> derivedRecords;
+                const auto derivedCount = readCount();
+                for (size_t i = 0; i < derivedCount; i++)
+                {
+                    auto baseClass = resolveAs<ClassSymbol>(readRef());
+                    derivedRecords.emplace_back(std::move(baseClass), resolveAs<ClassSymbol>(readRef()));
+                }
+                if (_pos != _data.size())
+                {
+                    corrupt("trailing bytes");
+                }
+                // 依赖模块的类是共享对象，数据全部校验通过后才登记派生类
+                for (const auto &[baseClass, derivedClass] : derivedRecords)
+                {
+                    if (baseClass && derivedClass)
+                    {
+                        baseClass->_addDerivedClass(derivedClass);
+                    }
+                }
+                module->symbolIndex = std::move(_objects);
+                return module;
+            }
+
+        private:
+            struct Ref {
+                uint64_t module = NULL_REF;
+                uint64_t index = 0;
+            };
+
+            std::string_view _data;
+            size_t _pos = 0;
+            CompilationSession &_session;
+            std::vector<std::string> _strings;
+            std::vector<std::shared_ptr<const CompiledModule>> _modules;
+            std::vector<std::shared_ptr<utils::Object>> _objects;
+            std::vector<std::function<void()>> _links;
+
+            [[noreturn]] static void corrupt(const std::string &reason)
+            {
+                throw std::runtime_error("Corrupted module cache: " + reason);
+            }
+
+            uint8_t readByte()
+            {
+                if (_pos >= _data.size())
+                {
+                    corrupt("unexpected end of data");
+                }
+                return static_cast<uint8_t>(_data[_pos++]);
+            }
+
+            uint64_t readVarint()
+            {
+                uint64_t value = 0;
+                if (!utils::readVarint(_data, _pos, value))
+                {
+                    corrupt("invalid varint");
+                }
+                return value;
+            }
+
+            size_t readCount()
+            {
+                const auto count = readVarint();
+                if (count > _data.size())
+                {
+                    corrupt("invalid count");
+                }
+                return count;
+            }
+
+            bool readBool()
+            {
+                return readByte() != 0;
+            }
+
+            int readInt()
+            {
+                const auto value = readVarint();
+                return static_cast<int>(static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1));
+            }
+
+            std::string readBytes()
+            {
+                std::string_view bytes;
+                if (!utils::readBytes(_data, _pos, bytes))
+                {
+                    corrupt("unexpected end of data");
+                }
+                return std::string(bytes);
+            }
+
+            const std::string &readString()
+            {
+                const auto index = readVarint();
+                if (index >= _strings.size())
+                {
+                    corrupt("invalid string index");
+                }
+                return _strings[index];
+            }
+
+            Ref readRef()
+            {
+                Ref ref;
+                ref.module = readVarint();
+                if (ref.module != NULL_REF)
+                {
+                    ref.index = readVarint();
+                }
+                return ref;
+            }
+
+            std::shared_ptr<utils::Object> resolve(const Ref &ref) const
+            {
+                if (ref.module == NULL_REF)
+                {
+                    return nullptr;
+                }
+                const auto &objects = ref.module == LOCAL_REF ? _objects
+                    : ref.module - 2 < _modules.size() ? _modules[ref.module - 2]->symbolIndex
+                    : (corrupt("invalid module reference"), _objects);
+                if (ref.index >= objects.size())
+                {
+                    corrupt("invalid object reference");
+                }
+                return objects[ref.index];
+            }
+
+            template <typename T>
+            std::shared_ptr<T> resolveAs(const Ref &ref) const
+            {
+                const auto &object = resolve(ref);
+                const auto &result = std::dynamic_pointer_cast<T>(object);
+                if (object && !result)
+                {
+                    corrupt("object type mismatch");
+                }
+                return result;
+            }
+
+            utils::Pos readPos()
+            {
+                const auto line = readVarint();
+                const auto column = readVarint();
+                const auto offset = readVarint();
+                return {line, column, offset, readString()};
+            }
+
+            struct SymbolHeader {
+                utils::Pos pos;
+                std::string value;
+                std::string raValue;
+                size_t scopeLevel;
+            };
+
+            SymbolHeader readSymbolHeader()
+            {
+                SymbolHeader header;
+                header.pos = readPos();
+                header.value = readString();
+                header.raValue = readString();
+                header.scopeLevel = readVarint();
+                return header;
+            }
+
+            std::shared_ptr<LabelSymbol> readLabel()
+            {
+                if (!readBool())
+                {
+                    return nullptr;
+                }
+                const bool isTypeLabel = readBool();
+                const auto header = readSymbolHeader();
+                const auto labelType = static_cast<LabelType>(readVarint());
+                const std::shared_ptr<LabelSymbol> label = isTypeLabel
+                    ? std::make_shared<TypeLabelSymbol>(header.pos, header.value, header.scopeLevel, header.raValue)
+                    : std::make_shared<LabelSymbol>(header.pos, header.value, header.raValue, header.scopeLevel, labelType);
+                if (label->getRaVal() != header.raValue || label->getLabelType() != labelType)
+                {
+                    corrupt("label mismatch: " + header.value);
+                }
+                const auto labelDesCount = readCount();
+                for (size_t i = 0; i < labelDesCount; i++)
+                {
+                    LabelSymbol::LabelDes labelDes;
+                    const auto desCount = readCount();
+                    for (size_t j = 0; j < desCount; j++)
+                    {
+                        labelDes.push_back(readLabel());
+                    }
+                    label->appendLabelDes(labelDes);
+                }
+                return label;
+            }
+
+            std::shared_ptr<TypeLabelSymbol> readTypeLabel()
+            {
+                const auto &label = readLabel();
+                const auto &typeLabel = std::dynamic_pointer_cast<TypeLabelSymbol>(label);
+                if (label && !typeLabel)
+                {
+                    corrupt("type label expected");
+                }
+                return typeLabel;
+            }
+
+            std::unordered_set<std::shared_ptr<LabelSymbol>> readLabels()
+            {
+                std::unordered_set<std::shared_ptr<LabelSymbol>> labels;
+                const auto count = readCount();
+                for (size_t i = 0; i < count; i++)
+                {
+                    labels.insert(readLabel());
+                }
+                return labels;
+            }
+
+            LabelMarkManager readLabelMarks()
+            {
+                const auto permission = readInt();
+                const auto objectOriented = readInt();
+                const auto lifeCycle = readInt();
+                const auto restriction = readInt();
+                std::unordered_set<std::string> typeLabelMarks;
+                const auto count = readCount();
+                for (size_t i = 0; i < count; i++)
+                {
+                    typeLabelMarks.insert(readString());
+                }
+                return {permission, objectOriented, lifeCycle, restriction, std::move(typeLabelMarks)};
+            }
+
+            struct ParameterFields {
+                SymbolHeader header;
+                ParamType paramType;
+                std::unordered_set<std::shared_ptr<LabelSymbol>> labels;
+                LabelMarkManager labelMarks;
+                std::shared_ptr<TypeLabelSymbol> typeLabel;
+                std::shared_ptr<TypeLabelSymbol> valueType;
+                std::optional<std::string> defaultValue;
+            };
+
+            ParameterFields readParameterFields()
+            {
+                ParameterFields fields;
+                fields.header = readSymbolHeader();
+                fields.paramType = static_cast<ParamType>(readVarint());
+                fields.labels = readLabels();
+                fields.labelMarks = readLabelMarks();
+                fields.typeLabel = readTypeLabel();
+                fields.valueType = readTypeLabel();
+                if (readBool())
+                {
+                    fields.defaultValue = readString();
+                }
+                return fields;
+            }
+
+            // 构造函数会按标签推导类型标签与标签标记，构造后以缓存中的值覆盖
+            static void restoreParameterFields(ParameterSymbol &param, const ParameterFields &fields)
+            {
+                param.getLabelMarkManager() = fields.labelMarks;
+                param.setTypeLabel(fields.typeLabel);
+                param.setDefaultValue(fields.defaultValue);
+            }
+
+            std::shared_ptr<ParameterSymbol> readParameter()
+            {
+                const auto &fields = readParameterFields();
+                const auto &param = std::make_shared<ParameterSymbol>(
+                    fields.paramType, fields.header.pos, fields.header.value, fields.header.raValue, fields.labels,
+                    fields.defaultValue, fields.header.scopeLevel, SymbolType::PARAMETER, fields.valueType);
+                restoreParameterFields(*param, fields);
+                if (param->getParamType() != fields.paramType)
+                {
+                    corrupt("parameter mismatch: " + fields.header.value);
+                }
+                return param;
+            }
+
+            std::shared_ptr<utils::Object> readObject()
+            {
+                switch (static_cast<ObjectTag>(readByte()))
+                {
+                case ObjectTag::SYMBOL_TABLE:
+                    {
+                        const auto &table = std::make_shared<SymbolTable>();
+                        const auto count = readCount();
+                        std::vector<std::tuple<bool, bool, Ref>> entries;
+                        entries.reserve(count);
+                        for (size_t i = 0; i < count; i++)
+                        {
+                            const auto byRid = readBool();
+                            const auto sysDefined = readBool();
+                            entries.emplace_back(byRid, sysDefined, readRef());
+                        }
+                        _links.emplace_back([this, table, entries = std::move(entries)] {
+                            for (const auto &[byRid, sysDefined, ref] : entries)
+                            {
+                                const auto &symbol = resolveAs<Symbol>(ref);
+                                if (!symbol)
+                                {
+                                    corrupt("null symbol table entry");
+                                }
+                                byRid ? table->insertByRID(symbol, sysDefined) : table->insertByName(symbol, sysDefined);
+                            }
+                        });
+                        return table;
+                    }
+                case ObjectTag::VARIABLE:
+                    {
+                        const auto &fields = readParameterFields();
+                        const auto &varSymbol = std::make_shared<VariableSymbol>(
+                            fields.header.pos, fields.header.value, fields.header.raValue, fields.labels,
+                            fields.header.scopeLevel, false, fields.valueType);
+                        restoreParameterFields(*varSymbol, fields);
+                        const auto classRef = readRef();
+                        const auto referencedRef = readRef();
+                        _links.emplace_back([this, varSymbol, classRef, referencedRef] {
+                            varSymbol->setClassSymbol(resolveAs<ClassSymbol>(classRef));
+                            varSymbol->setReferencedSymbol(resolveAs<Symbol>(referencedRef));
+                        });
+                        return varSymbol;
+                    }
+                case ObjectTag::PARAMETER:
+                    return readParameter();
+                case ObjectTag::FUNCTION:
+                    {
+                        const auto header = readSymbolHeader();
+                        const auto &labels = readLabels();
+                        auto labelMarks = readLabelMarks();
+                        std::vector<std::shared_ptr<ParameterSymbol>> parameters;
+                        const auto paramCount = readCount();
+                        for (size_t i = 0; i < paramCount; i++)
+                        {
+                            parameters.push_back(readParameter());
+                        }
+                        const auto &signature = readTypeLabel();
+                        const auto &returnType = readTypeLabel();
+                        const auto hasReturned = readBool();
+                        const auto builtinType = static_cast<TypeOfBuiltin>(readVarint());
+                        const auto functionType = static_cast<FunctionType>(readVarint());
+                        const auto &funcSymbol = std::make_shared<FunctionSymbol>(
+                            nullptr, header.pos, header.value, header.raValue, labels, parameters, signature,
+                            header.scopeLevel, builtinType, functionType);
+                        funcSymbol->getLabelMarkManager() = std::move(labelMarks);
+                        funcSymbol->reSetReturnType(returnType);
+                        funcSymbol->setHasReturned(hasReturned);
+                        const auto classRef = readRef();
+                        _links.emplace_back([this, funcSymbol, classRef] {
+                            funcSymbol->setClassSymbol(resolveAs<ClassSymbol>(classRef));
+                        });
+                        return funcSymbol;
+                    }
+                case ObjectTag::CLASS:
+                    {
+                        const auto header = readSymbolHeader();
+                        auto labelMarks = readLabelMarks();
+                        const auto collectionFinished = readBool();
+                        const auto visitPermission = static_cast<PermissionLabel>(readVarint());
+                        const auto &classSymbol = std::make_shared<ClassSymbol>(
+                            header.pos, header.value, header.raValue, std::move(labelMarks), header.scopeLevel,
+                            std::vector<std::shared_ptr<ClassSymbol>>{}, std::vector<std::shared_ptr<ClassSymbol>>{},
+                            nullptr, nullptr, collectionFinished, visitPermission);
+                        std::vector<Ref> baseRefs(readCount());
+                        for (auto &ref : baseRefs)
+                        {
+                            ref = readRef();
+                        }
+                        std::vector<Ref> derivedRefs(readCount());
+                        for (auto &ref : derivedRefs)
+                        {
+                            ref = readRef();
+                        }
+                        const auto membersRef = readRef();
+                        const auto staticMembersRef = readRef();
+                        const auto constructorsRef = readRef();
+                        _links.emplace_back([=, this] {
+                            for (const auto &ref : baseRefs)
+                            {
+                                classSymbol->getBaseClasses().push_back(resolveAs<ClassSymbol>(ref));
+                            }
+                            for (const auto &ref : derivedRefs)
+                            {
+                                classSymbol->getDerivedClasses().push_back(resolveAs<ClassSymbol>(ref));
+                            }
+                            classSymbol->getMembers() = resolveAs<SymbolTable>(membersRef);
+                            classSymbol->getStaticMembers() = resolveAs<SymbolTable>(staticMembersRef);
+                            classSymbol->getConstructors() = resolveAs<SymbolTable>(constructorsRef);
+                        });
+                        return classSymbol;
+                    }
+                case ObjectTag::LABEL:
+                    {
+                        const auto &label = readLabel();
+                        if (!label)
+                        {
+                            corrupt("null label object");
+                        }
+                        return label;
+                    }
+                default:
+                    corrupt("unknown object tag");
+                }
+            }
+        };
+    }
+
+    std::string ModuleCache::computeKey(CompilationSession& importer, const std::string& filepath)
+    {
+        if (CompileVisitor::__compile_flag_no_module_cache__)
+        {
+            return "";
+        }
+        try
+        {
+            const auto &modulePath = normalizeModulePath(filepath);
+            auto &moduleGraph = importer.getModuleGraph();
+            if (!moduleGraph.hasParsed(modulePath))
+            {
+                return "";
+            }
+            const utils::MappedFile source(modulePath);
+            std::string keySource;
+            utils::appendBytes(keySource, RCC_VERSION);
+            utils::appendBytes(keySource, base::RCC_BUILD_ID);
+            utils::appendVarint(keySource, FORMAT_VERSION);
+            utils::appendVarint(keySource, static_cast<uint64_t>(CompileVisitor::__compile_option_compile_level__));
+            utils::appendVarint(keySource, static_cast<uint64_t>(std::max(CompileVisitor::__compile_option_inline_threshold__, 0)));
+            utils::appendBytes(keySource, CompilationSession::getModuleKey(modulePath));
+            utils::appendVarint(keySource, utils::hashToCode(source.view()));
+            for (const auto &dependency : moduleGraph.getImports(modulePath))
+            {
+                const auto &module = importer.getModuleRegistry().find(dependency);
+                if (!module || module->cacheKey.empty())
+                {
+                    return "";
+                }
+                utils::appendBytes(keySource, module->cacheKey);
+            }
+            char buffer[17];
+            std::snprintf(buffer, sizeof(buffer), "%016llx",
+                          static_cast<unsigned long long>(utils::hashToCode(keySource)));
+            return buffer;
+        } catch (...)
+        {
+            return "";
+        }
+    }
+
+    std::string ModuleCache::getCachePath(const std::string& cacheKey)
+    {
+        return (std::filesystem::path(utils::getCacheDir()) / "modules" / (cacheKey + ".rmod")).string();
+    }
+
+    void ModuleCache::indexSymbols(CompiledModule& module)
+    {
+        try
+        {
+            const auto &foreign = collectForeignIndex(module);
+            module.symbolIndex = SymbolCollector(module, foreign).collect();
+        } catch (...)
+        {
+            module.symbolIndex.clear();
+            module.cacheKey.clear();
+        }
+    }
+
+    std::shared_ptr<CompiledModule> ModuleCache::load(CompilationSession& importer, const std::string& filepath,
+                                                      const std::string& cacheKey)
+    {
+        try
+        {
+            // 内置扩展优先取自嵌入的快照，其余模块取自缓存目录
+            if (const auto &data = BuiltinSnapshot::find(cacheKey); !data.empty())
+            {
+                return restore(importer, filepath, cacheKey, data);
+            }
+            const auto cachePath = getCachePath(cacheKey);
+            if (!std::filesystem::is_regular_file(cachePath) || std::filesystem::file_size(cachePath) == 0)
+            {
+                return nullptr;
+            }
+            const utils::MappedFile cacheFile(cachePath);
+            return restore(importer, filepath, cacheKey, cacheFile.view());
+        } catch (...)
+        {
+            return nullptr;
+        }
+    }
+
+    std::shared_ptr<CompiledModule> ModuleCache::restore(CompilationSession& importer, const std::string& filepath,
+                                                         const std::string& cacheKey, const std::string_view data)
+    {
+        const auto &modulePath = normalizeModulePath(filepath);
+        const auto &session = importer.createModuleSession(modulePath);
+        CompilationSession::Activation activation(*session);
+        ModuleReader reader(data, *session);
+        if (!reader.readHeader(cacheKey))
+        {
+            return nullptr;
+        }
+        const auto &module = reader.readModule(modulePath);
+        module->session = session;
+        module->cacheKey = cacheKey;
+        return module;
+    }
+
+    std::string ModuleCache::serialize(const CompiledModule& module)
+    {
+        // 缓存键只覆盖预解析记录的顶层导入，编译中出现其他导入的模块不缓存
+        const auto &imports = module.session->getModuleGraph().getImports(module.filepath);
+        for (const auto &dependency : module.dependencies)
+        {
+            if (std::ranges::find(imports, dependency) == imports.end())
+            {
+                throw std::runtime_error("Module imports an extension outside of its import graph: " + dependency);
+            }
+        }
+        const auto &foreign = collectForeignIndex(module);
+        return ModuleWriter(module, foreign).finish();
+    }
+
+    void ModuleCache::store(const CompiledModule& module)
+    {
+        try
+        {
+            const auto data = serialize(module);
+            const std::filesystem::path cachePath = getCachePath(module.cacheKey);
+            std::filesystem::create_directories(cachePath.parent_path());
+            // 先写各自独有的临时文件再整体替换，并发的编译进程与线程不会读到写了一半或被交错写入的缓存
+            auto tempPath = cachePath;
+            tempPath += makeTempSuffix();
+            {
+                std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+                out.write(data.data(), static_cast<std::streamsize>(data.size()));
+                if (!out)
+                {
+                    out.close();
+                    std::filesystem::remove(tempPath);
+                    return;
+                }
+            }
+            std::error_code errorCode;
+            std::filesystem::rename(tempPath, cachePath, errorCode);
+            if (errorCode)
+            {
+                std::filesystem::remove(tempPath, errorCode);
+            }
+        } catch (...) {}
+    }
+}
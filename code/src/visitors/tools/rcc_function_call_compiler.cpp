@@ -2,8 +2,11 @@
 // Created by RestRegular on 2025/10/1.
 //
 
+#include <algorithm>
 #include <queue>
+#include <ranges>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <string>
 
@@ -34,8 +37,8 @@ namespace ast
         classifyFuncArgs(node, posArgs, namedArgs, orderedArgs);
 
         // 备份 posArgs 和 namedArgs，用于后面填充 callInfos
-        const auto posArgsCopied = posArgs;
-        const auto namedArgsCopied = namedArgs;
+        auto posArgsCopied = posArgs;
+        auto namedArgsCopied = namedArgs;
 
         // 将 orderedArgs 转为 originalArgs / halfProcessedArgs
         prepareOrderedArgs(orderedArgs, originalArgs, halfProcessedArgs);
@@ -81,8 +84,8 @@ namespace ast
 
         // 组装 builtin::CallInfos 供 builtin 调用使用（与原代码保持一致）
         const builtin::CallInfos& callInfos{
-            fullProcessedArgs, originalArgs, posArgsCopied,
-            namedArgsCopied, node.getPos(), orderedArgs,
+            std::move(fullProcessedArgs), std::move(originalArgs), std::move(posArgsCopied),
+            std::move(namedArgsCopied), node.getPos(), std::move(orderedArgs),
             std::make_shared<FunctionCallNode>(node)
         };
 
@@ -179,15 +182,15 @@ namespace ast
                 else
                 {
                     const auto& typeLabel = varSymbol->getTypeLabel();
-                    if (typeLabel->is("func"))
+                    if (typeLabel->is(BuiltinTypeLabel::FUNC))
                     {
                         handleFuncTypeLabel(varSymbol, typeLabel, funcSymbol);
                     }
-                    else if (typeLabel->is("funi"))
+                    else if (typeLabel->is(BuiltinTypeLabel::FUNI))
                     {
                         handleFuniTypeLabel(varSymbol, typeLabel, funcSymbol);
                     }
-                    else if (typeLabel->is("any"))
+                    else if (typeLabel->is(BuiltinTypeLabel::ANY))
                     {
                         pass();
                     }
@@ -411,18 +414,18 @@ namespace ast
                                                         funcNameOpItem.toString(), "", {});
         }
         else if (const auto& funcType = getTypeLabelFromSymbol(funcNameSymbol);
-            funcType->is("func"))
+            funcType->is(BuiltinTypeLabel::FUNC))
         {
             // 当被调用对象本身是 func 类型（类型标签函数），直接 CALL
             raCodeBuilder << ri::CALL(funcNameSymbol->getRaVal(), halfProcessedArgs);
         }
-        else if (funcType->is("funi"))
+        else if (funcType->is(BuiltinTypeLabel::FUNI))
         {
             // funi 类型，调用并推入临时以获得返回值
             pushTemOpVarItemWithRecord(node.getPos(), getBuiltinTypeSymbol(getUnknownPos(), BuiltinType::B_ANY));
             raCodeBuilder << ri::IVOK(funcNameSymbol->getRaVal(), halfProcessedArgs, topOpRaVal());
         }
-        else if (funcType->is("any"))
+        else if (funcType->is(BuiltinTypeLabel::ANY))
         {
             throw RCCCompilerError::typeMissmatchError(node.getPos().toString(), getCodeLine(node.getPos()),
                                                        "It is not clear whether the called function has a return value.",
@@ -442,8 +445,89 @@ namespace ast
         }
     }
 
+    // ---------- helper: 调用点解析缓存 ----------
+    CallSiteCacheEntry& CompileVisitor::getCallSiteCacheEntry(const std::shared_ptr<FunctionSymbol>& funcSymbol)
+    {
+        const auto& [it, inserted] = callSiteCache.try_emplace(funcSymbol.get());
+        if (inserted)
+        {
+            auto& entry = it->second;
+            entry.callee = funcSymbol;
+            entry.params = funcSymbol->getParameters();
+            if (funcSymbol->is(TypeOfBuiltin::BUILTIN) || funcSymbol->is(TypeOfBuiltin::PURE_BUILTIN))
+            {
+                entry.dispatch = builtin::findBuiltinDispatch(funcSymbol->getVal());
+            }
+        }
+        return it->second;
+    }
+
+    // 按 processParameters 的取值规则推导每个形参的来源：同名命名参数优先，其次是下一个位置参数，再次是默认值
+    const CallBindingPlan& CompileVisitor::getCallBindingPlan(CallSiteCacheEntry& entry, const size_t posArgCount,
+                                                              const std::unordered_map<std::string, OpItem>& namedArgs)
+    {
+        std::vector<std::string> namedArgKeys{};
+        namedArgKeys.reserve(namedArgs.size());
+        for (const auto& name : namedArgs | std::views::keys)
+        {
+            namedArgKeys.push_back(name);
+        }
+        std::ranges::sort(namedArgKeys);
+        for (const auto& plan : entry.plans)
+        {
+            if (plan.posArgCount == posArgCount && plan.namedArgKeys == namedArgKeys)
+            {
+                return plan;
+            }
+        }
+
+        CallBindingPlan plan{posArgCount, std::move(namedArgKeys), {}};
+        plan.bindings.reserve(entry.params.size());
+        std::unordered_set<std::string_view> remainingKeys(plan.namedArgKeys.begin(), plan.namedArgKeys.end());
+        size_t remainingPosArgs = posArgCount;
+        for (const auto& param : entry.params)
+        {
+            switch (param->getParamType())
+            {
+            case ParamType::PARAM_POSITIONAL:
+            case ParamType::PARAM_KEYWORD:
+                if (remainingKeys.erase(param->getVal()) > 0)
+                {
+                    plan.bindings.push_back(CallBindingPlan::Binding::NAMED);
+                }
+                else if (remainingPosArgs > 0)
+                {
+                    plan.bindings.push_back(CallBindingPlan::Binding::POSITIONAL);
+                    remainingPosArgs--;
+                }
+                else if (param->getDefaultValue().has_value())
+                {
+                    plan.bindings.push_back(CallBindingPlan::Binding::DEFAULT);
+                }
+                else
+                {
+                    plan.bindings.push_back(CallBindingPlan::Binding::MISSING);
+                }
+                break;
+            case ParamType::PARAM_VAR_LEN_POSITIONAL:
+                plan.bindings.push_back(CallBindingPlan::Binding::VAR_LEN_POSITIONAL);
+                remainingPosArgs = 0;
+                break;
+            case ParamType::PARAM_VAR_LEN_KEYWORD:
+                // 打包时只读取剩余的命名参数，不将其移除
+                plan.bindings.push_back(CallBindingPlan::Binding::VAR_LEN_KEYWORD);
+                break;
+            default:
+                plan.bindings.push_back(CallBindingPlan::Binding::NONE);
+                break;
+            }
+        }
+        return entry.plans.emplace_back(std::move(plan));
+    }
+
     // ---------- helper: 处理函数参数（负责完整填充 fullProcessedArgs） ----------
     // 该方法基本为原函数中遍历 parameters 的内容，逻辑未改变，仅抽成方法。
+    // 各形参的取值来源取自调用点缓存中的绑定方案，位置参数的类型检查仍逐次进行。
     void CompileVisitor::processParameters(const std::shared_ptr<FunctionSymbol>& funcSymbol,
                                            std::queue<OpItem>& posArgs,
                                            std::unordered_map<std::string, OpItem>& namedArgs,
@@ -451,19 +535,21 @@ namespace ast
                                            std::vector<std::string>& fullProcessedArgs,
                                            const Pos& callPos)
     {
-        for (const auto& parameters = funcSymbol->getParameters();
-             const auto& param : parameters)
+        auto& entry = getCallSiteCacheEntry(funcSymbol);
+        const auto& plan = getCallBindingPlan(entry, posArgs.size(), namedArgs);
+        for (size_t paramIndex = 0; paramIndex < entry.params.size(); paramIndex++)
         {
-            if (param->getParamType() == ParamType::PARAM_POSITIONAL || param->getParamType() ==
-                ParamType::PARAM_KEYWORD)
+            const auto& param = entry.params[paramIndex];
+            switch (plan.bindings[paramIndex])
             {
-                if (const auto& it = namedArgs.find(param->getVal());
-                    it != namedArgs.end())
+            case CallBindingPlan::Binding::NAMED:
                 {
+                    const auto& it = namedArgs.find(param->getVal());
                     fullProcessedArgs.push_back(it->second.getRaVal(symbolTable));
                     namedArgs.erase(it);
                 }
-                else if (!posArgs.empty())
+                break;
+            case CallBindingPlan::Binding::POSITIONAL:
                 {
                     if (!checkTypeMatch(param, posArgs.front()))
                     {
@@ -496,11 +582,11 @@ namespace ast
                     fullProcessedArgs.push_back(posArgs.front().getRaVal(symbolTable));
                     posArgs.pop();
                 }
-                else if (param->getDefaultValue().has_value())
-                {
-                    fullProcessedArgs.push_back(param->getDefaultValue().value());
-                }
-                else
+                break;
+            case CallBindingPlan::Binding::DEFAULT:
+                fullProcessedArgs.push_back(param->getDefaultValue().value());
+                break;
+            case CallBindingPlan::Binding::MISSING:
                 {
                     // 参数缺失，抛出与原实现一致的 argumentError
                     throw RCCCompilerError::argumentError(callPos.toString(), getCodeLine(callPos),
@@ -532,138 +618,143 @@ namespace ast
                                                               "Please ensure that the number of parameters passed in when calling the function matches."
                                                           });
                 }
-            }
-            else if (param->getParamType() == ParamType::PARAM_VAR_LEN_POSITIONAL)
-            {
-                std::vector<std::string> items;
-                items.reserve(posArgs.size());
-                bool needAutoPack = true;
-                while (!posArgs.empty())
+            case CallBindingPlan::Binding::VAR_LEN_POSITIONAL:
                 {
-                    const auto& argItem = posArgs.front();
-                    // 先检查类型匹配
-                    // if (!checkTypeMatch(param, argItem))
-                    // {
-                    //     const auto& [fst, snd] = getTypesFromOpItem(argItem);
-                    //     throw RCCCompilerError::typeMissmatchError(argItem.getPos().toString(),
-                    //                                                getCodeLine(callPos),
-                    //                                                std::vector{
-                    //                                                    "Error symbol: " + param->toString(),
-                    //                                                    "Type mismatched value: " + argItem.toString()
-                    //                                                }, param->getTypeLabel()->toString(),
-                    //                                                fst
-                    //                                                    ? fst->toString()
-                    //                                                    : snd
-                    //                                                    ? snd->toString()
-                    //                                                    : RCC_UNKNOWN_CONST,
-                    //                                                {
-                    //                                                    "You can try using the `any` type to set the parameter types more loosely."
-                    //                                                });
-                    // }
-                    // 根据不同类型处理参数
-                    std::string item;
-                    switch (argItem.getType())
+                    std::vector<std::string> items;
+                    items.reserve(posArgs.size());
+                    bool needAutoPack = true;
+                    while (!posArgs.empty())
                     {
-                    case OpItemType::IDENTIFIER:
+                        const auto& argItem = posArgs.front();
+                        // 先检查类型匹配
+                        // if (!checkTypeMatch(param, argItem))
+                        // {
+                        //     const auto& [fst, snd] = getTypesFromOpItem(argItem);
+                        //     throw RCCCompilerError::typeMissmatchError(argItem.getPos().toString(),
+                        //                                                getCodeLine(callPos),
+                        //                                                std::vector{
+                        //                                                    "Error symbol: " + param->toString(),
+                        //                                                    "Type mismatched value: " + argItem.toString()
+                        //                                                }, param->getTypeLabel()->toString(),
+                        //                                                fst
+                        //                                                    ? fst->toString()
+                        //                                                    : snd
+                        //                                                    ? snd->toString()
+                        //                                                    : RCC_UNKNOWN_CONST,
+                        //                                                {
+                        //                                                    "You can try using the `any` type to set the parameter types more loosely."
+                        //                                                });
+                        // }
+                        // 根据不同类型处理参数
+                        std::string item;
+                        switch (argItem.getType())
                         {
-                            const auto& argSymbol = getSymbolFromOpItem(argItem);
-                            checkExists(argItem, callPos);
-                            item = argItem.getBelonging() ?
-                                raVal(argItem, true) :
-                                argSymbol->getRaVal();
-                            if (argSymbol->is(SymbolType::VARIABLE))
+                        case OpItemType::IDENTIFIER:
                             {
-                                if (const auto& varSymbol = std::static_pointer_cast<VariableSymbol>(argSymbol);
-                                    varSymbol->getTypeLabel()->is("series") ||
-                                    varSymbol->getValueType()->is("series"))
+                                const auto& argSymbol = getSymbolFromOpItem(argItem);
+                                checkExists(argItem, callPos);
+                                item = argItem.getBelonging() ?
+                                    raVal(argItem, true) :
+                                    argSymbol->getRaVal();
+                                if (argSymbol->is(SymbolType::VARIABLE))
                                 {
-                                    // 如果传入的是 series 类型变量，则视为用户手动打包，不进行自动打包
-                                    needAutoPack = false;
-                                    pushTemOpVarItemWithRecord(getUnknownPos(),
-                                                               TypeLabelSymbol::listTypeSymbol(
-                                                                   getUnknownPos(), curScopeLevel()));
-                                    raCodeBuilder
-                                        << ri::COPY(raVal(posArgs.front(), true), topOpRaVal())
-                                        << ri::TP_SET(topOpItem().getValueType()->getRaVal(), topOpRaVal());
+                                    if (const auto& varSymbol = std::static_pointer_cast<VariableSymbol>(argSymbol);
+                                        varSymbol->getTypeLabel()->is(BuiltinTypeLabel::SERIES) ||
+                                        varSymbol->getValueType()->is(BuiltinTypeLabel::SERIES))
+                                    {
+                                        // 如果传入的是 series 类型变量，则视为用户手动打包，不进行自动打包
+                                        needAutoPack = false;
+                                        pushTemOpVarItemWithRecord(getUnknownPos(),
+                                                                   TypeLabelSymbol::listTypeSymbol(
+                                                                       getUnknownPos(), curScopeLevel()));
+                                        raCodeBuilder
+                                            << ri::COPY(raVal(posArgs.front(), true), topOpRaVal())
+                                            << ri::TP_SET(topOpItem().getValueType()->getRaVal(), topOpRaVal());
+                                    }
                                 }
                             }
+                            break;
+                        case OpItemType::LITERAL_VALUE:
+                            {
+                                item = raVal(argItem, true);
+                            }
+                            break;
+                        default:
+                            throw RCCCompilerError::typeMissmatchError(argItem.getPos().toString(), getCodeLine(callPos),
+                                                                       "The type of the parameter operation item passed to the function call is incorrect.",
+                                                                       getListFormatString({
+                                                                           opItemTypeToFormatString(OpItemType::IDENTIFIER),
+                                                                           opItemTypeToFormatString(
+                                                                               OpItemType::LITERAL_VALUE)
+                                                                       }), opItemTypeToFormatString(argItem.getType()), {
+                                                                           "Please ensure that the types of the arguments passed to the function call are legal."
+                                                                       });
                         }
-                        break;
-                    case OpItemType::LITERAL_VALUE:
+                        items.push_back(std::move(item));
+                        posArgs.pop();
+                    }
+                    if (needAutoPack)
+                    {
+                        pushTemOpVarItemWithRecord(callPos, nullptr,
+                            nullptr, true);
+                        raCodeBuilder
+                            << ri::TP_SET(
+                                TypeLabelSymbol::listTypeSymbol(callPos, symbolTable.curScopeLevel())->getRaVal(),
+                                topOpRaVal());
+                        if (!items.empty())
                         {
-                            item = raVal(argItem, true);
+                            raCodeBuilder << ri::ITER_APND(items, topOpRaVal());
                         }
-                        break;
-                    default:
-                        throw RCCCompilerError::typeMissmatchError(argItem.getPos().toString(), getCodeLine(callPos),
-                                                                   "The type of the parameter operation item passed to the function call is incorrect.",
-                                                                   getListFormatString({
-                                                                       opItemTypeToFormatString(OpItemType::IDENTIFIER),
-                                                                       opItemTypeToFormatString(
-                                                                           OpItemType::LITERAL_VALUE)
-                                                                   }), opItemTypeToFormatString(argItem.getType()), {
-                                                                       "Please ensure that the types of the arguments passed to the function call are legal."
-                                                                   });
                     }
-                    items.push_back(std::move(item));
-                    posArgs.pop();
+                    fullProcessedArgs.push_back(rPopOpItemRaVal());
                 }
-                if (needAutoPack)
+                break;
+            case CallBindingPlan::Binding::VAR_LEN_KEYWORD:
                 {
+                    std::vector<std::string> items{};
+                    for (const auto& [name, opItem] : namedArgs)
+                    {
+                        // if (!checkTypeMatch(param, opItem))
+                        // {
+                        //     const auto& [fst, snd] = getTypesFromOpItem(opItem);
+                        //     throw RCCCompilerError::typeMissmatchError(opItem.getPos().toString(),
+                        //                                                getCodeLine(callPos),
+                        //                                                std::vector{
+                        //                                                    "Error symbol: " + param->toString(),
+                        //                                                    "Type mismatched value: " + opItem.toString()
+                        //                                                }, param->getTypeLabel()->toString(),
+                        //                                                fst
+                        //                                                    ? fst->toString()
+                        //                                                    : snd
+                        //                                                    ? snd->toString()
+                        //                                                    : RCC_UNKNOWN_CONST,
+                        //                                                {
+                        //                                                    "You can try using the `any` type to set the parameter types more loosely."
+                        //                                                });
+                        // }
+                        pushTemOpVarItemWithRecord(callPos, nullptr,
+                            nullptr, true);
+                        raCodeBuilder
+                            << ri::PAIR_SET(StringManager::toStringFormat(name), opItem.getRaVal(symbolTable),
+                                            topOpRaVal());
+                        items.push_back(rPopOpItemRaVal());
+                    }
                     pushTemOpVarItemWithRecord(callPos, nullptr,
                         nullptr, true);
                     raCodeBuilder
                         << ri::TP_SET(
-                            TypeLabelSymbol::listTypeSymbol(callPos, symbolTable.curScopeLevel())->getRaVal(),
+                            TypeLabelSymbol::dictTypeSymbol(callPos, symbolTable.curScopeLevel())->getRaVal(),
                             topOpRaVal());
                     if (!items.empty())
                     {
                         raCodeBuilder << ri::ITER_APND(items, topOpRaVal());
                     }
+                    fullProcessedArgs.push_back(rPopOpItemRaVal());
                 }
-                fullProcessedArgs.push_back(rPopOpItemRaVal());
-            }
-            else if (param->getParamType() == ParamType::PARAM_VAR_LEN_KEYWORD)
-            {
-                std::vector<std::string> items{};
-                for (const auto& [name, opItem] : namedArgs)
-                {
-                    // if (!checkTypeMatch(param, opItem))
-                    // {
-                    //     const auto& [fst, snd] = getTypesFromOpItem(opItem);
-                    //     throw RCCCompilerError::typeMissmatchError(opItem.getPos().toString(),
-                    //                                                getCodeLine(callPos),
-                    //                                                std::vector{
-                    //                                                    "Error symbol: " + param->toString(),
-                    //                                                    "Type mismatched value: " + opItem.toString()
-                    //                                                }, param->getTypeLabel()->toString(),
-                    //                                                fst
-                    //                                                    ? fst->toString()
-                    //                                                    : snd
-                    //                                                    ? snd->toString()
-                    //                                                    : RCC_UNKNOWN_CONST,
-                    //                                                {
-                    //                                                    "You can try using the `any` type to set the parameter types more loosely."
-                    //                                                });
-                    // }
-                    pushTemOpVarItemWithRecord(callPos, nullptr,
-                        nullptr, true);
-                    raCodeBuilder
-                        << ri::PAIR_SET(StringManager::toStringFormat(name), opItem.getRaVal(symbolTable),
-                                        topOpRaVal());
-                    items.push_back(rPopOpItemRaVal());
-                }
-                pushTemOpVarItemWithRecord(callPos, nullptr,
-                    nullptr, true);
-                raCodeBuilder
-                    << ri::TP_SET(
-                        TypeLabelSymbol::dictTypeSymbol(callPos, symbolTable.curScopeLevel())->getRaVal(),
-                        topOpRaVal());
-                if (!items.empty())
-                {
-                    raCodeBuilder << ri::ITER_APND(items, topOpRaVal());
-                }
-                fullProcessedArgs.push_back(rPopOpItemRaVal());
+                break;
+            case CallBindingPlan::Binding::NONE:
+            default:
+                break;
             }
         }
     }
@@ -672,15 +763,19 @@ namespace ast
     void CompileVisitor::emitFinalCall(const std::shared_ptr<FunctionSymbol>& funcSymbol,
                                        const builtin::CallInfos& callInfos)
     {
-        // 检查是否 builtin 函数（包含纯内建）
-        if ((funcSymbol->is(TypeOfBuiltin::BUILTIN) ||
+        // 注册表中的内置函数直接按缓存的分派调用
+        if (const auto dispatch = getCallSiteCacheEntry(funcSymbol).dispatch)
+        {
+            const auto& raCode = callBuiltinFunction(*this, dispatch, callInfos);
+            raCodeBuilder << raCode;
+        }
+        // 检查是否 builtin 函数（DLL 扩展提供的函数可能在编译过程中载入，不缓存）
+        else if ((funcSymbol->is(TypeOfBuiltin::BUILTIN) ||
                 funcSymbol->is(TypeOfBuiltin::PURE_BUILTIN)) &&
             builtin::isBuiltin(funcSymbol->getVal()))
         {
             // 交给 builtin::callBuiltinFunction 处理
-            auto callInfosCopy = callInfos;
-            callInfosCopy.processedArgs = callInfos.processedArgs;
-            const auto& raCode = callBuiltinFunction(*this, funcSymbol->getVal(), callInfosCopy);
+            const auto& raCode = callBuiltinFunction(*this, funcSymbol->getVal(), callInfos);
             raCodeBuilder << raCode;
         }
         else
@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""
+语法树缓存测试：
+1. 往返：对库模块与测试程序执行 RCC ast-verify，语法树序列化、载入后再次序列化的结果须与第一次完全相同；
+2. 回退：在独立的缓存目录中编译一个导入库模块的程序，随后把缓存文件截断、改写或改成旧的格式版本，
+   再次编译的输出须与冷缓存时一致，且缓存文件会被整体解析的结果重新写回。
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+from typing import Callable, Dict, List, Tuple
+
+SCRIPT_DIR = Path(__file__).resolve().parent
+REPO_DIR = SCRIPT_DIR.parent
+LIB_DIR = REPO_DIR / "release" / "Lib"
+TESTS_DIR = REPO_DIR / "tests"
+
+PROGRAM = """import(ds="ds", s="str")
+
+var l = [1, 2, 3]
+var n = ds.size(l)
+var t = "x" + "y"
+"""
+
+# 文件头：4 字节魔数后紧跟变长整数表示的格式版本
+VERSION_OFFSET = 4
+
+
+def flip(position: Callable[[bytes], int]) -> Callable[[bytes], bytes]:
+    def mutate(data: bytes) -> bytes:
+        index = position(data)
+        return data[:index] + bytes([data[index] ^ 0x5A]) + data[index + 1:]
+    return mutate
+
+
+# （说明，改写方式）：每种改写作用于冷缓存写出的原始文件
+MUTATIONS: List[Tuple[str, Callable[[bytes], bytes]]] = [
+    ("empty file", lambda data: b""),
+    ("truncated to half", lambda data: data[:len(data) // 2]),
+    ("truncated by one byte", lambda data: data[:-1]),
+    ("flipped byte in the middle", flip(lambda data: len(data) // 2)),
+    ("flipped last byte", flip(lambda data: len(data) - 1)),
+    ("trailing garbage", lambda data: data + b"\x00garbage"),
+    ("older format version", lambda data: data[:VERSION_OFFSET] + b"\x01" + data[VERSION_OFFSET + 1:]),
+    ("not a cache file", lambda data: b"RIO\x00" + bytes(range(256))),
+]
+
+
+def run(command: List[str], env: Dict[str, str] = None) -> subprocess.CompletedProcess:
+    return subprocess.run(command, capture_output=True, text=True, env=env, timeout=120)
+
+
+def check_round_trip(rcc: Path) -> int:
+    sources = sorted(LIB_DIR.rglob("*.rio")) + sorted(TESTS_DIR.glob("test_*/*.rio"))
+    failures = 0
+    for source in sources:
+        result = run([str(rcc), "ast-verify", f"--path={source}"])
+        if result.returncode != 0 or not result.stdout.startswith("Verified"):
+            failures += 1
+            print(f"[FAIL] round trip {source.relative_to(REPO_DIR)}:\n{result.stdout}{result.stderr}")
+    print(f"[{'PASS' if not failures else 'FAIL'}] round trip of {len(sources)} files")
+    return failures
+
+
+def check_fallback(rcc: Path, work: Path) -> int:
+    source = work / "main.rio"
+    source.write_text(PROGRAM, encoding="utf-8")
+    output = work / "main.ra"
+    ast_dir = work / "cache" / "rcc" / "ast"
+    # 关闭模块缓存，保证每次编译都经过语法树缓存
+    env = dict(os.environ, XDG_CACHE_HOME=str(work / "cache"))
+    command = [str(rcc), "compile", f"--path={source}", f"--output={output}", "no-module-cache"]
+
+    def compile_program() -> str:
+        if output.exists():
+            output.unlink()
+        result = run(command, env)
+        if result.returncode != 0 or not output.exists():
+            raise RuntimeError(f"compilation failed:\n{result.stdout}{result.stderr}")
+        # 文件头中的编译时间每次都不同，不参与比较
+        lines = output.read_text(encoding="utf-8").splitlines(keepends=True)
+        return "".join(line for line in lines if not line.startswith("~ Time:"))
+
+    failures = 0
+    try:
+        expected = compile_program()
+        originals = {path: path.read_bytes() for path in sorted(ast_dir.glob("*.rast"))}
+        if not originals:
+            raise RuntimeError(f"no AST cache files were written to {ast_dir}")
+        if compile_program() != expected:
+            raise RuntimeError("the output compiled from a warm AST cache differs from the cold one")
+        print(f"[PASS] warm cache ({len(originals)} cached modules)")
+    except RuntimeError as error:
+        print(f"[FAIL] {error}")
+        return 1
+
+    for description, mutate in MUTATIONS:
+        for path, data in originals.items():
+            path.write_bytes(mutate(data))
+        try:
+            if compile_program() != expected:
+                raise RuntimeError("the output differs from the cold cache")
+            stale = [path.name for path, data in originals.items() if path.read_bytes() != data]
+            if stale:
+                raise RuntimeError(f"cache files were not rewritten by a full parse: {', '.join(stale)}")
+            print(f"[PASS] {description}")
+        except RuntimeError as error:
+            failures += 1
+            print(f"[FAIL] {description}: {error}")
+    return failures
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Check the AST cache round trip and its fallback on bad cache files")
+    parser.add_argument("--rcc", type=Path, default=REPO_DIR / "release" / "RCC", help="path of the RCC executable")
+    args = parser.parse_args()
+    rcc = args.rcc.resolve()
+
+    failures = check_round_trip(rcc)
+    with tempfile.TemporaryDirectory(prefix="rcc_ast_cache_test_") as work:
+        failures += check_fallback(rcc, Path(work))
+    print(f"\n{'all checks passed' if not failures else f'{failures} checks failed'}")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""
+增量语法分析测试：以 RCC watch --watch-verify 监视一个测试程序的副本，依次写入一组编辑，
+每次更新后 RCC 会整体重新解析文件并与增量解析的结果（含各 Token 的位置）比较，不一致时以错误退出。
+同时要求至少有一次更新复用了未受影响的语句，确认增量路径确实被执行。
+"""
+
+import argparse
+import os
+import queue
+import re
+import subprocess
+import sys
+import tempfile
+import threading
+from pathlib import Path
+from typing import Callable, List, Tuple
+
+SCRIPT_DIR = Path(__file__).resolve().parent
+REPO_DIR = SCRIPT_DIR.parent
+SOURCE = REPO_DIR / "tests" / "test_9_integration" / "test.rio"
+UPDATE_PATTERN = re.compile(r"Updated: reparsed (\d+) statements, reused (\d+) statements")
+
+
+def replace_once(old: str, new: str) -> Callable[[str], str]:
+    def edit(text: str) -> str:
+        if old not in text:
+            raise ValueError(f"edit target not found: {old!r}")
+        return text.replace(old, new, 1)
+    return edit
+
+
+# （说明，编辑）：每个编辑作用于上一次编辑的结果
+EDITS: List[Tuple[str, Callable[[str], str]]] = [
+    ("change a literal in the middle", replace_once("sout(fib(4))", "sout(fib(40))")),
+    ("append a statement", lambda text: text + "\nsout(fib(11))\n"),
+    ("insert a line after the first function", replace_once("ret fib(n - 1) + fib(n - 2)\n}\n",
+                                                            "ret fib(n - 1) + fib(n - 2)\n}\nvar x = 1\n")),
+    ("delete a line", replace_once("sout(fib(6))\n", "")),
+    ("introduce a syntax error", replace_once("sout(fib(7))", "sout(fib(7)")),
+    ("fix the syntax error", replace_once("sout(fib(7)", "sout(fib(7))")),
+    ("edit inside a function body", replace_once("if n <= 1 {", "if n < 2 {")),
+    ("prepend a comment line", lambda text: "// watched\n" + text),
+    ("join two statements", replace_once("sout(fib(8))\nsout(fib(9))", "sout(fib(8)) sout(fib(9))")),
+    ("replace the whole file", lambda text: "var y = 2\nvar z = y * 3\n"),
+]
+
+
+def write_atomically(path: Path, text: str):
+    """先写临时文件再替换，watch 不会读到写了一半的内容"""
+    temp = path.with_suffix(".tmp")
+    temp.write_text(text, encoding="utf-8", newline="\n")
+    os.replace(temp, path)
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Check RCC watch against full parses after a series of edits")
+    parser.add_argument("--rcc", type=Path, default=REPO_DIR / "release" / "RCC", help="path of the RCC executable")
+    parser.add_argument("--timeout", type=float, default=30, help="seconds to wait for each update")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory(prefix="rcc_watch_test_") as work:
+        target = Path(work) / "test.rio"
+        text = SOURCE.read_text(encoding="utf-8")
+        write_atomically(target, text)
+        process = subprocess.Popen([str(args.rcc.resolve()), "watch", f"--path={target}", "watch-verify",
+                                    "--watch-interval=10", f"--watch-updates={len(EDITS)}"],
+                                   stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+        lines: "queue.Queue[str]" = queue.Queue()
+        threading.Thread(target=lambda: [lines.put(line) for line in process.stdout] + [lines.put("")],
+                         daemon=True).start()
+
+        def wait_for(prefix: str) -> str:
+            """读到以 prefix 开头的行并返回；进程提前退出或超时时报告已读到的输出"""
+            seen = []
+            while True:
+                try:
+                    line = lines.get(timeout=args.timeout)
+                except queue.Empty:
+                    raise RuntimeError(f"timed out waiting for {prefix!r}:\n" + "".join(seen))
+                if not line:
+                    raise RuntimeError(f"RCC exited before {prefix!r}:\n" + "".join(seen))
+                seen.append(line)
+                if line.startswith(prefix) or line.strip().startswith(prefix):
+                    return line
+
+        failures = 0
+        reused = 0
+        try:
+            wait_for("Verified")
+            for description, edit in EDITS:
+                text = edit(text)
+                write_atomically(target, text)
+                update = UPDATE_PATTERN.match(wait_for("Updated"))
+                wait_for("Verified")
+                reused += int(update.group(2))
+                print(f"[PASS] {description} (reparsed {update.group(1)}, reused {update.group(2)})")
+        except RuntimeError as error:
+            failures += 1
+            print(f"[FAIL] {error}")
+            process.kill()
+        returncode = process.wait(timeout=args.timeout)
+        if returncode != 0 and not failures:
+            failures += 1
+            print(f"[FAIL] RCC exited with {returncode}")
+        if reused == 0 and not failures:
+            failures += 1
+            print("[FAIL] no update reused any statement")
+    print(f"\n{len(EDITS) - failures if not failures else 0} edits verified, {failures} failed")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
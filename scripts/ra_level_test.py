@@ -0,0 +1,662 @@
+#!/usr/bin/env python3
+"""
+RA 编译级别一致性测试：将 tests 下的每个测试程序按编译级别 0~3 分别编译为 RA，
+用一个最小的 RA 解释器执行，要求各编译级别的输出都与 expected_ra.txt 完全一致。
+expected_ra.txt 由基线编译器（仓库的 baseline 提交，引入 RA 优化器之前）在编译级别 0 下的运行结果生成，
+与被测编译器无关，因此级别 0 本身的错误编译同样能被发现。更新方法：
+    python ra_level_test.py --rcc <基线编译器> --update-expected
+
+同时检查 RAB 字节码：各级别编译出的 RAB 经 rab-decode 还原后须与文本 RA 一致，
+截断或改写的 RAB 文件须被报告为错误或正常解码，不得使编译器崩溃。
+最后以导入模块的测试程序检查模块缓存的命中、源码修改后的失效以及损坏缓存项的回退。
+
+RA 后端尚不支持的程序（级别 0 编译失败且没有 expected_ra.txt）跳过；expected.txt 按 LLVM 后端的运行结果给出，不参与比较。
+"""
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+SCRIPT_DIR = Path(__file__).resolve().parent
+REPO_DIR = SCRIPT_DIR.parent
+LEVELS = (0, 1, 2, 3)
+# 检查模块缓存所用的测试程序：test.rio 导入同目录下的 util.rio，util.rio 中定义 var base = 10
+CACHE_TEST = "test_19_module_variable"
+EXPECTED_FILE = "expected_ra.txt"
+
+
+class RaError(Exception):
+    """RA 程序无法继续执行（未定义的名称、不支持的指令等），视为编译结果错误"""
+
+
+class RioThrow(Exception):
+    """由 EXPOSE 抛出的 Rio 异常"""
+
+    def __init__(self, value):
+        super().__init__(value)
+        self.value = value
+
+
+class Pair:
+    def __init__(self, key, value):
+        self.key = key
+        self.value = value
+
+
+class Function:
+    def __init__(self, name: str, params: List[str], start: int, end: int, env: "Env"):
+        self.name = name
+        self.params = params
+        self.start = start
+        self.end = end
+        self.env = env
+
+
+class TypeObject:
+    def __init__(self, name: str):
+        self.name = name
+        self.tp_fields: Dict[str, object] = {}
+        self.inst_fields: Dict[str, object] = {}
+
+
+class Instance:
+    def __init__(self, tp: TypeObject):
+        self.tp = tp
+        self.fields: Dict[str, object] = dict(tp.inst_fields)
+
+
+class Comparison:
+    """CMP 的结果，由随后的 CREL 按关系转换为布尔值"""
+
+    def __init__(self, left, right):
+        self.left = left
+        self.right = right
+
+
+class Env:
+    def __init__(self, parent: Optional["Env"] = None):
+        self.vars: Dict[str, object] = {}
+        self.parent = parent
+
+    def find(self, name: str) -> Optional["Env"]:
+        env = self
+        while env is not None:
+            if name in env.vars:
+                return env
+            env = env.parent
+        return None
+
+    def get(self, name: str):
+        env = self.find(name)
+        if env is None:
+            raise RaError(f"undefined name: {name}")
+        return env.vars[name]
+
+    def set(self, name: str, value):
+        env = self.find(name)
+        (env or self).vars[name] = value
+
+    def delete(self, name: str):
+        env = self.find(name)
+        if env is None:
+            raise RaError(f"DELETE of undefined name: {name}")
+        del env.vars[name]
+
+
+INT_PATTERN = re.compile(r"-?\d+")
+FLOAT_PATTERN = re.compile(r"-?\d+\.\d*([eE][-+]?\d+)?|-?\d+[eE][-+]?\d+")
+ESCAPES = {"n": "\n", "t": "\t", "r": "\r", "0": "\0", "\\": "\\", '"': '"', "'": "'"}
+
+
+def split_operands(text: str) -> List[str]:
+    """以 ", " 分隔操作数，字符串字面量内部的分隔符不算"""
+    operands, quote, begin, i = [], "", 0, 0
+    while i < len(text):
+        c = text[i]
+        if quote:
+            if c == "\\":
+                i += 1
+            elif c == quote:
+                quote = ""
+        elif c in "\"'":
+            quote = c
+        elif text.startswith(", ", i):
+            operands.append(text[begin:i])
+            begin = i + 2
+            i += 1
+        i += 1
+    operands.append(text[begin:])
+    return operands
+
+
+def parse_program(text: str) -> List[Tuple[str, List[str]]]:
+    """解析 RA 文本，忽略文件头、注释与空行"""
+    program = []
+    for line in text.splitlines():
+        if not line or line.startswith("~") or line.startswith(";"):
+            continue
+        op, _, rest = line.partition(": ")
+        if not rest or rest.startswith(";"):
+            program.append((op, []))
+        else:
+            program.append((op, split_operands(rest)))
+    return program
+
+
+def decode_string(literal: str) -> str:
+    chars, i, body = [], 0, literal[1:-1]
+    while i < len(body):
+        if body[i] == "\\" and i + 1 < len(body):
+            chars.append(ESCAPES.get(body[i + 1], body[i + 1]))
+            i += 2
+        else:
+            chars.append(body[i])
+            i += 1
+    return "".join(chars)
+
+
+def to_text(value) -> str:
+    if value is None:
+        return "null"
+    if value is True:
+        return "true"
+    if value is False:
+        return "false"
+    if isinstance(value, str):
+        return value
+    if isinstance(value, list):
+        return "[" + ", ".join(to_text(item) for item in value) + "]"
+    if isinstance(value, dict):
+        return "{" + ", ".join(f"{to_text(k)}: {to_text(v)}" for k, v in value.items()) + "}"
+    if isinstance(value, Function):
+        return f"<function {value.name}>"
+    if isinstance(value, (TypeObject, Instance)):
+        return f"<object>"
+    return str(value)
+
+
+def truncate_div(left, right):
+    if right == 0:
+        raise RioThrow("division by zero")
+    if isinstance(left, int) and isinstance(right, int):
+        quotient = abs(left) // abs(right)
+        return quotient if (left >= 0) == (right >= 0) else -quotient
+    return left / right
+
+
+def remainder(left, right):
+    if right == 0:
+        raise RioThrow("division by zero")
+    return left - right * truncate_div(left, right) if isinstance(left, int) and isinstance(right, int) \
+        else left - right * int(left / right)
+
+
+RELATIONS = {
+    "RE": lambda l, r: l == r,
+    "RNE": lambda l, r: l != r,
+    "RL": lambda l, r: l < r,
+    "RLE": lambda l, r: l <= r,
+    "RG": lambda l, r: l > r,
+    "RGE": lambda l, r: l >= r,
+    "AND": lambda l, r: bool(l) and bool(r),
+    "OR": lambda l, r: bool(l) or bool(r),
+}
+
+
+class RaInterpreter:
+    """只覆盖测试程序用到的 RA 指令；遇到未支持的指令时报错，而不是猜测其语义"""
+
+    def __init__(self, text: str, max_steps: int = 2_000_000):
+        self.program = parse_program(text)
+        self.output: List[str] = []
+        self.steps = 0
+        self.max_steps = max_steps
+        self.labels: Dict[str, int] = {}
+        self.block_ends: Dict[int, int] = {}
+        self.block_starts: Dict[int, int] = {}
+        # 指令位置 -> 包含它的最内层 UNTIL 循环的起始位置
+        self.loops: Dict[int, int] = {}
+        self.index_blocks()
+
+    def index_blocks(self):
+        """标签位置，函数、ATMP、DETECT、UNTIL 块的起止位置，以及每条指令所在的循环"""
+        stack: List[Tuple[int, str]] = []
+        for i, (op, operands) in enumerate(self.program):
+            loop = next((start for start, kind in reversed(stack) if kind == "UNTIL"), None)
+            if loop is not None:
+                self.loops[i] = loop
+            if op == "SET" and operands:
+                self.labels[operands[0]] = i
+            elif op in ("FUNI", "FUNC") and operands:
+                stack.append((i, operands[0]))
+            elif op in ("ATMP", "DETECT", "UNTIL"):
+                stack.append((i, op))
+            elif op == "END" and operands and stack and stack[-1][1] == operands[0]:
+                start = stack.pop()[0]
+                self.block_ends[start] = i
+                self.block_starts[i] = start
+
+    def value(self, token: str, env: Env):
+        if token.startswith('"') or token.startswith("'"):
+            return decode_string(token)
+        if token == "true":
+            return True
+        if token == "false":
+            return False
+        if token == "null":
+            return None
+        if INT_PATTERN.fullmatch(token):
+            return int(token)
+        if FLOAT_PATTERN.fullmatch(token):
+            return float(token)
+        return env.get(token)
+
+    def field_name(self, token: str) -> str:
+        return decode_string(token) if token.startswith('"') else token
+
+    def call(self, function, args: list):
+        if not isinstance(function, Function):
+            raise RaError(f"call of a non-function value: {to_text(function)}")
+        env = Env(function.env)
+        for i, param in enumerate(function.params):
+            env.vars[param] = args[i] if i < len(args) else None
+        return self.execute(function.start, function.end, env)
+
+    def run(self) -> str:
+        try:
+            self.execute(0, len(self.program), Env())
+        except RioThrow as throw:
+            self.output.append(f"<uncaught: {to_text(throw.value)}>\n")
+        return "".join(self.output)
+
+    def execute(self, pc: int, end: int, env: Env):
+        handlers: List[int] = []
+        while pc < end:
+            self.steps += 1
+            if self.steps > self.max_steps:
+                raise RaError("step limit exceeded")
+            op, operands = self.program[pc]
+            try:
+                jump = self.step(op, operands, pc, env, handlers)
+            except RioThrow as throw:
+                if not handlers:
+                    raise
+                # 跳到最内层 ATMP 块中的 DETECT，没有 DETECT 时继续向外抛出
+                attempt = handlers.pop()
+                detect = next((i for i in range(attempt + 1, self.block_ends[attempt])
+                               if self.program[i][0] == "DETECT"), None)
+                if detect is None:
+                    raise
+                detect_operands = self.program[detect][1]
+                if len(detect_operands) > 1:
+                    env.vars[detect_operands[1]] = throw.value
+                pc = detect + 1
+                continue
+            if isinstance(jump, tuple):
+                return jump[1]
+            pc = pc + 1 if jump is None else jump
+        return None
+
+    def step(self, op: str, operands: List[str], pc: int, env: Env, handlers: List[int]):
+        """执行一条指令，返回下一条指令的位置（None 表示顺序执行）或 ("RET", 返回值)"""
+        v = lambda token: self.value(token, env)
+        if op in ("PASS", "SET"):
+            return None
+        if op == "ALLOT":
+            for name in operands:
+                env.vars[name] = None
+        elif op == "DELETE":
+            for name in operands:
+                env.delete(name)
+        elif op in ("PUT", "COPY"):
+            env.set(operands[1], v(operands[0]))
+        elif op == "OPP":
+            value = v(operands[0])
+            env.set(operands[1], not value if isinstance(value, bool) else -value)
+        elif op == "ADD":
+            left, right = v(operands[0]), v(operands[1])
+            if isinstance(left, list) and isinstance(right, list):
+                env.set(operands[2], left + right)
+            elif isinstance(left, str) or isinstance(right, str):
+                env.set(operands[2], to_text(left) + to_text(right))
+            else:
+                env.set(operands[2], left + right)
+        elif op == "MUL":
+            env.set(operands[2], v(operands[0]) * v(operands[1]))
+        elif op == "DIV":
+            env.set(operands[2], truncate_div(v(operands[0]), v(operands[1])))
+        elif op == "MOD":
+            env.set(operands[2], remainder(v(operands[0]), v(operands[1])))
+        elif op == "POW":
+            env.set(operands[2], v(operands[0]) ** v(operands[1]))
+        elif op == "CMP":
+            env.set(operands[2], Comparison(v(operands[0]), v(operands[1])))
+        elif op == "CREL":
+            comparison = v(operands[0])
+            if not isinstance(comparison, Comparison) or operands[1] not in RELATIONS:
+                raise RaError(f"CREL without a comparison: {operands}")
+            env.set(operands[2], RELATIONS[operands[1]](comparison.left, comparison.right))
+        elif op in ("JT", "JF"):
+            if bool(v(operands[0])) == (op == "JT"):
+                return self.labels[operands[1]]
+        elif op == "JMP":
+            return self.labels[operands[0]]
+        elif op in ("FUNI", "FUNC"):
+            block_end = self.block_ends[pc]
+            env.set(operands[0], Function(operands[0], operands[1:], pc + 1, block_end, env))
+            return block_end + 1
+        elif op == "RET":
+            return "RET", v(operands[0]) if operands else None
+        elif op == "IVOK":
+            env.set(operands[-1], self.call(v(operands[0]), [v(arg) for arg in operands[1:-1]]))
+        elif op == "CALL":
+            self.call(v(operands[0]), [v(arg) for arg in operands[1:]])
+        elif op == "UNTIL":
+            # 比较结果满足给定关系时结束循环，否则执行循环体
+            comparison = v(operands[0])
+            if not isinstance(comparison, Comparison) or operands[1] not in RELATIONS:
+                raise RaError(f"UNTIL without a comparison: {operands}")
+            if RELATIONS[operands[1]](comparison.left, comparison.right):
+                return self.block_ends[pc] + 1
+        elif op == "EXIT" and operands and operands[0] in ("UNTIL", "LOOP", "LOOP_CONTINUE"):
+            if pc not in self.loops:
+                raise RaError(f"EXIT: {operands[0]} outside a loop")
+            loop = self.loops[pc]
+            return loop if operands[0] == "LOOP_CONTINUE" else self.block_ends[loop] + 1
+        elif op == "EXIT":
+            return "RET", None
+        elif op == "TP_SET":
+            kinds = {"tp-list": list, "tp-dict": dict}
+            if operands[0] not in kinds:
+                raise RaError(f"unsupported TP_SET type: {operands[0]}")
+            env.set(operands[1], kinds[operands[0]]())
+        elif op == "PAIR_SET":
+            env.set(operands[2], Pair(v(operands[0]), v(operands[1])))
+        elif op == "ITER_APND":
+            container = v(operands[-1])
+            for token in operands[:-1]:
+                item = v(token)
+                if isinstance(container, dict) and isinstance(item, Pair):
+                    container[item.key] = item.value
+                elif isinstance(container, list):
+                    container.append(item)
+                else:
+                    raise RaError(f"ITER_APND to {to_text(container)}")
+        elif op == "ITER_GET":
+            container, key = v(operands[0]), v(operands[1])
+            try:
+                env.set(operands[2], container[key])
+            except (KeyError, IndexError, TypeError):
+                raise RioThrow(f"no item {to_text(key)}")
+        elif op == "ITER_SIZE":
+            env.set(operands[1], len(v(operands[0])))
+        elif op == "SOUT":
+            value = v(operands[2])
+            text = "".join(to_text(item) for item in value) if operands[1] == "s-unpack" else to_text(value)
+            self.output.append(text + to_text(v(operands[3])))
+        elif op == "TP_DEF":
+            env.set(operands[0], TypeObject(operands[0]))
+        elif op == "TP_ADD_TP_FIELD":
+            v(operands[0]).tp_fields[self.field_name(operands[1])] = v(operands[2])
+        elif op == "TP_ADD_INST_FIELD":
+            v(operands[0]).inst_fields[self.field_name(operands[1])] = v(operands[2])
+        elif op == "TP_NEW":
+            env.set(operands[1], Instance(v(operands[0])))
+        elif op == "TP_GET_FIELD":
+            target, field = v(operands[0]), self.field_name(operands[1])
+            fields = target.tp_fields if isinstance(target, TypeObject) else target.fields \
+                if isinstance(target, Instance) else None
+            if fields is None or field not in fields:
+                raise RioThrow(f"no field {field}")
+            env.set(operands[2], fields[field])
+        elif op == "TP_SET_FIELD":
+            target = v(operands[0])
+            fields = target.tp_fields if isinstance(target, TypeObject) else target.fields
+            fields[self.field_name(operands[1])] = v(operands[2])
+        elif op == "EXPOSE":
+            raise RioThrow(v(operands[0]) if operands else None)
+        elif op == "ATMP":
+            handlers.append(pc)
+        elif op == "DETECT":
+            # 正常执行到异常处理块时跳过它
+            return self.block_ends[pc] + 1
+        elif op == "END":
+            if operands and operands[0] == "ATMP" and handlers:
+                handlers.pop()
+            elif operands and operands[0] == "UNTIL":
+                return self.block_starts[pc]
+        else:
+            raise RaError(f"unsupported instruction: {op}")
+        return None
+
+
+def run_ra(text: str) -> str:
+    try:
+        return RaInterpreter(text).run()
+    except RaError as error:
+        return f"<RA error: {error}>\n"
+    except RecursionError:
+        return "<RA error: recursion limit exceeded>\n"
+
+
+def compile_rio(rcc: Path, source: Path, output: Path, level: int, extra: List[str] = (),
+                env: Optional[dict] = None) -> subprocess.CompletedProcess:
+    return subprocess.run([str(rcc), "compile", f"--path={source}", f"--output={output}",
+                           f"--compile-level={level}", *extra],
+                          capture_output=True, text=True, env=env, timeout=120)
+
+
+def decode_rab(rcc: Path, source: Path, output: Path) -> subprocess.CompletedProcess:
+    return subprocess.run([str(rcc), "rab-decode", f"--path={source}", f"--output={output}"],
+                          capture_output=True, text=True, timeout=120)
+
+
+def strip_header(text: str) -> List[str]:
+    """去掉以 ~ 开头的文件头注释（其中记录了输出文件的路径）"""
+    return [line for line in text.splitlines() if not line.startswith("~")]
+
+
+class TestRun:
+    def __init__(self, rcc: Path, work_dir: Path):
+        self.rcc = rcc
+        self.work_dir = work_dir
+        self.failures: List[str] = []
+        self.passed = 0
+        self.skipped = 0
+        # 模块缓存写入临时目录，不受用户缓存中旧条目的影响
+        self.env = dict(os.environ, XDG_CACHE_HOME=str(work_dir / "cache"))
+
+    def check(self, condition: bool, name: str, detail: str = ""):
+        if condition:
+            self.passed += 1
+            print(f"[PASS] {name}")
+        else:
+            self.failures.append(name)
+            print(f"[FAIL] {name}" + (f"\n{detail}" if detail else ""))
+
+    def check_levels(self, test_dir: Path):
+        """各编译级别的输出须与基线编译器在级别 0 下的输出（expected_ra.txt）一致"""
+        source = test_dir / "test.rio"
+        expected_file = test_dir / EXPECTED_FILE
+        expected = expected_file.read_text(encoding="utf-8") if expected_file.exists() else None
+        for level in LEVELS:
+            target = self.work_dir / f"{test_dir.name}.cl{level}.ra"
+            result = compile_rio(self.rcc, source, target, level, env=self.env)
+            if result.returncode != 0:
+                if level == 0 and expected is None:
+                    self.skipped += 1
+                    print(f"[SKIP] {test_dir.name} - not supported by the RA backend")
+                    return
+                self.check(False, f"{test_dir.name} cl{level} compile", result.stdout + result.stderr)
+                return
+            if expected is None:
+                self.check(False, f"{test_dir.name} has {EXPECTED_FILE}",
+                           f"generate it with the baseline compiler: {Path(__file__).name} --rcc <baseline RCC> "
+                           f"--update-expected {test_dir.name}")
+                return
+            ra_text = target.read_text(encoding="utf-8")
+            output = run_ra(ra_text)
+            self.check(output == expected, f"{test_dir.name} cl{level} == baseline",
+                       f"--- baseline\n{expected}--- cl{level}\n{output}")
+            self.check_rab(test_dir, level, ra_text)
+        self.check_corrupt_rab(test_dir)
+
+    def update_expected(self, test_dir: Path):
+        """以当前的 --rcc（应为基线编译器）在级别 0 下的运行结果写入 expected_ra.txt"""
+        target = self.work_dir / f"{test_dir.name}.expected.ra"
+        result = compile_rio(self.rcc, test_dir / "test.rio", target, 0, env=self.env)
+        if result.returncode != 0:
+            self.skipped += 1
+            print(f"[SKIP] {test_dir.name} - not supported by the RA backend")
+            return
+        output = run_ra(target.read_text(encoding="utf-8"))
+        if output.startswith("<RA error"):
+            self.check(False, f"{test_dir.name} cl0 run", output)
+            return
+        (test_dir / EXPECTED_FILE).write_text(output, encoding="utf-8", newline="\n")
+        self.check(True, f"{test_dir.name} {EXPECTED_FILE} updated")
+
+    def check_rab(self, test_dir: Path, level: int, ra_text: str):
+        """RAB 编码后再解码须得到与文本 RA 相同的指令"""
+        name = f"{test_dir.name} cl{level} rab round-trip"
+        rab = self.work_dir / f"{test_dir.name}.cl{level}.rab"
+        result = compile_rio(self.rcc, test_dir / "test.rio", rab, level, ["--format=rab"], self.env)
+        if result.returncode != 0:
+            self.check(False, name, result.stdout + result.stderr)
+            return
+        decoded = self.work_dir / f"{test_dir.name}.cl{level}.decoded.ra"
+        result = decode_rab(self.rcc, rab, decoded)
+        if result.returncode != 0:
+            self.check(False, name, result.stdout + result.stderr)
+            return
+        self.check(strip_header(decoded.read_text(encoding="utf-8")) == strip_header(ra_text), name)
+
+    def check_corrupt_rab(self, test_dir: Path):
+        """截断的 RAB 须报告错误；任意改写一个字节的 RAB 可以解码成功或报告错误，但不得崩溃"""
+        data = (self.work_dir / f"{test_dir.name}.cl0.rab").read_bytes()
+        corrupt = self.work_dir / f"{test_dir.name}.corrupt.rab"
+        decoded = self.work_dir / f"{test_dir.name}.corrupt.ra"
+        truncated_ok = True
+        details = []
+        for size in sorted({0, 4, len(data) // 2, len(data) - 1}):
+            corrupt.write_bytes(data[:size])
+            result = decode_rab(self.rcc, corrupt, decoded)
+            if result.returncode != 1 or "Invalid RAB bytecode" not in result.stdout + result.stderr:
+                truncated_ok = False
+                details.append(f"truncated to {size} bytes: rc={result.returncode}\n{result.stdout}{result.stderr}")
+        self.check(truncated_ok, f"{test_dir.name} truncated rab rejected", "\n".join(details))
+        flipped_ok = True
+        details = []
+        for position in range(0, len(data), max(1, len(data) // 16)):
+            flipped = bytearray(data)
+            flipped[position] ^= 0xFF
+            corrupt.write_bytes(bytes(flipped))
+            result = decode_rab(self.rcc, corrupt, decoded)
+            if result.returncode not in (0, 1):
+                flipped_ok = False
+                details.append(f"byte {position} flipped: rc={result.returncode}\n{result.stdout}{result.stderr}")
+        self.check(flipped_ok, f"{test_dir.name} corrupted rab handled", "\n".join(details))
+
+    def check_module_cache(self, test_dir: Path):
+        """再次编译命中缓存且结果不变；修改被导入模块后缓存失效；损坏的缓存项被忽略并重新编译"""
+        case_dir = self.work_dir / "module_cache"
+        shutil.copytree(test_dir, case_dir)
+        env = dict(os.environ, XDG_CACHE_HOME=str(case_dir / "cache"))
+        modules_dir = case_dir / "cache" / "rcc" / "modules"
+        source = case_dir / "test.rio"
+        count = 0
+
+        def compile_case() -> Optional[str]:
+            nonlocal count
+            count += 1
+            target = case_dir / f"out{count}.ra"
+            result = compile_rio(self.rcc, source, target, 2, env=env)
+            if result.returncode != 0:
+                self.check(False, f"module cache compile #{count}", result.stdout + result.stderr)
+                return None
+            return target.read_text(encoding="utf-8")
+
+        def entries() -> Dict[str, int]:
+            return {path.name: path.stat().st_mtime_ns for path in modules_dir.glob("*")} \
+                if modules_dir.exists() else {}
+
+        first = compile_case()
+        if first is None:
+            return
+        stored = entries()
+        self.check(len(stored) > 0 and all(name.endswith(".rmod") for name in stored),
+                   "module cache stored", f"cache entries: {sorted(stored)}")
+
+        second = compile_case()
+        if second is None:
+            return
+        self.check(strip_header(second) == strip_header(first), "module cache hit output unchanged")
+        self.check(entries() == stored, "module cache hit reuses the entry", f"{stored} -> {entries()}")
+
+        util = case_dir / "util.rio"
+        util.write_text(util.read_text(encoding="utf-8").replace("base = 10", "base = 20"), encoding="utf-8")
+        modified = compile_case()
+        if modified is None:
+            return
+        self.check(len(set(entries()) - set(stored)) > 0, "module cache invalidated by source change",
+                   f"{sorted(stored)} -> {sorted(entries())}")
+        reference = run_ra(modified)
+        self.check(reference != run_ra(first) and not reference.startswith("<RA error"),
+                   "module cache change reaches the output", reference)
+
+        for entry in modules_dir.glob("*.rmod"):
+            data = entry.read_bytes()
+            entry.write_bytes(data[:len(data) // 2])
+        recovered = compile_case()
+        if recovered is None:
+            return
+        self.check(strip_header(recovered) == strip_header(modified), "module cache corrupt entry ignored")
+        self.check(not list(modules_dir.glob("*.tmp")), "module cache leaves no temp files")
+
+
+def find_rcc() -> Path:
+    for name in ("RCC", "RCC.exe"):
+        if (REPO_DIR / "release" / name).exists():
+            return REPO_DIR / "release" / name
+    return REPO_DIR / "release" / "RCC"
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Compare the output of RA compiled at every compile level")
+    parser.add_argument("--rcc", type=Path, default=find_rcc(), help="path of the RCC executable")
+    parser.add_argument("--tests", type=Path, default=REPO_DIR / "tests", help="directory containing test_* cases")
+    parser.add_argument("--update-expected", action="store_true",
+                        help=f"write {EXPECTED_FILE} from the level 0 output of --rcc, which should be the baseline compiler")
+    parser.add_argument("filter", nargs="*", help="only run the test cases whose directory name contains one of these")
+    args = parser.parse_args()
+    sys.setrecursionlimit(20000)
+
+    test_dirs = sorted((d for d in args.tests.iterdir() if d.is_dir() and (d / "test.rio").exists()),
+                       key=lambda d: [int(s) if s.isdigit() else s for s in re.split(r"(\d+)", d.name)])
+    if args.filter:
+        test_dirs = [d for d in test_dirs if any(f in d.name for f in args.filter)]
+    with tempfile.TemporaryDirectory(prefix="rcc_ra_test_") as work:
+        run = TestRun(args.rcc.resolve(), Path(work))
+        for test_dir in test_dirs:
+            if args.update_expected:
+                run.update_expected(test_dir)
+            else:
+                run.check_levels(test_dir)
+        cache_test = args.tests / CACHE_TEST
+        if not args.update_expected and (cache_test / "test.rio").exists() and \
+                (not args.filter or any(f in CACHE_TEST for f in args.filter)):
+            run.check_module_cache(cache_test)
+    print(f"\n{run.passed} passed, {len(run.failures)} failed, {run.skipped} skipped")
+    for name in run.failures:
+        print(f"  failed: {name}")
+    return 1 if run.failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
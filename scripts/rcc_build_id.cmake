@@ -0,0 +1,23 @@
+# 构建标识：构建时由 CMakeLists.txt 以 cmake -P 调用，对编译器的全部源文件计算散列，
+# 生成定义 base::RCC_BUILD_ID 的源文件。源文件修改后构建标识随之改变，版本号相同的不同构建不会共用模块缓存
+# 参数：SOURCES_FILE 源文件列表（每行一个，相对于工作目录），OUTPUT 生成的源文件
+file(STRINGS "${SOURCES_FILE}" sources)
+set(digests "")
+foreach(source IN LISTS sources)
+    file(SHA256 "${source}" digest)
+    string(APPEND digests "${source} ${digest}\n")
+endforeach()
+string(SHA256 buildId "${digests}")
+string(SUBSTRING "${buildId}" 0 16 buildId)
+string(CONCAT content "// Generated by scripts/rcc_build_id.cmake. Do not edit.\n"
+        "namespace base\n{\n"
+        "    extern const char RCC_BUILD_ID[] = \"${buildId}\";\n"
+        "}\n")
+# 内容不变时不改写，避免无谓的重新链接
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" previous)
+    if(previous STREQUAL content)
+        return()
+    endif()
+endif()
+file(WRITE "${OUTPUT}" "${content}")